@@ -27,13 +27,46 @@
 
 #include "tools.h"
 #include "activeObject.h"
+#include "writeBehind.h"
+#include "ostream.h"
+#include "waitQueue.h"
+#include "threadPool.h"
+#include "traceLog.h"
+#include "memoryAccount.h"
+#include "nameNoCase.h"
+#include "binaryLayout.h"
 #include "condor.h"
 #include "istream.h"
+#include "asyncIO.h"
+#include "gzipDecoder.h"
+#include "httpClient.h"
 #include "fileParserCSV.h"
+#include "compiledCSV.h"
 #include "fileParserINI.h"
+#include "condor2nav.h"
+#include "translator.h"
+#include "targetXCSoar6.h"
+#include "lkMapsDB.h"
+#include "naviConPool.h"
+#include "namedPipe.h"
+#include "taskGeometry.h"
+#include "taskCorridor.h"
+#include "recordWriter.h"
+#include "targetLK8000.h"
+#include "testSupport/testSupport.h"
+#include "../tools/PolarOptimiser/src/polarFit.h"
+#include "../tools/PolarOptimiser/src/polarXCSoar.h"
+#include "../tools/PolarOptimiser/src/parallel.h"
 #include "CppUnitTest.h"
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <thread>
 
 using namespace condor2nav;
 
@@ -45,6 +78,7 @@ template<> static std::wstring Microsoft::VisualStudio::CppUnitTestFramework::To
 namespace unitTests
 {
   using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+  using namespace condor2nav::test;
 
   const bfs::path MAIN_SRC_DIR = "..";
 
@@ -69,6 +103,43 @@ namespace unitTests
       Assert::AreEqual(99.123, Convert<double>("99.123"));
     }
 
+    TEST_METHOD(ConversionsFromTextNumeric)
+    {
+      Assert::AreEqual(12,                      Convert<int>("  12"));
+      Assert::AreEqual(12,                      Convert<int>("12abc"));
+      Assert::AreEqual(4294967295U,             Convert<unsigned>("4294967295"));
+      Assert::AreEqual(-2147483647 - 1,         Convert<int>("-2147483648"));
+      Assert::AreEqual(0.5,                     Convert<double>(".5"));
+      Assert::AreEqual(-0.0015,                 Convert<double>("-1.5e-3"));
+      Assert::AreEqual(12.345678901234567,      Convert<double>("12.345678901234567"));
+      Assert::AreEqual(54.366667f,              Convert<float>("54.366667"));
+      Assert::ExpectException<EOperationFailed>([]{ Convert<int>("abc"); });
+      Assert::ExpectException<EOperationFailed>([]{ Convert<int>("2147483648"); });
+      Assert::ExpectException<EOperationFailed>([]{ Convert<unsigned>("x1"); });
+      Assert::ExpectException<EOperationFailed>([]{ Convert<double>("."); });
+    }
+
+    TEST_METHOD(ConversionsBenchmark)
+    {
+      const unsigned count = 100000;
+      auto streamConvert = [](const std::string &str) { double v; std::stringstream stream{str}; stream >> v; return v; };
+      auto start = std::chrono::high_resolution_clock::now();
+      double sumStream = 0;
+      for(unsigned i = 0; i < count; ++i)
+        sumStream += streamConvert("43.123456");
+      auto mid = std::chrono::high_resolution_clock::now();
+      double sum = 0;
+      for(unsigned i = 0; i < count; ++i)
+        sum += Convert<double>("43.123456");
+      auto end = std::chrono::high_resolution_clock::now();
+      Assert::AreEqual(sumStream, sum);
+
+      using ms = std::chrono::milliseconds;
+      std::string msg{"Convert<double>: stream " + Convert(static_cast<unsigned>(std::chrono::duration_cast<ms>(mid - start).count())) +
+                      "ms, fast " + Convert(static_cast<unsigned>(std::chrono::duration_cast<ms>(end - mid).count())) + "ms\n"};
+      Logger::WriteMessage(msg.c_str());
+    }
+
     TEST_METHOD(ConversionsCoordinatesToText)
     {
       Assert::AreEqual(std::string{ "00:00.000N"}, Coord2DDMMFF(TLatitude{0}));
@@ -88,6 +159,40 @@ namespace unitTests
       Assert::AreEqual(std::string{"158:11:50W"},  Coord2DDMMSS(TLongitude{-158.1972226}));
       Assert::AreEqual(std::string{ "13:09:47S"},  Coord2DDMMSS(TLatitude{-13.163056}));
       Assert::AreEqual(std::string{"072:32:44W"},  Coord2DDMMSS(TLongitude{-72.545556}));
+
+      std::string str{"DP "};
+      Coord2DDMMSS(TLatitude{-13.163056}, str);
+      str += ' ';
+      Coord2DDMMSS(TLongitude{-72.545556}, str);
+      Assert::AreEqual(std::string{"DP 13:09:47S 072:32:44W"}, str);
+
+      char buffer[COORD_STR_MAX_LENGTH];
+      Assert::AreEqual(std::string{"158:11.833W"}, std::string(buffer, Coord2DDMMFF(TLongitude{-158.1972226}, buffer)));
+      Assert::AreEqual(std::string{ "21:34.767N"}, std::string(buffer, Coord2DDMMFF(TLatitude{21.5794446}, buffer)));
+      Assert::AreEqual(std::string{"072:32:44W"},  std::string(buffer, Coord2DDMMSS(TLongitude{-72.545556}, buffer)));
+      Assert::AreEqual(std::string{ "13:09:47S"},  std::string(buffer, Coord2DDMMSS(TLatitude{-13.163056}, buffer)));
+    }
+
+    TEST_METHOD(ConversionsCupCoordinates)
+    {
+      Assert::AreEqual(0.0, CupLatitude("0000.000N").value);
+      Assert::AreEqual(0.0, CupLongitude("00000.000E").value);
+      Assert::AreEqual(51 + 7.83 / 60, CupLatitude("5107.830N").value, 1e-9);
+      Assert::AreEqual(14 + 10.467 / 60, CupLongitude("01410.467E").value, 1e-9);
+      Assert::AreEqual(-(13 + 9.783 / 60), CupLatitude(" 1309.783S ").value, 1e-9);
+      Assert::AreEqual(-(158 + 11.833 / 60), CupLongitude("15811.833W").value, 1e-9);
+
+      // round trip with the .dat format
+      Assert::AreEqual(std::string{"158:11.833W"}, Coord2DDMMFF(CupLongitude("15811.833W")));
+      Assert::AreEqual(std::string{ "21:34.767N"}, Coord2DDMMFF(CupLatitude("2134.767N")));
+
+      Assert::ExpectException<EOperationFailed>([]{ CupLatitude(""); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLatitude("5107.830E"); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLatitude("5107830N"); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLatitude("5107.N"); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLatitude("5167.830N"); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLongitude("5107.830E"); });
+      Assert::ExpectException<EOperationFailed>([]{ CupLongitude("01410.467EE"); });
     }
 
     TEST_METHOD(ConversionsSpeed)
@@ -150,6 +255,32 @@ namespace unitTests
       Assert::IsFalse(FileExists("nonexisting"));
     }
 
+    TEST_METHOD(NamesNoCase)
+    {
+      const CNameNoCase name1{"Slovenia2.TXT"};
+      const CNameNoCase name2{"SLOVENIA2.txt"};
+      const CNameNoCase name3{"Alps.TXT"};
+      Assert::IsTrue(name1 == name2);
+      Assert::IsTrue(name1 != name3);
+      Assert::AreEqual(std::string("SLOVENIA2.txt"), name2.str());
+      Assert::IsTrue(std::hash<CNameNoCase>{}(name1) == std::hash<CNameNoCase>{}(name2));
+      Assert::IsTrue(name3 < name1);
+      Assert::IsFalse(name1 < name2 || name2 < name1);
+      Assert::AreEqual(0, name1.Compare("sLovenia2.Txt"));
+      Assert::IsTrue(name1.Compare("Slovenia3.txt") < 0);
+      Assert::IsTrue(name1.Compare("Slovenia") > 0);
+      Assert::IsTrue(CNameNoCase{}.empty());
+    }
+
+    TEST_METHOD(RangeValidators)
+    {
+      using TValidators = CHttpClient::TValidators;
+      Assert::AreEqual(std::string{"\"abc\""}, TValidators{"\"abc\"", "Wed, 21 Oct 2015 07:28:00 GMT"}.Range());
+      Assert::AreEqual(std::string{"Wed, 21 Oct 2015 07:28:00 GMT"}, TValidators{"W/\"abc\"", "Wed, 21 Oct 2015 07:28:00 GMT"}.Range());
+      Assert::IsTrue(TValidators{"W/\"abc\"", ""}.Range().empty());
+      Assert::IsTrue(TValidators{}.Range().empty());
+    }
+
   };
 
 
@@ -169,6 +300,477 @@ namespace unitTests
     }
   };
 
+  TEST_CLASS(TestWriteBehind) {
+  public:
+    TEST_METHOD(Barrier)
+    {
+      CWriteBehind queue{true};
+      bool written = false;
+      COStream stream{"condor2nav_writebehind.txt"};
+      stream << "data" << std::endl;
+      stream.Commit(queue, [&]{ written = true; });
+      queue.Wait();
+      Assert::IsTrue(written);
+      Assert::IsTrue(bfs::exists("condor2nav_writebehind.txt"));
+    }
+
+    TEST_METHOD(Errors)
+    {
+      CWriteBehind queue{true};
+      for(const auto &path : { "nonexisting_dir/file1.txt", "condor2nav_writebehind.txt", "nonexisting_dir/file2.txt" }) {
+        COStream stream{path};
+        stream << "data" << std::endl;
+        stream.Commit(queue);
+      }
+      try {
+        queue.Wait();
+        Assert::Fail(L"Write errors not reported");
+      }
+      catch(const EOperationFailed &ex) {
+        const std::string errors{ex.what()};
+        Assert::IsTrue(errors.find("file1.txt") != std::string::npos && errors.find("file2.txt") != std::string::npos);
+      }
+      queue.Wait();
+    }
+
+    TEST_METHOD(Disabled)
+    {
+      CWriteBehind queue{false};
+      COStream stream{"nonexisting_dir/file.txt"};
+      stream << "data" << std::endl;
+      Assert::ExpectException<EOperationFailed>([&]{ stream.Commit(queue); });
+    }
+  };
+
+
+
+  ////////////////////////   T R A C E   L O G   ////////////////////////
+
+  TEST_CLASS(TestTraceLog) {
+  public:
+    TEST_METHOD(Summary)
+    {
+      CTraceLog::Enable(true);
+      CTraceLog::Instance().Take();
+      for(unsigned i=0; i<3; i++) {
+        CTraceScope trace{"test", "Read", bfs::path{"file.txt"}};
+        trace.Bytes(100);
+      }
+      {
+        CTraceScope trace{"test", "Parse"};
+      }
+      CTraceLog::Enable(false);
+      {
+        CTraceScope trace{"test", "Disabled"};
+      }
+
+      const auto summary = CTraceLog::Summary(CTraceLog::Instance().Take());
+      Assert::AreEqual(size_t{2}, summary.size());
+      Assert::AreEqual(std::string{"test: Read"}, summary[0].name);
+      Assert::AreEqual(3u, summary[0].count);
+      Assert::IsTrue(summary[0].bytes == 300);
+      Assert::AreEqual(std::string{"test: Parse"}, summary[1].name);
+      Assert::IsTrue(CTraceLog::Instance().Take().empty());
+    }
+  };
+
+
+
+  ////////////////////////   M E M O R Y   A C C O U N T   ////////////////////////
+
+  TEST_CLASS(TestMemoryAccount) {
+  public:
+    TEST_METHOD(Usage)
+    {
+      const auto before = CMemoryAccount::Usage(TMemorySubsystem::OUTPUT);
+      {
+        CCountedString<TMemorySubsystem::OUTPUT> str(100000, 'x');
+        CMemoryCharge charge{TMemorySubsystem::OUTPUT};
+        charge.Set(1000);
+        charge.Set(500);
+        const auto usage = CMemoryAccount::Usage(TMemorySubsystem::OUTPUT);
+        Assert::IsTrue(usage.current >= before.current + 100500);
+        Assert::IsTrue(usage.peak >= before.current + 101000);
+      }
+      const auto after = CMemoryAccount::Usage(TMemorySubsystem::OUTPUT);
+      Assert::IsTrue(after.current == before.current);
+      Assert::IsTrue(after.peak >= before.current + 101000);
+    }
+
+    TEST_METHOD(ParserSetters)
+    {
+      const auto before = CMemoryAccount::Usage(TMemorySubsystem::PARSERS).current;
+      {
+        CFileParserINI parser{MAIN_SRC_DIR / "data/condor2nav.ini"};
+        const auto parsed = CMemoryAccount::Usage(TMemorySubsystem::PARSERS).current;
+        parser.Value("Condor2Nav", "UnitTestKey", std::string(1000, 'x'));
+        const auto added = CMemoryAccount::Usage(TMemorySubsystem::PARSERS).current;
+        Assert::IsTrue(added >= parsed + 1000);
+        parser.Value("Condor2Nav", "UnitTestKey", "x");
+        Assert::IsTrue(CMemoryAccount::Usage(TMemorySubsystem::PARSERS).current + 1000 <= added);
+      }
+      Assert::IsTrue(CMemoryAccount::Usage(TMemorySubsystem::PARSERS).current == before);
+    }
+  };
+
+
+
+  ////////////////////////   T H R E A D   P O O L   ////////////////////////
+
+  TEST_CLASS(TestThreadPool) {
+  public:
+    TEST_METHOD(Futures)
+    {
+      CThreadPool pool{4};
+      std::vector<std::future<int>> results;
+      for(int i = 0; i < 100; ++i)
+        results.emplace_back(pool.Send([i]{ return i * 2; }));
+      int sum = 0;
+      for(auto &r : results)
+        sum += r.get();
+      Assert::AreEqual(9900, sum);
+    }
+
+    TEST_METHOD(Exceptions)
+    {
+      CThreadPool pool{2};
+      auto result = pool.Send([]() -> int { throw EOperationFailed{"ERROR"}; });
+      Assert::ExpectException<EOperationFailed>([&]{ result.get(); });
+    }
+
+    TEST_METHOD(Cancellation)
+    {
+      CThreadPool pool{2};
+      CCancellationSource source;
+      source.Cancel();
+      bool started = false;
+      auto result = pool.Send([&](const CCancellationToken &){ started = true; }, source.Token());
+      Assert::ExpectException<EOperationCancelled>([&]{ result.get(); });
+      Assert::IsFalse(started);
+      Assert::IsFalse(CCancellationToken{}.Cancelled());
+    }
+  };
+
+
+
+  ////////////////////////   N A V I C O N   P O O L   ////////////////////////
+
+  TEST_CLASS(TestNaviConPool) {
+    static bfs::path Shell() { return std::getenv("ComSpec"); }
+
+  public:
+    TEST_METHOD(MissingWorker)
+    {
+      CNaviConPool pool{"nonexisting_worker.exe", 2};
+      float maxX, maxY;
+      Assert::ExpectException<EOperationFailed>([&]{ pool.Max("C:\\Condor", "AA3", maxX, maxY); });
+      Assert::ExpectException<EOperationFailed>([&]{ pool.Convert("C:\\Condor", "AA3", std::vector<float>{0, 0}); });
+    }
+
+    TEST_METHOD(DyingWorkers)
+    {
+      // the shell started as '"cmd.exe" "/c" "exit"' exits without writing the ready message;
+      // workers started concurrently must not keep each other pipes open
+      CNaviConPool pool{Shell(), 2};
+      std::vector<std::future<void>> workers;
+      for(int i = 0; i < 8; ++i)
+        workers.emplace_back(std::async(std::launch::async, [&]
+        {
+          float maxX, maxY;
+          pool.Max("/c", "exit", maxX, maxY);
+        }));
+      for(auto &w : workers) {
+        Assert::IsTrue(w.wait_for(std::chrono::seconds{10}) == std::future_status::ready);
+        Assert::ExpectException<EOperationFailed>([&]{ w.get(); });
+      }
+    }
+  };
+
+
+  TEST_CLASS(TestNamedPipe) {
+    static std::string PipeName(const std::string &test)
+    {
+      return "\\\\.\\pipe\\condor2nav_unittests_" + test + "_" + Convert(GetCurrentProcessId());
+    }
+
+  public:
+    TEST_METHOD(NoServer)
+    {
+      Assert::IsTrue(CNamedPipe::Connect(PipeName("NoServer"), 1000) == nullptr);
+    }
+
+    TEST_METHOD(Forwarding)
+    {
+      // the same exchange as between condor2nav-cli and a translation server
+      const auto name = PipeName("Forwarding");
+      CNamedPipe server{name};
+      auto serving = std::async(std::launch::async, [&]
+      {
+        server.Accept(CCancellationToken{});
+        std::string request;
+        if(!server.ReadLine(request, CCancellationToken{}, 5000))
+          request = "disconnected";
+        server.Write("O5\nHelloE3\nBadX1\n");
+        server.Disconnect();
+        return request;
+      });
+
+      auto client = CNamedPipe::Connect(name, 5000);
+      Assert::IsTrue(client != nullptr);
+      Assert::IsTrue(client->Write("-fpl\tC:\\task.fpl\n"));
+      std::string header, text;
+      Assert::IsTrue(client->ReadLine(header));
+      Assert::AreEqual(std::string{"O5"}, header);
+      Assert::IsTrue(client->Read(5, text));
+      Assert::AreEqual(std::string{"Hello"}, text);
+      Assert::IsTrue(client->ReadLine(header));
+      Assert::AreEqual(std::string{"E3"}, header);
+      Assert::IsTrue(client->Read(3, text));
+      Assert::AreEqual(std::string{"Bad"}, text);
+      Assert::IsTrue(client->ReadLine(header));
+      Assert::AreEqual(std::string{"X1"}, header);
+      Assert::IsFalse(client->ReadLine(header));
+      Assert::AreEqual(std::string{"-fpl\tC:\\task.fpl"}, serving.get());
+    }
+
+    TEST_METHOD(SilentClient)
+    {
+      const auto name = PipeName("SilentClient");
+      CNamedPipe server{name};
+      auto client = CNamedPipe::Connect(name, 5000);
+      Assert::IsTrue(client != nullptr);
+      server.Accept(CCancellationToken{});
+      std::string request;
+      Assert::ExpectException<EOperationFailed>([&]{ server.ReadLine(request, CCancellationToken{}, 500); });
+
+      // the server still serves the next client after the timeout
+      server.Disconnect();
+      auto serving = std::async(std::launch::async, [&]
+      {
+        server.Accept(CCancellationToken{});
+        std::string next;
+        server.ReadLine(next, CCancellationToken{}, 5000);
+        return next;
+      });
+      client = CNamedPipe::Connect(name, 5000);
+      Assert::IsTrue(client != nullptr);
+      Assert::IsTrue(client->Write("next\n"));
+      Assert::AreEqual(std::string{"next"}, serving.get());
+    }
+
+    TEST_METHOD(ReadCancel)
+    {
+      const auto name = PipeName("ReadCancel");
+      CNamedPipe server{name};
+      auto client = CNamedPipe::Connect(name, 5000);
+      Assert::IsTrue(client != nullptr);
+      server.Accept(CCancellationToken{});
+
+      CCancellationSource cancel;
+      auto stopping = std::async(std::launch::async, [&]
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        cancel.Cancel();
+      });
+      std::string request;
+      Assert::ExpectException<EOperationCancelled>([&]{ server.ReadLine(request, cancel.Token()); });
+      stopping.get();
+    }
+  };
+
+
+
+  ////////////////////////   W A I T   Q U E U E   ////////////////////////
+
+  TEST_CLASS(TestWaitQueue) {
+    static const unsigned PRODUCERS = 4;
+    static const unsigned COUNT = 100000;
+
+    template<class Push, class Pop>
+    static unsigned Benchmark(const char *name, Push push, Pop pop)
+    {
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<std::thread> producers;
+      for(unsigned i = 0; i < PRODUCERS; ++i)
+        producers.emplace_back([&]{ for(unsigned j = 0; j < COUNT; ++j) push(j); });
+      unsigned long long sum = 0;
+      for(unsigned received = 0; received < PRODUCERS * COUNT; )
+        received += pop(sum);
+      for(auto &p : producers)
+        p.join();
+      auto end = std::chrono::high_resolution_clock::now();
+      Assert::IsTrue(sum == PRODUCERS * (COUNT - 1ull) * COUNT / 2);
+
+      const auto ms = static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+      std::string msg{std::string{name} + ": " + Convert(PRODUCERS * COUNT) + " items in " + Convert(ms) + "ms\n"};
+      Logger::WriteMessage(msg.c_str());
+      return ms;
+    }
+
+  public:
+    TEST_METHOD(PopAll)
+    {
+      CWaitQueue<int> queue;
+      queue.Push(1);
+      queue.Push(2);
+      auto items = queue.PopAllWait();
+      Assert::AreEqual(size_t{2}, items.size());
+      Assert::AreEqual(1, items.front());
+    }
+
+    TEST_METHOD(BoundedTryPush)
+    {
+      CBoundedWaitQueue<int> queue{2};
+      Assert::IsTrue(queue.TryPush(1));
+      Assert::IsTrue(queue.TryPush(2));
+      Assert::IsFalse(queue.TryPush(3));
+      Assert::AreEqual(1, queue.PopWait());
+      Assert::IsTrue(queue.TryPush(3));
+    }
+
+    TEST_METHOD(RingFull)
+    {
+      CMPSCRingQueue<int> queue{3};
+      Assert::AreEqual(size_t{4}, queue.Capacity());
+      for(int i = 0; i < 4; ++i)
+        Assert::IsTrue(queue.TryPush(i));
+      Assert::IsFalse(queue.TryPush(4));
+      int value;
+      for(int i = 0; i < 4; ++i) {
+        Assert::IsTrue(queue.TryPop(value));
+        Assert::AreEqual(i, value);
+      }
+      Assert::IsFalse(queue.TryPop(value));
+    }
+
+    TEST_METHOD(BenchmarkPopWait)
+    {
+      CWaitQueue<unsigned> queue;
+      Benchmark("CWaitQueue::PopWait", [&](unsigned v){ queue.Push(v); },
+                [&](unsigned long long &sum){ sum += queue.PopWait(); return 1u; });
+    }
+
+    TEST_METHOD(BenchmarkPopAllWait)
+    {
+      CWaitQueue<unsigned> queue;
+      Benchmark("CWaitQueue::PopAllWait", [&](unsigned v){ queue.Push(v); }, [&](unsigned long long &sum)
+      {
+        auto items = queue.PopAllWait();
+        const auto num = static_cast<unsigned>(items.size());
+        for(; !items.empty(); items.pop())
+          sum += items.front();
+        return num;
+      });
+    }
+
+    TEST_METHOD(BenchmarkBounded)
+    {
+      CBoundedWaitQueue<unsigned> queue{1024};
+      Benchmark("CBoundedWaitQueue::PopAllWait", [&](unsigned v){ queue.Push(v); }, [&](unsigned long long &sum)
+      {
+        auto items = queue.PopAllWait();
+        const auto num = static_cast<unsigned>(items.size());
+        for(; !items.empty(); items.pop())
+          sum += items.front();
+        return num;
+      });
+    }
+
+    TEST_METHOD(BenchmarkRing)
+    {
+      CMPSCRingQueue<unsigned> queue{1024};
+      Benchmark("CMPSCRingQueue", [&](unsigned v){ while(!queue.TryPush(v)) std::this_thread::yield(); }, [&](unsigned long long &sum)
+      {
+        unsigned v;
+        if(!queue.TryPop(v))
+          return 0u;
+        sum += v;
+        return 1u;
+      });
+    }
+  };
+
+
+
+  ////////////////////////   B I N A R Y   L A Y O U T   ////////////////////////
+
+  struct TLayoutRecord {
+    char c;
+    int i;
+    short s;
+  };
+
+  TEST_CLASS(TestBinaryLayout) {
+  public:
+    TEST_METHOD(PackedRecord)
+    {
+      using CLayout = layout::TRecord<TLayoutRecord,
+        layout::TField<TLayoutRecord, char, &TLayoutRecord::c>,
+        layout::TField<TLayoutRecord, int, &TLayoutRecord::i>,
+        layout::TField<TLayoutRecord, short, &TLayoutRecord::s>>;
+      static_assert(CLayout::size == sizeof(char) + sizeof(int) + sizeof(short), "Record should not be padded");
+
+      const TLayoutRecord record{'a', 0x01020304, 0x0506};
+      char buffer[CLayout::size];
+      auto out = buffer;
+      CLayout::Write(out, record);
+      Assert::AreEqual<size_t>(CLayout::size, out - buffer);
+      Assert::AreEqual('a', buffer[0]);
+      Assert::AreEqual(0, memcmp(&record.i, buffer + sizeof(char), sizeof(int)));
+      Assert::AreEqual(0, memcmp(&record.s, buffer + sizeof(char) + sizeof(int), sizeof(short)));
+    }
+
+    TEST_METHOD(FileSections)
+    {
+      using CLayout = layout::TFile<layout::TString<4>, layout::TRecords<int, 3>, layout::TArray<short, 2>>;
+      static_assert(CLayout::size == 4 + 3 * sizeof(int) + 2 * sizeof(short), "Invalid file size");
+
+      const short array[] = { 7, 8 };
+      const auto buffer = CLayout::Serialize(std::string{"LK"}, std::vector<int>{5}, array);
+      Assert::AreEqual<size_t>(CLayout::size, buffer.size());
+      Assert::AreEqual(std::string("LK\0\0", 4), std::string(buffer.data(), 4));
+      const int records[] = { 5, 0, 0 };
+      Assert::AreEqual(0, memcmp(records, buffer.data() + 4, sizeof(records)));
+      Assert::AreEqual(0, memcmp(array, buffer.data() + 4 + sizeof(records), sizeof(array)));
+    }
+  };
+
+
+
+  ////////////////////////   G Z I P   D E C O D E R   ////////////////////////
+
+  TEST_CLASS(TestGzipDecoder) {
+  public:
+    TEST_METHOD(Portions)
+    {
+      // 'Condor2Nav gzip test\n' repeated 20 times
+      const unsigned char data[] = {
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x73, 0xce, 0xcf, 0x4b, 0xc9, 0x2f,
+        0x32, 0xf2, 0x4b, 0x2c, 0x53, 0x48, 0xaf, 0xca, 0x2c, 0x50, 0x28, 0x49, 0x2d, 0x2e, 0xe1, 0x72,
+        0x1e, 0x15, 0x1c, 0x4c, 0x82, 0x00, 0xd3, 0x27, 0x5f, 0x9a, 0xa4, 0x01, 0x00, 0x00
+      };
+      std::string expected;
+      for(unsigned i=0; i<20; i++)
+        expected += "Condor2Nav gzip test\n";
+
+      for(std::size_t portion : { std::size_t{1}, std::size_t{7}, sizeof(data) }) {
+        std::string result;
+        CGzipDecoder decoder{[&](const char *d, std::size_t size){ result.append(d, size); }};
+        for(std::size_t i=0; i<sizeof(data); i+=portion)
+          decoder.Write(reinterpret_cast<const char *>(data) + i, std::min(portion, sizeof(data) - i));
+        decoder.Finish();
+        Assert::AreEqual(expected, result);
+        Assert::AreEqual(static_cast<std::uint64_t>(expected.size()), decoder.Size());
+      }
+    }
+
+    TEST_METHOD(InvalidData)
+    {
+      CGzipDecoder decoder{[](const char *, std::size_t){}};
+      Assert::ExpectException<EOperationFailed>([&]{ decoder.Write("Not a gzip data", 15); decoder.Finish(); });
+    }
+  };
+
 
 
   ////////////////////////   I S T R E A M   ////////////////////////
@@ -204,6 +806,58 @@ namespace unitTests
       Assert::AreEqual(std::string(""), txt);
       Assert::IsFalse(static_cast<bool>(stream));
     }
+
+    TEST_METHOD(GetLineRange)
+    {
+      CIStream stream(MAIN_SRC_DIR / "README.txt");
+      bfs::ifstream expected(MAIN_SRC_DIR / "README.txt");
+      boost::string_ref line;
+      std::string expectedLine;
+      while(std::getline(expected, expectedLine)) {
+        Assert::IsTrue(stream.GetLine(line));
+        Assert::AreEqual(expectedLine, line.to_string());
+      }
+      Assert::IsFalse(stream.GetLine(line));
+      Assert::IsTrue(line.empty());
+      Assert::IsFalse(static_cast<bool>(stream));
+    }
+  };
+
+
+
+  ////////////////////////   A S Y N C   I O   ////////////////////////
+
+  TEST_CLASS(TestAsyncIO) {
+  public:
+    TEST_METHOD(LocalRoundTrip)
+    {
+      auto &io = CAsyncIO::Instance();
+      const auto dir = bfs::temp_directory_path() / "condor2nav_asyncIO" / "nested";
+      bfs::remove_all(dir.parent_path());
+      io.DirectoryCreate(dir).get();
+      Assert::IsTrue(io.Exists(dir).get());
+
+      // bigger than one read block
+      const std::string data(200 * 1024, 'x');
+      const auto file = dir / "data.bin";
+      Assert::IsFalse(io.Exists(file).get());
+      io.Write(file, data).get();
+      Assert::IsTrue(io.Exists(file).get());
+
+      std::string actual;
+      io.Read(file, [&](const char *buffer, std::size_t size){ actual.append(buffer, size); }).get();
+      Assert::IsTrue(data == actual);
+      bfs::remove_all(dir.parent_path());
+    }
+
+    TEST_METHOD(LocalErrors)
+    {
+      auto &io = CAsyncIO::Instance();
+      auto read = io.Read("nonexisting.some_file", [](const char *, std::size_t){});
+      Assert::ExpectException<EOperationFailed>([&]{ read.get(); });
+      auto write = io.Write(bfs::path{"nonexisting_dir"} / "some_file", "data");
+      Assert::ExpectException<EOperationFailed>([&]{ write.get(); });
+    }
   };
 
 
@@ -212,6 +866,15 @@ namespace unitTests
 
   TEST_CLASS(TestFileParserINI) {
   public:
+    TEST_METHOD(CopiedINIFile)
+    {
+      std::unique_ptr<CFileParserINI> source{new CFileParserINI(MAIN_SRC_DIR / "data/condor2nav.ini")};
+      CFileParserINI parser("copy.ini", *source);
+      source.reset();
+      Assert::AreEqual(std::string("LK8000"), parser.Value("Condor2Nav", "Target"));
+      Assert::AreEqual(std::string("1"), parser.Value("LK8000", "DefaultTaskOverwrite"));
+    }
+
     TEST_METHOD(InvalidINIFile)
     {
       Assert::ExpectException<EOperationFailed>([]{ CFileParserINI parser("nonexisting.some_file"); });
@@ -263,6 +926,88 @@ namespace unitTests
       Assert::ExpectException<EOperationFailed>([&]{ parser.Value("", "", "Fail"); });
       Assert::ExpectException<EOperationFailed>([&]{ parser.Value("", {}, "Fail"); });
     }
+
+    TEST_METHOD(ValidINIDump)
+    {
+      CFileParserINI parser(MAIN_SRC_DIR / "data/condor2nav.ini");
+      parser.Value("Condor2Nav", "AAA", "First");
+      parser.Dump("condor2nav_dump1.ini");
+      CFileParserINI dumped("condor2nav_dump1.ini");
+      Assert::AreEqual(std::string("First"), dumped.Value("Condor2Nav", "AAA"));
+      Assert::AreEqual(std::string("LK8000"), dumped.Value("Condor2Nav", "Target"));
+      dumped.Dump("condor2nav_dump2.ini");
+
+      bfs::ifstream dump1("condor2nav_dump1.ini");
+      std::stringstream dump1Str;
+      dump1Str << dump1.rdbuf();
+      bfs::ifstream dump2("condor2nav_dump2.ini");
+      std::stringstream dump2Str;
+      dump2Str << dump2.rdbuf();
+      Assert::AreEqual(dump1Str.str(), dump2Str.str());
+    }
+
+    TEST_METHOD(FanOutINIDump)
+    {
+      CFileParserINI parser(MAIN_SRC_DIR / "data/condor2nav.ini");
+      parser.Dump(std::vector<bfs::path>{"condor2nav_fanout1.ini", "condor2nav_fanout2.ini", "condor2nav_fanout3.ini"});
+      for(const auto &path : { "condor2nav_fanout1.ini", "condor2nav_fanout2.ini", "condor2nav_fanout3.ini" }) {
+        CFileParserINI dumped(path);
+        Assert::AreEqual(std::string("LK8000"), dumped.Value("Condor2Nav", "Target"));
+      }
+
+      // all the destinations are written even if some of them fail
+      bfs::remove("condor2nav_fanout1.ini");
+      Assert::ExpectException<EOperationFailed>([&]{ parser.Dump(std::vector<bfs::path>{"nonexisting_dir/condor2nav.ini", "condor2nav_fanout1.ini"}); });
+      Assert::IsTrue(bfs::exists("condor2nav_fanout1.ini"));
+    }
+
+    TEST_METHOD(UnchangedINIDump)
+    {
+      CFileParserINI parser(MAIN_SRC_DIR / "data/condor2nav.ini");
+      parser.Dump("condor2nav_unchanged.ini");
+      const auto writeTime = bfs::last_write_time("condor2nav_unchanged.ini");
+
+      // the same content is not written again
+      auto modify = []{
+        bfs::ofstream file("condor2nav_unchanged.ini");
+        file << "[Condor2Nav]" << std::endl << "Target=Modified" << std::endl;
+      };
+      modify();
+      bfs::last_write_time("condor2nav_unchanged.ini", writeTime);
+      parser.Value("Condor2Nav", "Target", "LK8000");
+      parser.Dump("condor2nav_unchanged.ini");
+      Assert::AreEqual(std::string("Modified"), CFileParserINI("condor2nav_unchanged.ini").Value("Condor2Nav", "Target"));
+
+      // modified content or file is written
+      parser.Value("Condor2Nav", "Target", "XCSoar");
+      parser.Dump("condor2nav_unchanged.ini");
+      Assert::AreEqual(std::string("XCSoar"), CFileParserINI("condor2nav_unchanged.ini").Value("Condor2Nav", "Target"));
+      modify();
+      bfs::last_write_time("condor2nav_unchanged.ini", writeTime - 10);
+      parser.Dump("condor2nav_unchanged.ini");
+      Assert::AreEqual(std::string("XCSoar"), CFileParserINI("condor2nav_unchanged.ini").Value("Condor2Nav", "Target"));
+    }
+
+    TEST_METHOD(INICache)
+    {
+      CFileParserINICache cache;
+      Assert::IsFalse(static_cast<bool>(cache.Parser({"nonexisting.some_file"})));
+
+      auto parser = cache.Parser({"nonexisting.some_file", MAIN_SRC_DIR / "data/condor2nav.ini"});
+      Assert::AreEqual((MAIN_SRC_DIR / "data/condor2nav.ini").string(), parser->Path().string());
+      parser->Value("Condor2Nav", "Target", "UnitTest");
+
+      // cached parsers are not modified by the callers
+      auto cached = cache.Parser({MAIN_SRC_DIR / "data/condor2nav.ini"});
+      Assert::AreEqual(std::string("LK8000"), cached->Value("Condor2Nav", "Target"));
+
+      const std::vector<bfs::path> pathList{"condor2nav_cache.ini"};
+      parser->Dump(pathList);
+      cache.Store(*parser, pathList);
+      auto stored = cache.Parser({"condor2nav_cache.ini", MAIN_SRC_DIR / "data/condor2nav.ini"});
+      Assert::AreEqual(std::string("UnitTest"), stored->Value("Condor2Nav", "Target"));
+      Assert::AreEqual(std::string("1"), stored->Value("LK8000", "DefaultTaskOverwrite"));
+    }
   };
 
 
@@ -287,9 +1032,9 @@ namespace unitTests
       Assert::AreEqual((MAIN_SRC_DIR / "data/GliderData.csv").string(), parser.Path().string());
       Assert::AreEqual(24U, parser.Rows().size());
       Assert::AreEqual(14U, parser.Rows()[0].size());
-      Assert::AreEqual(std::string("285"), parser.Row("ASW28")[1]);
-      Assert::AreEqual(std::string("285"), parser.Row("asw28", 0, true)[1]);
-      Assert::AreEqual(std::string("ASW22"), parser.Row("280", 1)[0]);
+      Assert::AreEqual(std::string("285"), parser.Row("ASW28")[1].to_string());
+      Assert::AreEqual(std::string("285"), parser.Row("asw28", 0, true)[1].to_string());
+      Assert::AreEqual(std::string("ASW22"), parser.Row("280", 1)[0].to_string());
     }
 
     TEST_METHOD(InvalidCSVFileEntry)
@@ -298,6 +1043,170 @@ namespace unitTests
       Assert::ExpectException<EOperationFailed>([&]{ parser.Row("asw28")[1]; });
       Assert::ExpectException<EOperationFailed>([&]{ parser.Row("123", 1)[0]; });
     }
+
+    TEST_METHOD(ModifiedCSVFileEntry)
+    {
+      CFileParserCSV parser(MAIN_SRC_DIR / "data/GliderData.csv");
+      {
+        const std::string name{"UnitTest"};
+        parser.Value(parser.Row("ASW22"), 0, name);
+      }
+      Assert::ExpectException<EOperationFailed>([&]{ parser.Row("ASW22"); });
+      Assert::AreEqual(std::string("280"), parser.Row("unittest", 0, true)[1].to_string());
+      Assert::AreEqual(std::string("UnitTest"), parser.Row("280", 1)[0].to_string());
+      Assert::ExpectException<EOperationFailed>([&]{ parser.Value(parser.Row("280", 1), 100, "Fail"); });
+      parser.RowAdd({ "NewGlider", "123" });
+      Assert::AreEqual(std::string("123"), parser.Row("NewGlider")[1].to_string());
+      Assert::AreEqual(std::string("NewGlider"), parser.Row("123", 1)[0].to_string());
+    }
+
+    TEST_METHOD(ModifiedCSVFileTemporaries)
+    {
+      CFileParserCSV parser(MAIN_SRC_DIR / "data/GliderData.csv");
+      // the values are temporaries destroyed before the rows are read
+      parser.RowAdd({ std::string{"Temporary"} + "Glider", Convert(456u) });
+      parser.Value(parser.Row("ASW28"), 1, std::string{"2"} + "99");
+      Assert::AreEqual(std::string("456"), parser.Row("TemporaryGlider")[1].to_string());
+      Assert::AreEqual(std::string("TemporaryGlider"), parser.Row("456", 1)[0].to_string());
+      Assert::AreEqual(std::string("299"), parser.Row("ASW28")[1].to_string());
+    }
+
+    TEST_METHOD(CompiledCSVUpToDate)
+    {
+      // run 'condor2nav-data' from the repository root if that fails
+      for(unsigned i=0; i<COMPILED_CSV_NUM; i++) {
+        const auto &table = COMPILED_CSV[i];
+        CIStream stream{MAIN_SRC_DIR / table.path};
+        std::uint64_t size;
+        Assert::AreEqual(std::string(table.fingerprint), CompiledCSVFingerprint(stream.Data(), size));
+        Assert::AreEqual(table.size, size);
+
+        const CFileParserCSV parsed{MAIN_SRC_DIR / table.path};
+        const CFileParserCSV compiled{MAIN_SRC_DIR / table.path, table};
+        Assert::IsTrue(parsed.Rows() == compiled.Rows());
+        for(const auto &row : parsed.Rows()) {
+          Assert::IsTrue(&compiled.Row(row[0].to_string()) == &compiled.Row(row[0].to_string(), 0, true));
+          Assert::IsTrue(compiled.Row(row[0].to_string()) == parsed.Row(row[0].to_string()));
+        }
+      }
+    }
+
+    TEST_METHOD(CompiledCSVLookup)
+    {
+      const auto table = std::find_if(COMPILED_CSV, COMPILED_CSV + COMPILED_CSV_NUM, [](const TCompiledCSV &t){ return t.path == std::string("data/GliderData.csv"); });
+      Assert::IsTrue(table != COMPILED_CSV + COMPILED_CSV_NUM);
+      CFileParserCSV parser{MAIN_SRC_DIR / "data/GliderData.csv", *table};
+      Assert::AreEqual(std::string("285"), parser.Row("asw28", 0, true)[1].to_string());
+      Assert::ExpectException<EOperationFailed>([&]{ parser.Row("asw28"); });
+      Assert::ExpectException<EOperationFailed>([&]{ parser.Row("NoSuchGlider"); });
+      Assert::AreEqual(std::string("ASW22"), parser.Row("280", 1)[0].to_string());
+
+      // files other than the distributed ones are always parsed
+      Assert::IsTrue(CompiledCSV(MAIN_SRC_DIR / "data/GliderData.csv") == nullptr);
+      Assert::IsTrue(CompiledCSV("data/condor2nav.ini") == nullptr);
+    }
+  };
+
+
+
+  ////////////////////////   T R A N S L A T O R   ////////////////////////
+
+  TEST_CLASS(TestTranslator) {
+  public:
+    TEST_METHOD(BuiltinTargets)
+    {
+      Assert::IsTrue(CTranslator::TargetInfo("XCSoar5").stages == CTranslator::STAGE_ALL);
+      Assert::IsTrue(CTranslator::TargetInfo("XCSoar6").stages == CTranslator::STAGE_ALL);
+      const auto lk8000 = CTranslator::TargetInfo("LK8000");
+      Assert::IsTrue((lk8000.stages & CTranslator::STAGE_TASK) != 0);
+      Assert::IsTrue((lk8000.stages & CTranslator::STAGE_WEATHER) == 0);
+      Assert::IsTrue(lk8000.factory != nullptr);
+
+      Assert::ExpectException<EOperationFailed>([]{ CTranslator::TargetInfo("XCSoar4"); });
+      Assert::ExpectException<EOperationFailed>([]{ CTranslator::TargetInfo("SeeYou"); });
+    }
+
+    TEST_METHOD(TargetRegister)
+    {
+      CTranslator::TTargetInfo info = { "UnitTestTarget", CTranslator::STAGE_TASK, "1", &CTranslator::TargetCreate<CTargetXCSoar6> };
+      CTranslator::TargetRegister(info);
+      Assert::IsTrue(CTranslator::TargetInfo("UnitTestTarget").stages == CTranslator::STAGE_TASK);
+
+      // registration with the same name replaces the previous one
+      info.stages = CTranslator::STAGE_TASK | CTranslator::STAGE_GLIDER;
+      CTranslator::TargetRegister(info);
+      Assert::IsTrue(CTranslator::TargetInfo("UnitTestTarget").stages == (CTranslator::STAGE_TASK | CTranslator::STAGE_GLIDER));
+      Assert::IsTrue(CTranslator::TargetInfo("XCSoar6").factory != nullptr);
+    }
+
+    TEST_METHOD(PolarDump)
+    {
+      const CFileParserCSV gliders{MAIN_SRC_DIR / "data/GliderData.csv"};
+      const CFileParserCSV polars{MAIN_SRC_DIR / "data/GliderPolars.csv"};
+      const auto &glider = gliders.Row("ASG29");
+      const auto polar = CTranslator::CTarget::GliderPolar(polars, glider);
+      Assert::IsTrue(polar != nullptr);
+
+      // polar points are the glider data ones and not the rounded fitted ones
+      const CWorkDir dir{"condor2nav-polar"};
+      for(auto gliderPolar : {polar, static_cast<const CFileParserCSV::CStringArray *>(nullptr)}) {
+        const auto path = dir / "Condor.plr";
+        COStream polarFile{path};
+        CTargetXCSoarCommon::PolarDump(polarFile, glider, gliderPolar);
+        polarFile.Commit();
+
+        CIStream stream{path};
+        std::string line;
+        for(std::string next; stream.GetLine(next); )
+          line = next;
+        Assert::AreEqual(std::string{"368,200,76,-0.483,136,-0.87,170,-1.5"}, line);
+      }
+    }
+
+    TEST_METHOD(WaypointsSubset)
+    {
+      using TPosition = CCondor::CCoordConverter::TPosition;
+      const CCondor::CCoordConverter::CPositionArray positions = {
+        TPosition{TLongitude{10}, TLatitude{45}},
+        TPosition{TLongitude{11}, TLatitude{45}}
+      };
+      const CTaskCorridor corridor{positions, 5};
+
+      const CWorkDir dir{"condor2nav-waypoints"};
+      FileWrite(dir / "Scenery.cup",
+                "name,code,country,lat,lon,elev,style,rwdir,rwlen,freq,desc\r\n"
+                "* not a waypoint\r\n"
+                "\"Start\",ST,,4500.000N,01000.000E,100.0m,1,,,,\r\n"
+                "\"Outside\",OUT,,4600.000N,01030.000E,200.0m,1,,,,\r\n"
+                "not a waypoint either\r\n"
+                "\"Inside, with comma\",IN,,4501.000N,01030.000E,300.0m,1,,,,\r\n"
+                "-----Related Tasks-----\r\n"
+                "\"Task\",\"Start\",\"Inside, with comma\"\r\n");
+
+      CTargetLK8000::TWaypointsSubset result;
+      {
+        CIStream input{dir / "Scenery.cup"};
+        CRecordWriter output{dir / "Subset.cup"};
+        result = CTargetLK8000::WaypointsFilter(input, corridor, output);
+        output.Commit();
+      }
+      Assert::AreEqual(3u, result.total);
+      Assert::AreEqual(2u, result.subset);
+
+      // only the header line and the waypoints inside the corridor are kept
+      const std::vector<std::string> expected = {
+        "name,code,country,lat,lon,elev,style,rwdir,rwlen,freq,desc",
+        "\"Start\",ST,,4500.000N,01000.000E,100.0m,1,,,,",
+        "\"Inside, with comma\",IN,,4501.000N,01030.000E,300.0m,1,,,,"
+      };
+      std::vector<std::string> actual;
+      CIStream subset{dir / "Subset.cup"};
+      for(std::string line; subset.GetLine(line); )
+        actual.push_back(line);
+      Assert::AreEqual(expected.size(), actual.size());
+      for(size_t i=0; i<expected.size(); i++)
+        Assert::AreEqual(expected[i], actual[i]);
+    }
   };
 
 
@@ -328,4 +1237,319 @@ namespace unitTests
 
   };
 
+
+  ////////////////////////   T A S K   G E O M E T R Y   ////////////////////////
+
+  TEST_CLASS(TestTaskGeometry) {
+  public:
+    TEST_METHOD(Bisectors)
+    {
+      using TPosition = CCondor::CCoordConverter::TPosition;
+      const CCondor::CCoordConverter::CPositionArray positions = {
+        TPosition{TLongitude{0}, TLatitude{0}},
+        TPosition{TLongitude{0}, TLatitude{1}},
+        TPosition{TLongitude{1}, TLatitude{1}}
+      };
+      const CTaskGeometry geometry{positions};
+      Assert::AreEqual(std::size_t{2}, geometry.Legs());
+      Assert::AreEqual(180u, geometry.Bisector(0));
+      Assert::AreEqual(315u, geometry.Bisector(1));
+      Assert::AreEqual(90u, geometry.Bisector(2));
+    }
+  };
+
+
+  ////////////////////////   L K   M A P S   D B   ////////////////////////
+
+  TEST_CLASS(TestLKMapsDB) {
+  public:
+    TEST_METHOD(LandscapesMatch)
+    {
+      const CWorkDir dir{"condor2nav-lkmaps"};
+      const CCurrentDir current{dir.Path()};
+      std::mt19937 rand{2012};
+      const unsigned landscapes = 300;
+      auto templates = LandscapesGenerate(landscapes, 400, rand);
+      const CTestApp app;
+      CLKMapsDB db{app};
+      db.LandscapesMatch(templates);
+
+      // brute-force search of all the templates in the catalogue order
+      struct TMap {
+        std::string name;
+        double lonMin, lonMax, latMin, latMax;
+        unsigned scale;
+      };
+      auto value = [](const CFileParserINI &parser, const char *key){ return Convert<double>(parser.Value("", key)); };
+      std::sort(templates.begin(), templates.end());
+      std::vector<TMap> maps;
+      for(const auto &name : templates) {
+        const CFileParserINI map{"data/LK8000/LKMTemplates/" + name.str()};
+        const unsigned scale = map.Value("", "RES250") == "YES" ? 250 : map.Value("", "RES500") == "YES" ? 500 : 1000;
+        maps.push_back(TMap{map.Value("", "NAME"), value(map, "LONMIN"), value(map, "LONMAX"), value(map, "LATMIN"), value(map, "LATMAX"), scale});
+      }
+
+      const CFileParserCSV sceneries{"data/LK8000/SceneryData.csv"};
+      unsigned matched = 0;
+      for(unsigned i=0; i<landscapes; i++) {
+        const auto name = "Landscape" + Convert(i);
+        const CFileParserINI landscape{"data/Landscapes/" + name + "_1.0.TXT"};
+        const TMap *best = nullptr;
+        for(const auto &map : maps)
+          if((!best || map.scale < best->scale) &&
+             InsideArea(TLongitude{map.lonMin}, TLongitude{map.lonMax}, TLatitude{map.latMin}, TLatitude{map.latMax},
+                        TLongitude{value(landscape, "LONMIN")}, TLongitude{value(landscape, "LONMAX")},
+                        TLatitude{value(landscape, "LATMIN")}, TLatitude{value(landscape, "LATMAX")}))
+            best = &map;
+        const auto &row = sceneries.Row(name, 0, true);
+        Assert::AreEqual(best ? best->name + ".LKM" : std::string{}, row[CTranslator::CTarget::SCENERY_MAP_FILE].to_string());
+        if(best) {
+          Assert::AreEqual(best->name + "_" + Convert(best->scale) + ".DEM", row[CTranslator::CTarget::SCENERY_TERRAIN_FILE].to_string());
+          ++matched;
+        }
+      }
+      Assert::IsTrue(matched > landscapes / 2);
+    }
+  };
+
+
+  ////////////////////////   P O L A R   O P T I M I S E R   ////////////////////////
+
+  TEST_CLASS(TestPolarFit) {
+    /**
+     * @brief Generates measured polar curve points.
+     *
+     * Points are spread around XCSoar polar curve equation with a random error.
+     */
+    static void PolarGenerate(std::mt19937 &rand, unsigned points, std::vector<double> &speeds, std::vector<double> &sinks)
+    {
+      std::uniform_real_distribution<double> speed{60, 250};
+      std::uniform_real_distribution<double> noise{-0.05, 0.05};
+      speeds.clear();
+      sinks.clear();
+      for(unsigned i=0; i<points; i++) {
+        const double v = speed(rand) / 3.6;
+        speeds.push_back(v * 3.6);
+        sinks.push_back(-0.0017 * v * v + 0.045 * v - 0.9 + noise(rand));
+      }
+    }
+
+    /**
+     * @brief The best 3 points search with XCSoar polar calculations for every point.
+     */
+    static polarOptimiser::CPolarFit::TResult BestExhaustive(const std::vector<double> &speeds, const std::vector<double> &sinks)
+    {
+      polarOptimiser::CPolarFit::TResult best = { { 0, 1, 2 }, 0xFFFF };
+      const auto size = static_cast<unsigned>(speeds.size());
+      for(unsigned i=0; i<size; i++)
+        for(unsigned j=i+1; j<size; j++)
+          for(unsigned k=j+1; k<size; k++) {
+            const double speed[3] = { speeds[i], speeds[j], speeds[k] };
+            const double sink[3] = { sinks[i], sinks[j], sinks[k] };
+            const polarOptimiser::CPolarXCSoar polar{speed, sink};
+            double error = 0;
+            for(unsigned l=0; l<size; l++)
+              error += std::abs(polar.Sink(speeds[l], 400, 0) - sinks[l]);
+            if(error < best.error) {
+              best.error = error;
+              best.idx[0] = i;
+              best.idx[1] = j;
+              best.idx[2] = k;
+            }
+          }
+      return best;
+    }
+
+    static void ThreadMark(void *context, unsigned thread, unsigned threads)
+    {
+      auto &runs = *static_cast<std::vector<unsigned> *>(context);
+      if(threads == runs.size())
+        ++runs[thread];
+    }
+
+  public:
+    TEST_METHOD(Best)
+    {
+      std::mt19937 rand{2012};
+      std::vector<double> speeds, sinks;
+      for(unsigned points=3; points<40; points++) {
+        PolarGenerate(rand, points, speeds, sinks);
+        const auto expected = BestExhaustive(speeds, sinks);
+        const auto actual = polarOptimiser::CPolarFit{speeds, sinks}.Best();
+        for(unsigned i=0; i<3; i++)
+          Assert::AreEqual(expected.idx[i], actual.idx[i]);
+        Assert::AreEqual(expected.error, actual.error, 1e-9);
+      }
+      Assert::ExpectException<std::runtime_error>([]{ polarOptimiser::CPolarFit(std::vector<double>(2, 100), std::vector<double>(2, -1)); });
+    }
+
+    TEST_METHOD(LeastSquares)
+    {
+      // points exactly on the curve give its coefficients
+      std::vector<double> speeds, sinks;
+      for(unsigned i=0; i<10; i++) {
+        const double v = 20 + i * 5;
+        speeds.push_back(v * 3.6);
+        sinks.push_back(-0.002 * v * v + 0.05 * v - 1);
+      }
+      double polar[3];
+      polarOptimiser::CPolarFit{speeds, sinks}.LeastSquares(std::vector<double>(), polar);
+      Assert::AreEqual(-0.002, polar[0], 1e-9);
+      Assert::AreEqual(0.05, polar[1], 1e-9);
+      Assert::AreEqual(-1.0, polar[2], 1e-9);
+      Assert::ExpectException<std::runtime_error>([&]{ polarOptimiser::CPolarFit{speeds, sinks}.LeastSquares(std::vector<double>(3, 1), polar); });
+    }
+
+    TEST_METHOD(ParallelRun)
+    {
+      const unsigned threads = polarOptimiser::ProcessorsNumber() + 2;
+      std::vector<unsigned> runs(threads, 0);
+      polarOptimiser::ParallelRun(ThreadMark, &runs, threads);
+      for(auto count : runs)
+        Assert::AreEqual(1u, count);
+    }
+  };
+
+
+  ////////////////////////   P E R F O R M A N C E   B U D G E T S   ////////////////////////
+
+  /**
+   * @brief Performance budget of a hot path.
+   *
+   * Budgets are read from 'UnitTests/perfBudgets.ini' file. Checked operation
+   * is run a few times and the fastest run has to fit in the memory
+   * allocations budget of current build configuration. Wall-clock time
+   * depends on the load of the machine so it is only reported unless
+   * CONDOR2NAV_TIME_BUDGETS environment variable is set.
+   */
+  class CBudget {
+    const CFileParserINI _parser;
+    const std::string _chapter;
+
+    std::string Key(const char *key) const
+    {
+#ifdef _DEBUG
+      return key + std::string{"Debug"};
+#else
+      return key;
+#endif
+    }
+
+  public:
+    explicit CBudget(std::string chapter) :
+      _parser{MAIN_SRC_DIR / "UnitTests/perfBudgets.ini"}, _chapter{std::move(chapter)}
+    {}
+
+    unsigned Value(const char *key) const { return Convert<unsigned>(_parser.Value(_chapter, key)); }
+
+    template<class Func, class Prepare>
+    void Check(Func func, Prepare prepare, unsigned runs = 3) const
+    {
+      using ms = std::chrono::milliseconds;
+      auto bestTime = ms::max();
+      auto bestAllocations = std::numeric_limits<unsigned long long>::max();
+      for(unsigned i = 0; i < runs; ++i) {
+        prepare();
+        const auto startAllocations = allocations.load();
+        const auto start = std::chrono::high_resolution_clock::now();
+        func();
+        const auto time = std::chrono::duration_cast<ms>(std::chrono::high_resolution_clock::now() - start);
+        bestTime = std::min(bestTime, time);
+        bestAllocations = std::min(bestAllocations, allocations.load() - startAllocations);
+      }
+
+      const auto timeBudget = Value(Key("TimeMs").c_str());
+      const auto allocationsBudget = Value(Key("Allocations").c_str());
+      std::ostringstream msg;
+      msg << _chapter << ": " << bestTime.count() << " ms (budget " << timeBudget << " ms), "
+          << bestAllocations << " allocations (budget " << allocationsBudget << ")";
+      const auto text = msg.str();
+      Logger::WriteMessage((text + "\n").c_str());
+      const std::wstring wmsg{text.begin(), text.end()};
+      if(std::getenv("CONDOR2NAV_TIME_BUDGETS"))
+        Assert::IsTrue(bestTime.count() <= timeBudget, wmsg.c_str());
+      Assert::IsTrue(bestAllocations <= allocationsBudget, wmsg.c_str());
+    }
+
+    template<class Func>
+    void Check(Func func, unsigned runs = 3) const
+    {
+      Check(func, []{}, runs);
+    }
+  };
+
+
+  TEST_CLASS(TestPerformanceBudgets) {
+  public:
+    TEST_METHOD(FPLParse)
+    {
+      const CBudget budget{"FPLParse"};
+      const CWorkDir dir{"condor2nav-perf"};
+      std::mt19937 rand{2012};
+      std::uniform_real_distribution<float> pos{0, 400000};
+      std::ostringstream fpl;
+      fpl << "[Version]\r\nCondor version=1120\r\n\r\n[Task]\r\nLandscape=Budget\r\n";
+      const unsigned zones = budget.Value("Lines") / 10;
+      fpl << "PZCount=" << zones << "\r\n";
+      for(unsigned i=0; i<zones; i++) {
+        for(unsigned c=0; c<4; c++) {
+          fpl << "PZPos" << c << "X" << i << "=" << pos(rand) << "\r\n";
+          fpl << "PZPos" << c << "Y" << i << "=" << pos(rand) << "\r\n";
+        }
+        fpl << "PZBase" << i << "=0\r\n";
+        fpl << "PZTop" << i << "=2000\r\n";
+      }
+      fpl << "\r\n[Plane]\r\nName=ASW28\r\n";
+      const auto path = dir / "Budget.fpl";
+      FileWrite(path, fpl.str());
+
+      budget.Check([&]{ Assert::AreEqual(std::string{"ASW28"}, CFileParserINI{path}.Value("Plane", "Name")); });
+    }
+
+    TEST_METHOD(CSVParse)
+    {
+      const CBudget budget{"CSVParse"};
+      const CWorkDir dir{"condor2nav-perf"};
+      std::mt19937 rand{2012};
+      std::uniform_int_distribution<int> value{0, 100000};
+      std::ostringstream csv;
+      csv << "Name,Value1,Value2,Value3,Value4,Value5,Value6,Description\n";
+      const auto rows = budget.Value("Rows");
+      for(unsigned i=0; i<rows; i++)
+        csv << "Row" << i << "," << value(rand) << "," << value(rand) << "," << value(rand) << "," << value(rand) << ","
+            << value(rand) << "," << value(rand) << ",Description of row " << i << "\n";
+      const auto path = dir / "Budget.csv";
+      FileWrite(path, csv.str());
+
+      budget.Check([&]{ Assert::AreEqual(size_t{rows + 1}, CFileParserCSV{path}.Rows().size()); });
+    }
+
+    TEST_METHOD(LandscapesMatchCold)
+    {
+      const CBudget budget{"LandscapesMatchCold"};
+      const CWorkDir dir{"condor2nav-perf"};
+      const CCurrentDir current{dir.Path()};
+      std::mt19937 rand{2012};
+      const auto templates = LandscapesGenerate(budget.Value("Landscapes"), budget.Value("Templates"), rand);
+      const CTestApp app;
+      CLKMapsDB db{app};
+      budget.Check([&]{ db.LandscapesMatch(templates); },
+                   []{ bfs::remove("data/Landscapes.cat"); bfs::remove("data/LK8000/LKMTemplates.cat"); });
+    }
+
+    TEST_METHOD(LandscapesMatch)
+    {
+      const CBudget budget{"LandscapesMatch"};
+      const CWorkDir dir{"condor2nav-perf"};
+      const CCurrentDir current{dir.Path()};
+      std::mt19937 rand{2012};
+      const auto templates = LandscapesGenerate(budget.Value("Landscapes"), budget.Value("Templates"), rand);
+      const CTestApp app;
+      CLKMapsDB db{app};
+      db.LandscapesMatch(templates);
+      budget.Check([&]{ db.LandscapesMatch(templates); });
+    }
+  };
+
 }
+
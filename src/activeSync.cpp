@@ -26,13 +26,96 @@
  */
 
 #include "activeSync.h"
+#include "traceLog.h"
 #include <memory>
+#include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <array>
+#include <vector>
+#include <set>
+#include <map>
+#include <cwctype>
 #include <rapi.h>
 #include <boost/filesystem.hpp>
 
 namespace {
 
+  std::mutex instanceMutex;      // guards the singleton creation
+  std::mutex warmupMutex;        // guards the background connection handshake
+  std::shared_future<void> warmup;
+  std::atomic<unsigned> blockSize{condor2nav::CActiveSync::DEFAULT_BLOCK_SIZE};
+
+  /**
+   * @brief Cache of remote file system state.
+   */
+  struct TCache {
+    std::mutex mutex;
+    std::set<std::wstring> dirs;           ///< @brief Directories known to exist
+    std::map<std::wstring, bool> files;    ///< @brief Results of file existence checks
+  } cache;
+
+  /**
+   * @brief Returns the cache key of a remote path.
+   *
+   * Remote file system is case insensitive.
+   *
+   * @param path Remote path.
+   *
+   * @return Cache key.
+   */
+  std::wstring CacheKey(const bfs::path &path)
+  {
+    auto key = path.wstring();
+    for(auto &c : key)
+      c = static_cast<wchar_t>(std::towlower(c));
+    return key;
+  }
+
+  /**
+   * @brief Marks directory and all its parents as existing.
+   *
+   * @param path Remote directory path.
+   */
+  void CacheDirectory(bfs::path path)
+  {
+    std::lock_guard<std::mutex> lock{cache.mutex};
+    for(; !path.empty() && path != "\\"; path = path.parent_path())
+      if(!cache.dirs.insert(CacheKey(path)).second)
+        break;
+  }
+
+  /**
+   * @brief Stores file existence in the cache.
+   *
+   * @param path   Remote file path.
+   * @param exists File existence.
+   */
+  void CacheFile(const bfs::path &path, bool exists)
+  {
+    {
+      std::lock_guard<std::mutex> lock{cache.mutex};
+      cache.files[CacheKey(path)] = exists;
+    }
+    if(exists)
+      CacheDirectory(path.parent_path());
+  }
+
+  /**
+   * @brief Removes file existence from the cache.
+   *
+   * Used when the state of the file is not known (i.e. failed creation
+   * of an existing file).
+   *
+   * @param path Remote file path.
+   */
+  void CacheErase(const bfs::path &path)
+  {
+    std::lock_guard<std::mutex> lock{cache.mutex};
+    cache.files.erase(CacheKey(path));
+  }
+
   // rapi.dll interface
   using FCeRapiInitEx = HRESULT(WINAPI*)(RAPIINIT *pRapiInit);
   using FCeRapiUninit = HRESULT(WINAPI*)();
@@ -60,6 +143,9 @@ namespace {
   using FCeCloseHandle = BOOL(WINAPI*)(HANDLE hObject);
   using FCeCreateDirectory = BOOL(WINAPI*)(LPCWSTR lpPathName,
                                            LPSECURITY_ATTRIBUTES lpSecurityAttributes);
+  using FCeFindFirstFile = HANDLE(WINAPI*)(LPCWSTR lpFileName,
+                                           LPCE_FIND_DATA lpFindFileData);
+  using FCeFindClose = BOOL(WINAPI*)(HANDLE hFindFile);
 
   template<typename SYMBOL_TYPE>
   inline void Symbol(const HMODULE &module, const std::string &name, SYMBOL_TYPE &out)
@@ -88,6 +174,8 @@ namespace condor2nav {
     FCeWriteFile       ceWriteFile;
     FCeCloseHandle     ceCloseHandle;
     FCeCreateDirectory ceCreateDirectory;
+    FCeFindFirstFile   ceFindFirstFile;
+    FCeFindClose       ceFindClose;
   };
 
   class CActiveSync::CRapiHandleDeleter {
@@ -106,19 +194,67 @@ namespace condor2nav {
 
 
 /**
- * @brief Returns singleton instance.
+ * @brief Creates singleton instance.
  *
- * Method returns singleton instance.
+ * @exception std Thrown when ActiveSync connection cannot be established.
  *
  * @return Singleton instance.
  */
-condor2nav::CActiveSync &condor2nav::CActiveSync::Instance()
+condor2nav::CActiveSync &condor2nav::CActiveSync::Create()
 {
+  // function local statics initialization is not thread-safe in VS2013
+  std::lock_guard<std::mutex> lock{instanceMutex};
   static CActiveSync instance;
   return instance;
 }
 
 
+/**
+ * @brief Starts ActiveSync connection handshake in the background.
+ *
+ * Method returns immediately. Errors are reported by the first call to
+ * Instance().
+ */
+void condor2nav::CActiveSync::Warmup()
+{
+  std::lock_guard<std::mutex> lock{warmupMutex};
+  if(!warmup.valid())
+    warmup = std::async(std::launch::async, []{ Create(); }).share();
+}
+
+
+/**
+ * @brief Returns singleton instance.
+ *
+ * Method returns singleton instance. If the connection handshake was
+ * started with Warmup() method waits only for its completion.
+ *
+ * @exception std Thrown when ActiveSync connection cannot be established.
+ *
+ * @return Singleton instance.
+ */
+condor2nav::CActiveSync &condor2nav::CActiveSync::Instance()
+{
+  std::shared_future<void> handshake;
+  {
+    std::lock_guard<std::mutex> lock{warmupMutex};
+    handshake = warmup;
+  }
+  if(handshake.valid()) {
+    try {
+      handshake.get();
+    }
+    catch(...) {
+      // next call retries the connection (i.e. device was connected in the meantime)
+      std::lock_guard<std::mutex> lock{warmupMutex};
+      warmup = std::shared_future<void>{};
+      throw;
+    }
+  }
+  return Create();
+}
+
+
 /**
  * @brief Class constructor.
  *
@@ -127,6 +263,7 @@ condor2nav::CActiveSync &condor2nav::CActiveSync::Instance()
 condor2nav::CActiveSync::CActiveSync() :
   _lib{::LoadLibrary("rapi.dll")}, _iface{std::make_unique<TDLLIface>()}, _rapi{false, CRapiDeleter(*_iface)}
 {
+  CTraceScope trace{"activesync", "Handshake"};
   if(!_lib.get())
     throw EOperationFailed{"ERROR: Couldn't open 'rapi.dll' library!!! Please check that ActiveSync is installed correctly."};
   Symbol(_lib.get(), "CeRapiInitEx",      _iface->ceRapiInitEx);
@@ -138,6 +275,8 @@ condor2nav::CActiveSync::CActiveSync() :
   Symbol(_lib.get(), "CeWriteFile",       _iface->ceWriteFile);
   Symbol(_lib.get(), "CeCloseHandle",     _iface->ceCloseHandle);
   Symbol(_lib.get(), "CeCreateDirectory", _iface->ceCreateDirectory);
+  Symbol(_lib.get(), "CeFindFirstFile",   _iface->ceFindFirstFile);
+  Symbol(_lib.get(), "CeFindClose",       _iface->ceFindClose);
 
   // init RAPI
   RAPIINIT initData{};
@@ -171,16 +310,84 @@ condor2nav::CActiveSync::CActiveSync() :
 
 
 /**
- * @brief Reads whole file to a string.
+ * @brief Sets transfer block size.
  *
- * Method reads whole file to a string.
+ * @param size Transfer block size in bytes (0 restores the default).
+ */
+void condor2nav::CActiveSync::BlockSize(unsigned size)
+{
+  blockSize = size ? size : DEFAULT_BLOCK_SIZE;
+}
+
+
+/**
+ * @brief Returns transfer block size.
+ *
+ * @return Transfer block size in bytes.
+ */
+unsigned condor2nav::CActiveSync::BlockSize()
+{
+  return blockSize;
+}
+
+
+/**
+ * @brief Clears cached remote file system state.
+ *
+ * Should be called when remote files might have been modified by other
+ * applications (i.e. before each translation).
+ */
+void condor2nav::CActiveSync::CacheClear()
+{
+  std::lock_guard<std::mutex> lock{cache.mutex};
+  cache.dirs.clear();
+  cache.files.clear();
+}
+
+
+/**
+ * @brief Reads whole text file to a string.
+ *
+ * Method reads file block after block and removes all carriage returns
+ * while the data streams through.
  *
  * @param src Target file path. 
+ *
+ * @exception std Thrown when operation failed to execute.
  * 
  * @return String with file content. 
  */
 std::string condor2nav::CActiveSync::Read(const bfs::path &src) const
 {
+  std::string text;
+  Read(src, [&](const char *data, std::size_t size)
+  {
+    const auto end = data + size;
+    for(auto it = data; it != end;) {
+      const auto cr = std::find(it, end, '\r');
+      text.append(it, cr);
+      it = cr == end ? cr : cr + 1;
+    }
+  });
+  return text;
+}
+
+
+/**
+ * @brief Reads a file block after block.
+ *
+ * Method reads file in blocks of BlockSize() bytes using two buffers. Each
+ * block is provided to the handler on another thread while the next block
+ * is being read.
+ *
+ * @param src     Target file path. 
+ * @param handler Handler of read data blocks.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+void condor2nav::CActiveSync::Read(const bfs::path &src, const CReadHandler &handler) const
+{
+  std::lock_guard<std::mutex> lock{_mutex};
   std::unique_ptr<HANDLE, CRapiHandleDeleter> hSrc{_iface->ceCreateFile(src.wstring().c_str(),
                                                                         GENERIC_READ,
                                                                         FILE_SHARE_READ,
@@ -191,31 +398,45 @@ std::string condor2nav::CActiveSync::Read(const bfs::path &src) const
                                                    CRapiHandleDeleter{*_iface}};
   if(hSrc.get() == INVALID_HANDLE_VALUE)
     throw EOperationFailed{"ERROR: Unable to open ActiveSync file '" + src.string() + "'!!!"};
-
-  auto numBytes = _iface->ceGetFileSize(hSrc.get(), nullptr);
-  std::vector<char> buffer;
-  buffer.resize(numBytes);
-
-  if(!_iface->ceReadFile(hSrc.get(), buffer.data(), numBytes, &numBytes, nullptr))
-    throw EOperationFailed{"ERROR: Reading ActiveSync file '" + src.string() + "'!!!"};
-
-  // remove all returns from a file
-  buffer.erase(std::remove_if(begin(buffer), end(buffer), [](char c){ return c == '\r'; }), end(buffer));
-
-  return buffer.data();
+  CacheFile(src, true);
+
+  const auto size = BlockSize();
+  std::array<std::vector<char>, 2> buffers;
+  buffers[0].resize(size);
+  buffers[1].resize(size);
+
+  std::future<void> pending;
+  for(unsigned i = 0;; i = 1 - i) {
+    DWORD numBytes = 0;
+    const auto status = _iface->ceReadFile(hSrc.get(), buffers[i].data(), size, &numBytes, nullptr);
+
+    // previous block has to be handled before its buffer is used again
+    if(pending.valid())
+      pending.get();
+    if(!status)
+      throw EOperationFailed{"ERROR: Reading ActiveSync file '" + src.string() + "'!!!"};
+    if(numBytes == 0)
+      break;
+
+    const auto data = buffers[i].data();
+    pending = std::async(std::launch::async, [&handler, data, numBytes]{ handler(data, numBytes); });
+  }
 }
 
 
 /**
  * @brief Writes buffer to a file on the target device.
  *
- * Method writes buffer to a file on the target device.
+ * Method writes buffer to a file on the target device in blocks of BlockSize() bytes.
  *
  * @param dest Target file path. 
  * @param buffer Buffer with file content. 
+ *
+ * @exception std Thrown when operation failed to execute.
  */
-void condor2nav::CActiveSync::Write(const bfs::path &dest, const std::string &buffer) const
+void condor2nav::CActiveSync::Write(const bfs::path &dest, boost::string_ref buffer) const
 {
+  std::lock_guard<std::mutex> lock{_mutex};
   std::unique_ptr<HANDLE, CRapiHandleDeleter> hDest{_iface->ceCreateFile(dest.wstring().c_str(),
                                                                          GENERIC_WRITE,
                                                                          FILE_SHARE_READ,
@@ -224,33 +445,104 @@ void condor2nav::CActiveSync::Write(const bfs::path &dest, const std::string &bu
                                                                          FILE_ATTRIBUTE_NORMAL,
                                                                          nullptr),
                                                     CRapiHandleDeleter{*_iface}};
-  if(hDest.get() == INVALID_HANDLE_VALUE)
+  if(hDest.get() == INVALID_HANDLE_VALUE) {
+    // the file might still exist (i.e. locked by the device application)
+    CacheErase(dest);
     throw EOperationFailed{"ERROR: Unable to open ActiveSync file '" + dest.string() + "'!!!"};
+  }
+  CacheFile(dest, true);
+
+  const std::size_t size = BlockSize();
+  for(std::size_t pos = 0; pos < buffer.size();) {
+    DWORD numBytes;
+    const auto count = static_cast<DWORD>(std::min(size, buffer.size() - pos));
+    if(!_iface->ceWriteFile(hDest.get(), buffer.data() + pos, count, &numBytes, nullptr) || numBytes == 0)
+      throw EOperationFailed{"ERROR: Writing ActiveSync file '" + dest.string() + "'!!!"};
+    pos += numBytes;
+  }
+}
 
-  DWORD numBytes;
-  if(!_iface->ceWriteFile(hDest.get(), buffer.c_str(), buffer.size(), &numBytes, nullptr))
-    throw EOperationFailed{"ERROR: Writing ActiveSync file '" + dest.string() + "'!!!"};
+
+/**
+ * @brief Writes data provided block after block to a file on the target device.
+ *
+ * Method uses two buffers of BlockSize() bytes. The next block is prepared
+ * by the provider on another thread while the previous one is being written.
+ *
+ * @param dest     Target file path. 
+ * @param provider Provider of data blocks.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+void condor2nav::CActiveSync::Write(const bfs::path &dest, const CWriteProvider &provider) const
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  std::unique_ptr<HANDLE, CRapiHandleDeleter> hDest{_iface->ceCreateFile(dest.wstring().c_str(),
+                                                                         GENERIC_WRITE,
+                                                                         FILE_SHARE_READ,
+                                                                         nullptr,
+                                                                         CREATE_ALWAYS,
+                                                                         FILE_ATTRIBUTE_NORMAL,
+                                                                         nullptr),
+                                                    CRapiHandleDeleter{*_iface}};
+  if(hDest.get() == INVALID_HANDLE_VALUE) {
+    // the file might still exist (i.e. locked by the device application)
+    CacheErase(dest);
+    throw EOperationFailed{"ERROR: Unable to open ActiveSync file '" + dest.string() + "'!!!"};
+  }
+  CacheFile(dest, true);
+
+  const std::size_t size = BlockSize();
+  std::array<std::vector<char>, 2> buffers;
+  buffers[0].resize(size);
+  buffers[1].resize(size);
+
+  auto count = provider(buffers[0].data(), size);
+  for(unsigned i = 0; count > 0; i = 1 - i) {
+    auto next = buffers[1 - i].data();
+    auto prepared = std::async(std::launch::async, [&provider, next, size]{ return provider(next, size); });
+
+    for(std::size_t pos = 0; pos < count;) {
+      DWORD numBytes;
+      if(!_iface->ceWriteFile(hDest.get(), buffers[i].data() + pos, static_cast<DWORD>(count - pos), &numBytes, nullptr) || numBytes == 0) {
+        prepared.wait();
+        throw EOperationFailed{"ERROR: Writing ActiveSync file '" + dest.string() + "'!!!"};
+      }
+      pos += numBytes;
+    }
+    count = prepared.get();
+  }
 }
 
 
 /**
  * @brief Creates directory on the target device.
  *
- * Method creates directory on the target device.
+ * Method creates directory on the target device. Nothing is sent to the
+ * device if the directory is already known to exist.
  *
  * @param path Target directory path. 
  */
 void condor2nav::CActiveSync::DirectoryCreate(const bfs::path &path) const
 {
+  {
+    std::lock_guard<std::mutex> lock{cache.mutex};
+    if(cache.dirs.count(CacheKey(path)))
+      return;
+  }
+
+  std::lock_guard<std::mutex> lock{_mutex};
   if(!_iface->ceCreateDirectory(path.wstring().c_str(), nullptr) && _iface->ceGetLastError() != ERROR_ALREADY_EXISTS)
     throw EOperationFailed{"ERROR: Creating ActiveSync directory '" + path.string() + "'!!!"};
+  CacheDirectory(path);
 }
 
 
 /**
  * @brief Checks if a file exists on the target device.
  *
- * Method checks if a file exists on the target device.
+ * Method checks if a file exists on the target device. Cached result is
+ * returned if the file was already checked, read or written.
  *
  * @param path Target file path.
  *
@@ -258,6 +550,14 @@ void condor2nav::CActiveSync::DirectoryCreate(const bfs::path &path) const
  */
 bool condor2nav::CActiveSync::FileExists(const bfs::path &path) const
 {
+  {
+    std::lock_guard<std::mutex> lock{cache.mutex};
+    auto it = cache.files.find(CacheKey(path));
+    if(it != cache.files.end())
+      return it->second;
+  }
+
+  std::lock_guard<std::mutex> lock{_mutex};
   std::unique_ptr<HANDLE, CRapiHandleDeleter> hDest{_iface->ceCreateFile(path.wstring().c_str(),
                                                                          GENERIC_READ,
                                                                          FILE_SHARE_READ,
@@ -267,10 +567,43 @@ bool condor2nav::CActiveSync::FileExists(const bfs::path &path) const
                                                                          nullptr),
                                                     CRapiHandleDeleter{*_iface}};
   if(hDest.get() == INVALID_HANDLE_VALUE) {
-    if(_iface->ceGetLastError() == ERROR_FILE_NOT_FOUND)
+    if(_iface->ceGetLastError() == ERROR_FILE_NOT_FOUND) {
+      CacheFile(path, false);
       return false;
+    }
     throw EOperationFailed{"ERROR: Unable to check if file '" + path.string() + "' exists!!!"};
   }
-  else
-    return true;
+  CacheFile(path, true);
+  return true;
+}
+
+
+/**
+ * @brief Returns file modification time.
+ *
+ * Method obtains file attributes with one RAPI call without opening the file.
+ *
+ * @param path Target file path.
+ *
+ * @exception std Thrown when operation failed to execute.
+ *
+ * @return File modification time (FILETIME units) or 0 if file does not exist.
+ */
+std::uint64_t condor2nav::CActiveSync::FileWriteTime(const bfs::path &path) const
+{
+  CE_FIND_DATA data;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    const auto find = _iface->ceFindFirstFile(path.wstring().c_str(), &data);
+    if(find == INVALID_HANDLE_VALUE) {
+      const auto error = _iface->ceGetLastError();
+      if(error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND && error != ERROR_NO_MORE_FILES)
+        throw EOperationFailed{"ERROR: Unable to check ActiveSync file '" + path.string() + "' attributes!!!"};
+      CacheFile(path, false);
+      return 0;
+    }
+    _iface->ceFindClose(find);
+  }
+  CacheFile(path, true);
+  return (static_cast<std::uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
 }
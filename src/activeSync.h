@@ -32,6 +32,7 @@
 #include "tools.h"
 #include "boostfwd.h"
 #include <functional>
+#include <mutex>
 
 
 namespace condor2nav {
@@ -42,9 +43,42 @@ namespace condor2nav {
    * condor2nav::CActiveSync class is a wrapper around ActiveSync interface.
    * It uses RAPI interface to communicate with remote device.
    *
+   * Files are transferred in blocks of BlockSize() bytes. Processing of one
+   * block overlaps the RAPI transfer of the next one.
+   *
+   * Directories known to exist and results of file existence checks are
+   * cached until CacheClear() is called so repeated checks do not need any
+   * RAPI calls. Writes and reads update the cache.
+   *
+   * Connection handshake may take several seconds. Warmup() starts it in
+   * the background so that Instance() waits only for the time that is left.
+   *
    * @note Singleton design pattern
+   * @note All the methods are thread-safe
    */
   class CActiveSync : CNonCopyable {
+  public:
+    /**
+     * @brief Handler of a block of data read from a file.
+     *
+     * @param data Block data.
+     * @param size Block size.
+     */
+    using CReadHandler = std::function<void(const char *data, std::size_t size)>;
+
+    /**
+     * @brief Provider of a block of data to write to a file.
+     *
+     * @param buffer Buffer to fill.
+     * @param size   Buffer size.
+     *
+     * @return Number of bytes provided (0 means the end of data).
+     */
+    using CWriteProvider = std::function<std::size_t(char *buffer, std::size_t size)>;
+
+    static const unsigned DEFAULT_BLOCK_SIZE = 64 * 1024;   ///< @brief Default transfer block size. 
+
+  private:
     struct TDLLIface;
     class CRapiHandleDeleter;
 
@@ -63,14 +97,23 @@ namespace condor2nav {
     CLibraryRes _lib;                                 ///< @brief DLL instance. 
     std::unique_ptr<TDLLIface> _iface;	              ///< @brief DLL interface.
     CRapiRes _rapi;                                   ///< @brief RAPI RAII wrapper. 
+    mutable std::mutex _mutex;                        ///< @brief Serializes RAPI calls from different threads. 
 
     CActiveSync();
+    static CActiveSync &Create();
   public:
+    static void Warmup();
     static CActiveSync &Instance();
+    static void BlockSize(unsigned size);
+    static unsigned BlockSize();
+    static void CacheClear();
     std::string Read(const bfs::path &src) const;
-    void Write(const bfs::path &dest, const std::string &buffer) const;
+    void Read(const bfs::path &src, const CReadHandler &handler) const;
+    void Write(const bfs::path &dest, boost::string_ref buffer) const;
+    void Write(const bfs::path &dest, const CWriteProvider &provider) const;
     void DirectoryCreate(const bfs::path &path) const;
     bool FileExists(const bfs::path &path) const;
+    std::uint64_t FileWriteTime(const bfs::path &path) const;
   };
 
 }
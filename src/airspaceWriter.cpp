@@ -0,0 +1,287 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file airspaceWriter.cpp
+ *
+ * @brief Implements the condor2nav::CAirspaceWriter class. 
+ */
+
+#include "airspaceWriter.h"
+#include "istream.h"
+#include "ostream.h"
+#include "tools.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+  const double NAUTICAL_MILE = 1.852;    ///< @brief Nautical mile length [km]
+
+  /**
+   * @brief External OpenAir airspace.
+   */
+  struct TAirspace {
+    std::string lines;                   ///< @brief Airspace definition lines.
+    double lonMin, lonMax;               ///< @brief Longitude range of all the airspace coordinates.
+    double latMin, latMax;               ///< @brief Latitude range of all the airspace coordinates.
+    double radius;                       ///< @brief The biggest circle or arc radius [km].
+    bool lon, lat;                       ///< @brief Coordinates ranges are valid.
+
+    void Reset()
+    {
+      lines.clear();
+      radius = 0;
+      lon = lat = false;
+    }
+
+    void Longitude(double value)
+    {
+      lonMin = lon ? std::min(lonMin, value) : value;
+      lonMax = lon ? std::max(lonMax, value) : value;
+      lon = true;
+    }
+
+    void Latitude(double value)
+    {
+      latMin = lat ? std::min(latMin, value) : value;
+      latMax = lat ? std::max(latMax, value) : value;
+      lat = true;
+    }
+
+    bool Inside(const condor2nav::CAirspaceWriter::TArea &area) const
+    {
+      if(!lon || !lat)
+        return false;
+      const double latMargin = radius / condor2nav::DEGREE_LENGTH;
+      const double lonMargin = latMargin / std::max(0.01, std::cos(condor2nav::Deg2Rad(std::max(std::abs(latMin), std::abs(latMax)))));
+      return lonMin - lonMargin <= area.lonMax && lonMax + lonMargin >= area.lonMin &&
+        latMin - latMargin <= area.latMax && latMax + latMargin >= area.latMin;
+    }
+  };
+
+  bool IsDigit(char ch)
+  {
+    return ch >= '0' && ch <= '9';
+  }
+
+  /**
+   * @brief Parses decimal number from the beginning of the string.
+   *
+   * @param str   The string to parse (parsed characters are removed).
+   * @param value Parsed value.
+   *
+   * @return @p true if a number was found.
+   */
+  bool Number(boost::string_ref &str, double &value)
+  {
+    size_t i = 0;
+    value = 0;
+    for(; i<str.size() && IsDigit(str[i]); i++)
+      value = value * 10 + (str[i] - '0');
+    const bool found = i > 0;
+    if(i < str.size() && str[i] == '.') {
+      double scale = 0.1;
+      for(i++; i<str.size() && IsDigit(str[i]); i++, scale /= 10)
+        value += (str[i] - '0') * scale;
+    }
+    str.remove_prefix(i);
+    return found;
+  }
+
+  /**
+   * @brief Updates airspace coordinates ranges with all coordinates found in the line.
+   *
+   * Coordinates may be provided as DD:MM:SS, DD:MM.MMM or DD:MM:SS.SS followed
+   * with the hemisphere letter.
+   *
+   * @param airspace The airspace to update.
+   * @param str      OpenAir line data after the command.
+   */
+  void Coordinates(TAirspace &airspace, boost::string_ref str)
+  {
+    while(!str.empty()) {
+      if(!IsDigit(str.front())) {
+        str.remove_prefix(1);
+        continue;
+      }
+      double deg, min = 0, sec = 0;
+      Number(str, deg);
+      if(!str.empty() && str.front() == ':') {
+        str.remove_prefix(1);
+        Number(str, min);
+        if(!str.empty() && str.front() == ':') {
+          str.remove_prefix(1);
+          Number(str, sec);
+        }
+      }
+      while(!str.empty() && str.front() == ' ')
+        str.remove_prefix(1);
+      if(str.empty())
+        break;
+      const double value = deg + min / 60 + sec / 3600;
+      switch(str.front()) {
+      case 'N': case 'n': airspace.Latitude(value);   break;
+      case 'S': case 's': airspace.Latitude(-value);  break;
+      case 'E': case 'e': airspace.Longitude(value);  break;
+      case 'W': case 'w': airspace.Longitude(-value); break;
+      default: ;
+      }
+    }
+  }
+
+  /**
+   * @brief Updates airspace radius with the circle or arc radius.
+   *
+   * @param airspace The airspace to update.
+   * @param str      OpenAir line data after the command.
+   */
+  void Radius(TAirspace &airspace, boost::string_ref str)
+  {
+    str = condor2nav::Trim(str);
+    double value;
+    if(Number(str, value))
+      airspace.radius = std::max(airspace.radius, value * NAUTICAL_MILE);
+  }
+
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CAirspaceWriter class constructor.
+ */
+condor2nav::CAirspaceWriter::CAirspaceWriter() :
+  _airspaces{0}
+{
+  _data += "*******************************************************\n";
+  _data += "* Condor Task Penalty Zones generated with Condor2Nav *\n";
+  _data += "*******************************************************\n";
+}
+
+
+/**
+ * @brief Writes task penalty zones.
+ *
+ * @param penaltyZones Task penalty zones.
+ */
+void condor2nav::CAirspaceWriter::PenaltyZones(const CCondor::CTask::CPenaltyZoneArray &penaltyZones)
+{
+  // about 160 characters are needed for every penalty zone
+  _data.reserve(_data.size() + penaltyZones.size() * 160);
+  for(size_t i=0; i<penaltyZones.size(); i++) {
+    const auto &pz = penaltyZones[i];
+    _data += "\nAC P\nAN Penalty Zone ";
+    _data += Convert(static_cast<unsigned>(i + 1));
+    _data += "\nAH ";
+    _data += Convert(pz.top);
+    _data += "m AMSL\nAL ";
+    if(pz.base == 0)
+      _data += "0";
+    else {
+      _data += Convert(pz.base);
+      _data += "m AMSL";
+    }
+    _data += '\n';
+
+    for(const auto &position : pz.corners) {
+      _data += "DP ";
+      Coord2DDMMSS(position.latitude, _data);
+      _data += ' ';
+      Coord2DDMMSS(position.longitude, _data);
+      _data += '\n';
+    }
+  }
+  _airspaces += static_cast<unsigned>(penaltyZones.size());
+}
+
+
+/**
+ * @brief Merges external OpenAir airspace file.
+ *
+ * Method copies airspaces definitions from the external OpenAir file. Comments
+ * and empty lines are skipped.
+ *
+ * @param path The path of the OpenAir file to merge.
+ * @param area If provided only the airspaces with any part inside the area are merged.
+ *
+ * @exception std Thrown when the file cannot be read.
+ *
+ * @return The number of merged airspaces.
+ */
+unsigned condor2nav::CAirspaceWriter::Merge(const bfs::path &path, const TArea *area)
+{
+  CIStream input{path};
+  unsigned merged = 0;
+  TAirspace airspace;
+  airspace.Reset();
+  auto flush = [&]
+  {
+    if(!airspace.lines.empty() && (!area || airspace.Inside(*area))) {
+      _data += '\n';
+      _data += airspace.lines;
+      merged++;
+    }
+    airspace.Reset();
+  };
+
+  boost::string_ref line;
+  while(input.GetLine(line)) {
+    line = Trim(line);
+    if(line.empty() || line.front() == '*')
+      continue;
+    if(line.starts_with("AC ") || line == "AC")
+      flush();
+    else if(airspace.lines.empty())
+      // skip data not assigned to any airspace
+      continue;
+
+    if(line.starts_with("DP") || line.starts_with("DB") || line.starts_with("V "))
+      Coordinates(airspace, line.substr(2));
+    else if(line.starts_with("DC") || line.starts_with("DA"))
+      Radius(airspace, line.substr(2));
+
+    airspace.lines.append(line.data(), line.size());
+    airspace.lines += '\n';
+  }
+  flush();
+
+  _airspaces += merged;
+  return merged;
+}
+
+
+/**
+ * @brief Writes the airspace file.
+ *
+ * @param path  The path of the output file.
+ * @param queue The queue executing the write.
+ *
+ * @exception std Thrown when the file cannot be written and the queue is disabled.
+ */
+void condor2nav::CAirspaceWriter::Commit(const bfs::path &path, CWriteBehind &queue) const
+{
+  COStream output{path};
+  output.Write(_data.data(), _data.size());
+  output.Commit(queue);
+}
@@ -0,0 +1,69 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file airspaceWriter.h
+ *
+ * @brief Declares the condor2nav::CAirspaceWriter class. 
+ */
+
+#ifndef __AIRSPACEWRITER_H__
+#define __AIRSPACEWRITER_H__
+
+#include "nonCopyable.h"
+#include "condor.h"
+#include <string>
+
+namespace condor2nav {
+
+  class CWriteBehind;
+
+  /**
+   * @brief OpenAir airspace file writer.
+   *
+   * condor2nav::CAirspaceWriter class generates OpenAir airspace file with task
+   * penalty zones. Airspaces from external OpenAir files may be merged into the
+   * output (optionally only those that are close to the task area). All the data
+   * is formatted directly into one buffer that is written to the file at once.
+   */
+  class CAirspaceWriter : CNonCopyable {
+    std::string _data;                    ///< @brief Formatted file data. 
+    unsigned _airspaces;                  ///< @brief The number of written airspaces. 
+
+  public:
+    /**
+     * @brief Merge area.
+     */
+    struct TArea {
+      double lonMin, lonMax;
+      double latMin, latMax;
+    };
+
+    CAirspaceWriter();
+    unsigned Airspaces() const { return _airspaces; }
+    void PenaltyZones(const CCondor::CTask::CPenaltyZoneArray &penaltyZones);
+    unsigned Merge(const bfs::path &path, const TArea *area = nullptr);
+    void Commit(const bfs::path &path, CWriteBehind &queue) const;
+  };
+
+}
+
+#endif /* __AIRSPACEWRITER_H__ */
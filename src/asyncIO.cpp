@@ -0,0 +1,215 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file asyncIO.cpp
+ *
+ * @brief Implements the condor2nav::CAsyncIO class. 
+ */
+
+#include "asyncIO.h"
+#include "activeSync.h"
+#include "httpClient.h"
+#include "traceLog.h"
+#include "tools.h"
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <vector>
+
+
+namespace {
+
+  std::mutex instanceMutex;      // guards the singleton creation
+
+  /**
+   * @brief Writes data to a local file.
+   *
+   * @param path The path of the file to create.
+   * @param data The data to write.
+   *
+   * @exception std Thrown when operation failed.
+   */
+  void LocalWrite(const bfs::path &path, boost::string_ref data)
+  {
+    using namespace condor2nav;
+    bfs::ofstream stream{path, std::ios_base::out | std::ios_base::binary};
+    if(!stream)
+      throw EOperationFailed{"ERROR: Couldn't open file '" + path.string() + "' for writing!!!"};
+    if(!stream.write(data.data(), static_cast<std::streamsize>(data.size())))
+      throw EOperationFailed{"ERROR: Couldn't write file '" + path.string() + "'!!!"};
+  }
+
+}
+
+
+/**
+ * @brief Returns singleton instance.
+ *
+ * Method returns singleton instance.
+ *
+ * @return Singleton instance.
+ */
+condor2nav::CAsyncIO &condor2nav::CAsyncIO::Instance()
+{
+  // function local statics initialization is not thread-safe in VS2013
+  std::lock_guard<std::mutex> lock{instanceMutex};
+  static CAsyncIO instance;
+  return instance;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CAsyncIO class constructor.
+ */
+condor2nav::CAsyncIO::CAsyncIO() :
+  _local{std::max(2u, std::thread::hardware_concurrency())}, _http{HTTP_THREADS}
+{
+}
+
+
+/**
+ * @brief Reads a file.
+ *
+ * Method reads the whole local or ActiveSync file block after block.
+ * The data is provided exactly as stored in the file. The handler is
+ * called on the I/O thread.
+ *
+ * @param path    The path of the file to read.
+ * @param handler The handler of the read data blocks.
+ *
+ * @return The future completion of the read.
+ */
+std::future<void> condor2nav::CAsyncIO::Read(const bfs::path &path, CReadHandler handler)
+{
+  if(PathType(path) == TPathType::ACTIVE_SYNC)
+    return Serialize([path, handler]{ CActiveSync::Instance().Read(path, handler); });
+
+  return _local.Send([path, handler]
+  {
+    bfs::ifstream stream{path, std::ios_base::in | std::ios_base::binary};
+    if(!stream)
+      throw EOperationFailed{"ERROR: Couldn't open file '" + path.string() + "' for reading!!!"};
+    std::vector<char> buffer(LOCAL_BLOCK_SIZE);
+    while(stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || stream.gcount())
+      handler(buffer.data(), static_cast<std::size_t>(stream.gcount()));
+    if(stream.bad())
+      throw EOperationFailed{"ERROR: Couldn't read file '" + path.string() + "'!!!"};
+  });
+}
+
+
+/**
+ * @brief Downloads a file.
+ *
+ * Method downloads a file from the server reusing already established
+ * connection if possible. The handler is called on the I/O thread.
+ *
+ * @param server  Server to download the file from.
+ * @param url     Path of the file on the server.
+ * @param timeout Download timeout in seconds.
+ * @param handler The handler of the received data blocks.
+ *
+ * @return The future completion of the download.
+ */
+std::future<void> condor2nav::CAsyncIO::Read(const std::string &server, const bfs::path &url, unsigned timeout, CReadHandler handler)
+{
+  return _http.Send([server, url, timeout, handler]
+  {
+    CHttpClient::Instance().Get(server, url, timeout, 0,
+                                [&](std::uint64_t, const char *data, std::size_t size){ handler(data, size); });
+  });
+}
+
+
+/**
+ * @brief Writes a file.
+ *
+ * Method creates (or overwrites) the local or ActiveSync file.
+ *
+ * @param path The path of the file to create.
+ * @param data The data to write. It has to stay valid until the operation
+ *             is completed.
+ *
+ * @return The future completion of the write.
+ */
+std::future<void> condor2nav::CAsyncIO::Write(const bfs::path &path, boost::string_ref data)
+{
+  auto write = [path, data]
+  {
+    CTraceScope trace{"io", "Write", path};
+    trace.Bytes(data.size());
+    if(PathType(path) == TPathType::ACTIVE_SYNC)
+      CActiveSync::Instance().Write(path, data);
+    else
+      LocalWrite(path, data);
+  };
+
+  if(PathType(path) == TPathType::ACTIVE_SYNC)
+    return Serialize(write);
+  return _local.Send(write);
+}
+
+
+/**
+ * @brief Checks if a file exists.
+ *
+ * @param path The path of the file to check.
+ *
+ * @return The future @p true if the file exists.
+ */
+std::future<bool> condor2nav::CAsyncIO::Exists(const bfs::path &path)
+{
+  if(PathType(path) == TPathType::ACTIVE_SYNC)
+    return Serialize([path]{ return CActiveSync::Instance().FileExists(path); });
+  return _local.Send([path]{ return bfs::exists(path); });
+}
+
+
+/**
+ * @brief Creates a directory.
+ *
+ * Method creates the directory together with all missing parent directories.
+ *
+ * @param path The path of the directory to create.
+ *
+ * @return The future completion of the operation.
+ */
+std::future<void> condor2nav::CAsyncIO::DirectoryCreate(const bfs::path &path)
+{
+  if(PathType(path) == TPathType::ACTIVE_SYNC)
+    return Serialize([path]
+    {
+      auto dir = path;
+      std::vector<bfs::path> dirs;
+      while(dir.parent_path() != "\\") {
+        dirs.emplace_back(dir);
+        dir = dir.parent_path();
+      }
+      auto &activeSync = CActiveSync::Instance();
+      std::for_each(dirs.crbegin(), dirs.crend(),
+                    [&](const bfs::path &d){ activeSync.DirectoryCreate(d); });
+    });
+
+  return _local.Send([path]{ bfs::create_directories(path); });
+}
@@ -0,0 +1,106 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file asyncIO.h
+ *
+ * @brief Declares the condor2nav::CAsyncIO class. 
+ */
+
+#ifndef __ASYNCIO_H__
+#define __ASYNCIO_H__
+
+#include "activeObject.h"
+#include "threadPool.h"
+#include "boostfwd.h"
+#include <boost/utility/string_ref.hpp>
+#include <functional>
+#include <future>
+
+namespace condor2nav {
+
+  /**
+   * @brief Asynchronous I/O scheduler.
+   *
+   * condor2nav::CAsyncIO class is the single entry point for file operations
+   * on local, ActiveSync and HTTP paths. Each operation is executed by
+   * the backend selected for the path and its result (or the exception)
+   * is provided with a future:
+   * - local files (including network shares) are processed in parallel
+   *   on a pool of I/O threads,
+   * - ActiveSync files are processed one after another on a dedicated
+   *   thread so RAPI calls are executed in the order they were sent
+   *   and callers never block on the RAPI connection,
+   * - HTTP downloads are executed on a separate pool so slow servers
+   *   do not hold the local I/O threads.
+   *
+   * Blocking helpers (i.e. condor2nav::FileExists()) wait for the future
+   * of the asynchronous operation.
+   */
+  class CAsyncIO : CNonCopyable {
+  public:
+    /**
+     * @brief Read data handler.
+     *
+     * @param data Pointer to the data block.
+     * @param size The size of the data block.
+     */
+    using CReadHandler = std::function<void(const char *data, std::size_t size)>;
+
+  private:
+    static const unsigned LOCAL_BLOCK_SIZE = 64 * 1024;  ///< @brief Local files read block size. 
+    static const unsigned HTTP_THREADS = 2;      ///< @brief Number of concurrent HTTP downloads. 
+
+    CThreadPool _local;                          ///< @brief Local files backend. 
+    CThreadPool _http;                           ///< @brief HTTP backend. 
+    CActiveObject _rapi;                         ///< @brief ActiveSync backend (serializes RAPI calls). 
+
+    CAsyncIO();
+
+    /**
+     * @brief Sends the operation to the ActiveSync thread.
+     *
+     * @param func Operation to run.
+     *
+     * @return The future result of the operation.
+     */
+    template<typename F>
+    auto Serialize(F func) -> std::future<decltype(func())>
+    {
+      using R = decltype(func());
+      auto task = std::make_shared<std::packaged_task<R()>>(std::move(func));
+      auto future = task->get_future();
+      _rapi.Send([task]{ (*task)(); });
+      return future;
+    }
+
+  public:
+    static CAsyncIO &Instance();
+    std::future<void> Read(const bfs::path &path, CReadHandler handler);
+    std::future<void> Read(const std::string &server, const bfs::path &url, unsigned timeout, CReadHandler handler);
+    std::future<void> Write(const bfs::path &path, boost::string_ref data);
+    std::future<bool> Exists(const bfs::path &path);
+    std::future<void> DirectoryCreate(const bfs::path &path);
+  };
+
+}
+
+#endif /* __ASYNCIO_H__ */
@@ -0,0 +1,551 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file benchmarks/main.cpp
+ *
+ * @brief Implements Condor2Nav performance benchmarks.
+ *
+ * Benchmarks measure the throughput and the number of memory allocations of
+ * the parsers, converters and I/O classes used by the translation. All the
+ * inputs are synthetic and generated with a fixed seed in a temporary working
+ * directory so the results of different builds can be compared. HTTP
+ * downloads are served by a local server.
+ */
+
+#include "condor2nav.h"
+#include "condor.h"
+#include "fileParserCSV.h"
+#include "fileParserINI.h"
+#include "httpClient.h"
+#include "lkMapsDB.h"
+#include "ostream.h"
+#include "waitQueue.h"
+#include "testSupport/testSupport.h"
+#include <boost/asio/ip/tcp.hpp>
+#include "tools.h"        // has to be included after boost/asio
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+  using condor2nav::test::allocations;
+  using condor2nav::test::allocatedBytes;
+  using condor2nav::test::FileWrite;
+
+  volatile std::size_t sink;                            ///< @brief Results of benchmarked code (prevents optimizing it out)
+
+  const unsigned SEED = 2012;                           ///< @brief Seed of all synthetic inputs
+  const unsigned FPL_TURNPOINTS = 100;
+  const unsigned FPL_PENALTY_ZONES = 1000;
+  const unsigned CSV_ROWS = 20000;
+  const unsigned CONDOR_LANDSCAPES = 200;
+  const unsigned LK8000_TEMPLATES = 5000;
+  const unsigned CONVERSIONS = 100000;
+  const unsigned OSTREAM_LINES = 100000;
+  const unsigned QUEUE_ITEMS = 1000000;
+  const std::size_t HTTP_BODY_SIZE = 8 * 1024 * 1024;
+
+
+  /**
+   * @brief Prints benchmarks usage.
+   */
+  void Usage()
+  {
+    std::cout << "Usage: condor2nav-bench [FILTER...]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Runs benchmarks which names contain any of provided filters (or all of them)." << std::endl;
+  }
+
+
+  /**
+   * @brief Benchmarks runner.
+   *
+   * Every benchmark is run once to warm up the caches and then the requested
+   * number of times. Its time and memory allocations are reported per iteration
+   * together with the throughput of processed bytes or items.
+   */
+  class CRunner {
+  public:
+    /**
+     * @brief Units of benchmark throughput.
+     */
+    enum class TUnit {
+      BYTES,                ///< @brief Processed data size
+      ITEMS                 ///< @brief Processed elements
+    };
+
+  private:
+    std::vector<std::string> _filters;      ///< @brief Names filters
+
+  public:
+    explicit CRunner(std::vector<std::string> filters) : _filters{std::move(filters)}
+    {
+      std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+                << std::setw(12) << "ms/iter" << std::setw(16) << "throughput"
+                << std::setw(14) << "allocs/iter" << std::setw(14) << "KB/iter" << std::endl;
+    }
+
+    /**
+     * @brief Checks if a benchmark should be run.
+     *
+     * @param name Benchmark name.
+     *
+     * @return @p true if the benchmark is enabled.
+     */
+    bool Enabled(const std::string &name) const
+    {
+      return _filters.empty() || std::any_of(_filters.begin(), _filters.end(), [&](const std::string &f){ return name.find(f) != std::string::npos; });
+    }
+
+    /**
+     * @brief Runs a benchmark.
+     *
+     * @param name       Benchmark name.
+     * @param iterations The number of measured iterations.
+     * @param unit       Throughput unit.
+     * @param amount     The number of bytes or items processed in one iteration.
+     * @param func       Benchmarked code.
+     */
+    template<class Func>
+    void Run(const std::string &name, unsigned iterations, TUnit unit, double amount, Func func) const
+    {
+      if(!Enabled(name))
+        return;
+
+      func();
+      const auto allocStart = allocations.load();
+      const auto bytesStart = allocatedBytes.load();
+      const auto start = std::chrono::high_resolution_clock::now();
+      for(unsigned i=0; i<iterations; i++)
+        func();
+      const auto end = std::chrono::high_resolution_clock::now();
+      const auto allocCount = allocations.load() - allocStart;
+      const auto bytesCount = allocatedBytes.load() - bytesStart;
+
+      const double seconds = std::chrono::duration<double>(end - start).count() / iterations;
+      std::ostringstream throughput;
+      throughput << std::fixed << std::setprecision(1);
+      if(unit == TUnit::BYTES)
+        throughput << amount / seconds / (1024 * 1024) << " MB/s";
+      else
+        throughput << amount / seconds / 1000 << " k/s";
+      std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(3)
+                << std::setw(12) << seconds * 1000 << std::setw(16) << throughput.str() << std::setprecision(1)
+                << std::setw(14) << static_cast<double>(allocCount) / iterations
+                << std::setw(14) << static_cast<double>(bytesCount) / iterations / 1024 << std::endl;
+    }
+  };
+
+
+  /**
+   * @brief Generates Condor task file with many turnpoints and penalty zones.
+   *
+   * @param rand Random numbers generator.
+   *
+   * @return File content.
+   */
+  std::string FPLGenerate(std::mt19937 &rand)
+  {
+    std::uniform_real_distribution<float> pos{0, 400000};
+    std::ostringstream fpl;
+    fpl << "[Version]\r\nCondor version=1120\r\n\r\n";
+    fpl << "[Task]\r\nLandscape=Benchmark\r\nCount=" << FPL_TURNPOINTS << "\r\n";
+    for(unsigned i=0; i<FPL_TURNPOINTS; i++) {
+      fpl << "TPName" << i << "=Turnpoint " << i << "\r\n";
+      fpl << "TPPosX" << i << "=" << pos(rand) << "\r\n";
+      fpl << "TPPosY" << i << "=" << pos(rand) << "\r\n";
+      fpl << "TPPosZ" << i << "=" << pos(rand) / 1000 << "\r\n";
+      fpl << "TPAirport" << i << "=0\r\n";
+      fpl << "TPSectorType" << i << "=0\r\n";
+      fpl << "TPRadius" << i << "=3000\r\n";
+      fpl << "TPAngle" << i << "=90\r\n";
+      fpl << "TPAltitude" << i << "=500\r\n";
+      fpl << "TPWidth" << i << "=0\r\n";
+      fpl << "TPHeight" << i << "=0\r\n";
+      fpl << "TPAzimuth" << i << "=0\r\n";
+    }
+    fpl << "PZCount=" << FPL_PENALTY_ZONES << "\r\n";
+    for(unsigned i=0; i<FPL_PENALTY_ZONES; i++) {
+      for(unsigned c=0; c<4; c++) {
+        fpl << "PZPos" << c << "X" << i << "=" << pos(rand) << "\r\n";
+        fpl << "PZPos" << c << "Y" << i << "=" << pos(rand) << "\r\n";
+      }
+      fpl << "PZBase" << i << "=0\r\n";
+      fpl << "PZTop" << i << "=2000\r\n";
+    }
+    fpl << "\r\n[Plane]\r\nName=ASW28\r\nSkin=Default\r\n\r\n";
+    fpl << "[Weather]\r\nWindDir=270\r\nWindSpeed=5\r\nWindUpperSpeed=10\r\n";
+    return fpl.str();
+  }
+
+
+  /**
+   * @brief Generates big CSV database.
+   *
+   * @param rand Random numbers generator.
+   *
+   * @return File content.
+   */
+  std::string CSVGenerate(std::mt19937 &rand)
+  {
+    std::uniform_int_distribution<int> value{0, 100000};
+    std::ostringstream csv;
+    csv << "Name,Value1,Value2,Value3,Value4,Value5,Value6,Description\n";
+    for(unsigned i=0; i<CSV_ROWS; i++)
+      csv << "Row" << i << "," << value(rand) << "," << value(rand) << "," << value(rand) << "," << value(rand) << ","
+          << value(rand) << "," << value(rand) << ",Description of row " << i << "\n";
+    return csv.str();
+  }
+
+
+  /**
+   * @brief Local HTTP/1.1 server.
+   *
+   * Server provides the same content for every request on keep-alive
+   * connections. Content is sent in chunks if the path starts with
+   * '/chunked'. Connections are served one at a time and are closed
+   * after a second of inactivity.
+   */
+  class CHttpServer : condor2nav::CNonCopyable {
+    static const unsigned IDLE_TIMEOUT = 1;               ///< @brief Idle connection timeout [s]
+    static const unsigned RESPONSE_TIMEOUT = 30;          ///< @brief Response sending timeout [s]
+    static const std::size_t CHUNK_SIZE = 64 * 1024;      ///< @brief The size of one chunk of chunked content
+
+    boost::asio::io_service _service;
+    boost::asio::ip::tcp::acceptor _acceptor;
+    std::string _response;                                ///< @brief Response with content length provided
+    std::string _chunkedResponse;                         ///< @brief Response with chunked content
+    std::atomic<bool> _stop;
+    std::thread _thread;
+
+    void Serve()
+    {
+      while(!_stop) {
+        boost::asio::ip::tcp::iostream stream;
+        boost::system::error_code error;
+        _acceptor.accept(*stream.rdbuf(), error);
+        if(error || _stop)
+          return;
+        for(;;) {
+          stream.expires_from_now(boost::posix_time::seconds(IDLE_TIMEOUT));
+          std::string request;
+          std::string line;
+          if(!std::getline(stream, request))
+            break;
+          while(std::getline(stream, line) && line != "\r")
+            ;
+          if(!stream)
+            break;
+          stream.expires_from_now(boost::posix_time::seconds(RESPONSE_TIMEOUT));
+          const auto &response = request.find("GET /chunked") == 0 ? _chunkedResponse : _response;
+          stream.write(response.data(), response.size());
+          stream.flush();
+        }
+      }
+    }
+
+  public:
+    explicit CHttpServer(const std::string &content) :
+      _acceptor{_service, boost::asio::ip::tcp::endpoint{boost::asio::ip::address_v4::loopback(), 0}}, _stop{false}
+    {
+      _response = "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: " + condor2nav::Convert(content.size()) +
+                  "\r\nConnection: keep-alive\r\n\r\n" + content;
+
+      std::ostringstream chunked;
+      chunked << "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nTransfer-Encoding: chunked\r\nConnection: keep-alive\r\n\r\n";
+      for(std::size_t pos=0; pos<content.size(); pos+=CHUNK_SIZE) {
+        const auto size = std::min(CHUNK_SIZE, content.size() - pos);
+        chunked << std::hex << size << "\r\n";
+        chunked.write(content.data() + pos, size);
+        chunked << "\r\n";
+      }
+      chunked << "0\r\n\r\n";
+      _chunkedResponse = chunked.str();
+
+      _thread = std::thread{[this]{ Serve(); }};
+    }
+
+    ~CHttpServer()
+    {
+      // wake up the server waiting for a new connection
+      _stop = true;
+      boost::asio::ip::tcp::iostream wakeup{"127.0.0.1", Server().substr(Server().find(':') + 1)};
+      _thread.join();
+    }
+
+    std::string Server() const { return "127.0.0.1:" + condor2nav::Convert(static_cast<unsigned>(_acceptor.local_endpoint().port())); }
+  };
+
+  const std::size_t CHttpServer::CHUNK_SIZE;
+
+
+  /**
+   * @brief Runs all benchmarks.
+   *
+   * @param runner Benchmarks runner.
+   */
+  void BenchmarksRun(const CRunner &runner)
+  {
+    using TUnit = CRunner::TUnit;
+    using namespace condor2nav;
+    std::mt19937 rand{SEED};
+
+    // INI and FPL files
+    const bfs::path fplPath = "Benchmark.fpl";
+    const auto fplSize = FileWrite(fplPath, FPLGenerate(rand));
+    runner.Run("CFileParserINI FPL parse", 50, TUnit::BYTES, fplSize, [&]{ sink = CFileParserINI{fplPath}.Value("Task", "Count").size(); });
+    runner.Run("condor::FPLSummary", 200, TUnit::BYTES, fplSize, [&]{ sink = condor::FPLSummary(fplPath).tpCount; });
+    {
+      const CFileParserINI fpl{fplPath};
+      runner.Run("CFileParserINI FPL task values", 50, TUnit::ITEMS, FPL_TURNPOINTS * 12 + FPL_PENALTY_ZONES * 10, [&]
+      {
+        std::size_t sum = 0;
+        for(unsigned i=0; i<FPL_TURNPOINTS; i++) {
+          const auto idx = Convert(i);
+          for(const char *key : {"TPName", "TPPosX", "TPPosY", "TPPosZ", "TPAirport", "TPSectorType",
+                                 "TPRadius", "TPAngle", "TPAltitude", "TPWidth", "TPHeight", "TPAzimuth"})
+            sum += fpl.Value("Task", key + idx).size();
+        }
+        for(unsigned i=0; i<FPL_PENALTY_ZONES; i++) {
+          const auto idx = Convert(i);
+          for(unsigned c=0; c<4; c++) {
+            sum += fpl.Value("Task", "PZPos" + Convert(c) + "X" + idx).size();
+            sum += fpl.Value("Task", "PZPos" + Convert(c) + "Y" + idx).size();
+          }
+          sum += fpl.Value("Task", "PZBase" + idx).size();
+          sum += fpl.Value("Task", "PZTop" + idx).size();
+        }
+        sink = sum;
+      });
+    }
+
+    // CSV files
+    const bfs::path csvPath = "Benchmark.csv";
+    const auto csvSize = FileWrite(csvPath, CSVGenerate(rand));
+    runner.Run("CFileParserCSV parse", 20, TUnit::BYTES, csvSize, [&]{ sink = CFileParserCSV{csvPath}.Rows().size(); });
+    {
+      const CFileParserCSV csv{csvPath};
+      std::vector<std::string> names;
+      for(unsigned i=0; i<CSV_ROWS; i+=7)
+        names.push_back("row" + Convert(i));
+      runner.Run("CFileParserCSV Row nocase", 20, TUnit::ITEMS, static_cast<double>(names.size()), [&]
+      {
+        std::size_t sum = 0;
+        for(const auto &name : names)
+          sum += csv.Row(name, 0, true).size();
+        sink = sum;
+      });
+    }
+
+    // conversions
+    {
+      std::uniform_real_distribution<double> coord{-180, 180};
+      std::vector<std::string> doubles, ints;
+      std::vector<double> values;
+      for(unsigned i=0; i<CONVERSIONS; i++) {
+        values.push_back(coord(rand));
+        doubles.push_back(Convert(values.back()));
+        ints.push_back(Convert(static_cast<int>(values.back() * 1000)));
+      }
+      runner.Run("Convert<double>", 10, TUnit::ITEMS, CONVERSIONS, [&]
+      {
+        double sum = 0;
+        for(const auto &str : doubles)
+          sum += Convert<double>(str);
+        sink = static_cast<std::size_t>(sum);
+      });
+      runner.Run("Convert<int>", 10, TUnit::ITEMS, CONVERSIONS, [&]
+      {
+        int sum = 0;
+        for(const auto &str : ints)
+          sum += Convert<int>(str);
+        sink = static_cast<std::size_t>(sum);
+      });
+      runner.Run("Convert(double)", 10, TUnit::ITEMS, CONVERSIONS, [&]
+      {
+        std::size_t sum = 0;
+        for(auto v : values)
+          sum += Convert(v).size();
+        sink = sum;
+      });
+      runner.Run("Coord2DDMMFF", 10, TUnit::ITEMS, CONVERSIONS * 2, [&]
+      {
+        std::size_t sum = 0;
+        for(auto v : values)
+          sum += Coord2DDMMFF(TLongitude{v}).size() + Coord2DDMMFF(TLatitude{v / 2}).size();
+        sink = sum;
+      });
+      runner.Run("Coord2DDMMSS", 10, TUnit::ITEMS, CONVERSIONS * 2, [&]
+      {
+        std::size_t sum = 0;
+        for(auto v : values)
+          sum += Coord2DDMMSS(TLongitude{v}).size() + Coord2DDMMSS(TLatitude{v / 2}).size();
+        sink = sum;
+      });
+      runner.Run("Coord2DDMMSS append", 10, TUnit::ITEMS, CONVERSIONS * 2, [&]
+      {
+        std::string str;
+        for(auto v : values) {
+          str.clear();
+          Coord2DDMMSS(TLongitude{v}, str);
+          Coord2DDMMSS(TLatitude{v / 2}, str);
+        }
+        sink = str.size();
+      });
+      runner.Run("Coord2DDMMFF buffer", 10, TUnit::ITEMS, CONVERSIONS * 2, [&]
+      {
+        char buffer[COORD_STR_MAX_LENGTH];
+        std::size_t sum = 0;
+        for(auto v : values)
+          sum += (Coord2DDMMFF(TLongitude{v}, buffer) - buffer) + (Coord2DDMMFF(TLatitude{v / 2}, buffer) - buffer);
+        sink = sum;
+      });
+      runner.Run("CupLatitude", 10, TUnit::ITEMS, CONVERSIONS, [&]
+      {
+        double sum = 0;
+        for(std::size_t i=0; i<CONVERSIONS; i++)
+          sum += CupLatitude(i % 2 ? "5107.830N" : "3412.005S").value;
+        sink = static_cast<std::size_t>(sum);
+      });
+    }
+
+    // output streams
+    {
+      const bfs::path outPath = "Benchmark.out";
+      const std::string line{"1,45:12:34N,012:34:56E,123M,T,Turnpoint name,Comment\r\n"};
+      runner.Run("COStream write and commit", 10, TUnit::BYTES, static_cast<double>(line.size()) * OSTREAM_LINES, [&]
+      {
+        COStream stream{outPath};
+        for(unsigned i=0; i<OSTREAM_LINES; i++)
+          stream << line;
+        stream.Commit();
+      });
+      runner.Run("COStream formatted write and commit", 10, TUnit::ITEMS, OSTREAM_LINES, [&]
+      {
+        COStream stream{outPath};
+        for(unsigned i=0; i<OSTREAM_LINES; i++)
+          stream << i << "," << i * 0.25 << ",Turnpoint " << i << "\r\n";
+        stream.Commit();
+      });
+    }
+
+    // wait queues
+    runner.Run("CWaitQueue PopWait", 3, TUnit::ITEMS, QUEUE_ITEMS, [&]
+    {
+      CWaitQueue<unsigned> queue;
+      std::thread producer{[&]{ for(unsigned i=0; i<QUEUE_ITEMS; i++) queue.Push(i); }};
+      std::size_t sum = 0;
+      for(unsigned i=0; i<QUEUE_ITEMS; i++)
+        sum += queue.PopWait();
+      producer.join();
+      sink = sum;
+    });
+    runner.Run("CWaitQueue PopAllWait", 3, TUnit::ITEMS, QUEUE_ITEMS, [&]
+    {
+      CWaitQueue<unsigned> queue;
+      std::thread producer{[&]{ for(unsigned i=0; i<QUEUE_ITEMS; i++) queue.Push(i); }};
+      std::size_t sum = 0;
+      for(unsigned received=0; received<QUEUE_ITEMS; ) {
+        auto items = queue.PopAllWait();
+        received += static_cast<unsigned>(items.size());
+        for(; !items.empty(); items.pop())
+          sum += items.front();
+      }
+      producer.join();
+      sink = sum;
+    });
+
+    // LK8000 maps matching
+    if(runner.Enabled("CLKMapsDB")) {
+      const auto templates = test::LandscapesGenerate(CONDOR_LANDSCAPES, LK8000_TEMPLATES, rand);
+      const test::CTestApp app;
+      CLKMapsDB db{app};
+      runner.Run("CLKMapsDB LandscapesMatch cold", 3, TUnit::ITEMS, LK8000_TEMPLATES, [&]
+      {
+        bfs::remove("data/Landscapes.cat");
+        bfs::remove("data/LK8000/LKMTemplates.cat");
+        sink = db.LandscapesMatch(templates).size();
+      });
+      runner.Run("CLKMapsDB LandscapesMatch catalogued", 20, TUnit::ITEMS, LK8000_TEMPLATES, [&]{ sink = db.LandscapesMatch(templates).size(); });
+    }
+
+    // HTTP downloads
+    if(runner.Enabled("CHttpClient")) {
+      std::string content(HTTP_BODY_SIZE, '\0');
+      std::uniform_int_distribution<int> byte{0, 255};
+      for(auto &c : content)
+        c = static_cast<char>(byte(rand));
+      const CHttpServer server{content};
+      for(const char *url : {"/file.bin", "/chunked/file.bin"}) {
+        runner.Run(std::string{"CHttpClient Get "} + url, 10, TUnit::BYTES, HTTP_BODY_SIZE, [&]
+        {
+          std::size_t received = 0;
+          CHttpClient::Instance().Get(server.Server(), url, 30, 0, [&](std::uint64_t, const char *, std::size_t size){ received += size; });
+          if(received != HTTP_BODY_SIZE)
+            throw EOperationFailed{"ERROR: Invalid size of '" + std::string{url} + "' content!!!"};
+          sink = received;
+        });
+      }
+    }
+  }
+
+}
+
+
+int main(int argc, const char *argv[])
+{
+  std::vector<std::string> filters;
+  for(int i=1; i<argc; i++) {
+    if(argv[i][0] == '-') {
+      Usage();
+      return EXIT_FAILURE;
+    }
+    filters.emplace_back(argv[i]);
+  }
+
+  int status = EXIT_SUCCESS;
+  try {
+    const condor2nav::test::CWorkDir workDir{"condor2nav-bench"};
+    const condor2nav::test::CCurrentDir currentDir{workDir.Path()};
+    FileWrite(condor2nav::test::CTestApp::CONFIG_FILE_NAME, "[Condor2Nav]\r\n");
+
+    CRunner runner{std::move(filters)};
+    BenchmarksRun(runner);
+  }
+  catch(const std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  return status;
+}
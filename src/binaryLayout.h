@@ -0,0 +1,189 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file binaryLayout.h
+ *
+ * @brief Compile-time described binary records layouts.
+ */
+
+#ifndef __BINARY_LAYOUT_H__
+#define __BINARY_LAYOUT_H__
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+namespace condor2nav {
+
+  /**
+   * @brief Compile-time described binary records layouts.
+   *
+   * Binary files (e.g. XCSoar task files) are the dumps of the application
+   * memory. Their layouts are described here as a list of fields and sections
+   * so that one serializer with a size known during compilation writes the
+   * whole file into a preallocated buffer in a single pass.
+   */
+  namespace layout {
+
+    /**
+     * @brief Sum of the sizes of the layout elements.
+     */
+    template<typename... Elements>
+    struct TSize;
+
+    template<>
+    struct TSize<> {
+      enum : size_t { value = 0 };
+    };
+
+    template<typename Element, typename... Elements>
+    struct TSize<Element, Elements...> {
+      enum : size_t { value = Element::size + TSize<Elements...>::value };
+    };
+
+
+    /**
+     * @brief Structure field written as raw bytes.
+     *
+     * @tparam Class  The type of the structure.
+     * @tparam Type   The type of the field.
+     * @tparam Member The field to write.
+     */
+    template<typename Class, typename Type, Type Class::*Member>
+    struct TField {
+      enum : size_t { size = sizeof(Type) };
+      static void Write(char *&out, const Class &obj)
+      {
+        memcpy(out, &(obj.*Member), size);
+        out += size;
+      }
+    };
+
+
+    /**
+     * @brief Packed structure record.
+     *
+     * Only the listed fields are written one after the other (without any
+     * padding between them).
+     *
+     * @tparam Class  The type of the structure.
+     * @tparam Fields The fields to write (condor2nav::layout::TField).
+     */
+    template<typename Class, typename... Fields>
+    struct TRecord {
+      enum : size_t { size = TSize<Fields...>::value };
+      static void Write(char *&out, const Class &obj)
+      {
+        int expand[] = { 0, (Fields::Write(out, obj), 0)... };
+        (void)expand;
+      }
+    };
+
+
+    /**
+     * @brief Fixed size array of structures written as raw bytes.
+     *
+     * @tparam T The type of the array element.
+     * @tparam N The number of elements.
+     */
+    template<typename T, unsigned N>
+    struct TArray {
+      enum : size_t { size = N * sizeof(T) };
+      static void Write(char *&out, const T array[])
+      {
+        memcpy(out, array, size);
+        out += size;
+      }
+    };
+
+
+    /**
+     * @brief Fixed size array of structures filled with the provided records.
+     *
+     * Elements for which no record is provided are left zeroed.
+     *
+     * @tparam T The type of the array element.
+     * @tparam N The number of elements.
+     */
+    template<typename T, unsigned N>
+    struct TRecords {
+      enum : size_t { size = N * sizeof(T) };
+      static void Write(char *&out, const std::vector<T> &records)
+      {
+        memcpy(out, records.data(), std::min<size_t>(records.size(), N) * sizeof(T));
+        out += size;
+      }
+    };
+
+
+    /**
+     * @brief Fixed size text.
+     *
+     * The text is truncated or padded with zeros to the required size.
+     *
+     * @tparam N The size of the text.
+     */
+    template<unsigned N>
+    struct TString {
+      enum : size_t { size = N };
+      static void Write(char *&out, const std::string &str)
+      {
+        memcpy(out, str.data(), std::min<size_t>(str.size(), N));
+        out += size;
+      }
+    };
+
+
+    /**
+     * @brief Binary file layout.
+     *
+     * @tparam Sections The file sections in the order of writing.
+     */
+    template<typename... Sections>
+    struct TFile {
+      enum : size_t { size = TSize<Sections...>::value };
+
+      /**
+       * @brief Serializes the file.
+       *
+       * @param args The data of each section (in the order of sections).
+       *
+       * @return Zero initialized buffer of the file size filled with the data.
+       */
+      template<typename... Args>
+      static std::vector<char> Serialize(const Args &...args)
+      {
+        static_assert(sizeof...(Args) == sizeof...(Sections), "The data should be provided for each file section");
+        std::vector<char> buffer(static_cast<size_t>(size));
+        auto out = buffer.data();
+        int expand[] = { 0, (Sections::Write(out, args), 0)... };
+        (void)expand;
+        return buffer;
+      }
+    };
+
+  }
+
+}
+
+#endif /* __BINARY_LAYOUT_H__ */
@@ -0,0 +1,75 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file cancellation.h
+ *
+ * @brief Declares cooperative cancellation classes. 
+ */
+
+#ifndef __CANCELLATION_H__
+#define __CANCELLATION_H__
+
+#include "exception.h"
+#include <atomic>
+#include <memory>
+
+namespace condor2nav {
+
+  /**
+   * @brief Cancellation token.
+   *
+   * condor2nav::CCancellationToken class is provided to long running
+   * operations that should check periodically if they were cancelled.
+   * Default constructed token is never cancelled.
+   */
+  class CCancellationToken {
+    std::shared_ptr<const std::atomic<bool>> _flag;      ///< @brief Cancellation state shared with the source. 
+  public:
+    CCancellationToken() {}
+    explicit CCancellationToken(std::shared_ptr<const std::atomic<bool>> flag) : _flag{std::move(flag)} {}
+    bool Cancelled() const { return _flag && _flag->load(); }
+    void ThrowIfCancelled() const
+    {
+      if(Cancelled())
+        throw EOperationCancelled{"Operation cancelled!!!"};
+    }
+  };
+
+
+  /**
+   * @brief Cancellation source.
+   *
+   * condor2nav::CCancellationSource class creates cancellation tokens and
+   * cancels all of them at once. Copies of the source share its state.
+   */
+  class CCancellationSource {
+    std::shared_ptr<std::atomic<bool>> _flag;            ///< @brief Cancellation state. 
+  public:
+    CCancellationSource() : _flag{std::make_shared<std::atomic<bool>>(false)} {}
+    void Cancel() { _flag->store(true); }
+    bool Cancelled() const { return _flag->load(); }
+    CCancellationToken Token() const { return CCancellationToken{_flag}; }
+  };
+
+}
+
+#endif /* __CANCELLATION_H__ */
@@ -28,7 +28,106 @@
 #include "condor2navCLI.h"
 #include "translator.h"
 #include "condor.h"
+#include "fileWatcher.h"
+#include "namedPipe.h"
+#include "threadPool.h"
+#include "traitsNoCase.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
+
+
+const unsigned condor2nav::cli::CCondor2NavCLI::WATCH_DEBOUNCE;
+const unsigned condor2nav::cli::CCondor2NavCLI::CONNECT_TIMEOUT;
+const unsigned condor2nav::cli::CCondor2NavCLI::REQUEST_TIMEOUT;
+const char condor2nav::cli::CCondor2NavCLI::PIPE_NAME[] = "\\\\.\\pipe\\condor2nav";
+
+namespace {
+
+  condor2nav::CCancellationSource watchCancel;
+
+  std::mutex clientMutex;
+  condor2nav::CNamedPipe *client = nullptr;
+
+  /**
+   * @brief Translation server client scope.
+   *
+   * Traces logged during the scope are relayed to the connected client.
+   */
+  class CClientScope : condor2nav::CNonCopyable {
+  public:
+    explicit CClientScope(condor2nav::CNamedPipe &pipe)
+    {
+      std::lock_guard<std::mutex> lock{clientMutex};
+      client = &pipe;
+    }
+    ~CClientScope()
+    {
+      condor2nav::CCondor2Nav::CLogger::Flush();
+      std::lock_guard<std::mutex> lock{clientMutex};
+      client = nullptr;
+    }
+  };
+
+  /**
+   * @brief Console control events handler.
+   *
+   * Stops watch mode on Ctrl+C and Ctrl+Break.
+   *
+   * @param ctrlType Control event type.
+   *
+   * @return TRUE if the event was handled.
+   */
+  BOOL WINAPI ConsoleCtrlHandler(DWORD ctrlType)
+  {
+    if(ctrlType == CTRL_C_EVENT || ctrlType == CTRL_BREAK_EVENT) {
+      watchCancel.Cancel();
+      return TRUE;
+    }
+    return FALSE;
+  }
+
+  /**
+   * @brief Checks if the file name matches the mask.
+   *
+   * Mask may contain '*' (any characters sequence) and '?' (any character)
+   * wildcards. Letters are compared case insensitive.
+   *
+   * @param mask The mask to use.
+   * @param name The file name to check.
+   *
+   * @return @p true if the name matches the mask.
+   */
+  bool WildcardMatch(const char *mask, const char *name)
+  {
+    const char *star = nullptr;
+    const char *starName = nullptr;
+    while(*name) {
+      if(*mask == '*') {
+        star = mask++;
+        starName = name;
+      }
+      else if(*mask == '?' || (*mask && tolower(static_cast<unsigned char>(*mask)) == tolower(static_cast<unsigned char>(*name)))) {
+        mask++;
+        name++;
+      }
+      else if(star) {
+        mask = star + 1;
+        name = ++starName;
+      }
+      else
+        return false;
+    }
+    while(*mask == '*')
+      mask++;
+    return !*mask;
+  }
+
+}
 
 
 /**
@@ -43,6 +142,17 @@ condor2nav::cli::CCondor2NavCLI::CLogger::CLogger(TType type) :
 }
 
 
+/**
+ * @brief Class destructor.
+ *
+ * Waits for all pending traces to be dumped.
+ */
+condor2nav::cli::CCondor2NavCLI::CLogger::~CLogger()
+{
+  Flush();
+}
+
+
 /**
  * @brief Dumps the text to the console output. 
  *
@@ -52,16 +162,13 @@ condor2nav::cli::CCondor2NavCLI::CLogger::CLogger(TType type) :
  */
 void condor2nav::cli::CCondor2NavCLI::CLogger::Trace(const std::string &str) const
 {
-  switch(Type()) {
-  case TType::LOG_NORMAL:
-  case TType::LOG_HIGH:
-    std::cout << str;
-    break;
-  case TType::WARNING:
-  case TType::ERROR:
-    std::cerr << str;
-    break;
-  }
+  const bool error = Type() == TType::WARNING || Type() == TType::ERROR;
+  (error ? std::cerr : std::cout) << str;
+
+  // relay the trace to the translation server client
+  std::lock_guard<std::mutex> lock{clientMutex};
+  if(client)
+    client->Write((error ? "E" : "O") + Convert(static_cast<unsigned>(str.size())) + "\n" + str);
 }
 
 
@@ -77,6 +184,23 @@ condor2nav::cli::CCondor2NavCLI::CCondor2NavCLI() :
 }
 
 
+/**
+ * @brief Prints periodic download status line.
+ *
+ * Status reports of one download are serialized so no locking is needed.
+ *
+ * @param status Overall status of the current files download.
+ */
+void condor2nav::cli::CCondor2NavCLI::DownloadStatus(const CDownloader::TStatus &status) const
+{
+  const auto now = std::chrono::steady_clock::now();
+  if(!status.done && now - _statusReported < std::chrono::milliseconds{STATUS_INTERVAL})
+    return;
+  _statusReported = now;
+  Log() << "Download status: " << status.Summary() << std::endl;
+}
+
+
 /**
  * @brief Prints condor2nav executable usage help. 
  *
@@ -90,7 +214,7 @@ void condor2nav::cli::CCondor2NavCLI::Usage() const
   Log() << "and you are welcome to redistribute it under GNU GPL conditions." << std::endl;
   Log() << std::endl;
   Log() << "Usage:" << std::endl;
-  Log() << "  condor2nav.exe [-h|--aat <TASK_MIN_TIME>][--default|--last-race|<FPL_PATH>]" << std::endl;
+  Log() << "  condor2nav.exe [-h|--aat <TASK_MIN_TIME>][--local][--default|--last-race|--watch|--server|--sync|--batch <DIR|MASK>|<FPL_PATH>]" << std::endl;
   Log() << std::endl;
   Log() << "  -h                    - that help message" << std::endl;
   Log() << "  --aat <TASK_MIN_TIME> - convert a task as AAT with provided Task Minimum Time" << std::endl;
@@ -104,6 +228,23 @@ void condor2nav::cli::CCondor2NavCLI::Usage() const
   Log() << "                           task file on local disk. Join the race, exit after few" << std::endl;
   Log() << "                           seconds, run translation with --last-race option and" << std::endl;
   Log() << "                           join a race once again, but now with full PDA support)" << std::endl;
+  Log() << "  --watch               - wait for new task files saved by Condor and translate" << std::endl;
+  Log() << "                          each of them as soon as it is written" << std::endl;
+  Log() << "                          (Flight plans and race results directories are watched" << std::endl;
+  Log() << "                           until Ctrl+C is pressed)" << std::endl;
+  Log() << "  --server              - stay resident and serve translation requests of other" << std::endl;
+  Log() << "                          condor2nav-cli.exe runs until Ctrl+C is pressed" << std::endl;
+  Log() << "                          (Configuration, databases, coordinates converters and" << std::endl;
+  Log() << "                           ActiveSync connection stay loaded between requests)" << std::endl;
+  Log() << "  --local               - do not forward the translation to a running server" << std::endl;
+  Log() << "  --sync                - upload staged outputs of the last translation to" << std::endl;
+  Log() << "                          currently connected device" << std::endl;
+  Log() << "                          (Only files that differ from the ones on the device" << std::endl;
+  Log() << "                           are uploaded. Requires StagingPath in condor2nav.ini)" << std::endl;
+  Log() << "  --batch <DIR|MASK>    - translate all FPL files from the directory or matching" << std::endl;
+  Log() << "                          the file name mask (e.g. C:\\Tasks\\Day*.fpl)" << std::endl;
+  Log() << "                          (Every task is translated to the subdirectory of" << std::endl;
+  Log() << "                           the output directory named after the FPL file)" << std::endl;
   Log() << "  <FPL_PATH>            - full path to Condor FPL file" << std::endl;
   Log() << "                          (The same result can be achieved i.e. by drag-and-drop" << std::endl;
   Log() << "                           of FPL file in Windows Explorer onto condor2nav.exe icon)" << std::endl;
@@ -148,6 +289,23 @@ auto condor2nav::cli::CCondor2NavCLI::CLIParse(int argc, const char *argv[]) con
     else if(arg == "--last-race") {
       opt.fplType = TFPLType::RESULT;
     }
+    else if(arg == "--watch") {
+      opt.watch = true;
+    }
+    else if(arg == "--sync") {
+      opt.sync = true;
+    }
+    else if(arg == "--server") {
+      opt.server = true;
+    }
+    else if(arg == "--local") {
+      opt.local = true;
+    }
+    else if(arg == "--batch") {
+      if(i + 1 == argc || argv[i + 1][0] == '-')
+        throw EOperationFailed{"ERROR: Batch directory or mask not provided!!!"};
+      opt.batch = argv[++i];
+    }
     else if(arg[0] == '-') {
       throw EOperationFailed{"ERROR: Unkown option '" + arg + "' provided!!!"};
     }
@@ -217,22 +375,405 @@ int condor2nav::cli::CCondor2NavCLI::Run(int argc, const char *argv[]) const
 {
   // parse CLI options
   auto options = CLIParse(argc, argv);
+
+  // upload outputs of the previous translation
+  if(options.sync) {
+    CTranslator::Sync(*this, ConfigParser());
+    return EXIT_SUCCESS;
+  }
   
   // obtain Condor installation path
   auto condorPath = condor::InstallPath();
+
+  if(options.watch)
+    return Watch(condorPath, options.aatTime);
+
+  if(options.server)
+    return Serve(condorPath);
+
+  if(!options.batch.empty())
+    return Batch(condorPath, options.batch, options.aatTime);
   
   // create Condor FPL file path
   if(options.fplType != TFPLType::USER)
     options.fplPath = condor::FPLPath(ConfigParser(), options.fplType, condorPath);
 
-  // create Condor wrapper
-  CCondor condor{condorPath, options.fplPath};
-  if(!AATCheck(condor, options.aatTime))
-    return EXIT_FAILURE;
-
   // run translation
-  CTranslator translator{*this, ConfigParser(), condor, options.aatTime};
+  return Translate(condorPath, options.fplPath, options.aatTime) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/**
+ * @brief Translates one task file.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param fplPath    Full pathname of the FPL file.
+ * @param aatTime    AAT time provided from command line.
+ *
+ * @exception std Thrown when translation failed.
+ *
+ * @return @p false if the task cannot be translated.
+ */
+bool condor2nav::cli::CCondor2NavCLI::Translate(const bfs::path &condorPath, const bfs::path &fplPath, unsigned aatTime) const
+{
+  CCondor condor{condorPath, fplPath, NaviConPool()};
+  if(!AATCheck(condor, aatTime))
+    return false;
+
+  CTranslator translator{*this, ConfigParser(), condor, aatTime};
   translator.Run();
-  
+  return true;
+}
+
+
+/**
+ * @brief Runs watch mode.
+ *
+ * Method watches Condor flight plans and race results directories and translates
+ * every FPL file that was created or modified there. Configuration, CSV databases
+ * and ActiveSync connection are reused by all translations. Watching is stopped
+ * with Ctrl+C. The file has to remain unchanged for 'Condor/WatchDebounce' ms
+ * before the translation starts.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param aatTime    AAT time provided from command line.
+ *
+ * @exception std Thrown when directories cannot be watched.
+ *
+ * @return Application execution result.
+ */
+int condor2nav::cli::CCondor2NavCLI::Watch(const bfs::path &condorPath, unsigned aatTime) const
+{
+  unsigned debounce = WATCH_DEBOUNCE;
+  try {
+    debounce = Convert<unsigned>(ConfigParser().Value("Condor", "WatchDebounce"));
+  }
+  catch(const Exception &) {
+  }
+
+  const CFileWatcher::CPathList dirs{condor::FlightPlansPath(ConfigParser(), condorPath),
+                                     condor::RaceResultsPath(ConfigParser(), condorPath)};
+  CFileWatcher watcher{dirs, ".fpl", debounce};
+  SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE);
+
+  LogHigh() << "Watching '" << dirs[0].string() << "' and '" << dirs[1].string() << "' for new tasks (press Ctrl+C to exit)..." << std::endl;
+  try {
+    while(true) {
+      const auto fplPath = watcher.Wait(watchCancel.Token());
+      LogHigh() << "New task file '" << fplPath.string() << "' found" << std::endl;
+      if(fplPath.parent_path() == dirs[1])
+        condor::RaceResultAdded(dirs[1], fplPath);
+      try {
+        Translate(condorPath, fplPath, aatTime);
+      }
+      catch(const EOperationCancelled &) {
+        throw;
+      }
+      catch(const std::exception &ex) {
+        Error() << ex.what() << std::endl;
+      }
+    }
+  }
+  catch(const EOperationCancelled &) {
+    LogHigh() << "Watching stopped" << std::endl;
+  }
+
+  SetConsoleCtrlHandler(ConsoleCtrlHandler, FALSE);
   return EXIT_SUCCESS;
 }
+
+
+/**
+ * @brief Runs translation server mode.
+ *
+ * Method stays resident and translates tasks requested by other condor2nav-cli
+ * runs through a named pipe. Configuration, CSV databases, maps catalogues,
+ * coordinates converters and ActiveSync connection are loaded once and reused
+ * by all the requests, so a translation does not pay for the process startup.
+ * Requests are served one at a time and all traces of a request are relayed
+ * to its client. The server is stopped with Ctrl+C.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ *
+ * @exception std Thrown when the pipe cannot be created.
+ *
+ * @return Application execution result.
+ */
+int condor2nav::cli::CCondor2NavCLI::Serve(const bfs::path &condorPath) const
+{
+  CNamedPipe pipe{PIPE_NAME};
+  SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE);
+
+  LogHigh() << "Waiting for translation requests on '" << PIPE_NAME << "' (press Ctrl+C to exit)..." << std::endl;
+  try {
+    while(true) {
+      pipe.Accept(watchCancel.Token());
+      try {
+        // a client that does not send its request in time does not block the others
+        std::string request;
+        if(pipe.ReadLine(request, watchCancel.Token(), REQUEST_TIMEOUT)) {
+          int status;
+          {
+            CClientScope scope{pipe};
+            status = Request(condorPath, request);
+          }
+          pipe.Write("X" + Convert(status) + "\n");
+        }
+      }
+      catch(const EOperationFailed &ex) {
+        Error() << ex.what() << std::endl;
+      }
+      pipe.Disconnect();
+    }
+  }
+  catch(const EOperationCancelled &) {
+    LogHigh() << "Translation server stopped" << std::endl;
+  }
+
+  SetConsoleCtrlHandler(ConsoleCtrlHandler, FALSE);
+  return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Serves one translation request.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param request    Command line arguments of the client separated with tabs.
+ *
+ * @return Client execution result.
+ */
+int condor2nav::cli::CCondor2NavCLI::Request(const bfs::path &condorPath, const std::string &request) const
+{
+  // tabs are not allowed in Windows paths so they separate the arguments
+  std::vector<std::string> args{"condor2nav-cli"};
+  for(std::string::size_type begin = 0, end; !request.empty() && begin <= request.size(); begin = end + 1) {
+    end = std::min(request.find('\t', begin), request.size());
+    args.emplace_back(request, begin, end - begin);
+  }
+  std::vector<const char *> argv;
+  for(const auto &arg : args)
+    argv.push_back(arg.c_str());
+
+  try {
+    if(std::find(args.begin(), args.end(), "-h") != args.end())
+      throw EOperationFailed{"ERROR: Help cannot be requested from the translation server!!!"};
+    auto options = CLIParse(static_cast<int>(argv.size()), argv.data());
+    if(options.watch || options.server || !options.batch.empty())
+      throw EOperationFailed{"ERROR: Only single task translations are served by the translation server!!!"};
+
+    if(options.sync) {
+      CTranslator::Sync(*this, ConfigParser());
+      return EXIT_SUCCESS;
+    }
+    if(options.fplType != TFPLType::USER)
+      options.fplPath = condor::FPLPath(ConfigParser(), options.fplType, condorPath);
+    LogHigh() << "Translation of '" << options.fplPath.string() << "' requested" << std::endl;
+    return Translate(condorPath, options.fplPath, options.aatTime) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  catch(const std::exception &ex) {
+    Error() << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+
+/**
+ * @brief Forwards the translation to a running translation server.
+ *
+ * Single task translations and synchronizations are forwarded to a server
+ * started with '--server' option, if one is running. Traces of the server are
+ * printed on the console. Relative FPL file paths are resolved before sending.
+ *
+ * @param argc         Number of command-line arguments.
+ * @param argv         Array of command-line argument strings.
+ * @param [out] status Execution result of the translation.
+ *
+ * @exception std Thrown when the server disconnected during the translation.
+ *
+ * @return @p true if the translation was done by the server.
+ */
+bool condor2nav::cli::CCondor2NavCLI::Forward(int argc, const char *argv[], int &status)
+{
+  std::string request;
+  for(int i = 1; i < argc; i++) {
+    std::string arg{argv[i]};
+    if(arg == "-h" || arg == "--watch" || arg == "--server" || arg == "--batch" || arg == "--local")
+      return false;
+    if(arg == "--aat" && i + 1 < argc)
+      arg += "\t" + std::string{argv[++i]};
+    else if(!arg.empty() && arg[0] != '-')
+      arg = bfs::absolute(arg).string();
+    request += (request.empty() ? "" : "\t") + arg;
+  }
+
+  auto pipe = CNamedPipe::Connect(PIPE_NAME, CONNECT_TIMEOUT);
+  if(!pipe || !pipe->Write(request + "\n"))
+    return false;
+
+  // relay server traces until the execution result arrives
+  std::string header;
+  while(pipe->ReadLine(header) && !header.empty()) {
+    if(header[0] == 'X') {
+      status = Convert<int>(header.substr(1));
+      return true;
+    }
+    std::string text;
+    if(!pipe->Read(Convert<unsigned>(header.substr(1)), text))
+      break;
+    (header[0] == 'E' ? std::cerr : std::cout) << text;
+  }
+  throw EOperationFailed{"ERROR: Translation server disconnected during the translation!!!"};
+}
+
+
+/**
+ * @brief Finds batch translation task files.
+ *
+ * @param pattern Directory with FPL files or FPL file path with a name mask.
+ *
+ * @exception std Thrown when the directory cannot be read.
+ *
+ * @return Sorted list of found FPL files.
+ */
+std::vector<bfs::path> condor2nav::cli::CCondor2NavCLI::BatchFiles(const bfs::path &pattern) const
+{
+  bfs::path dir = pattern;
+  std::string mask = "*.fpl";
+  if(!bfs::is_directory(pattern)) {
+    dir = pattern.has_parent_path() ? pattern.parent_path() : bfs::path{"."};
+    mask = pattern.filename().string();
+  }
+  if(!bfs::is_directory(dir))
+    throw EOperationFailed{"ERROR: Batch directory '" + dir.string() + "' not found!!!"};
+
+  std::vector<bfs::path> files;
+  for(bfs::directory_iterator it{dir}, end; it != end; ++it) {
+    const auto name = it->path().filename().string();
+    if(bfs::is_regular_file(it->status()) && CStringNoCase{it->path().extension().string().c_str()} == ".fpl" &&
+       WildcardMatch(mask.c_str(), name.c_str()))
+      files.push_back(it->path());
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+
+/**
+ * @brief Runs batch translation.
+ *
+ * Method translates all the FPL files found with the provided pattern. Every
+ * task is translated to the subdirectory (named after the FPL file) of the
+ * configured targets output directories. Configuration and CSV databases
+ * are reused by all translations. Tasks are grouped by landscape so that
+ * coordinates converter of each landscape is initialized only once and
+ * shared by all its tasks. Translations run concurrently on a thread pool
+ * sized to the number of CPU cores. If NaviCon.dll workers are enabled,
+ * coordinates of different landscapes are converted in parallel too.
+ * Staged outputs are uploaded once after all the translations finished.
+ * A summary is reported at the end.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param pattern    Directory with FPL files or FPL file path with a name mask.
+ * @param aatTime    AAT time provided from command line.
+ *
+ * @exception std Thrown when no task files were found.
+ *
+ * @return Application execution result.
+ */
+int condor2nav::cli::CCondor2NavCLI::Batch(const bfs::path &condorPath, const bfs::path &pattern, unsigned aatTime) const
+{
+  using CClock = std::chrono::steady_clock;
+  const auto start = CClock::now();
+
+  const auto files = BatchFiles(pattern);
+  if(files.empty())
+    throw EOperationFailed{"ERROR: No FPL files found with '" + pattern.string() + "'!!!"};
+
+  struct TResult {
+    std::string error;
+    double time;
+  };
+  std::vector<TResult> results(files.size());
+
+  // parse all the tasks and share one coordinates converter between the tasks of the same landscape
+  std::vector<std::unique_ptr<CCondor>> condors(files.size());
+  std::map<std::string, std::vector<size_t>> landscapes;
+  for(size_t i=0; i<files.size(); i++) {
+    try {
+      condors[i] = std::make_unique<CCondor>(condorPath, files[i], NaviConPool());
+      landscapes[condors[i]->TaskParser().Value("Task", "Landscape")].push_back(i);
+    }
+    catch(const std::exception &ex) {
+      results[i].error = ex.what();
+    }
+  }
+  for(const auto &landscape : landscapes) {
+    const auto &tasks = landscape.second;
+    const auto converter = condors[tasks.front()]->CoordConverterShared();
+    for(size_t i=1; i<tasks.size(); i++)
+      condors[tasks[i]]->CoordConverterShare(converter);
+  }
+
+  const auto workers = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned>(files.size())));
+  LogHigh() << "Translating " << files.size() << " tasks of " << landscapes.size() << " landscapes with " << workers << " workers..." << std::endl;
+  {
+    CThreadPool pool{workers};
+    std::vector<std::future<void>> futures;
+    futures.reserve(files.size());
+    for(const auto &landscape : landscapes) {
+      for(const auto i : landscape.second) {
+        futures.push_back(pool.Send([&, i]
+        {
+          const auto taskStart = CClock::now();
+          try {
+            auto time = aatTime;
+            if(!AATCheck(*condors[i], time))
+              throw EOperationFailed{"ERROR: Corrupted condor-club task file!!!"};
+            CTranslator translator{*this, ConfigParser(), *condors[i], time, files[i].stem(), false};
+            translator.Run();
+          }
+          catch(const std::exception &ex) {
+            results[i].error = ex.what();
+          }
+          results[i].time = std::chrono::duration<double>(CClock::now() - taskStart).count();
+
+          // release the task (landscape converter is released with the last task using it)
+          condors[i].reset();
+        }));
+      }
+    }
+    for(auto &future : futures)
+      future.get();
+  }
+
+  // staged outputs of all the tasks are uploaded once, after all of them were written
+  std::string syncError;
+  try {
+    CTranslator::Sync(*this, ConfigParser());
+  }
+  catch(const std::exception &ex) {
+    syncError = ex.what();
+  }
+
+  // report summary
+  unsigned failed = 0;
+  LogHigh() << "Batch translation summary:" << std::endl;
+  for(size_t i=0; i<files.size(); i++) {
+    std::ostringstream time;
+    time << std::fixed << std::setprecision(1) << results[i].time;
+    if(results[i].error.empty())
+      Log() << "  OK     " << files[i].filename().string() << " (" << time.str() << " s)" << std::endl;
+    else {
+      Error() << "  FAILED " << files[i].filename().string() << ": " << results[i].error << std::endl;
+      failed++;
+    }
+  }
+  std::ostringstream total;
+  total << std::fixed << std::setprecision(1) << std::chrono::duration<double>(CClock::now() - start).count();
+  LogHigh() << files.size() - failed << "/" << files.size() << " tasks translated in " << total.str() << " s" << std::endl;
+  if(!syncError.empty())
+    Error() << "  FAILED synchronization: " << syncError << std::endl;
+
+  return failed || !syncError.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -29,6 +29,7 @@
 #define __CONDOR2NAV_CLI_H__
 
 #include "condor2nav.h"
+#include <chrono>
 
 /**
  * @brief Condor2Nav project namespace.
@@ -60,6 +61,7 @@ namespace condor2nav {
         void Trace(const std::string &str) const override;
       public:
         explicit CLogger(TType type);
+        ~CLogger();
       };
 
     private:
@@ -67,24 +69,46 @@ namespace condor2nav {
         TFPLType fplType;
         bfs::path fplPath;
         unsigned aatTime;
+        bfs::path batch;
+        bool watch;
+        bool sync;
+        bool server;
+        bool local;
       };
 
+      static const unsigned WATCH_DEBOUNCE = 1000;   ///< @brief Default time without writes before a watched FPL file is translated [ms]
+      static const unsigned CONNECT_TIMEOUT = 5000;  ///< @brief Max time to wait for a busy translation server [ms]
+      static const unsigned REQUEST_TIMEOUT = 5000;  ///< @brief Max time to wait for a request of a connected client [ms]
+      static const char PIPE_NAME[];                 ///< @brief Name of translation server pipe
+      static const unsigned STATUS_INTERVAL = 5000;  ///< @brief Minimum time between download status lines [ms]
+
       CLogger _normal;              ///< @brief Normal logging level logger
       CLogger _high;                ///< @brief Important logging level logger
       CLogger _warning;             ///< @brief Warning logging level logger
       CLogger _error;               ///< @brief Error logging level logger
 
+      mutable std::chrono::steady_clock::time_point _statusReported; ///< @brief Time of the last download status line
+
       void Usage() const;
       TOptions CLIParse(int argc, const char *argv[]) const;
       bool AATCheck(const CCondor &condor, unsigned &aatTime) const;
+      bool Translate(const bfs::path &condorPath, const bfs::path &fplPath, unsigned aatTime) const;
+      int Watch(const bfs::path &condorPath, unsigned aatTime) const;
+      int Serve(const bfs::path &condorPath) const;
+      int Request(const bfs::path &condorPath, const std::string &request) const;
+      std::vector<bfs::path> BatchFiles(const bfs::path &pattern) const;
+      int Batch(const bfs::path &condorPath, const bfs::path &pattern, unsigned aatTime) const;
 
     public:
+      static bool Forward(int argc, const char *argv[], int &status);
+
       CCondor2NavCLI();
 
       const CLogger &Log() const override     { return _normal; }
       const CLogger &LogHigh() const override { return _high; }
       const CLogger &Warning() const override { return _warning; }
       const CLogger &Error() const override   { return _error; }
+      void DownloadStatus(const CDownloader::TStatus &status) const override;
 
       int Run(int argc, const char *argv[]) const;
     };
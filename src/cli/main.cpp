@@ -26,6 +26,7 @@
  */
 
 #include "condor2navCLI.h"
+#include <future>
 #include <iostream>
 
 
@@ -40,9 +41,33 @@
 int main(int argc, const char *argv[])
 {
   try {
+    // resident translation server has everything loaded already
+    int status;
+    if(condor2nav::cli::CCondor2NavCLI::Forward(argc, argv, status))
+      return status;
+
     condor2nav::cli::CCondor2NavCLI app;
-    app.OnStart([]{ return false; });
-    return app.Run(argc, argv);
+
+    // translation waits only for the maps of its landscape
+    condor2nav::CCancellationSource mapsCancel;
+    auto mapsSync = std::async(std::launch::async, [&]{ app.OnStart(mapsCancel.Token()); });
+    try {
+      status = app.Run(argc, argv);
+    }
+    catch(...) {
+      mapsCancel.Cancel();
+      throw;
+    }
+
+    // maps not needed by this command are downloaded by the next one
+    mapsCancel.Cancel();
+    try {
+      mapsSync.get();
+    }
+    catch(const std::exception &ex) {
+      std::cerr << ex.what() << std::endl;
+    }
+    return status;
   }
   catch(const condor2nav::Exception &ex) {
     std::cerr << ex.what() << std::endl;
@@ -0,0 +1,109 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file compiledCSV.cpp
+ *
+ * @brief Implements the CSV tables compiled into the application.
+ */
+
+#include "compiledCSV.h"
+#include "fingerprint.h"
+#include "istream.h"
+#include "tools.h"
+#include "traitsNoCase.h"
+#include <boost/filesystem.hpp>
+
+
+/**
+ * @brief Returns the perfect hash of a value.
+ *
+ * Hash is case insensitive so that the same slot is used for both case
+ * sensitive and insensitive lookups.
+ *
+ * @param value The value to hash.
+ * @param seed  The hash seed.
+ *
+ * @return Hash of the value.
+ */
+unsigned condor2nav::CompiledCSVHash(boost::string_ref value, unsigned seed)
+{
+  // 32-bit FNV-1a
+  std::uint32_t hash = 2166136261u ^ seed;
+  for(auto c : value) {
+    hash ^= static_cast<unsigned char>(ToUpper(c));
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+
+/**
+ * @brief Returns the fingerprint of CSV file data.
+ *
+ * '\r' characters are skipped so that line endings conversion of the file
+ * does not make it look customized.
+ *
+ * @param data The data of the file.
+ * @param size Set to the size of the data without '\r' characters.
+ *
+ * @return Fingerprint of the data.
+ */
+std::string condor2nav::CompiledCSVFingerprint(boost::string_ref data, std::uint64_t &size)
+{
+  std::string text;
+  text.reserve(data.size());
+  for(auto c : data)
+    if(c != '\r')
+      text += c;
+  size = text.size();
+  return CFingerprint{}.Add(text).String();
+}
+
+
+/**
+ * @brief Returns compiled table of a CSV file.
+ *
+ * Compiled table is returned only if the file was not customized by the user
+ * (it has the same content as the one the table was generated from) or if it
+ * does not exist. The file is read and hashed but not parsed.
+ *
+ * @param filePath The path of the CSV file.
+ *
+ * @return Compiled table or @p nullptr if the file should be parsed.
+ */
+auto condor2nav::CompiledCSV(const bfs::path &filePath) -> const TCompiledCSV *
+{
+  const auto path = filePath.generic_string();
+  for(unsigned i=0; i<COMPILED_CSV_NUM; i++) {
+    const auto &table = COMPILED_CSV[i];
+    if(path != table.path)
+      continue;
+    if(!FileExists(filePath))
+      return &table;
+
+    CIStream stream{filePath};
+    std::uint64_t size;
+    const auto fingerprint = CompiledCSVFingerprint(stream.Data(), size);
+    return size == table.size && fingerprint == table.fingerprint ? &table : nullptr;
+  }
+  return nullptr;
+}
@@ -0,0 +1,67 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file compiledCSV.h
+ *
+ * @brief Declares the CSV tables compiled into the application.
+ */
+
+#ifndef __COMPILED_CSV_H__
+#define __COMPILED_CSV_H__
+
+#include "boostfwd.h"
+#include <boost/utility/string_ref.hpp>
+#include <cstdint>
+#include <string>
+
+namespace condor2nav {
+
+  /**
+   * @brief CSV file compiled into the application.
+   *
+   * Tables are generated from the CSV files distributed with Condor2Nav by
+   * 'condor2nav-data' tool. Rows of the first column are found with a perfect
+   * hash: a case insensitive hash of every distinct value with the table seed
+   * gives a unique slot that stores the index of the first row with that value.
+   */
+  struct TCompiledCSV {
+    const char *path;                     ///< @brief Path of the source file relative to the application directory. 
+    std::uint64_t size;                   ///< @brief The size of the source file without '\r' characters. 
+    const char *fingerprint;              ///< @brief The fingerprint of the source file without '\r' characters. 
+    unsigned rowsNum;                     ///< @brief The number of rows. 
+    const unsigned *rowOffsets;           ///< @brief Offsets of the first cell of every row (rowsNum + 1 entries). 
+    const char *const *cells;             ///< @brief Cells of all the rows. 
+    unsigned seed;                        ///< @brief Perfect hash seed. 
+    unsigned slotsNum;                    ///< @brief The number of hash slots (power of 2). 
+    const unsigned short *slots;          ///< @brief Row index + 1 for every slot (0 if empty). 
+  };
+
+  extern const TCompiledCSV COMPILED_CSV[];           ///< @brief Compiled CSV files. 
+  extern const unsigned COMPILED_CSV_NUM;             ///< @brief The number of compiled CSV files. 
+
+  unsigned CompiledCSVHash(boost::string_ref value, unsigned seed);
+  std::string CompiledCSVFingerprint(boost::string_ref data, std::uint64_t &size);
+  const TCompiledCSV *CompiledCSV(const bfs::path &filePath);
+
+}
+
+#endif /* __COMPILED_CSV_H__ */
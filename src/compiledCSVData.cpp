@@ -0,0 +1,435 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Generated by condor2nav-data tool from Condor2Nav CSV files. Do not edit!
+//
+
+/**
+ * @file compiledCSVData.cpp
+ *
+ * @brief Defines the CSV tables compiled into the application.
+ */
+
+#include "compiledCSV.h"
+
+
+namespace {
+
+  // data/GliderData.csv
+  const char *const CELLS_0[] = {
+    "CondorName", "SpeedMax[km/h]", "DAeCIndex", "WaterBalastEmptyTime[s]", "WingArea [m2]", "MassDryGross[kg]", "MaxWaterBallast[liters]", "Speed1[km/h]", "Sink1[m/s]", "Speed2", "Sink2", "Speed3", "Sink3", "Flaps",
+    "ASG29", "285", "120", "200", "10.5", "368", "200", "76", "-0.483", "136", "-0.87", "170", "-1.5", "568,5,0,L/6/5,108,4,128,3,160,2,195,1",
+    "ASK13", "200", "78", "0", "17.5", "380", "0", "64", "-0.726", "100", "-1.17", "130", "-2.22", "",
+    "ASW15", "220", "98", "112", "10.68", "294", "90", "85", "-0.64", "90", "-0.68", "164", "-2.23", "",
+    "ASW19", "255", "100", "100", "11", "375", "100", "105", "-0.78", "150", "-1.61", "166", "-2.08", "",
+    "ASW22", "280", "128", "118", "16.69", "500", "235", "85", "-0.395", "121", "-0.68", "180", "-1.93", "500,5,0,5,72,4,92,3,103,2,129,1",
+    "ASW27", "285", "114", "190", "9", "317", "190", "75", "-0.54", "181", "-1.82", "222", "-3.14", "317,6,0,5,74,4,82,3B,104,3A,126,2,170,1",
+    "ASW28", "285", "108", "180", "10.5", "268", "180", "77", "-0.572", "129", "-1.021", "185", "-2.9198", "",
+    "ASW28-18", "270", "114", "190", "11.88", "295", "190", "78", "-0.494", "91", "-0.522", "128", "-0.97", "",
+    "Discus2", "250", "108", "200", "10.16", "328", "200", "78", "-0.574", "105", "-0.67", "165", "-1.91", "",
+    "Discus2c", "280", "114", "200", "11.36", "318", "200", "77", "-0.503", "134", "-1.08", "175", "-2.35", "",
+    "Fox", "282", "80", "0", "12.34", "420", "0", "92", "-0.99", "121", "-1.15", "166", "-2.12", "",
+    "Jantar2b", "250", "116", "165", "14.25", "408", "165", "75", "-0.461", "129", "-0.93", "170", "-1.87", "573,5,0,+2,95,+1,113,0,145,-1,190,-2",
+    "JantarStd3", "285", "100", "150", "10.66", "373", "150", "79", "-0.67", "111", "-0.86", "170", "-2.15", "",
+    "Libelle", "250", "98", "50", "9.85", "307", "50", "86", "-0.65", "100", "-0.79", "163", "-2.21", "",
+    "LS10", "280", "120", "190", "11.45", "348", "190", "81", "-0.501", "111", "-0.64", "185", "-1.89", "538,4,0,L/10,100,5,123,0,200,-4",
+    "LS4", "280", "106", "170", "10.5", "327", "170", "96", "-0.66", "120", "-0.9", "145", "-1.36", "",
+    "LS6", "270", "112", "160", "10.5", "328", "160", "75", "-0.592", "120", "-0.83", "200", "-2.29", "328,4,0,10,100,5,117,0,151,-5",
+    "LS8", "280", "108", "190", "10.5", "339", "190", "85", "-0.586", "127", "-0.96", "148", "-1.36", "",
+    "LS8s", "280", "114", "190", "11.4", "340", "190", "84", "-0.514", "150", "-1.38", "159", "-1.61", "",
+    "Nimbus4", "275", "128", "300", "17.86", "500", "300", "86", "-0.4", "137", "-0.95", "201", "-2.64", "500,5,0,+2,78,+1,95,0,135,-1,165,-2",
+    "PW-5", "213", "86", "0", "10.16", "270", "0", "86", "-0.751", "105", "-1.04", "120", "-1.4", "",
+    "Ventus2", "270", "114", "200", "9.67", "317", "200", "74", "-0.528", "142", "-1.02", "181", "-1.85", "517,7,0,L,85,+2/+1,110,0,138,-1,164,-2,218,S,230,S1",
+    "Ventus2cx", "285", "120", "200", "11.03", "365", "200", "76", "-0.475", "93", "-0.509", "185", "-1.88", "565,6,0,L/+2/+1,100,0,120,-1,173,-2,210,S,225,S1",
+  };
+  const unsigned ROWS_0[] = {
+    0, 14, 28, 42, 56, 70, 84, 98, 112, 126, 140, 154, 168, 182, 196, 210,
+    224, 238, 252, 266, 280, 294, 308, 322, 336,
+  };
+  const unsigned short SLOTS_0[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 24, 0, 0, 8, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 14, 17, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 13, 0,
+    0, 0, 0, 0, 1, 0, 16, 3, 0, 0, 2, 0, 0, 0, 0, 6,
+    0, 23, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 12,
+    0, 9, 0, 0, 0, 0, 0, 0, 0, 22, 20, 0, 0, 0, 0, 0,
+    7, 0, 0, 18, 0, 0, 0, 0, 0, 5, 0, 10, 0, 19, 0, 0,
+  };
+
+  // data/LK8000/SceneryData.csv
+  const char *const CELLS_1[] = {
+    "Condor Scenery", "Map File", "Terrain File", "Waypoints File",
+    "Alpi2", "", "", "Alpi2_2.02.cup",
+    "Alpi3", "", "", "Alpi3_3.3.cup",
+    "alps_XL", "", "", "alps_XL_1.0.cup",
+    "Alsace", "", "", "Alsace_1.1.cup",
+    "Andalusia", "", "", "Andalusia_V1.0.cup",
+    "Appalachia", "", "", "Appalachia_1.0.cup",
+    "area51", "", "", "area51_1.0.cup",
+    "bacchus_marsh", "", "", "bacchus_marsh_.cup",
+    "Belgique", "", "", "Belgique_Rev 1.0.cup",
+    "benabarre", "", "", "benabarre_1.00.cup",
+    "British_Columbia", "", "", "British_Columbia_1.01.cup",
+    "Bulgaria", "", "", "Bulgaria_1.0.cup",
+    "Catalunya", "", "", "Catalunya_1.00.cup",
+    "central_alps", "", "", "central_alps_1.0.cup",
+    "Central_Florida", "", "", "Central_Florida_1.cup",
+    "Central_GER", "", "", "Central_GER_2.0.1.cup",
+    "Central-Colombia", "", "", "Central-Colombia_2.1a.cup",
+    "Cologne_Duss", "", "", "Cologne_Duss_v1.0.cup",
+    "Colorado", "", "", "Colorado_1.2.cup",
+    "Condorclub", "", "", "Condorclub_1.0.cup",
+    "Corse", "", "", "Corse_1.0.cup",
+    "Czech rep", "", "", "Czech rep_1.0.cup",
+    "Czechoslovakia", "", "", "Czechoslovakia_2.0.cup",
+    "Denmark", "", "", "Denmark_1.00.cup",
+    "East-Andalucia", "", "", "East-Andalucia_1.00.cup",
+    "EasternAlps2.0", "", "", "EasternAlps2.0_2.0.cup",
+    "EastHungary", "", "", "EastHungary_2.0.cup",
+    "Eden", "", "", "Eden_1.0.cup",
+    "Fayence50", "", "", "Fayence50_Rev1.0.cup",
+    "FitzRoy", "", "", "FitzRoy_1.00.cup",
+    "Flying_M_Ranch", "", "", "Flying_M_Ranch_1.00.cup",
+    "Fuentemilanos", "", "", "Fuentemilanos_1.00.cup",
+    "glaciar", "", "", "glaciar_1.1.cup",
+    "Glacier Park", "", "", "Glacier Park_1.0.cup",
+    "gotland", "", "", "gotland_1.02.cup",
+    "Grenoble", "", "", "Grenoble_1.1.cup",
+    "Haut_Atlas_Maroc", "", "", "Haut_Atlas_Maroc_1.0.cup",
+    "Hawaii", "", "", "Hawaii_1.5.cup",
+    "Himalaya", "", "", "Himalaya_1.0.cup",
+    "HoodRiver", "", "", "HoodRiver_2.0.cup",
+    "Hungary", "", "", "Hungary_1.00.cup",
+    "HW_SWGermany", "", "", "HW_SWGermany_1.08.cup",
+    "IslandHop", "", "", "IslandHop_1.0.cup",
+    "kisogawa2", "", "", "kisogawa2_.cup",
+    "Lakekeepit", "", "", "Lakekeepit_1.1.cup",
+    "Logan", "", "", "Logan_1.01.cup",
+    "Makalu Range", "", "", "Makalu Range_2.0.cup",
+    "Massif_Central", "", "", "Massif_Central_1.0.cup",
+    "Mifflin", "", "", "Mifflin_1.0.cup",
+    "Mount_Olympus", "", "", "Mount_Olympus_1.0.cup",
+    "narromine", "", "", "narromine_0.1.cup",
+    "Nevada", "", "", "Nevada_1.0.cup",
+    "NEVictoria", "", "", "NEVictoria_0.9.cup",
+    "New_Mexico", "", "", "New_Mexico_1.0.cup",
+    "NewZealand", "", "", "NewZealand_0.8.cup",
+    "Normandie", "", "", "Normandie_0.5.cup",
+    "NorthernNorway", "", "", "NorthernNorway_1.0.cup",
+    "Oahu HD", "", "", "Oahu HD_1.0.cup",
+    "PacificNW", "", "", "PacificNW_2.0.cup",
+    "Palmeira-BR", "", "", "Palmeira-BR_.cup",
+    "Peru", "", "", "Peru_1.0.cup",
+    "PNG", "", "", "PNG_1.00.cup",
+    "polska_pn3", "", "", "polska_pn3_.cup",
+    "Porta-Westfalica", "", "", "Porta-Westfalica_1.0.cup",
+    "Provence", "", "", "Provence_1.30.cup",
+    "Provence2", "", "", "Provence2_1.0.cup",
+    "pyrenees", "", "", "pyrenees_1.beta.cup",
+    "pyrenees2", "", "", "pyrenees2_2.1.cup",
+    "Reinsdorf", "", "", "Reinsdorf_1.0.cup",
+    "Rieti", "", "", "Rieti_1.00.cup",
+    "Rio-Grande", "", "", "Rio-Grande_2.0.cup",
+    "RockyMountains", "", "", "RockyMountains_1.01.cup",
+    "romania", "", "", "romania_0.2d.cup",
+    "Rouen-Boos", "", "", "Rouen-Boos_V 1.0.cup",
+    "Sagarmatha", "", "", "Sagarmatha_1.00.cup",
+    "sandiego", "", "", "sandiego_1.1.cup",
+    "Scotland", "", "", "Scotland_2.1.cup",
+    "ScotlandHD", "", "", "ScotlandHD_HD.cup",
+    "SEQld", "", "", "SEQld_0.8.cup",
+    "SerbiaMontenegro", "", "", "SerbiaMontenegro_1.0.cup",
+    "Sierra Nevada", "", "", "Sierra Nevada_1.1.cup",
+    "Slovak Rep", "", "", "Slovak Rep_1.0.cup",
+    "SlovakiaCE", "", "", "SlovakiaCE_6.0.cup",
+    "Slovenia", "", "", "Slovenia_1.03.cup",
+    "SloveniaHD", "", "", "SloveniaHD_1.0.cup",
+    "Soaring-Island", "", "", "Soaring-Island_1.0.cup",
+    "South_UK_V2", "", "", "South_UK_V2_2.cup",
+    "SouthTurkey", "", "", "SouthTurkey_1.1.cup",
+    "SouthWest_GER", "", "", "SouthWest_GER_1.01.cup",
+    "SouthWest-Poland", "", "", "SouthWest-Poland_0.5.cup",
+    "StirlingRanges", "", "", "StirlingRanges_2.0.cup",
+    "Sydney_HunterV", "", "", "Sydney_HunterV_1.0.cup",
+    "teton", "", "", "teton_1.00.cup",
+    "uk_vfr3", "", "", "uk_vfr3_3.0.cup",
+    "ulster", "", "", "ulster_0.1.cup",
+    "Uvalde", "", "", "Uvalde_1.0.cup",
+    "Virgin", "", "", "Virgin_1.0.cup",
+    "Vysocina2", "", "", "Vysocina2_1.0.cup",
+    "West&Wales", "", "", "West&Wales_1.3.cup",
+    "West_Australia", "", "", "West_Australia_1.00.cup",
+    "West_swiss", "", "", "West_swiss_1.02.cup",
+    "WestAlpi", "", "", "WestAlpi_2.0.cup",
+    "YAlps", "", "", "YAlps_0.02.cup",
+  };
+  const unsigned ROWS_1[] = {
+    0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60,
+    64, 68, 72, 76, 80, 84, 88, 92, 96, 100, 104, 108, 112, 116, 120, 124,
+    128, 132, 136, 140, 144, 148, 152, 156, 160, 164, 168, 172, 176, 180, 184, 188,
+    192, 196, 200, 204, 208, 212, 216, 220, 224, 228, 232, 236, 240, 244, 248, 252,
+    256, 260, 264, 268, 272, 276, 280, 284, 288, 292, 296, 300, 304, 308, 312, 316,
+    320, 324, 328, 332, 336, 340, 344, 348, 352, 356, 360, 364, 368, 372, 376, 380,
+    384, 388, 392, 396, 400, 404, 408, 412, 416,
+  };
+  const unsigned short SLOTS_1[] = {
+    0, 73, 0, 0, 0, 0, 0, 0, 0, 0, 57, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 68, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 92, 0, 0, 0, 0, 0, 12, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 99, 0, 0, 86, 0,
+    0, 0, 0, 0, 0, 0, 0, 41, 96, 0, 0, 45, 0, 0, 0, 0,
+    0, 0, 56, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 90, 55, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 88, 27, 0, 0, 0, 0, 0, 0,
+    0, 79, 0, 0, 0, 0, 0, 0, 43, 0, 0, 0, 0, 0, 0, 0,
+    91, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 71, 0, 0, 0,
+    0, 0, 19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0,
+    0, 67, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 39, 0, 0, 14, 0, 0, 0, 0,
+    0, 64, 0, 0, 0, 0, 0, 0, 0, 61, 0, 101, 0, 0, 8, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 0, 0, 0, 0, 0, 0,
+    0, 54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 74, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 31, 0, 0, 29, 0, 0, 0, 0, 49, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 50, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 63, 0, 0, 0, 0, 0, 0, 0, 0, 81, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 60, 0, 0, 0, 0, 0, 0, 0, 77,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0,
+    0, 0, 0, 0, 0, 40, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 20, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 58, 0, 0, 0, 0, 59, 0,
+    0, 0, 0, 0, 0, 0, 0, 18, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 103, 0, 0, 62, 0, 0, 0, 0,
+    0, 0, 0, 44, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 94, 0, 48, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 95, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 80, 0, 0, 0, 0, 84, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 72, 53, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 34, 0, 0, 0, 0, 0, 0, 0, 4, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 17, 98, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 70, 0, 0, 0, 0, 38, 0,
+    0, 0, 0, 0, 97, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 33, 89, 0, 0, 0,
+    16, 0, 0, 2, 0, 25, 46, 0, 69, 0, 0, 22, 36, 0, 28, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 82, 0, 100, 0, 0, 0, 0, 66, 0, 0, 0, 0, 76, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 52, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 87, 0, 0, 42, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 51, 0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 102, 0, 0, 0, 0, 0,
+    0, 0, 47, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    104, 0, 0, 0, 0, 0, 0, 0, 0, 0, 93, 0, 0, 0, 0, 32,
+    0, 0, 0, 0, 75, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    83, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 37, 0, 0, 0, 78, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 85, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  };
+
+  // data/XCSoar/SceneryData.csv
+  const char *const CELLS_2[] = {
+    "Condor Scenery", "Map File", "Terrain File", "Waypoints File",
+    "Alpi2", "Alpi2_2.02.xcm", "", "",
+    "Alpi3", "Alpi3_3.3.xcm", "", "",
+    "alps_XL", "alps_XL_1.0.xcm", "", "",
+    "Alsace", "Alsace_1.1.xcm", "", "",
+    "Andalusia", "Andalusia_V1.0.xcm", "", "",
+    "Appalachia", "Appalachia_1.0.xcm", "", "",
+    "area51", "area51_1.0.xcm", "", "",
+    "bacchus_marsh", "bacchus_marsh_.xcm", "", "",
+    "Belgique", "Belgique_Rev 1.0.xcm", "", "",
+    "benabarre", "benabarre_1.00.xcm", "", "",
+    "British_Columbia", "British_Columbia_1.01.xcm", "", "",
+    "Bulgaria", "Bulgaria_1.0.xcm", "", "",
+    "Catalunya", "Catalunya_1.00.xcm", "", "",
+    "central_alps", "central_alps_1.0.xcm", "", "",
+    "Central_Florida", "Central_Florida_1.xcm", "", "",
+    "Central_GER", "Central_GER_2.0.1.xcm", "", "",
+    "Central-Colombia", "Central-Colombia_2.1a.xcm", "", "",
+    "Cologne_Duss", "Cologne_Duss_v1.0.xcm", "", "",
+    "Colorado", "Colorado_1.2.xcm", "", "",
+    "Condorclub", "Condorclub_1.0.xcm", "", "",
+    "Corse", "Corse_1.0.xcm", "", "",
+    "Czech rep", "Czech rep_1.0.xcm", "", "",
+    "Czechoslovakia", "Czechoslovakia_2.0.xcm", "", "",
+    "Denmark", "Denmark_1.00.xcm", "", "",
+    "East-Andalucia", "East-Andalucia_1.00.xcm", "", "",
+    "EasternAlps2.0", "EasternAlps2.0_2.0.xcm", "", "",
+    "EastHungary", "EastHungary_2.0.xcm", "", "",
+    "Eden", "Eden_1.0.xcm", "", "",
+    "Fayence50", "Fayence50_Rev1.0.xcm", "", "",
+    "FitzRoy", "FitzRoy_1.00.xcm", "", "",
+    "Flying_M_Ranch", "Flying_M_Ranch_1.00.xcm", "", "",
+    "Fuentemilanos", "Fuentemilanos_1.00.xcm", "", "",
+    "glaciar", "glaciar_1.1.xcm", "", "",
+    "Glacier Park", "Glacier Park_1.0.xcm", "", "",
+    "gotland", "gotland_1.02.xcm", "", "",
+    "Grenoble", "Grenoble_1.1.xcm", "", "",
+    "Haut_Atlas_Maroc", "Haut_Atlas_Maroc_1.0.xcm", "", "",
+    "Hawaii", "Hawaii_1.5.xcm", "", "",
+    "Himalaya", "Himalaya_1.0.xcm", "", "",
+    "HoodRiver", "HoodRiver_2.0.xcm", "", "",
+    "Hungary", "Hungary_1.00.xcm", "", "",
+    "HW_SWGermany", "HW_SWGermany_1.08.xcm", "", "",
+    "IslandHop", "IslandHop_1.0.xcm", "", "",
+    "kisogawa2", "kisogawa2_.xcm", "", "",
+    "Lakekeepit", "Lakekeepit_1.1.xcm", "", "",
+    "Logan", "Logan_1.01.xcm", "", "",
+    "Makalu Range", "Makalu Range_2.0.xcm", "", "",
+    "Massif_Central", "Massif_Central_1.0.xcm", "", "",
+    "Mifflin", "Mifflin_1.0.xcm", "", "",
+    "Mount_Olympus", "Mount_Olympus_1.0.xcm", "", "",
+    "narromine", "narromine_0.1.xcm", "", "",
+    "Nevada", "Nevada_1.0.xcm", "", "",
+    "NEVictoria", "NEVictoria_0.9.xcm", "", "",
+    "New_Mexico", "New_Mexico_1.0.xcm", "", "",
+    "NewZealand", "NewZealand_0.8.xcm", "", "",
+    "Normandie", "Normandie_0.5.xcm", "", "",
+    "NorthernNorway", "NorthernNorway_1.0.xcm", "", "",
+    "Oahu HD", "Oahu HD_1.0.xcm", "", "",
+    "PacificNW", "PacificNW_2.0.xcm", "", "",
+    "Palmeira-BR", "Palmeira-BR_.xcm", "", "",
+    "Peru", "Peru_1.0.xcm", "", "",
+    "PNG", "PNG_1.00.xcm", "", "",
+    "polska_pn3", "polska_pn3_.xcm", "", "",
+    "Porta-Westfalica", "Porta-Westfalica_1.0.xcm", "", "",
+    "Provence", "Provence_1.30.xcm", "", "",
+    "Provence2", "Provence2_1.0.xcm", "", "",
+    "pyrenees", "pyrenees_1.beta.xcm", "", "",
+    "pyrenees2", "pyrenees2_2.1.xcm", "", "",
+    "Reinsdorf", "Reinsdorf_1.0.xcm", "", "",
+    "Rieti", "Rieti_1.00.xcm", "", "",
+    "Rio-Grande", "Rio-Grande_2.0.xcm", "", "",
+    "RockyMountains", "RockyMountains_1.01.xcm", "", "",
+    "romania", "romania_0.2d.xcm", "", "",
+    "Rouen-Boos", "Rouen-Boos_V 1.0.xcm", "", "",
+    "Sagarmatha", "Sagarmatha_1.00.xcm", "", "",
+    "sandiego", "sandiego_1.1.xcm", "", "",
+    "Scotland", "Scotland_2.1.xcm", "", "",
+    "ScotlandHD", "ScotlandHD_HD.xcm", "", "",
+    "SEQld", "SEQld_0.8.xcm", "", "",
+    "SerbiaMontenegro", "SerbiaMontenegro_1.0.xcm", "", "",
+    "Sierra Nevada", "Sierra Nevada_1.1.xcm", "", "",
+    "Slovak Rep", "Slovak Rep_1.0.xcm", "", "",
+    "SlovakiaCE", "SlovakiaCE_6.0.xcm", "", "",
+    "Slovenia", "Slovenia_1.03.xcm", "", "",
+    "SloveniaHD", "SloveniaHD_1.0.xcm", "", "",
+    "Soaring-Island", "Soaring-Island_1.0.xcm", "", "",
+    "South_UK_V2", "South_UK_V2_2.xcm", "", "",
+    "SouthTurkey", "SouthTurkey_1.1.xcm", "", "",
+    "SouthWest_GER", "SouthWest_GER_1.01.xcm", "", "",
+    "SouthWest-Poland", "SouthWest-Poland_0.5.xcm", "", "",
+    "StirlingRanges", "StirlingRanges_2.0.xcm", "", "",
+    "Sydney_HunterV", "Sydney_HunterV_1.0.xcm", "", "",
+    "teton", "teton_1.00.xcm", "", "",
+    "uk_vfr3", "uk_vfr3_3.0.xcm", "", "",
+    "ulster", "ulster_0.1.xcm", "", "",
+    "Uvalde", "Uvalde_1.0.xcm", "", "",
+    "Virgin", "Virgin_1.0.xcm", "", "",
+    "Vysocina2", "Vysocina2_1.0.xcm", "", "",
+    "West&Wales", "West&Wales_1.3.xcm", "", "",
+    "West_Australia", "West_Australia_1.00.xcm", "", "",
+    "West_swiss", "West_swiss_1.02.xcm", "", "",
+    "WestAlpi", "WestAlpi_2.0.xcm", "", "",
+    "YAlps", "YAlps_0.02.xcm", "", "",
+  };
+  const unsigned ROWS_2[] = {
+    0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60,
+    64, 68, 72, 76, 80, 84, 88, 92, 96, 100, 104, 108, 112, 116, 120, 124,
+    128, 132, 136, 140, 144, 148, 152, 156, 160, 164, 168, 172, 176, 180, 184, 188,
+    192, 196, 200, 204, 208, 212, 216, 220, 224, 228, 232, 236, 240, 244, 248, 252,
+    256, 260, 264, 268, 272, 276, 280, 284, 288, 292, 296, 300, 304, 308, 312, 316,
+    320, 324, 328, 332, 336, 340, 344, 348, 352, 356, 360, 364, 368, 372, 376, 380,
+    384, 388, 392, 396, 400, 404, 408, 412, 416,
+  };
+  const unsigned short SLOTS_2[] = {
+    0, 73, 0, 0, 0, 0, 0, 0, 0, 0, 57, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 13, 0, 0, 0, 0, 0, 68, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 92, 0, 0, 0, 0, 0, 12, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 99, 0, 0, 86, 0,
+    0, 0, 0, 0, 0, 0, 0, 41, 96, 0, 0, 45, 0, 0, 0, 0,
+    0, 0, 56, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 90, 55, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 88, 27, 0, 0, 0, 0, 0, 0,
+    0, 79, 0, 0, 0, 0, 0, 0, 43, 0, 0, 0, 0, 0, 0, 0,
+    91, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 71, 0, 0, 0,
+    0, 0, 19, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 0, 0,
+    0, 67, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 39, 0, 0, 14, 0, 0, 0, 0,
+    0, 64, 0, 0, 0, 0, 0, 0, 0, 61, 0, 101, 0, 0, 8, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 65, 0, 0, 0, 0, 0, 0,
+    0, 54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 74, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 31, 0, 0, 29, 0, 0, 0, 0, 49, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 50, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 63, 0, 0, 0, 0, 0, 0, 0, 0, 81, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 60, 0, 0, 0, 0, 0, 0, 0, 77,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 0, 0,
+    0, 0, 0, 0, 0, 40, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 20, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 58, 0, 0, 0, 0, 59, 0,
+    0, 0, 0, 0, 0, 0, 0, 18, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 103, 0, 0, 62, 0, 0, 0, 0,
+    0, 0, 0, 44, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 94, 0, 48, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 95, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 80, 0, 0, 0, 0, 84, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 72, 53, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 34, 0, 0, 0, 0, 0, 0, 0, 4, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 30, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 17, 98, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 70, 0, 0, 0, 0, 38, 0,
+    0, 0, 0, 0, 97, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 33, 89, 0, 0, 0,
+    16, 0, 0, 2, 0, 25, 46, 0, 69, 0, 0, 22, 36, 0, 28, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 82, 0, 100, 0, 0, 0, 0, 66, 0, 0, 0, 0, 76, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 52, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 87, 0, 0, 42, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 51, 0, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 102, 0, 0, 0, 0, 0,
+    0, 0, 47, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    104, 0, 0, 0, 0, 0, 0, 0, 0, 0, 93, 0, 0, 0, 0, 32,
+    0, 0, 0, 0, 75, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    83, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 37, 0, 0, 0, 78, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 35, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 85, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  };
+
+}
+
+
+const condor2nav::TCompiledCSV condor2nav::COMPILED_CSV[] = {
+  { "data/GliderData.csv", 1945, "2d8586cf852452cd", 24, ROWS_0, CELLS_0, 3u, 128, SLOTS_0 },
+  { "data/LK8000/SceneryData.csv", 3295, "f4b20946c1a3f96c", 104, ROWS_1, CELLS_1, 472u, 1024, SLOTS_1 },
+  { "data/XCSoar/SceneryData.csv", 3295, "860aea42e94a1964", 104, ROWS_2, CELLS_2, 472u, 1024, SLOTS_2 }
+};
+
+const unsigned condor2nav::COMPILED_CSV_NUM = sizeof(COMPILED_CSV) / sizeof(*COMPILED_CSV);
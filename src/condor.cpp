@@ -28,14 +28,26 @@
 #include "condor.h"
 #include "traitsNoCase.h"
 #include "tools.h"
+#include "istream.h"
+#include "ostream.h"
+#include "traceLog.h"
+#include <boost/filesystem/fstream.hpp>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace {
 
   const bfs::path FLIGHT_PLANS_PATH = "FlightPlans\\User";
   const bfs::path RACE_RESULTS_PATH = "RaceResults";
+  const bfs::path RACE_RESULTS_INDEX_PATH = "data/Cache/RaceResults.index";
+
+  std::mutex raceResultsIndexMutex;          ///< @brief Serializes race results index file updates.
+
+  // NaviCon.dll keeps only one landscape initialized in the whole process
+  std::mutex naviConMutex;                   ///< @brief Serializes NaviCon.dll calls of all converters.
+  std::string naviConTrn;                    ///< @brief The terrain NaviCon.dll is initialized with.
 
   // NaviCon.dll interface
   using FNaviConInit = int(WINAPI*)(const char *trnFile);
@@ -54,6 +66,49 @@ namespace {
     out = sym;
   }
 
+
+  /**
+   * @brief Coordinates conversion cache file header.
+   */
+  struct TCacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::int64_t trnTime;
+    std::uint64_t trnSize;
+    float maxX;
+    float maxY;
+    std::uint32_t count;
+  };
+
+  /**
+   * @brief Coordinates conversion cache file entry.
+   */
+  struct TCacheEntry {
+    float x;
+    float y;
+    float lon;
+    float lat;
+  };
+
+  const char CACHE_MAGIC[4] = { 'C', '2', 'N', 'C' };
+
+
+  /**
+   * @brief Returns the cache key for Condor coordinates.
+   *
+   * @param x The x coordinate.
+   * @param y The y coordinate.
+   *
+   * @return Cache key.
+   */
+  std::uint64_t CacheKey(float x, float y)
+  {
+    std::uint32_t xBits, yBits;
+    std::memcpy(&xBits, &x, sizeof(xBits));
+    std::memcpy(&yBits, &y, sizeof(yBits));
+    return static_cast<std::uint64_t>(xBits) << 32 | yBits;
+  }
+
 }
 
 namespace condor2nav {
@@ -73,82 +128,355 @@ namespace condor2nav {
 
 /* ******************** C O N D O R   -   C O O R D   C O N V E R T E R ********************* */
 
+const bfs::path condor2nav::CCondor::CCoordConverter::CACHE_DIR = "data/Cache";
+
+
 /**
  * @brief Class constructor
  *
- * condor2nav::CCondor::CCoordConverter class constructor that connects to 
- * NaviCon.dll library interface and initializes it with current terrain file.
+ * condor2nav::CCondor::CCoordConverter class constructor that loads the conversion
+ * cache for current terrain. NaviCon.dll library is loaded only when needed.
  *
  * @param condorPath The path to Condor directory
  * @param trnName The name of the terrain used in task
+ * @param pool NaviCon.dll workers pool (nullptr to use NaviCon.dll in-process)
+ * @param cache Specifies if the conversion cache file should be used
  */
-condor2nav::CCondor::CCoordConverter::CCoordConverter(const bfs::path &condorPath, const std::string &trnName) :
-  _iface{std::make_unique<TDLLIface>()}, _lib{::LoadLibrary((condorPath / "NaviCon.dll").string().c_str())}
+condor2nav::CCondor::CCoordConverter::CCoordConverter(bfs::path condorPath, std::string trnName, const CNaviConPool *pool, bool cache) :
+  _condorPath{std::move(condorPath)}, _trnName{std::move(trnName)}, _pool{pool}, _trnTime{0}, _trnSize{0}, _cacheEnabled{false},
+  _cacheModified{false}, _maxX{0}, _maxY{0}, _maxValid{false}
 {
-  if(!_lib.get())
-    throw EOperationFailed{"ERROR: Couldn't open 'NaviCon.dll' from Condor directory '" + condorPath.string() + "'!!!"};
-  
-  Symbol(_lib.get(), "NaviConInit", _iface->naviConInit);
-  Symbol(_lib.get(), "GetMaxX",     _iface->getMaxX);
-  Symbol(_lib.get(), "GetMaxY",     _iface->getMaxY);
-  Symbol(_lib.get(), "XYToLon",     _iface->xyToLon);
-  Symbol(_lib.get(), "XYToLat",     _iface->xyToLat);
-
-  // init coordinates
-  auto trnPath = condorPath / "Landscapes" / trnName / (trnName + ".trn");
-  _iface->naviConInit(trnPath.string().c_str());
+  boost::system::error_code ec;
+  auto trnPath = _condorPath / "Landscapes" / _trnName / (_trnName + ".trn");
+  _trnSize = bfs::file_size(trnPath, ec);
+  if(!ec)
+    _trnTime = bfs::last_write_time(trnPath, ec);
+  _cacheEnabled = cache && !ec;
+  if(_cacheEnabled)
+    CacheLoad();
 }
 
 
 /**
-* @brief Class constructor
+* @brief Class destructor
+*
+* Stores new conversion results in the cache file.
 *
 * NOTE: Destructor definition is needed here to make sure that TDLLIface is defined.
 */
 condor2nav::CCondor::CCoordConverter::~CCoordConverter()
 {
+  try {
+    if(_cacheModified)
+      CacheSave();
+  }
+  catch(const std::exception &) {
+    // cache is only an optimization
+  }
+}
+
+
+/**
+ * @brief Returns the path of the cache file.
+ *
+ * @return The path of the cache file for current terrain.
+ */
+bfs::path condor2nav::CCondor::CCoordConverter::CachePath() const
+{
+  return CACHE_DIR / (_trnName + ".cache");
+}
+
+
+/**
+ * @brief Loads the conversion cache.
+ *
+ * Method loads conversion results from the cache file. The cache is ignored
+ * if it was created for a different version of the terrain file or if its
+ * size does not match the number of entries stored in its header.
+ */
+void condor2nav::CCondor::CCoordConverter::CacheLoad()
+{
+  const auto path = CachePath();
+  bfs::ifstream stream{path, std::ios_base::in | std::ios_base::binary};
+  if(!stream)
+    return;
+
+  TCacheHeader header;
+  if(!stream.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+     std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) ||
+     header.version != CACHE_VERSION || header.trnTime != _trnTime || header.trnSize != _trnSize)
+    return;
+
+  // truncated or corrupted file
+  boost::system::error_code ec;
+  const auto size = bfs::file_size(path, ec);
+  if(ec || size != sizeof(header) + static_cast<std::uint64_t>(header.count) * sizeof(TCacheEntry))
+    return;
+
+  std::vector<TCacheEntry> entries(header.count);
+  if(header.count &&
+     !stream.read(reinterpret_cast<char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TCacheEntry))))
+    return;
+
+  _maxX = header.maxX;
+  _maxY = header.maxY;
+  _maxValid = true;
+  _cache.reserve(entries.size());
+  for(const auto &entry : entries)
+    _cache.emplace(CacheKey(entry.x, entry.y), std::make_pair(entry.lon, entry.lat));
+}
+
+
+/**
+ * @brief Stores the conversion cache.
+ *
+ * Method stores all conversion results in the cache file.
+ */
+void condor2nav::CCondor::CCoordConverter::CacheSave() const
+{
+  DirectoryCreate(CACHE_DIR);
+  bfs::ofstream stream{CachePath(), std::ios_base::out | std::ios_base::binary};
+  if(!stream)
+    return;
+
+  TCacheHeader header{};
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.trnTime = _trnTime;
+  header.trnSize = _trnSize;
+  header.maxX = _maxX;
+  header.maxY = _maxY;
+  header.count = static_cast<std::uint32_t>(_cache.size());
+
+  std::vector<TCacheEntry> entries;
+  entries.reserve(_cache.size());
+  for(const auto &value : _cache) {
+    TCacheEntry entry;
+    const auto xBits = static_cast<std::uint32_t>(value.first >> 32);
+    const auto yBits = static_cast<std::uint32_t>(value.first);
+    std::memcpy(&entry.x, &xBits, sizeof(entry.x));
+    std::memcpy(&entry.y, &yBits, sizeof(entry.y));
+    entry.lon = value.second.first;
+    entry.lat = value.second.second;
+    entries.push_back(entry);
+  }
+
+  stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if(!entries.empty())
+    stream.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(TCacheEntry)));
 }
 
 
 /**
- * @brief Converts Condor coordinates to longitude.
+ * @brief Returns NaviCon.dll interface.
+ *
+ * Method connects to NaviCon.dll library interface and initializes it with
+ * current terrain file on the first use.
+ *
+ * @note Should be called with the mutex locked.
+ *
+ * @return NaviCon.dll interface.
+ */
+auto condor2nav::CCondor::CCoordConverter::Iface() const -> const TDLLIface &
+{
+  if(_iface)
+    return *_iface;
+
+  CLibraryRes lib{::LoadLibrary((_condorPath / "NaviCon.dll").string().c_str())};
+  if(!lib.get())
+    throw EOperationFailed{"ERROR: Couldn't open 'NaviCon.dll' from Condor directory '" + _condorPath.string() + "'!!!"};
+
+  auto iface = std::make_unique<TDLLIface>();
+  Symbol(lib.get(), "NaviConInit", iface->naviConInit);
+  Symbol(lib.get(), "GetMaxX",     iface->getMaxX);
+  Symbol(lib.get(), "GetMaxY",     iface->getMaxY);
+  Symbol(lib.get(), "XYToLon",     iface->xyToLon);
+  Symbol(lib.get(), "XYToLat",     iface->xyToLat);
+
+  // init coordinates
+  {
+    std::lock_guard<std::mutex> naviConLock{naviConMutex};
+    Activate(*iface);
+    _maxX = iface->getMaxX();
+    _maxY = iface->getMaxY();
+    _maxValid = true;
+  }
+
+  _lib = std::move(lib);
+  _iface = std::move(iface);
+  return *_iface;
+}
+
+
+/**
+ * @brief Initializes NaviCon.dll with the converter terrain.
+ *
+ * NaviCon.dll is loaded only once by the process so converters of different
+ * landscapes have to initialize it again if another terrain was used in
+ * the meantime.
  *
- * Method converts Condor coordinates to a double longitude value.
+ * @note Should be called with NaviCon.dll mutex locked.
+ *
+ * @param iface NaviCon.dll interface.
+ */
+void condor2nav::CCondor::CCoordConverter::Activate(const TDLLIface &iface) const
+{
+  const auto trnPath = (_condorPath / "Landscapes" / _trnName / (_trnName + ".trn")).string();
+  if(naviConTrn != trnPath) {
+    CTraceScope trace{"navicon", "NaviConInit", _trnName};
+    iface.naviConInit(trnPath.c_str());
+    naviConTrn = trnPath;
+  }
+}
+
+
+/**
+ * @brief Obtains landscape max coordinates.
+ *
+ * @note Should be called with the mutex locked.
+ */
+void condor2nav::CCondor::CCoordConverter::MaxInit() const
+{
+  if(_pool) {
+    _pool->Max(_condorPath, _trnName, _maxX, _maxY);
+    _maxValid = true;
+  }
+  else
+    Iface();
+}
+
+
+/**
+ * @brief Returns landscape max X coordinate.
+ *
+ * @return Landscape max X coordinate.
+ */
+float condor2nav::CCondor::CCoordConverter::MaxX() const
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  if(!_maxValid)
+    MaxInit();
+  return _maxX;
+}
+
+
+/**
+ * @brief Returns landscape max Y coordinate.
+ *
+ * @return Landscape max Y coordinate.
+ */
+float condor2nav::CCondor::CCoordConverter::MaxY() const
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  if(!_maxValid)
+    MaxInit();
+  return _maxY;
+}
+
+
+/**
+ * @brief Converts Condor coordinates to geographic position.
+ *
+ * Method converts Condor coordinates to longitude and latitude values.
  * 
- * @param x The x coordinate.
- * @param y The y coordinate. 
+ * @param point Condor map coordinates.
  *
- * @return Converted double longitude value.
+ * @return Converted position.
  */
-condor2nav::TLongitude condor2nav::CCondor::CCoordConverter::Longitude(const std::string &x, const std::string &y) const
+auto condor2nav::CCondor::CCoordConverter::Position(const TPoint &point) const -> TPosition
 {
-  auto xVal = Convert<float>(x);
-  auto yVal = Convert<float>(y);
-  auto lon = _iface->xyToLon(xVal, yVal);
-  auto deg = static_cast<int>(lon);
-  auto min = static_cast<int>(floor((lon - deg) * 60.0 * 1000 + 0.5)) / static_cast<double>(1000.0);
-  return TLongitude{deg + min / 60};
+  return Positions(CPointArray{point}).front();
 }
 
 
 /**
- * @brief Converts Condor coordinates to double latitude value.
+ * @brief Converts an array of Condor coordinates to raw NaviCon.dll values.
  *
- * Method converts Condor coordinates to latitude.
+ * Method converts all provided Condor coordinates to longitude and latitude values
+ * in one pass. Values missing in the cache are sent to the landscape worker in
+ * one request if workers pool is used.
  * 
- * @param x The x coordinate.
- * @param y The y coordinate. 
+ * @param points Condor map coordinates.
  *
- * @return Converted double latitude value.
+ * @return Longitude and latitude values stored one after another (in the same order as provided points).
  */
-condor2nav::TLatitude condor2nav::CCondor::CCoordConverter::Latitude(const std::string &x, const std::string &y) const
+std::vector<float> condor2nav::CCondor::CCoordConverter::Values(const CPointArray &points) const
 {
-  auto xVal = Convert<float>(x);
-  auto yVal = Convert<float>(y);
-  auto lat = _iface->xyToLat(xVal, yVal);
-  auto deg = static_cast<int>(lat);
-  auto min = static_cast<int>(floor((lat - deg) * 60.0 * 1000 + 0.5)) / static_cast<double>(1000.0);
-  return TLatitude{deg + min / 60};
+  std::vector<float> values(points.size() * 2);
+  std::lock_guard<std::mutex> lock{_mutex};
+
+  std::vector<size_t> missing;
+  for(size_t i = 0; i < points.size(); ++i) {
+    auto it = _cache.find(CacheKey(points[i].x, points[i].y));
+    if(it == _cache.end()) {
+      missing.push_back(i);
+      continue;
+    }
+    values[2 * i] = it->second.first;
+    values[2 * i + 1] = it->second.second;
+  }
+  if(missing.empty())
+    return values;
+
+  CTraceScope trace{"navicon", "Convert", _trnName};
+  if(_pool) {
+    std::vector<float> request;
+    request.reserve(missing.size() * 2);
+    for(auto i : missing) {
+      request.push_back(points[i].x);
+      request.push_back(points[i].y);
+    }
+    const auto response = _pool->Convert(_condorPath, _trnName, request);
+    for(size_t j = 0; j < missing.size(); ++j) {
+      values[2 * missing[j]] = response[2 * j];
+      values[2 * missing[j] + 1] = response[2 * j + 1];
+    }
+  }
+  else {
+    const auto &iface = Iface();
+    std::lock_guard<std::mutex> naviConLock{naviConMutex};
+    Activate(iface);
+    for(auto i : missing) {
+      values[2 * i] = iface.xyToLon(points[i].x, points[i].y);
+      values[2 * i + 1] = iface.xyToLat(points[i].x, points[i].y);
+    }
+  }
+
+  for(auto i : missing)
+    _cache.emplace(CacheKey(points[i].x, points[i].y), std::make_pair(values[2 * i], values[2 * i + 1]));
+  _cacheModified = _cacheEnabled;
+  return values;
+}
+
+
+/**
+ * @brief Converts an array of Condor coordinates to geographic positions.
+ *
+ * Method converts all provided Condor coordinates to longitude and latitude values
+ * in one pass. Converted values are rounded to 1/1000 of a minute.
+ * 
+ * @param points Condor map coordinates.
+ *
+ * @return Converted positions (in the same order as provided points).
+ */
+auto condor2nav::CCondor::CCoordConverter::Positions(const CPointArray &points) const -> CPositionArray
+{
+  // convert coordinates (longitude and latitude stored one after another)
+  const auto raw = Values(points);
+  std::vector<double> values(raw.begin(), raw.end());
+
+  // round minutes
+  for(auto &value : values) {
+    auto deg = static_cast<int>(value);
+    auto min = static_cast<int>(floor((value - deg) * 60.0 * 1000 + 0.5)) / 1000.0;
+    value = deg + min / 60;
+  }
+
+  CPositionArray positions;
+  positions.reserve(points.size());
+  for(size_t i = 0; i < points.size(); ++i)
+    positions.push_back(TPosition{TLongitude{values[2 * i]}, TLatitude{values[2 * i + 1]}});
+  return positions;
 }
 
 
@@ -164,18 +492,216 @@ condor2nav::TLatitude condor2nav::CCondor::CCoordConverter::Latitude(const std::
  * 
  * @param condorPath Full pathname of the Condor directory. 
  * @param fplPath    Condor FPL file to convert path
+ * @param naviConPool NaviCon.dll workers pool (nullptr to use NaviCon.dll in-process)
  *
  * @exception std Thrown when not supported Condor version.
  */
-condor2nav::CCondor::CCondor(const bfs::path &condorPath, const bfs::path &fplPath):
+condor2nav::CCondor::CCondor(const bfs::path &condorPath, const bfs::path &fplPath, const CNaviConPool *naviConPool):
+_condorPath{condorPath},
 _taskParser{fplPath},
-_coordConverter{condorPath, _taskParser.Value("Task", "Landscape")}
+_naviConPool{naviConPool}
 {
-  if(Convert<unsigned>(_taskParser.Value("Version", "Condor version")) < CONDOR_VERSION_SUPPORTED)
+  if(Convert<unsigned>(_taskParser.Value("Version", "Condor version")) < condor::VERSION_SUPPORTED)
     throw EOperationFailed{"Condor vesion '" + _taskParser.Value("Version", "Condor version") + "' not supported!!!"};
 }
 
 
+/**
+ * @brief Returns Condor map coordinates converter.
+ *
+ * Method returns Condor map coordinates converter for the task landscape.
+ * The converter is created on the first use so translations that do not
+ * need coordinates conversion do not pay for its initialization.
+ *
+ * @return Condor map coordinates converter.
+ */
+auto condor2nav::CCondor::CoordConverter() const -> const CCoordConverter &
+{
+  std::lock_guard<std::mutex> lock{_coordConverterMutex};
+  if(!_coordConverter)
+    _coordConverter = std::make_shared<const CCoordConverter>(_condorPath, _taskParser.Value("Task", "Landscape"), _naviConPool);
+  return *_coordConverter;
+}
+
+
+/**
+ * @brief Returns shared Condor map coordinates converter.
+ *
+ * Converter may be shared with other tasks of the same landscape (see
+ * condor2nav::CCondor::CoordConverterShare()).
+ *
+ * @return Condor map coordinates converter.
+ */
+auto condor2nav::CCondor::CoordConverterShared() const -> std::shared_ptr<const CCoordConverter>
+{
+  CoordConverter();
+  std::lock_guard<std::mutex> lock{_coordConverterMutex};
+  return _coordConverter;
+}
+
+
+/**
+ * @brief Uses already initialized coordinates converter.
+ *
+ * Method makes the task use the converter created for another task of the
+ * same landscape so that its cache and NaviCon.dll are initialized only once.
+ *
+ * @param coordConverter Condor map coordinates converter of the task landscape.
+ *
+ * @exception std Thrown when the converter was already used or is of a different landscape.
+ */
+void condor2nav::CCondor::CoordConverterShare(std::shared_ptr<const CCoordConverter> coordConverter)
+{
+  std::lock_guard<std::mutex> lock{_coordConverterMutex};
+  if(_coordConverter)
+    throw EOperationFailed{"ERROR: Coordinates converter already in use!!!"};
+  if(coordConverter->Landscape() != _taskParser.Value("Task", "Landscape"))
+    throw EOperationFailed{"ERROR: Coordinates converter of landscape '" + coordConverter->Landscape() + "' cannot be used for '" + _taskParser.Value("Task", "Landscape") + "' task!!!"};
+  _coordConverter = std::move(coordConverter);
+}
+
+
+/**
+ * @brief Returns Condor task.
+ *
+ * Method returns the task of the FPL file. The task is created on the first
+ * use.
+ *
+ * @exception std Thrown when the FPL file task data is invalid.
+ *
+ * @return Condor task.
+ */
+auto condor2nav::CCondor::Task() const -> const CTask &
+{
+  std::lock_guard<std::mutex> lock{_taskMutex};
+  if(!_task)
+    _task = std::make_unique<const CTask>(*this);
+  return *_task;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CCondor::CTask class constructor. Turnpoints and penalty zones
+ * are not read until they are used so that translations which do not need
+ * them do not pay for their parsing and coordinates conversion.
+ *
+ * @param condor Condor task data.
+ */
+condor2nav::CCondor::CTask::CTask(const CCondor &condor) :
+  _condor(condor), _landscape{condor._taskParser.Value("Task", "Landscape")}
+{
+}
+
+
+/**
+ * @brief Returns task turnpoints.
+ *
+ * Method reads all the turnpoints on the first use and converts their
+ * coordinates with one call.
+ *
+ * @exception std Thrown when the FPL file turnpoints data is invalid.
+ *
+ * @return Task turnpoints (including takeoff).
+ */
+auto condor2nav::CCondor::CTask::Turnpoints() const -> const CTurnpointArray &
+{
+  std::lock_guard<std::mutex> lock{_turnpointsMutex};
+  if(_turnpoints)
+    return *_turnpoints;
+
+  const auto &taskParser = _condor._taskParser;
+  const auto tpNum = Convert<unsigned>(taskParser.Value("Task", "Count"));
+
+  CCoordConverter::CPointArray points;
+  points.reserve(tpNum);
+  for(unsigned i=0; i<tpNum; i++) {
+    const auto idx = Convert(i);
+    points.push_back(CCoordConverter::TPoint{Convert<float>(taskParser.Value("Task", "TPPosX" + idx)),
+                                             Convert<float>(taskParser.Value("Task", "TPPosY" + idx))});
+  }
+  const auto positions = _condor.CoordConverter().Positions(points);
+
+  auto turnpoints = std::make_unique<CTurnpointArray>();
+  turnpoints->reserve(tpNum);
+  for(unsigned i=0; i<tpNum; i++) {
+    const auto idx = Convert(i);
+    turnpoints->push_back(TTurnpoint{taskParser.Value("Task", "TPName" + idx),
+                                     positions[i],
+                                     Convert<double>(taskParser.Value("Task", "TPPosZ" + idx)),
+                                     Convert<unsigned>(taskParser.Value("Task", "TPSectorType" + idx)),
+                                     Convert<unsigned>(taskParser.Value("Task", "TPRadius" + idx)),
+                                     Convert<unsigned>(taskParser.Value("Task", "TPAngle" + idx)),
+                                     Convert<unsigned>(taskParser.Value("Task", "TPHeight" + idx)),
+                                     Convert<unsigned>(taskParser.Value("Task", "TPWidth" + idx))});
+  }
+  _turnpoints = std::move(turnpoints);
+  return *_turnpoints;
+}
+
+
+/**
+ * @brief Returns task penalty zones.
+ *
+ * Method reads all the penalty zones on the first use and converts the
+ * coordinates of their corners with one call.
+ *
+ * @exception std Thrown when the FPL file penalty zones data is invalid.
+ *
+ * @return Task penalty zones.
+ */
+auto condor2nav::CCondor::CTask::PenaltyZones() const -> const CPenaltyZoneArray &
+{
+  std::lock_guard<std::mutex> lock{_penaltyZonesMutex};
+  if(_penaltyZones)
+    return *_penaltyZones;
+
+  const auto &taskParser = _condor._taskParser;
+  const auto pzNum = Convert<unsigned>(taskParser.Value("Task", "PZCount"));
+
+  CCoordConverter::CPointArray points;
+  points.reserve(pzNum * 4);
+  for(unsigned i=0; i<pzNum; i++) {
+    const auto idx = Convert(i);
+    for(unsigned j=0; j<4; j++) {
+      const auto corner = Convert(j);
+      points.push_back(CCoordConverter::TPoint{Convert<float>(taskParser.Value("Task", "PZPos" + corner + "X" + idx)),
+                                               Convert<float>(taskParser.Value("Task", "PZPos" + corner + "Y" + idx))});
+    }
+  }
+  const auto positions = pzNum ? _condor.CoordConverter().Positions(points) : CCoordConverter::CPositionArray{};
+
+  auto penaltyZones = std::make_unique<CPenaltyZoneArray>();
+  penaltyZones->reserve(pzNum);
+  for(unsigned i=0; i<pzNum; i++) {
+    const auto idx = Convert(i);
+    const auto corners = positions.begin() + i * 4;
+    penaltyZones->push_back(TPenaltyZone{{{corners[0], corners[1], corners[2], corners[3]}},
+                                         Convert<unsigned>(taskParser.Value("Task", "PZBase" + idx)),
+                                         Convert<double>(taskParser.Value("Task", "PZTop" + idx))});
+  }
+  _penaltyZones = std::move(penaltyZones);
+  return *_penaltyZones;
+}
+
+
+/**
+ * @brief Returns the positions of all the turnpoints.
+ *
+ * @return Turnpoints positions (including takeoff).
+ */
+auto condor2nav::CCondor::CTask::Positions() const -> CCoordConverter::CPositionArray
+{
+  const auto &turnpoints = Turnpoints();
+  CCoordConverter::CPositionArray positions;
+  positions.reserve(turnpoints.size());
+  for(const auto &tp : turnpoints)
+    positions.push_back(tp.position);
+  return positions;
+}
+
+
 
 /**
 * @brief Returns a path to Condor: The Competition Soaring Simulator
@@ -201,6 +727,40 @@ bfs::path condor2nav::condor::InstallPath()
 }
 
 
+/**
+* @brief Returns the directory of user flight plans.
+*
+* @param configParser     The INI file configuration parser.
+* @param condorPath       Full pathname of the Condor: The Competition Soaring Simulator.
+*
+* @return Directory configured with 'Condor/FlightPlansPath' or the Condor default one.
+*/
+bfs::path condor2nav::condor::FlightPlansPath(const CFileParserINI &configParser, const bfs::path &condorPath)
+{
+  auto path = bfs::path{configParser.Value("Condor", "FlightPlansPath")};
+  if(path.empty())
+    path = condorPath / FLIGHT_PLANS_PATH;
+  return path;
+}
+
+
+/**
+* @brief Returns the directory of race results.
+*
+* @param configParser     The INI file configuration parser.
+* @param condorPath       Full pathname of the Condor: The Competition Soaring Simulator.
+*
+* @return Directory configured with 'Condor/RaceResultsPath' or the Condor default one.
+*/
+bfs::path condor2nav::condor::RaceResultsPath(const CFileParserINI &configParser, const bfs::path &condorPath)
+{
+  auto path = bfs::path{configParser.Value("Condor", "RaceResultsPath")};
+  if(path.empty())
+    path = condorPath / RACE_RESULTS_PATH;
+  return path;
+}
+
+
 /**
 * @brief Returns FPL file path.
 *
@@ -220,28 +780,199 @@ bfs::path condor2nav::condor::FPLPath(const CFileParserINI &configParser,
 {
   bfs::path fplPath;
   if(fplType == CCondor2Nav::TFPLType::DEFAULT) {
-    auto fplPathUser = bfs::path{configParser.Value("Condor", "FlightPlansPath")};
-    if(fplPathUser.empty())
-      fplPath = condorPath / FLIGHT_PLANS_PATH / (configParser.Value("Condor", "DefaultTaskName") + ".fpl");
-    else
-      fplPath = fplPathUser / (configParser.Value("Condor", "DefaultTaskName") + ".fpl");
+    fplPath = FlightPlansPath(configParser, condorPath) / (configParser.Value("Condor", "DefaultTaskName") + ".fpl");
   }
   else if(fplType == CCondor2Nav::TFPLType::RESULT) {
-    auto resultsPath = bfs::path{configParser.Value("Condor", "RaceResultsPath")};
-    if(resultsPath.empty())
-      resultsPath = condorPath / RACE_RESULTS_PATH;
-
-    // find the latest race result
-    std::vector<bfs::path> results;
-    std::copy_if(bfs::directory_iterator(resultsPath), bfs::directory_iterator(), std::back_inserter(results),
-                 [](const bfs::path &f){ return CStringNoCase{f.extension().string().c_str()} == ".fpl"; });
-    auto result = std::max_element(cbegin(results), cend(results),
-                                   [](const bfs::path &f1, const bfs::path &f2)
-    { return bfs::last_write_time(f1) < bfs::last_write_time(f2); });
-    if(result != results.end())
-      fplPath = result->string();
-    else
-      throw EOperationFailed{"ERROR: Cannot find last result FPL file in '" + fplPath.string() + "'(" + Convert(GetLastError()) + ")!!!"};
+    const auto resultsPath = RaceResultsPath(configParser, condorPath);
+    fplPath = RaceResultLatest(resultsPath);
+    if(fplPath.empty())
+      throw EOperationFailed{"ERROR: Cannot find last result FPL file in '" + resultsPath.string() + "'!!!"};
   }
   return fplPath;
 }
+
+
+namespace {
+
+  /**
+  * @brief Stores race results index.
+  *
+  * @note Should be called with the index mutex locked.
+  *
+  * @param resultsPath The directory of race results.
+  * @param latest      Full pathname of the latest race result FPL file.
+  * @param latestTime  Modification time of the latest race result FPL file.
+  */
+  void RaceResultsIndexStore(const bfs::path &resultsPath, const bfs::path &latest, std::time_t latestTime)
+  {
+    try {
+      condor2nav::DirectoryCreate(RACE_RESULTS_INDEX_PATH.parent_path());
+      condor2nav::COStream index{RACE_RESULTS_INDEX_PATH};
+      index << "Path=" << resultsPath.string() << std::endl;
+      index << "Latest=" << latest.string() << std::endl;
+      index << "LatestTime=" << condor2nav::Convert(static_cast<std::int64_t>(latestTime)) << std::endl;
+      index.Commit();
+    }
+    catch(const std::exception &) {
+      // index is only an optimization
+    }
+  }
+
+}
+
+
+/**
+* @brief Returns the latest race result.
+*
+* Method uses the race results index stored by the previous call. The index is
+* valid as long as the latest result was not modified since then and the results
+* directory was not modified after the latest result was written (no result was
+* added later), so the check does not depend on the number of race results. Otherwise
+* the directory is scanned once, reading the modification time of every FPL file
+* only once, and the index is updated.
+*
+* @param resultsPath The directory of race results.
+*
+* @return Full pathname of the latest race result FPL file or empty path if not found.
+*/
+bfs::path condor2nav::condor::RaceResultLatest(const bfs::path &resultsPath)
+{
+  std::lock_guard<std::mutex> lock{raceResultsIndexMutex};
+  boost::system::error_code ec;
+  const auto dirTime = bfs::last_write_time(resultsPath, ec);
+  if(ec)
+    return bfs::path{};
+
+  // check the index
+  try {
+    const CFileParserINI index{RACE_RESULTS_INDEX_PATH};
+    const bfs::path latest{index.Value("", "Latest")};
+    if(index.Value("", "Path") == resultsPath.string()) {
+      const auto latestTime = bfs::last_write_time(latest, ec);
+      if(!ec && Convert<std::int64_t>(index.Value("", "LatestTime")) == latestTime && dirTime <= latestTime)
+        return latest;
+    }
+  }
+  catch(const Exception &) {
+  }
+
+  // find the latest race result
+  bfs::path latest;
+  std::time_t latestTime = 0;
+  for(bfs::directory_iterator it{resultsPath, ec}, end; !ec && it != end; it.increment(ec)) {
+    const auto &path = it->path();
+    if(CStringNoCase{path.extension().string().c_str()} != ".fpl")
+      continue;
+    const auto time = bfs::last_write_time(path, ec);
+    if(ec)
+      continue;
+    if(latest.empty() || time > latestTime) {
+      latest = path;
+      latestTime = time;
+    }
+  }
+  if(!latest.empty())
+    RaceResultsIndexStore(resultsPath, latest, latestTime);
+  return latest;
+}
+
+
+/**
+* @brief Updates race results index with a new race result.
+*
+* Method should be called when directory changes notifications report a new
+* race result so that the next lookup does not have to scan the directory.
+*
+* @param resultsPath The directory of race results.
+* @param fplPath     Full pathname of the new race result FPL file.
+*/
+void condor2nav::condor::RaceResultAdded(const bfs::path &resultsPath, const bfs::path &fplPath)
+{
+  std::lock_guard<std::mutex> lock{raceResultsIndexMutex};
+  boost::system::error_code ec;
+  const auto fplTime = bfs::last_write_time(fplPath, ec);
+  if(ec)
+    return;
+
+  // do not replace newer result
+  try {
+    const CFileParserINI index{RACE_RESULTS_INDEX_PATH};
+    if(index.Value("", "Path") == resultsPath.string() &&
+       Convert<std::int64_t>(index.Value("", "LatestTime")) > fplTime)
+      return;
+  }
+  catch(const Exception &) {
+  }
+  RaceResultsIndexStore(resultsPath, fplPath, fplTime);
+}
+
+
+/**
+* @brief Returns the summary of FPL file.
+*
+* Method reads only the entries needed to describe the task from the FPL file.
+* No values are stored for other entries and Condor coordinates converter is not used.
+*
+* @param fplPath Full pathname of the FPL file.
+*
+* @exception std Thrown when FPL file cannot be read or Condor version is not supported.
+*
+* @return The summary of FPL file.
+*/
+condor2nav::condor::TFPLSummary condor2nav::condor::FPLSummary(const bfs::path &fplPath)
+{
+  TFPLSummary summary{};
+  bool versionFound = false;
+  bool countFound = false;
+
+  CIStream stream{fplPath};
+  boost::string_ref line;
+  boost::string_ref chapter;
+  while(stream.GetLine(line)) {
+    line = Trim(line);
+    if(line.empty() || line[0] == ';' || line[0] == '#')
+      continue;
+
+    if(line[0] == '[') {
+      auto pos = line.find(']');
+      chapter = pos == boost::string_ref::npos ? boost::string_ref{} : Trim(line.substr(1, pos - 1));
+      continue;
+    }
+
+    if(chapter != "Version" && chapter != "Task" && chapter != "Plane")
+      continue;
+
+    auto pos = line.find('=');
+    if(pos == boost::string_ref::npos)
+      continue;
+    auto key = Trim(line.substr(0, pos));
+    auto value = Trim(line.substr(pos + 1));
+
+    if(chapter == "Version") {
+      if(key == "Condor version") {
+        summary.version = Convert<unsigned>(value.to_string());
+        versionFound = true;
+      }
+    }
+    else if(chapter == "Task") {
+      if(key == "Landscape")
+        summary.landscape = value.to_string();
+      else if(key == "Count") {
+        summary.tpCount = Convert<unsigned>(value.to_string());
+        countFound = true;
+      }
+      else if(key == "AAT")
+        summary.aat = value.to_string();
+      else if(key == "DesignatedTime")
+        summary.designatedTime = value.to_string();
+    }
+    else if(key == "Name")
+      summary.plane = value.to_string();
+  }
+
+  if(!versionFound || !countFound || summary.landscape.empty())
+    throw EOperationFailed{"ERROR: '" + fplPath.string() + "' does not look like a Condor FPL file!!!"};
+  if(summary.version < VERSION_SUPPORTED)
+    throw EOperationFailed{"Condor vesion '" + Convert(summary.version) + "' not supported!!!"};
+  return summary;
+}
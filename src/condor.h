@@ -32,6 +32,13 @@
 #include "nonCopyable.h"
 #include "fileParserINI.h"
 #include "boostfwd.h"
+#include "naviConPool.h"
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
 #include <windows.h>
 
 namespace condor2nav {
@@ -51,27 +58,142 @@ namespace condor2nav {
      * condor2nav::CCondor::CCoordConverter is responsible for
      * Condor map coordinates convertions. It uses NaviCon.dll library
      * provided with every Condor release.
+     *
+     * Conversion results are stored in a per-landscape cache file that is
+     * valid as long as the landscape terrain file is not changed. The DLL
+     * is loaded only when a value not found in the cache is requested.
+     * If condor2nav::CNaviConPool is provided, missing values are converted
+     * by the landscape worker process instead of the NaviCon.dll loaded
+     * by the application.
      */
     class CCoordConverter : CNonCopyable {
+    public:
+      /**
+       * @brief Condor map coordinates.
+       */
+      struct TPoint {
+        float x;
+        float y;
+      };
+      using CPointArray = std::vector<TPoint>;
+
+      /**
+       * @brief Geographic position.
+       */
+      struct TPosition {
+        TLongitude longitude;
+        TLatitude latitude;
+      };
+      using CPositionArray = std::vector<TPosition>;
+
+    private:
       struct TDLLIface;
-      std::unique_ptr<TDLLIface> _iface;	       ///< @brief DLL interface.
-      CLibraryRes _lib;                            ///< @brief DLL instance. 
+      using CCache = std::unordered_map<std::uint64_t, std::pair<float, float>>;  ///< @brief Converted (lon, lat) values indexed by (x, y).
+
+      static const bfs::path CACHE_DIR;            ///< @brief The directory with coordinates conversion cache files.
+      static const std::uint32_t CACHE_VERSION = 1;///< @brief The version of cache file format.
+
+      const bfs::path _condorPath;                 ///< @brief The path to Condor directory.
+      const std::string _trnName;                  ///< @brief The name of the terrain.
+      const CNaviConPool *const _pool;             ///< @brief NaviCon.dll workers pool (nullptr to use NaviCon.dll in-process).
+      std::int64_t _trnTime;                       ///< @brief Last modification time of the terrain file.
+      std::uint64_t _trnSize;                      ///< @brief The size of the terrain file.
+      bool _cacheEnabled;                          ///< @brief Terrain file was found so results can be cached.
+
+      mutable std::mutex _mutex;                   ///< @brief Protects the data below.
+      mutable std::unique_ptr<TDLLIface> _iface;   ///< @brief DLL interface.
+      mutable CLibraryRes _lib;                    ///< @brief DLL instance. 
+      mutable CCache _cache;                       ///< @brief Conversion results.
+      mutable bool _cacheModified;                 ///< @brief New results were added to the cache.
+      mutable float _maxX;                         ///< @brief Landscape max X coordinate.
+      mutable float _maxY;                         ///< @brief Landscape max Y coordinate.
+      mutable bool _maxValid;                      ///< @brief Max coordinates are known.
+
+      bfs::path CachePath() const;
+      void CacheLoad();
+      void CacheSave() const;
+      const TDLLIface &Iface() const;
+      void Activate(const TDLLIface &iface) const;
+      void MaxInit() const;
+
     public:
-      CCoordConverter(const bfs::path &condorPath, const std::string &trnName);
+      CCoordConverter(bfs::path condorPath, std::string trnName, const CNaviConPool *pool = nullptr, bool cache = true);
       ~CCoordConverter();
-      TLongitude Longitude(const std::string &x, const std::string &y) const;
-      TLatitude Latitude(const std::string &x, const std::string &y) const;
+      const std::string &Landscape() const { return _trnName; }
+      float MaxX() const;
+      float MaxY() const;
+      std::vector<float> Values(const CPointArray &points) const;
+      TPosition Position(const TPoint &point) const;
+      CPositionArray Positions(const CPointArray &points) const;
+    };
+
+    /**
+     * @brief Condor task.
+     *
+     * condor2nav::CCondor::CTask provides task turnpoints and penalty zones
+     * with typed fields. Turnpoints and penalty zones are parsed from the FPL
+     * file on their first use and all of their coordinates are converted with
+     * one call so that all the translation targets only read the same data.
+     */
+    class CTask : CNonCopyable {
+    public:
+      /**
+       * @brief Task turnpoint.
+       */
+      struct TTurnpoint {
+        std::string name;                        ///< @brief Turnpoint name.
+        CCoordConverter::TPosition position;     ///< @brief Turnpoint position.
+        double altitude;                         ///< @brief Turnpoint altitude [m].
+        unsigned sectorType;                     ///< @brief Sector type (condor::TSectorType).
+        unsigned radius;                         ///< @brief Sector radius [m].
+        unsigned angle;                          ///< @brief Sector angle [deg].
+        unsigned height;                         ///< @brief Sector max height [m].
+        unsigned width;                          ///< @brief Sector min height [m].
+      };
+      using CTurnpointArray = std::vector<TTurnpoint>;
+
+      /**
+       * @brief Task penalty zone.
+       */
+      struct TPenaltyZone {
+        std::array<CCoordConverter::TPosition, 4> corners;  ///< @brief Penalty zone corners positions.
+        unsigned base;                                      ///< @brief Penalty zone bottom [m] (0 for ground).
+        double top;                                         ///< @brief Penalty zone top [m].
+      };
+      using CPenaltyZoneArray = std::vector<TPenaltyZone>;
+
+    private:
+      const CCondor &_condor;                                          ///< @brief Condor task data.
+      std::string _landscape;                                          ///< @brief Task landscape name.
+      mutable std::mutex _turnpointsMutex;                             ///< @brief Protects turnpoints parsing.
+      mutable std::unique_ptr<const CTurnpointArray> _turnpoints;      ///< @brief Task turnpoints (including takeoff, parsed on first use).
+      mutable std::mutex _penaltyZonesMutex;                           ///< @brief Protects penalty zones parsing.
+      mutable std::unique_ptr<const CPenaltyZoneArray> _penaltyZones;  ///< @brief Task penalty zones (parsed on first use).
+
+    public:
+      explicit CTask(const CCondor &condor);
+      const std::string &Landscape() const { return _landscape; }
+      const CTurnpointArray &Turnpoints() const;
+      const CPenaltyZoneArray &PenaltyZones() const;
+      CCoordConverter::CPositionArray Positions() const;
     };
 
   private:
-    static const unsigned CONDOR_VERSION_SUPPORTED = 1120;	  ///< @brief Supported Condor version.
+    const bfs::path _condorPath;                   ///< @brief Condor directory. 
     const CFileParserINI _taskParser;	           ///< @brief Condor task file parser. 
-    const CCoordConverter _coordConverter;	       ///< @brief Condor map coordinates converter. 
+    const CNaviConPool *const _naviConPool;        ///< @brief NaviCon.dll workers pool (may be nullptr). 
+    mutable std::mutex _coordConverterMutex;       ///< @brief Protects coordinates converter creation. 
+    mutable std::shared_ptr<const CCoordConverter> _coordConverter;	 ///< @brief Condor map coordinates converter (created on first use). 
+    mutable std::mutex _taskMutex;                 ///< @brief Protects task creation. 
+    mutable std::unique_ptr<const CTask> _task;    ///< @brief Condor task (created on first use). 
 
   public:
-    CCondor(const bfs::path &condorPath, const bfs::path &fplPath);
+    CCondor(const bfs::path &condorPath, const bfs::path &fplPath, const CNaviConPool *naviConPool = nullptr);
     const CFileParserINI &TaskParser() const      { return _taskParser; }
-    const CCoordConverter &CoordConverter() const { return _coordConverter; }
+    const CCoordConverter &CoordConverter() const;
+    std::shared_ptr<const CCoordConverter> CoordConverterShared() const;
+    void CoordConverterShare(std::shared_ptr<const CCoordConverter> coordConverter);
+    const CTask &Task() const;
   };
 
   namespace condor {
@@ -84,10 +206,29 @@ namespace condor2nav {
       SECTOR_WINDOW	        ///< @brief Window. 
     };
 
+    const unsigned VERSION_SUPPORTED = 1120;	  ///< @brief Supported Condor version.
+
+    /**
+     * @brief The summary of FPL file.
+     */
+    struct TFPLSummary {
+      unsigned version;               ///< @brief Condor version.
+      std::string landscape;          ///< @brief Task landscape.
+      std::string aat;                ///< @brief AAT task type ("" for not AAT tasks).
+      std::string designatedTime;     ///< @brief AAT task designated time.
+      std::string plane;              ///< @brief Plane name.
+      unsigned tpCount;               ///< @brief The number of task points (including takeoff).
+    };
+
     bfs::path InstallPath();
+    bfs::path FlightPlansPath(const CFileParserINI &configParser, const bfs::path &condorPath);
+    bfs::path RaceResultsPath(const CFileParserINI &configParser, const bfs::path &condorPath);
     bfs::path FPLPath(const CFileParserINI &configParser,
                       CCondor2Nav::TFPLType fplType,
                       const bfs::path &condorPath);
+    bfs::path RaceResultLatest(const bfs::path &resultsPath);
+    void RaceResultAdded(const bfs::path &resultsPath, const bfs::path &fplPath);
+    TFPLSummary FPLSummary(const bfs::path &fplPath);
 
   }
 
@@ -27,8 +27,181 @@
 
 #include "condor2nav.h"
 #include "lkMapsDB.h"
+#include "translator.h"
+#include "activeSync.h"
+#include "naviConPool.h"
+#include "waitQueue.h"
+#include "traceLog.h"
+#include "memoryAccount.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <windows.h>
 
 const char *condor2nav::CCondor2Nav::CONFIG_FILE_NAME = "condor2nav.ini";
+const char *condor2nav::CCondor2Nav::TRACE_FILE_NAME = "condor2nav-trace.json";
+
+namespace condor2nav {
+
+  /**
+   * @brief Background logs sink.
+   *
+   * Class owns the thread that dumps logged lines to their loggers. Lines are
+   * provided by any thread through a lock-free queue so logging never waits
+   * for a slow console or logging window.
+   */
+  class CLogSink : CNonCopyable {
+    struct TMessage {
+      const CCondor2Nav::CLogger *logger;
+      std::string text;
+    };
+
+    static const unsigned QUEUE_CAPACITY = 4096;                            ///< @brief Max number of pending lines
+    static const unsigned IDLE_TIMEOUT = 20;                                ///< @brief Max time to sleep with an empty queue [ms]
+
+    CMPSCRingQueue<TMessage> _queue{QUEUE_CAPACITY};   ///< @brief Pending lines
+    std::atomic<unsigned long long> _queued{0};        ///< @brief Number of lines queued so far
+    std::atomic<unsigned long long> _processed{0};     ///< @brief Number of lines dumped so far
+    std::atomic<bool> _sleeping{false};                ///< @brief Sink thread waits for new lines
+    std::atomic<bool> _quit{false};                    ///< @brief Sink thread should finish
+    std::mutex _mutex;
+    std::condition_variable _dataReady;
+    std::thread _thread;
+
+    void Run();
+
+  public:
+    CLogSink();
+    ~CLogSink();
+    void Push(const CCondor2Nav::CLogger &logger, std::string &&text);
+    void Flush();
+  };
+
+}
+
+
+namespace {
+
+  std::mutex instanceMutex;
+  std::unique_ptr<condor2nav::CLogSink> sink;
+
+  /**
+   * @brief Returns the logs sink.
+   *
+   * The sink is created on first use and lives until the application exits.
+   *
+   * @return Logs sink.
+   */
+  condor2nav::CLogSink &LogSink()
+  {
+    std::lock_guard<std::mutex> lock{instanceMutex};
+    if(!sink)
+      sink = std::make_unique<condor2nav::CLogSink>();
+    return *sink;
+  }
+
+}
+
+
+const unsigned condor2nav::CLogSink::QUEUE_CAPACITY;
+const unsigned condor2nav::CLogSink::IDLE_TIMEOUT;
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Starts the sink thread.
+ */
+condor2nav::CLogSink::CLogSink()
+{
+  _thread = std::thread{[this]{ Run(); }};
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Dumps all pending lines and stops the sink thread.
+ */
+condor2nav::CLogSink::~CLogSink()
+{
+  Flush();
+  _quit = true;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _dataReady.notify_one();
+  }
+  _thread.join();
+}
+
+
+/**
+ * @brief Sink thread function.
+ *
+ * Dumps queued lines to their loggers until asked to quit.
+ */
+void condor2nav::CLogSink::Run()
+{
+  TMessage msg;
+  while(true) {
+    if(_queue.TryPop(msg)) {
+      try {
+        msg.logger->Trace(msg.text);
+      }
+      catch(...) {
+        // logging failures cannot be reported anywhere
+      }
+      msg.text.clear();
+      ++_processed;
+      continue;
+    }
+
+    if(_quit)
+      break;
+
+    std::unique_lock<std::mutex> lock{_mutex};
+    _sleeping = true;
+    _dataReady.wait_for(lock, std::chrono::milliseconds{IDLE_TIMEOUT});
+    _sleeping = false;
+  }
+}
+
+
+/**
+ * @brief Queues a line to be dumped by the sink thread.
+ *
+ * Method yields while the queue is full.
+ *
+ * @param logger Logger to use.
+ * @param text   Line text.
+ */
+void condor2nav::CLogSink::Push(const CCondor2Nav::CLogger &logger, std::string &&text)
+{
+  TMessage msg{&logger, std::move(text)};
+  while(!_queue.TryPush(std::move(msg)))
+    std::this_thread::yield();
+  ++_queued;
+  if(_sleeping) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _dataReady.notify_one();
+  }
+}
+
+
+/**
+ * @brief Waits until all the lines queued so far are dumped.
+ */
+void condor2nav::CLogSink::Flush()
+{
+  const auto queued = _queued.load();
+  while(_processed < queued)
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+}
+
 
 /**
  * @brief Class constructor. 
@@ -42,29 +215,334 @@ condor2nav::CCondor2Nav::CLogger::CLogger(TType type) :
 }
 
 
+/**
+ * @brief Class destructor.
+ *
+ * Queues the line to the background sink.
+ */
+condor2nav::CCondor2Nav::CLogger::CLine::~CLine()
+{
+  if(_logger && !_text.empty())
+    LogSink().Push(*_logger, std::move(_text));
+}
+
+
+/**
+ * @brief Waits until all the lines logged so far are dumped.
+ *
+ * Has to be called by derived loggers before they are destroyed.
+ */
+void condor2nav::CCondor2Nav::CLogger::Flush()
+{
+  LogSink().Flush();
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Reads the configuration file and applies global I/O settings. If any
+ * translation target writes to ActiveSync device the connection handshake
+ * is started in the background so it overlaps with the task data parsing.
+ * When LK8000 maps synchronization is enabled translations wait for the maps
+ * matching done by OnStart(). Coordinates are converted by NaviCon.dll worker
+ * processes if they are enabled and the worker executable is installed next
+ * to the application.
+ */
 condor2nav::CCondor2Nav::CCondor2Nav() :
   _configParser{CONFIG_FILE_NAME}
+{
+  try {
+    CTraceLog::Enable(_configParser.Value("Condor2Nav", "Trace") == "1");
+  }
+  catch(const Exception &) {
+  }
+
+  try {
+    _memoryReport = _configParser.Value("Condor2Nav", "MemoryReport") == "1";
+  }
+  catch(const Exception &) {
+  }
+
+  try {
+    CActiveSync::BlockSize(Convert<unsigned>(_configParser.Value("Condor2Nav", "ActiveSyncBlockSize")));
+  }
+  catch(const Exception &) {
+  }
+
+  try {
+    for(const auto &name : CTranslator::TargetNames(_configParser)) {
+      if(PathType(CTranslator::OutputPath(_configParser, name)) == TPathType::ACTIVE_SYNC) {
+        CActiveSync::Warmup();
+        break;
+      }
+    }
+  }
+  catch(const Exception &) {
+    // configuration errors are reported by the translation
+  }
+
+  try {
+    _mapsMatching = MapsCheck();
+  }
+  catch(const Exception &) {
+  }
+
+  try {
+    const auto workers = Convert<unsigned>(_configParser.Value("Condor", "NaviConWorkers"));
+    wchar_t exePath[MAX_PATH];
+    if(workers && GetModuleFileNameW(nullptr, exePath, MAX_PATH)) {
+      const auto workerPath = bfs::path{exePath}.parent_path() / CNaviConPool::WORKER_FILE_NAME;
+      if(bfs::exists(workerPath))
+        _naviConPool = std::make_unique<CNaviConPool>(workerPath, workers);
+    }
+  }
+  catch(const Exception &) {
+  }
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * NOTE: Destructor definition is needed here to make sure that CNaviConPool is defined.
+ */
+condor2nav::CCondor2Nav::~CCondor2Nav()
 {
 }
 
 
-void condor2nav::CCondor2Nav::OnStart(std::function<bool()> abort)
+/**
+ * @brief Checks if LK8000 maps synchronization is enabled.
+ *
+ * @exception std Thrown when the configuration is invalid.
+ *
+ * @return @p true if LK8000 maps should be synchronized on startup.
+ */
+bool condor2nav::CCondor2Nav::MapsCheck() const
 {
-  if(_configParser.Value("Condor2Nav", "Target") == "LK8000" && _configParser.Value("LK8000", "CheckForMapUpdates") == "1") {
+  const auto targets = CTranslator::TargetNames(_configParser);
+  return std::find(targets.begin(), targets.end(), "LK8000") != targets.end() && _configParser.Value("LK8000", "CheckForMapUpdates") == "1";
+}
+
+
+/**
+ * @brief Synchronizes LK8000 maps.
+ *
+ * Method may be run in the background. Translations have to wait only
+ * until new maps are matched to the landscapes and the maps of the
+ * translated landscape are downloaded.
+ *
+ * @param cancel Cancellation token of the startup operations.
+ */
+void condor2nav::CCondor2Nav::OnStart(CCancellationToken cancel)
+{
+  if(MapsCheck()) {
     LogHigh() << "LK8000 maps synchronization START" << std::endl;
     try {
+      CTraceScope trace{"startup", "Maps synchronization"};
       CLKMapsDB db{*this};
-      auto allTemplates = db.LKMTemplatesSync(abort);
+      auto allTemplates = db.LKMTemplatesSync(cancel);
+      CLKMapsDB::CMapsList newMaps;
       if(allTemplates.size()) {
         // new templates found - check if better maps can be used
-        auto newMaps = db.LandscapesMatch(std::move(allTemplates));
-        if(newMaps.size() && !abort())
-          db.LKMDownload(newMaps, abort);
+        newMaps = db.LandscapesMatch(std::move(allTemplates));
       }
+
+      // translations may start now
+      std::vector<CNameNoCase> landscapes;
+      for(const auto &map : newMaps)
+        landscapes.insert(landscapes.end(), map.second.landscapes.begin(), map.second.landscapes.end());
+      MapsPending(landscapes);
+
+      if(newMaps.size() && !cancel.Cancelled())
+        db.LKMDownload(newMaps, cancel);
       LogHigh() << "LK8000 maps synchronization FINISH" << std::endl;
     }
     catch(const std::exception &ex) {
       Error() << ex.what() << std::endl;
     }
   }
+  MapsPending(std::vector<CNameNoCase>{});
+  MemoryReport("Startup");
+}
+
+
+/**
+ * @brief Sets the landscape which maps should be downloaded first.
+ *
+ * @param landscape The name of the landscape.
+ */
+void condor2nav::CCondor2Nav::MapsPriority(const std::string &landscape) const
+{
+  std::lock_guard<std::mutex> lock{_mapsMutex};
+  _mapsPriority = landscape;
+}
+
+
+/**
+ * @brief Returns the landscape which maps should be downloaded first.
+ *
+ * @return The name of the landscape.
+ */
+std::string condor2nav::CCondor2Nav::MapsPriority() const
+{
+  std::lock_guard<std::mutex> lock{_mapsMutex};
+  return _mapsPriority;
+}
+
+
+/**
+ * @brief Finishes maps matching.
+ *
+ * @param landscapes The landscapes which maps will be downloaded.
+ */
+void condor2nav::CCondor2Nav::MapsPending(const std::vector<CNameNoCase> &landscapes) const
+{
+  {
+    std::lock_guard<std::mutex> lock{_mapsMutex};
+    _mapsMatching = false;
+    _mapsPending = std::unordered_set<CNameNoCase>(landscapes.begin(), landscapes.end());
+  }
+  _mapsChanged.notify_all();
+}
+
+
+/**
+ * @brief Marks the landscapes maps as downloaded.
+ *
+ * Failed downloads are marked too so that translations do not wait for them.
+ *
+ * @param landscapes The landscapes using the downloaded map.
+ */
+void condor2nav::CCondor2Nav::MapsDownloaded(const std::vector<CNameNoCase> &landscapes) const
+{
+  {
+    std::lock_guard<std::mutex> lock{_mapsMutex};
+    for(const auto &landscape : landscapes)
+      _mapsPending.erase(landscape);
+  }
+  _mapsChanged.notify_all();
+}
+
+
+/**
+ * @brief Waits for the landscape maps.
+ *
+ * Method blocks until new maps are matched to the landscapes and the maps of
+ * the provided landscape are downloaded. Downloads of that landscape are
+ * prioritized.
+ *
+ * @param landscape The name of the landscape.
+ */
+void condor2nav::CCondor2Nav::MapsWait(const std::string &landscape) const
+{
+  const CNameNoCase name{landscape};
+  std::unique_lock<std::mutex> lock{_mapsMutex};
+  _mapsPriority = landscape;
+  auto ready = [&]{ return !_mapsMatching && !_mapsPending.count(name); };
+  if(!ready()) {
+    lock.unlock();
+    Log() << "Waiting for '" << landscape << "' LK8000 maps..." << std::endl;
+    CTraceScope trace{"translation", "Maps wait", landscape};
+    lock.lock();
+    _mapsChanged.wait(lock, ready);
+  }
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Starts a traced translation.
+ *
+ * @param app Application reporting the stages.
+ */
+condor2nav::CCondor2Nav::CTraceSession::CTraceSession(const CCondor2Nav &app) :
+  _app(app)
+{
+  std::lock_guard<std::mutex> lock{_app._traceMutex};
+  ++_app._traceTranslations;
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Reports the stages if no other translation is running.
+ */
+condor2nav::CCondor2Nav::CTraceSession::~CTraceSession()
+{
+  // reports of consecutive translations do not overlap
+  std::lock_guard<std::mutex> lock{_app._traceMutex};
+  if(--_app._traceTranslations)
+    return;
+  try {
+    _app.TraceReport();
+  }
+  catch(const std::exception &) {
+  }
+}
+
+
+/**
+ * @brief Reports processing stages measured so far.
+ *
+ * If tracing is enabled the summary of the stages measured since
+ * the previous report is logged and written to the trace file. Reported
+ * stages are removed from the trace log.
+ */
+void condor2nav::CCondor2Nav::TraceReport() const
+{
+  if(!CTraceLog::Enabled())
+    return;
+
+  const auto events = CTraceLog::Instance().Take();
+  const auto summary = CTraceLog::Summary(events);
+  LogHigh() << "Stages summary:" << std::endl;
+  for(const auto &s : summary) {
+    std::ostringstream line;
+    line << " - " << std::left << std::setw(40) << s.name << std::right
+         << std::setw(6) << s.count << "x"
+         << std::setw(10) << std::chrono::duration_cast<std::chrono::milliseconds>(s.duration).count() << " ms";
+    if(s.bytes)
+      line << std::setw(10) << (s.bytes + 1023) / 1024 << " KB";
+    LogHigh() << line.str() << std::endl;
+  }
+
+  try {
+    CTraceLog::Instance().Dump(events, TRACE_FILE_NAME);
+  }
+  catch(const std::exception &ex) {
+    Warning() << ex.what() << std::endl;
+  }
+}
+
+
+/**
+ * @brief Reports memory usage.
+ *
+ * If memory report is enabled current and peak memory usage of
+ * the accounted subsystems is logged.
+ *
+ * @param operation The name of the finished operation.
+ */
+void condor2nav::CCondor2Nav::MemoryReport(const std::string &operation) const
+{
+  if(!_memoryReport)
+    return;
+
+  auto line = [](const char *name, CMemoryAccount::TUsage usage) {
+    std::ostringstream str;
+    str << " - " << std::left << std::setw(20) << name << std::right
+        << std::setw(10) << (usage.current + 1023) / 1024 << " KB"
+        << std::setw(10) << (usage.peak + 1023) / 1024 << " KB peak";
+    return str.str();
+  };
+  LogHigh() << operation << " memory usage:" << std::endl;
+  for(unsigned i = 0; i < CMemoryAccount::SUBSYSTEMS_NUM; ++i) {
+    auto subsystem = static_cast<TMemorySubsystem>(i);
+    LogHigh() << line(CMemoryAccount::Name(subsystem), CMemoryAccount::Usage(subsystem)) << std::endl;
+  }
+  LogHigh() << line("total", CMemoryAccount::Total()) << std::endl;
 }
@@ -30,7 +30,16 @@
 
 #include "nonCopyable.h"
 #include "fileParserINI.h"
+#include "fileParserCSV.h"
+#include "cancellation.h"
+#include "downloader.h"
+#include "nameNoCase.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <sstream>
+#include <vector>
 
 #undef ERROR   // workaround v\for some VS headers macro
 
@@ -40,6 +49,7 @@
 namespace condor2nav {
 
   class CFileParserINI;
+  class CNaviConPool;
 
   /**
    * @brief Main project class.
@@ -78,9 +88,71 @@ namespace condor2nav {
     private:
       const TType _type;	  ///< @brief Logger type
 
+    public:
+      /**
+       * @brief Logged line.
+       *
+       * Class gathers all the fragments provided to a logger in one expression
+       * and queues them as one line to the background sink when destroyed.
+       */
+      class CLine {
+        const CLogger *_logger;               ///< @brief Logger to use
+        std::string _text;                    ///< @brief Line text
+      public:
+        explicit CLine(const CLogger &logger) : _logger{&logger} {}
+        CLine(CLine &&other) : _logger{other._logger}, _text{std::move(other._text)} { other._logger = nullptr; }
+        CLine(const CLine &) = delete;
+        CLine &operator=(const CLine &) = delete;
+        ~CLine();
+
+        CLine &operator<<(const std::string &str) { _text += str; return *this; }
+        CLine &operator<<(const char *str)        { _text += str; return *this; }
+        CLine &operator<<(char c)                 { _text += c; return *this; }
+
+        /**
+         * @brief Adds new data to the line.
+         *
+         * @param obj Data to write. 
+         *
+         * @return Line instance.
+         */
+        template<class T>
+        CLine &operator<<(const T &obj)
+        {
+          std::ostringstream stream;
+          stream << obj;
+          _text += stream.str();
+          return *this;
+        }
+
+        /**
+         * @brief Writes functor (e.g. std::endl) to a line.
+         *
+         * @param f Functor to write. 
+         *
+         * @return Line instance.
+         */
+        CLine &operator<<(std::ostream &(*f)(std::ostream &))
+        {
+          if(f == static_cast<std::ostream &(*)(std::ostream &)>(std::endl<char, std::char_traits<char>>))
+            _text += '\n';
+          else {
+            std::ostringstream stream;
+            stream << f;
+            _text += stream.str();
+          }
+          return *this;
+        }
+      };
+
+    private:
+      friend class CLogSink;
+
       /**
        * @brief Dumps the text to the logger output. 
        *
+       * Method is called from the background sink thread.
+       *
        * @param str The string to dump. 
        */
       virtual void Trace(const std::string &str) const = 0;
@@ -91,63 +163,113 @@ namespace condor2nav {
     public:
       explicit CLogger(TType type);
       virtual ~CLogger() {}
-      
+
+      static void Flush();
+
       /**
       * @brief Provides new traces to a logger. 
       *
-      * Function provides new traces to a stream.
+      * Function starts a new line with provided data. The line is logged
+      * when the whole expression is evaluated.
       *
       * @param logger Logger to use. 
       * @param obj Data to write. 
       *
-      * @return Stream instance.
+      * @return New line.
        */
       template<class T>
-      friend const CLogger &operator<<(const CLogger &logger, const T &obj)
+      friend CLine operator<<(const CLogger &logger, const T &obj)
       {
-        std::stringstream stream;
-        stream << obj;
-        logger.Trace(stream.str());
-        return logger;
+        CLine line{logger};
+        line << obj;
+        return line;
       }
 
       /**
       * @brief Writes functor (e.g. std::endl) to a logger.
       *
-      * Method writes functor (e.g. std::endl) to a logger.
+      * Function starts a new line with provided functor (e.g. std::endl).
       *
       * @param logger Logger to use. 
       * @param f Functor to write. 
       *
-      * @return Stream instance.
+      * @return New line.
        */
-      friend const CLogger &operator<<(const CLogger &logger, std::ostream &(*f)(std::ostream &))
+      friend CLine operator<<(const CLogger &logger, std::ostream &(*f)(std::ostream &))
       {
-        std::stringstream stream;
-        stream << f;
-        logger.Trace(stream.str());
-        return logger;
+        CLine line{logger};
+        line << f;
+        return line;
       }
     };
 
+    /**
+     * @brief Traced translation scope.
+     *
+     * Stages measured while translations run concurrently (i.e. in batch
+     * mode) are reported once, when the last of the translations finishes.
+     */
+    class CTraceSession : CNonCopyable {
+      const CCondor2Nav &_app;                    ///< @brief Application reporting the stages
+    public:
+      explicit CTraceSession(const CCondor2Nav &app);
+      ~CTraceSession();
+    };
+
   private:
     const CFileParserINI _configParser;	          ///< @brief The INI file configuration parser
+    mutable CFileParserCSVCache _csvCache;        ///< @brief CSV databases kept between translations
+    mutable CFileParserINICache _iniCache;        ///< @brief Target profiles kept between translations
+    std::unique_ptr<CNaviConPool> _naviConPool;   ///< @brief NaviCon.dll worker processes (nullptr if disabled)
+    bool _memoryReport = false;                   ///< @brief Memory usage is reported after startup and translations
+
+    mutable std::mutex _mapsMutex;                ///< @brief Guards the maps synchronization state
+    mutable std::condition_variable _mapsChanged; ///< @brief Signalled when the maps synchronization state changes
+    mutable bool _mapsMatching = false;           ///< @brief New maps are being matched to the landscapes
+    mutable std::unordered_set<CNameNoCase> _mapsPending; ///< @brief Landscapes with maps not downloaded yet
+    mutable std::string _mapsPriority;            ///< @brief Landscape which maps should be downloaded first
+
+    mutable std::mutex _traceMutex;               ///< @brief Guards the traced translations counter and reports
+    mutable unsigned _traceTranslations = 0;      ///< @brief The number of translations running
+
+    bool MapsCheck() const;
+    void TraceReport() const;
 
   protected:
     static const char *CONFIG_FILE_NAME;          ///< @brief The name of the configuration INI file.
+    static const char *TRACE_FILE_NAME;           ///< @brief The name of the stages trace file.
 
   public:
     CCondor2Nav();
-    virtual ~CCondor2Nav() {}
+    virtual ~CCondor2Nav();
 
     const CFileParserINI &ConfigParser() const { return _configParser; }
+    CFileParserCSVCache &CSVCache() const { return _csvCache; }
+    CFileParserINICache &INICache() const { return _iniCache; }
+    const CNaviConPool *NaviConPool() const { return _naviConPool.get(); }
+
+    void MapsPriority(const std::string &landscape) const;
+    std::string MapsPriority() const;
+    void MapsPending(const std::vector<CNameNoCase> &landscapes) const;
+    void MapsDownloaded(const std::vector<CNameNoCase> &landscapes) const;
+    void MapsWait(const std::string &landscape) const;
+    void MemoryReport(const std::string &operation) const;
 
     /**
      * @brief Handler triggered on application startup. 
      *
-     * @param abort Funtion to call to check if execution should be aborted.
+     * @param cancel Cancellation token of the startup operations.
+     */
+    virtual void OnStart(CCancellationToken cancel);
+
+    /**
+     * @brief Handler triggered periodically with the overall download status.
+     *
+     * Handler is called from the download worker threads.
+     *
+     * @param status Overall status of the current files download.
      */
-    virtual void OnStart(std::function<bool()> abort);
+    virtual void DownloadStatus(const CDownloader::TStatus &status) const {}
 
     /**
      * @brief Returns normal logging level logger. 
@@ -0,0 +1,250 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file dataCompiler/main.cpp
+ *
+ * @brief Implements compiler of CSV files distributed with Condor2Nav.
+ *
+ * Compiler generates the source file with tables of sceneries and gliders
+ * data used by the application instead of parsing the files on startup.
+ * It should be run from the repository root directory every time these
+ * files are changed. If it is not, the application detects stale tables
+ * and parses the files as before.
+ */
+
+#include "compiledCSV.h"
+#include "fileParserCSV.h"
+#include "istream.h"
+#include "ostream.h"
+#include "tools.h"
+#include "traitsNoCase.h"
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+  const char *const CSV_FILES[] = {
+    "data/GliderData.csv",
+    "data/LK8000/SceneryData.csv",
+    "data/XCSoar/SceneryData.csv"
+  };
+  const bfs::path DEFAULT_OUTPUT = "src/compiledCSVData.cpp";
+  const unsigned SEEDS_NUM = 100000;             // the number of seeds tried for one slots table size
+
+
+  /**
+   * @brief Prints compiler usage.
+   */
+  void Usage()
+  {
+    std::cout << "Usage: condor2nav-data [OUTPUT_FILE]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Compiles Condor2Nav sceneries and gliders CSV files to '" << DEFAULT_OUTPUT.generic_string() << "'." << std::endl;
+    std::cout << "The tool has to be run from the repository root directory." << std::endl;
+  }
+
+
+  /**
+   * @brief Returns C++ string literal.
+   *
+   * @param str The string to quote.
+   *
+   * @return String literal.
+   */
+  std::string Literal(boost::string_ref str)
+  {
+    std::string literal = "\"";
+    for(auto c : str) {
+      if(c == '"' || c == '\\') {
+        literal += '\\';
+        literal += c;
+      }
+      else if(c < ' ' || c > '~') {
+        // octal escapes are never longer than 3 digits
+        char buf[8];
+        std::sprintf(buf, "\\%03o", static_cast<unsigned char>(c));
+        literal += buf;
+      }
+      else
+        literal += c;
+    }
+    return literal + "\"";
+  }
+
+
+  /**
+   * @brief Finds a perfect hash of the first column values.
+   *
+   * @param rows     The rows of the file.
+   * @param seed     Set to the found hash seed.
+   * @param slotsNum Set to the number of hash slots.
+   *
+   * @return Row index + 1 for every slot.
+   */
+  std::vector<unsigned> PerfectHash(const condor2nav::CFileParserCSV::CRowsList &rows, unsigned &seed, unsigned &slotsNum)
+  {
+    // the first row with a value is found by lookups
+    std::map<std::string, unsigned> keys;
+    for(unsigned i=0; i<rows.size(); i++) {
+      if(rows[i].empty())
+        continue;
+      std::string key{rows[i][0].to_string()};
+      for(auto &ch : key)
+        ch = static_cast<char>(condor2nav::ToUpper(ch));
+      keys.emplace(key, i + 1);
+    }
+
+    for(slotsNum = 2; slotsNum < 2 * keys.size(); slotsNum *= 2)
+      ;
+    for(;; slotsNum *= 2) {
+      for(seed=0; seed<SEEDS_NUM; seed++) {
+        std::vector<unsigned> slots(slotsNum, 0);
+        bool collision = false;
+        for(const auto &key : keys) {
+          auto &slot = slots[condor2nav::CompiledCSVHash(key.first, seed) & (slotsNum - 1)];
+          if(slot) {
+            collision = true;
+            break;
+          }
+          slot = key.second;
+        }
+        if(!collision)
+          return slots;
+      }
+    }
+  }
+
+
+  /**
+   * @brief Writes compiled tables of one CSV file.
+   *
+   * @param out   Output stream.
+   * @param index The index of the table.
+   * @param path  The path of the CSV file.
+   *
+   * @return Initializer of the table description.
+   */
+  std::string TableWrite(condor2nav::COStream &out, unsigned index, const bfs::path &path)
+  {
+    using namespace condor2nav;
+
+    std::uint64_t size;
+    std::string fingerprint;
+    {
+      CIStream stream{path};
+      fingerprint = CompiledCSVFingerprint(stream.Data(), size);
+    }
+    const CFileParserCSV parser{path};
+    const auto &rows = parser.Rows();
+    unsigned seed, slotsNum;
+    const auto slots = PerfectHash(rows, seed, slotsNum);
+    if(rows.size() >= 0xFFFF)
+      throw EOperationFailed{"ERROR: File '" + path.string() + "' has too many rows to be compiled!!!"};
+
+    // cells and rows offsets
+    const auto suffix = Convert(index);
+    std::vector<unsigned> offsets{0};
+    out << "  // " << path.generic_string() << "\n";
+    out << "  const char *const CELLS_" << suffix << "[] = {\n";
+    for(const auto &row : rows) {
+      out << "   ";
+      for(const auto &cell : row)
+        out << " " << Literal(cell) << ",";
+      out << "\n";
+      offsets.push_back(offsets.back() + static_cast<unsigned>(row.size()));
+    }
+    out << "  };\n";
+
+    out << "  const unsigned ROWS_" << suffix << "[] = {";
+    for(size_t i=0; i<offsets.size(); i++)
+      out << (i % 16 ? " " : "\n    ") << offsets[i] << ",";
+    out << "\n  };\n";
+
+    out << "  const unsigned short SLOTS_" << suffix << "[] = {";
+    for(size_t i=0; i<slots.size(); i++)
+      out << (i % 16 ? " " : "\n    ") << slots[i] << ",";
+    out << "\n  };\n\n";
+
+    return "  { " + Literal(path.generic_string()) + ", " + Convert(static_cast<unsigned>(size)) + ", " + Literal(fingerprint) + ", " +
+           Convert(static_cast<unsigned>(rows.size())) + ", ROWS_" + suffix + ", CELLS_" + suffix + ", " +
+           Convert(seed) + "u, " + Convert(slotsNum) + ", SLOTS_" + suffix + " }";
+  }
+
+}
+
+
+/**
+ * @brief Compiler main entry point.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv Command line arguments.
+ *
+ * @return Process exit code.
+ */
+int main(int argc, const char *argv[])
+{
+  try {
+    if(argc > 2 || (argc == 2 && argv[1][0] == '-')) {
+      Usage();
+      return EXIT_FAILURE;
+    }
+    const bfs::path output = argc == 2 ? bfs::path{argv[1]} : DEFAULT_OUTPUT;
+
+    condor2nav::COStream out{output};
+    out << "//\n";
+    out << "// This file is part of Condor2Nav file formats translator.\n";
+    out << "//\n";
+    out << "// Generated by condor2nav-data tool from Condor2Nav CSV files. Do not edit!\n";
+    out << "//\n\n";
+    out << "/**\n";
+    out << " * @file compiledCSVData.cpp\n";
+    out << " *\n";
+    out << " * @brief Defines the CSV tables compiled into the application.\n";
+    out << " */\n\n";
+    out << "#include \"compiledCSV.h\"\n\n\n";
+    out << "namespace {\n\n";
+    std::vector<std::string> tables;
+    for(auto path : CSV_FILES) {
+      std::cout << "Compiling '" << path << "'..." << std::endl;
+      tables.push_back(TableWrite(out, static_cast<unsigned>(tables.size()), path));
+    }
+    out << "}\n\n\n";
+    out << "const condor2nav::TCompiledCSV condor2nav::COMPILED_CSV[] = {\n";
+    for(size_t i=0; i<tables.size(); i++)
+      out << tables[i] << (i + 1 < tables.size() ? ",\n" : "\n");
+    out << "};\n\n";
+    out << "const unsigned condor2nav::COMPILED_CSV_NUM = sizeof(COMPILED_CSV) / sizeof(*COMPILED_CSV);\n";
+    out.Commit();
+
+    std::cout << "Tables written to '" << output.generic_string() << "'" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
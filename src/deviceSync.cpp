@@ -0,0 +1,179 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file deviceSync.cpp
+ *
+ * @brief Implements the condor2nav::CDeviceSync class. 
+ */
+
+#include "deviceSync.h"
+#include "activeSync.h"
+#include "fileParserCSV.h"
+#include "fingerprint.h"
+#include "recordWriter.h"
+#include "tools.h"
+#include <boost/filesystem/fstream.hpp>
+#include <vector>
+
+const bfs::path condor2nav::CDeviceSync::MANIFEST_FILE_NAME = "condor2nav.manifest";
+
+namespace {
+
+  /**
+   * @brief Columns of the manifest file.
+   *
+   * Device file paths are stored quoted so they may contain commas.
+   */
+  enum TManifestColumns {
+    MANIFEST_FINGERPRINT,
+    MANIFEST_SIZE,
+    MANIFEST_PATH
+  };
+
+  const std::size_t READ_BLOCK_SIZE = 64 * 1024;        ///< @brief Block size used to fingerprint local files
+
+  /**
+   * @brief Returns the fingerprint of a local file content.
+   *
+   * @param path Local file path.
+   *
+   * @exception std Thrown when the file cannot be read.
+   *
+   * @return File content fingerprint.
+   */
+  std::string FileFingerprint(const bfs::path &path)
+  {
+    using namespace condor2nav;
+    bfs::ifstream stream{path, std::ios_base::in | std::ios_base::binary};
+    if(!stream)
+      throw EOperationFailed{"ERROR: Couldn't open file '" + path.string() + "' for reading!!!"};
+
+    CFingerprint fingerprint;
+    std::vector<char> buffer(READ_BLOCK_SIZE);
+    while(stream) {
+      stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      fingerprint.Add(boost::string_ref{buffer.data(), static_cast<std::size_t>(stream.gcount())});
+    }
+    return fingerprint.String();
+  }
+
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param stagingPath Local staging directory.
+ * @param devicePath  Device directory that should mirror the staging one.
+ */
+condor2nav::CDeviceSync::CDeviceSync(bfs::path stagingPath, bfs::path devicePath) :
+  _stagingPath{std::move(stagingPath)}, _devicePath{std::move(devicePath)}
+{
+}
+
+
+/**
+ * @brief Reads the manifest of files uploaded to the device.
+ *
+ * @exception std Thrown when the manifest cannot be read.
+ *
+ * @return Device manifest (empty if not found).
+ */
+auto condor2nav::CDeviceSync::ManifestRead() const -> CManifest
+{
+  CManifest manifest;
+  const auto path = _devicePath / MANIFEST_FILE_NAME;
+  if(!FileExists(path))
+    return manifest;
+
+  const CFileParserCSV parser{path};
+  for(const auto &row : parser.Rows())
+    if(row.size() == MANIFEST_PATH + 1)
+      manifest[row[MANIFEST_PATH].to_string()] = TEntry{Convert<std::uint64_t>(row[MANIFEST_SIZE].to_string()), row[MANIFEST_FINGERPRINT].to_string()};
+  return manifest;
+}
+
+
+/**
+ * @brief Uploads changed files to the device.
+ *
+ * Method compares the size and the fingerprint of every file in the staging
+ * directory with the device manifest and uploads only the files that are
+ * different. The manifest is updated if anything was uploaded.
+ *
+ * @exception std Thrown when synchronization failed.
+ *
+ * @return Synchronization statistics.
+ */
+auto condor2nav::CDeviceSync::Run() const -> TStatus
+{
+  TStatus status{};
+  if(!bfs::exists(_stagingPath))
+    return status;
+
+  const auto previous = ManifestRead();
+  CManifest manifest;
+  auto &activeSync = CActiveSync::Instance();
+
+  for(bfs::recursive_directory_iterator it{_stagingPath}, end; it != end; ++it) {
+    if(!bfs::is_regular_file(it->status()))
+      continue;
+
+    // relative path in device format
+    const auto &path = it->path();
+    std::string relative;
+    for(auto p = path; p != _stagingPath; p = p.parent_path())
+      relative = p.filename().string() + (relative.empty() ? "" : "\\" + relative);
+
+    TEntry entry{bfs::file_size(path), FileFingerprint(path)};
+    ++status.files;
+
+    const auto dest = _devicePath / relative;
+    auto prev = previous.find(dest.string());
+    if(prev == previous.end() || prev->second.size != entry.size || prev->second.fingerprint != entry.fingerprint) {
+      DirectoryCreate(dest.parent_path());
+      bfs::ifstream stream{path, std::ios_base::in | std::ios_base::binary};
+      if(!stream)
+        throw EOperationFailed{"ERROR: Couldn't open file '" + path.string() + "' for reading!!!"};
+      activeSync.Write(dest, CActiveSync::CWriteProvider{[&](char *buffer, std::size_t size)
+      {
+        stream.read(buffer, static_cast<std::streamsize>(size));
+        return static_cast<std::size_t>(stream.gcount());
+      }});
+      ++status.uploaded;
+      status.bytes += entry.size;
+    }
+    manifest[dest.string()] = std::move(entry);
+  }
+
+  // keep entries of files that were uploaded before but are not staged any more
+  for(const auto &entry : previous)
+    manifest.insert(entry);
+
+  if(status.uploaded) {
+    CRecordWriter writer{_devicePath / MANIFEST_FILE_NAME};
+    for(const auto &entry : manifest)
+      writer.Row(entry.second.fingerprint, entry.second.size, "\"" + entry.first + "\"");
+    writer.Commit();
+  }
+  return status;
+}
@@ -0,0 +1,84 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file deviceSync.h
+ *
+ * @brief Declares the condor2nav::CDeviceSync class. 
+ */
+
+#ifndef __DEVICESYNC_H__
+#define __DEVICESYNC_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace condor2nav {
+
+  /**
+   * @brief Staging tree to device synchronizer.
+   *
+   * condor2nav::CDeviceSync uploads files from a local staging directory to
+   * the device. The size and the content fingerprint of every uploaded file
+   * are stored in a manifest file on the device so only changed files are
+   * uploaded next time. Manifest entries are keyed by the full device path
+   * of the file so they never match files of another device directory.
+   */
+  class CDeviceSync : CNonCopyable {
+  public:
+    /**
+     * @brief Synchronization statistics.
+     */
+    struct TStatus {
+      unsigned files;                     ///< @brief The number of files in the staging directory
+      unsigned uploaded;                  ///< @brief The number of uploaded files
+      std::uint64_t bytes;                ///< @brief The number of uploaded bytes
+    };
+
+    static const bfs::path MANIFEST_FILE_NAME;  ///< @brief Device manifest file name
+
+  private:
+    /**
+     * @brief Manifest entry.
+     */
+    struct TEntry {
+      std::uint64_t size;                 ///< @brief File size
+      std::string fingerprint;            ///< @brief File content fingerprint
+    };
+    using CManifest = std::map<std::string, TEntry>;   ///< @brief Manifest entries keyed by device file path
+
+    const bfs::path _stagingPath;         ///< @brief Local staging directory
+    const bfs::path _devicePath;          ///< @brief Device directory
+
+    CManifest ManifestRead() const;
+
+  public:
+    CDeviceSync(bfs::path stagingPath, bfs::path devicePath);
+    TStatus Run() const;
+  };
+
+}
+
+#endif /* __DEVICESYNC_H__ */
@@ -0,0 +1,277 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file downloader.cpp
+ *
+ * @brief Implements the condor2nav::CDownloader class. 
+ */
+
+#include "downloader.h"
+#include "tools.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+
+
+/**
+ * @brief Describes the download status.
+ *
+ * @return One line description of the download status.
+ */
+std::string condor2nav::CDownloader::TStatus::Summary() const
+{
+  std::string str = Convert(finished) + "/" + Convert(files) + " files";
+  if(active)
+    str += ", " + Convert(active) + " active";
+  if(failed)
+    str += ", " + Convert(failed) + " failed";
+  if(retries)
+    str += ", " + Convert(retries) + " retries";
+  str += ", " + Convert(static_cast<unsigned>(size / 1024)) + " kB";
+  if(!done)
+    str += " (" + Convert(rate / 1024) + " kB/s)";
+  str += ", " + Convert(completion / 10) + "." + Convert(completion % 10) + "%";
+  if(eta)
+    str += ", ETA " + Convert(eta / 60) + ":" + (eta % 60 < 10 ? "0" : "") + Convert(eta % 60);
+  return str;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CDownloader class constructor.
+ *
+ * @param connections The maximum number of concurrent connections.
+ * @param retries     The number of retries of a failed download.
+ * @param retryDelay  The delay in ms before the first retry (doubled for every next one).
+ */
+condor2nav::CDownloader::CDownloader(unsigned connections, unsigned retries, unsigned retryDelay) :
+  _connections{std::max(connections, 1u)}, _retries{retries}, _retryDelay{retryDelay}
+{
+}
+
+
+/**
+ * @brief Downloads one file.
+ *
+ * Method downloads one file retrying failed attempts. Every retry resumes
+ * the data received by the previous attempts.
+ *
+ * @param file     File to download.
+ * @param cancel   Cancellation token checked between retries.
+ * @param progress Handler called with download progress.
+ * @param retry    Handler called before every retry.
+ * @param error    Description of the last error.
+ *
+ * @return @p true if the file was downloaded.
+ */
+bool condor2nav::CDownloader::Download(const TFile &file, const CCancellationToken &cancel, const CDownloadProgress &progress,
+                                       const std::function<void()> &retry, std::string &error) const
+{
+  auto delay = std::chrono::milliseconds{_retryDelay};
+  for(unsigned attempt=0; ; attempt++) {
+    try {
+      condor2nav::Download(file.server, file.url, file.path, file.timeout, progress);
+      return true;
+    }
+    catch(const std::exception &ex) {
+      error = ex.what();
+    }
+
+    if(attempt == _retries)
+      break;
+
+    // wait before retrying but do not block the cancellation request
+    const auto end = std::chrono::steady_clock::now() + delay;
+    while(std::chrono::steady_clock::now() < end) {
+      if(cancel.Cancelled())
+        break;
+      std::this_thread::sleep_for(std::min(std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()),
+                                           std::chrono::milliseconds{100}));
+    }
+    if(cancel.Cancelled())
+      break;
+    retry();
+    delay *= 2;
+  }
+  return false;
+}
+
+
+/**
+ * @brief Downloads all the files.
+ *
+ * Method downloads provided files using up to the configured number
+ * of concurrent connections. Handlers are called from worker threads.
+ * Overall status reports are serialized and the last one is provided
+ * from the calling thread after all the workers finished.
+ *
+ * @param files The list of files to download.
+ * @param cancel Cancellation token checked between downloads.
+ * @param start Handler called when a file download starts.
+ * @param error Handler called when a file could not be downloaded.
+ * @param progress Handler called periodically with download progress.
+ * @param priority Handler selecting files that should be downloaded first.
+ * @param status Handler called periodically with overall download status.
+ *
+ * @return The list of flags specifying which files were downloaded.
+ */
+auto condor2nav::CDownloader::Run(const CFileList &files, const CCancellationToken &cancel,
+                                  const CStartHandler &start, const CErrorHandler &error,
+                                  const CProgressHandler &progress /* = CProgressHandler{} */,
+                                  const CPriorityHandler &priority /* = CPriorityHandler{} */,
+                                  const CStatusHandler &status /* = CStatusHandler{} */) const -> CStatusList
+{
+  std::vector<char> result(files.size(), 0);
+  std::list<size_t> pending;
+  for(size_t i=0; i<files.size(); i++)
+    pending.push_back(i);
+  std::mutex pendingMutex;
+
+  // take the first prioritized file or the first one in the original order
+  auto next = [&](size_t &i)
+  {
+    std::lock_guard<std::mutex> lock{pendingMutex};
+    if(pending.empty())
+      return false;
+    auto it = pending.begin();
+    if(priority) {
+      const auto found = std::find_if(pending.begin(), pending.end(), [&](size_t idx){ return priority(files[idx]); });
+      if(found != pending.end())
+        it = found;
+    }
+    i = *it;
+    pending.erase(it);
+    return true;
+  };
+
+  // progress of the started files gathered for overall status reports
+  struct TProgress {
+    std::uint64_t size = 0;
+    std::uint64_t total = 0;
+    unsigned rate = 0;
+    bool active = false;
+  };
+  using clock = std::chrono::steady_clock;
+  std::vector<TProgress> fileProgress(files.size());
+  TStatus current;
+  current.files = static_cast<unsigned>(files.size());
+  const auto begin = clock::now();
+  auto reported = begin;
+  std::mutex statusMutex;
+
+  // must be called with the status mutex locked
+  auto report = [&](bool force)
+  {
+    const auto now = clock::now();
+    if(!status || (!force && now - reported < std::chrono::milliseconds{STATUS_INTERVAL}))
+      return;
+    reported = now;
+
+    // active files of unknown size count as half done once data arrive
+    current.size = 0;
+    current.rate = 0;
+    double done = current.finished + current.failed;
+    for(const auto &p : fileProgress) {
+      current.size += p.size;
+      current.rate += p.rate;
+      if(p.active && p.total)
+        done += std::min(1.0, static_cast<double>(p.size) / p.total);
+      else if(p.active && p.size)
+        done += 0.5;
+    }
+    const auto fraction = files.empty() ? 1.0 : std::min(1.0, done / files.size());
+    current.completion = static_cast<unsigned>(fraction * 1000);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - begin).count();
+    current.eta = !current.done && fraction > 0 && fraction < 1 ? static_cast<unsigned>(elapsed * (1 - fraction) / fraction + 0.5) : 0;
+    status(current);
+  };
+
+  auto worker = [&]
+  {
+    size_t i;
+    while(!cancel.Cancelled() && next(i)) {
+      start(files[i]);
+      {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        current.active++;
+        fileProgress[i].active = true;
+      }
+
+      auto fileStatus = [&](std::uint64_t size, std::uint64_t total, unsigned rate, bool done)
+      {
+        if(progress)
+          progress(files[i], size, total, rate, done);
+        std::lock_guard<std::mutex> lock{statusMutex};
+        auto &p = fileProgress[i];
+        p.size = size;
+        p.total = total;
+        p.rate = done ? 0 : rate;
+        report(false);
+      };
+      auto retry = [&]
+      {
+        std::lock_guard<std::mutex> lock{statusMutex};
+        current.retries++;
+      };
+
+      std::string msg;
+      const bool downloaded = Download(files[i], cancel, fileStatus, retry, msg);
+      if(!downloaded && !cancel.Cancelled())
+        error(files[i], msg);
+
+      std::lock_guard<std::mutex> lock{statusMutex};
+      current.active--;
+      fileProgress[i].rate = 0;
+      fileProgress[i].active = false;
+      if(downloaded) {
+        result[i] = 1;
+        current.finished++;
+      }
+      else if(!cancel.Cancelled())
+        current.failed++;
+      report(false);
+    }
+  };
+
+  const auto workersNum = std::min<size_t>(_connections, files.size());
+  std::vector<std::future<void>> workers;
+  for(size_t i=1; i<workersNum; i++)
+    workers.emplace_back(std::async(std::launch::async, worker));
+  if(workersNum)
+    worker();
+  for(auto &w : workers)
+    w.get();
+
+  {
+    std::lock_guard<std::mutex> lock{statusMutex};
+    current.done = true;
+    report(true);
+  }
+
+  return CStatusList(result.begin(), result.end());
+}
@@ -0,0 +1,116 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file downloader.h
+ *
+ * @brief Declares the condor2nav::CDownloader class. 
+ */
+
+#ifndef __DOWNLOADER_H__
+#define __DOWNLOADER_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include "cancellation.h"
+#include "tools.h"
+#include <cstdint>
+#include <boost/filesystem/path.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Concurrent files downloader.
+   *
+   * condor2nav::CDownloader class downloads a list of files using a bounded
+   * number of concurrent connections. Each failed download is retried with
+   * an exponential backoff. Execution may be cancelled with a cancellation
+   * token that is checked between downloads and during backoff delays.
+   * Partially downloaded files are kept so that next download resumes them.
+   * An optional priority handler moves selected files to the front of the
+   * queue. It is checked every time a connection becomes free so the
+   * priorities may change during the download. Overall progress of all the
+   * files is gathered from the workers and provided in batches no more often
+   * than every STATUS_INTERVAL.
+   */
+  class CDownloader : CNonCopyable {
+  public:
+    /**
+     * @brief File to download.
+     */
+    struct TFile {
+      std::string server;                 ///< @brief Server to connect to. 
+      bfs::path url;                      ///< @brief Path of the file on the server. 
+      bfs::path path;                     ///< @brief Local path of the downloaded file. 
+      unsigned timeout;                   ///< @brief Connection timeout in seconds. 
+    };
+
+    /**
+     * @brief Overall download status.
+     */
+    struct TStatus {
+      unsigned files = 0;                 ///< @brief The number of files to download. 
+      unsigned finished = 0;              ///< @brief The number of downloaded files. 
+      unsigned failed = 0;                ///< @brief The number of files that could not be downloaded. 
+      unsigned active = 0;                ///< @brief The number of files being downloaded. 
+      unsigned retries = 0;               ///< @brief The number of retried download attempts. 
+      std::uint64_t size = 0;             ///< @brief The number of bytes of started files already downloaded. 
+      unsigned rate = 0;                  ///< @brief Current download rate in bytes per second. 
+      unsigned completion = 0;            ///< @brief Overall completion in per mille. 
+      unsigned eta = 0;                   ///< @brief Estimated remaining time in seconds (0 if unknown). 
+      bool done = false;                  ///< @brief @p true for the last status of the run. 
+
+      std::string Summary() const;
+    };
+
+    using CFileList = std::vector<TFile>;
+    using CStatusList = std::vector<bool>;
+    using CStartHandler = std::function<void(const TFile &file)>;
+    using CErrorHandler = std::function<void(const TFile &file, const std::string &error)>;
+    using CProgressHandler = std::function<void(const TFile &file, std::uint64_t size, std::uint64_t total, unsigned rate, bool done)>;
+    using CPriorityHandler = std::function<bool(const TFile &file)>;
+    using CStatusHandler = std::function<void(const TStatus &status)>;
+
+    static const unsigned STATUS_INTERVAL = 1000;  ///< @brief The minimum time in ms between overall status reports. 
+
+  private:
+    const unsigned _connections;          ///< @brief The maximum number of concurrent connections. 
+    const unsigned _retries;              ///< @brief The number of retries of a failed download. 
+    const unsigned _retryDelay;           ///< @brief The delay in ms before the first retry. 
+
+    bool Download(const TFile &file, const CCancellationToken &cancel, const CDownloadProgress &progress,
+                  const std::function<void()> &retry, std::string &error) const;
+
+  public:
+    CDownloader(unsigned connections, unsigned retries, unsigned retryDelay);
+    CStatusList Run(const CFileList &files, const CCancellationToken &cancel,
+                    const CStartHandler &start, const CErrorHandler &error,
+                    const CProgressHandler &progress = CProgressHandler{},
+                    const CPriorityHandler &priority = CPriorityHandler{},
+                    const CStatusHandler &status = CStatusHandler{}) const;
+  };
+
+}
+
+#endif /* __DOWNLOADER_H__ */
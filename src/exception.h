@@ -52,6 +52,14 @@ namespace condor2nav {
     explicit EOperationFailed(std::string error) : Exception{std::move(error)} {}
   };
 
+
+  /**
+   * @brief Operation cancelled exception. 
+   */
+  struct EOperationCancelled : Exception {
+    explicit EOperationCancelled(std::string error) : Exception{std::move(error)} {}
+  };
+
 }
 
 #endif /* __EXCEPTION_H__ */
\ No newline at end of file
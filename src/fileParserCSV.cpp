@@ -26,8 +26,10 @@
  */
 
 #include "fileParserCSV.h"
+#include "compiledCSV.h"
 #include "istream.h"
 #include "ostream.h"
+#include "traceLog.h"
 #include "tools.h"
 #include "traitsNoCase.h"
 #include <string>
@@ -35,52 +37,138 @@
 
 namespace {
 
+  /**
+  * @brief Finds the first occurrence of any of the characters in a string range.
+  *
+  * Method finds the first occurrence of any of the characters starting from
+  * the provided position.
+  *
+  * @param str   The string range to search in.
+  * @param chars The characters to search for.
+  * @param pos   The position to start searching from.
+  *
+  * @return The position of found character or @p npos.
+  */
+  size_t FindFirstOf(boost::string_ref str, boost::string_ref chars, size_t pos)
+  {
+    auto ret = str.substr(pos).find_first_of(chars);
+    return ret == boost::string_ref::npos ? ret : pos + ret;
+  }
+
+
+  /**
+  * @brief Returns the index key of the value.
+  *
+  * Method returns the key used to store provided value in rows index.
+  *
+  * @param value  The value to use.
+  * @param nocase Specifies if the index is case insensitive.
+  *
+  * @return Index key.
+  */
+  std::string IndexKey(boost::string_ref value, bool nocase)
+  {
+    std::string key{value.to_string()};
+    if(!nocase)
+      return key;
+    for(auto &ch : key)
+      ch = static_cast<char>(condor2nav::ToUpper(ch));
+    return key;
+  }
+
+
   /**
   * @brief Parses the line as CSV (Comma Separated Values).
   *
-  * Method parses the line as CSV (Comma Separated Values).
+  * Method parses the line as CSV (Comma Separated Values). The line is
+  * copied to the strings arena once and returned values are its parts.
   *
   * @param line            The line to parse.
+  * @param arena           The storage of the line text.
   *
   * @return Parsed values.
   */
-  std::vector<std::string> LineParseCSV(const std::string &line)
+  condor2nav::CFileParserCSV::CStringArray LineParseCSV(boost::string_ref line, condor2nav::CStringArena &arena)
   {
     using namespace condor2nav;
-    std::vector<std::string> values;
+    line = arena.Store(line);
+    CFileParserCSV::CStringArray values;
     bool insideQuote = false;
     size_t pos = 0, newValuePos = 0;
     do {
       auto posOld = pos;
       if(insideQuote) {
-        pos = line.find_first_of("\"", posOld);
+        pos = FindFirstOf(line, "\"", posOld);
         insideQuote = false;
       }
       else {
-        pos = line.find_first_of(",\"", posOld);
-        if(pos != std::string::npos && line[pos] == '\"') {
+        pos = FindFirstOf(line, ",\"", posOld);
+        if(pos != boost::string_ref::npos && line[pos] == '\"') {
           insideQuote = true;
         }
         else {
-          auto len = (pos != std::string::npos) ? (pos - newValuePos) : pos;
-          auto value = line.substr(newValuePos, len);
-          Trim(value);
+          auto len = (pos != boost::string_ref::npos) ? (pos - newValuePos) : pos;
+          auto value = Trim(line.substr(newValuePos, len));
           if(!value.empty() && value[0] == '\"')
             // remove quotes
             value = value.substr(1, value.size() - 2);
-          values.emplace_back(std::move(value));
-          if(pos != std::string::npos)
+          values.emplace_back(value);
+          if(pos != boost::string_ref::npos)
             newValuePos = pos + 1;
         }
       }
-      if(pos != std::string::npos)
+      if(pos != boost::string_ref::npos)
         pos++;
     }
-    while(pos != std::string::npos);
+    while(pos != boost::string_ref::npos);
 
     return values;
   }
 
+
+  /**
+  * @brief Returns the memory used by CSV rows.
+  *
+  * @param rows The rows to check.
+  *
+  * @return The number of bytes used.
+  */
+  std::size_t Footprint(const condor2nav::CFileParserCSV::CRowsList &rows)
+  {
+    using namespace condor2nav;
+    auto bytes = rows.size() * sizeof(CFileParserCSV::CStringArray);
+    for(const auto &row : rows) {
+      bytes += row.capacity() * sizeof(boost::string_ref);
+    }
+    return bytes;
+  }
+
+
+  /**
+  * @brief Returns the memory used by rows indexes.
+  *
+  * Method estimates the size of hash table nodes and buckets.
+  *
+  * @param indexes The indexes to check.
+  *
+  * @return The number of bytes used.
+  */
+  template<class IndexesMap>
+  std::size_t Footprint(const IndexesMap &indexes)
+  {
+    using namespace condor2nav;
+    using CIndex = typename IndexesMap::mapped_type;
+    std::size_t bytes = 0;
+    for(const auto &index : indexes) {
+      bytes += sizeof(typename IndexesMap::value_type) + 4 * sizeof(void *);
+      bytes += index.second.bucket_count() * sizeof(void *) +
+               index.second.size() * (sizeof(typename CIndex::value_type) + 2 * sizeof(void *));
+      for(const auto &entry : index.second)
+        bytes += CMemoryAccount::Heap(entry.first);
+    }
+    return bytes;
+  }
+
 }
 
 /**
@@ -91,20 +179,44 @@ namespace {
  * @param filePath The path of the CSV file to parse.
  */
 condor2nav::CFileParserCSV::CFileParserCSV(bfs::path filePath) :
-  _filePath{std::move(filePath)}
+  _filePath{std::move(filePath)}, _arena{TMemorySubsystem::PARSERS}, _indexesVerify{false},
+  _rowsMemory{TMemorySubsystem::PARSERS}, _indexesMemory{TMemorySubsystem::PARSERS}
 {
+  CTraceScope trace{"parser", "CSV", _filePath};
+
   // open CSV file
-  CIStream inputStream{filePath};
+  CIStream inputStream{_filePath};
 
   // parse all lines
-  std::string line;
+  boost::string_ref line;
   while(inputStream.GetLine(line)) {
     if(line.empty())
       continue;
-    _rowsList.emplace_back(LineParseCSV(line));
+    _rowsList.emplace_back(LineParseCSV(line, _arena));
   }
-  if(_rowsList.front().size() <= 1)
-    throw EOperationFailed{"ERROR: File '" + filePath.string() + "' does not look like a CSV File!!"};
+  if(_rowsList.empty() || _rowsList.front().size() <= 1)
+    throw EOperationFailed{"ERROR: File '" + _filePath.string() + "' does not look like a CSV File!!"};
+  _rowsMemory.Set(Footprint(_rowsList));
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CFileParserCSV class constructor that uses a table compiled
+ * into the application instead of parsing the file.
+ *
+ * @param filePath The path of the CSV file the table was compiled from.
+ * @param compiled Compiled table.
+ */
+condor2nav::CFileParserCSV::CFileParserCSV(bfs::path filePath, const TCompiledCSV &compiled) :
+  _filePath{std::move(filePath)}, _arena{TMemorySubsystem::PARSERS}, _indexesVerify{false},
+  _rowsMemory{TMemorySubsystem::PARSERS}, _indexesMemory{TMemorySubsystem::PARSERS}, _compiled{&compiled}
+{
+  CTraceScope trace{"parser", "CSV compiled", _filePath};
+  for(unsigned i=0; i<compiled.rowsNum; i++)
+    _rowsList.emplace_back(compiled.cells + compiled.rowOffsets[i], compiled.cells + compiled.rowOffsets[i + 1]);
+  _rowsMemory.Set(Footprint(_rowsList));
 }
 
 
@@ -123,30 +235,64 @@ condor2nav::CFileParserCSV::CFileParserCSV(bfs::path filePath) :
  */
 auto condor2nav::CFileParserCSV::Row(const std::string &value, unsigned column /* = 0 */, bool nocase /* = false */) const -> const CStringArray &
 {
-  auto nonConst = const_cast<CFileParserCSV *>(this);
-  return nonConst->Row(value, column, nocase);
+  auto row = RowFind(value, column, nocase);
+  if(!row)
+    throw EOperationFailed{"ERROR: Couldn't find value '" + value + "' in column '" + Convert(column) + "' of CSV file '" + Path().string() + "'!!!"};
+  return *row;
 }
 
 
 /**
- * @brief Returns requested row.
+ * @brief Finds requested row.
  *
- * Method returns the values from one row specified by the value in specified column.
+ * Method finds the first row that has provided value in specified column. The search
+ * uses the index for that column that is built on the first use. If rows could have
+ * been modified since the index was built, found row is verified and the indexes are
+ * rebuilt when needed. The first column of the compiled table is searched with its
+ * perfect hash instead. Only values that are not found there fall back to the index.
+ * Indexes are built under a lock so the same parser may be searched from many threads.
  *
  * @param value  The value to use for searching.
  * @param column The column index to be used for value comparison.
  * @param nocase Specifies if a search should be case sensitive.
  *
- * @exception std Thrown when requested row is not found.
- *
- * @return Requested row.
+ * @return Requested row or @p nullptr if not found.
  */
-auto condor2nav::CFileParserCSV::Row(const std::string &value, unsigned column /* = 0 */, bool nocase /* = false */) -> CStringArray &
+auto condor2nav::CFileParserCSV::RowFind(const std::string &value, unsigned column, bool nocase) const -> CStringArray *
 {
-  for(auto &row : _rowsList)
-    if(row.at(column) == value || (nocase && row[column].c_str() == CStringNoCase{value.c_str()}))
-      return row;
-  throw EOperationFailed{"ERROR: Couldn't find value '" + value + "' in column '" + Convert(column) + "' of CSV file '" + Path().string() + "'!!!"};
+  const auto key = IndexKey(value, nocase);
+  if(_compiled && column == 0) {
+    const auto slot = _compiled->slots[CompiledCSVHash(value, _compiled->seed) & (_compiled->slotsNum - 1)];
+    if(slot) {
+      auto &row = const_cast<CFileParserCSV *>(this)->_rowsList[slot - 1];
+      if(!row.empty() && IndexKey(row[0], nocase) == key)
+        return &row;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock{_indexesMutex};
+  for(;;) {
+    auto &index = _indexesMap[std::make_pair(column, nocase)];
+    if(index.empty()) {
+      // build the index (the first row with given value is used)
+      auto nonConst = const_cast<CFileParserCSV *>(this);
+      for(auto &row : nonConst->_rowsList)
+        if(row.size() > column)
+          index.emplace(IndexKey(row[column], nocase), &row);
+      _indexesMemory.Set(Footprint(_indexesMap));
+    }
+
+    auto it = index.find(key);
+    if(it != index.end() && (!_indexesVerify || IndexKey(it->second->at(column), nocase) == key))
+      return it->second;
+    if(!_indexesVerify)
+      return nullptr;
+
+    // rows could have been modified so rebuild indexes and try again
+    _indexesMap.clear();
+    _indexesMemory.Set(0);
+    _indexesVerify = false;
+  }
 }
 
 
@@ -164,15 +310,53 @@ auto condor2nav::CFileParserCSV::Rows() const -> const CRowsList &
 
 
 /**
- * @brief Returns all rows.
+ * @brief Adds a row.
  *
- * Method returns all rows parsed from a CSV file.
+ * Method copies the cells to the parser strings storage and appends
+ * the row to the end of the file. Provided cells do not have to outlive
+ * the call.
  *
- * @return Rows.
+ * @param cells The cells of the new row.
  */
-auto condor2nav::CFileParserCSV::Rows() -> CRowsList &
+void condor2nav::CFileParserCSV::RowAdd(const CStringArray &cells)
 {
-  return _rowsList;
+  CStringArray row;
+  row.reserve(cells.size());
+  for(const auto &cell : cells)
+    row.emplace_back(_arena.Store(cell));
+  _rowsList.emplace_back(std::move(row));
+  _rowsMemory.Set(_rowsMemory.Bytes() + sizeof(CStringArray) + _rowsList.back().capacity() * sizeof(boost::string_ref));
+
+  // indexes do not contain the new row
+  std::lock_guard<std::mutex> lock{_indexesMutex};
+  _indexesMap.clear();
+  _indexesMemory.Set(0);
+  _indexesVerify = false;
+  _compiled = nullptr;
+}
+
+
+/**
+ * @brief Sets the value of a cell.
+ *
+ * Method copies the value to the parser strings storage so it does not
+ * have to outlive the call.
+ *
+ * @param row    The row of this parser to modify (returned by Row() or Rows()).
+ * @param column The column index of the cell.
+ * @param value  The value to set.
+ *
+ * @exception std Thrown when the column does not exist in the row.
+ */
+void condor2nav::CFileParserCSV::Value(const CStringArray &row, unsigned column, boost::string_ref value)
+{
+  if(column >= row.size())
+    throw EOperationFailed{"ERROR: Column '" + Convert(column) + "' does not exist in the row of CSV file '" + Path().string() + "'!!!"};
+  // rows are never provided to the callers as modifiable
+  const_cast<CStringArray &>(row)[column] = _arena.Store(value);
+  std::lock_guard<std::mutex> lock{_indexesMutex};
+  _indexesVerify = true;
+  _compiled = nullptr;
 }
 
 
@@ -194,4 +378,40 @@ void condor2nav::CFileParserCSV::Dump(const bfs::path &filePath /* = "" */) cons
     }
     ostream << std::endl;
   }
+  ostream.Commit();
+}
+
+
+/**
+* @brief Returns the parser of a CSV file.
+*
+* Method returns cached parser of the file. The file is parsed again if its
+* modification time changed since the last call. Files without modification
+* time (i.e. remote ones) are parsed only once. Files distributed with
+* Condor2Nav that were not customized by the user are not parsed but
+* provided from the tables compiled into the application. Callers keep
+* the returned parser (and the rows referenced from it) valid even if
+* the cache replaces it in the meantime.
+*
+* @param filePath Path of the CSV file.
+*
+* @exception std Thrown when the file cannot be parsed.
+*
+* @return CSV file parser.
+*/
+auto condor2nav::CFileParserCSVCache::Parser(const bfs::path &filePath) -> std::shared_ptr<const CFileParserCSV>
+{
+  boost::system::error_code ec;
+  auto writeTime = bfs::last_write_time(filePath, ec);
+  if(ec)
+    writeTime = 0;
+
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto &entry = _entries[filePath];
+  if(!entry.parser || (writeTime && entry.writeTime != writeTime)) {
+    const auto compiled = CompiledCSV(filePath);
+    entry.parser = compiled ? std::make_shared<const CFileParserCSV>(filePath, *compiled) : std::make_shared<const CFileParserCSV>(filePath);
+    entry.writeTime = writeTime;
+  }
+  return entry.parser;
 }
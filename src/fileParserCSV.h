@@ -30,39 +30,102 @@
 
 #include "nonCopyable.h"
 #include "boostfwd.h"
+#include "memoryAccount.h"
+#include "stringArena.h"
 #include <deque>
 #include <vector>
 #include <string>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <ctime>
 #include <boost/filesystem.hpp>
+#include <boost/utility/string_ref.hpp>
 
 namespace condor2nav {
 
+  struct TCompiledCSV;
+
   /**
    * @brief CSV type files parser.
    *
    * condor2nav::CFileParserCSV is the CSV (Comma Separated Values) type
    * files parser. Any file that provides values separated with commas can
    * be processed with that class.
+   *
+   * Rows lookups are using indexes that are built on demand for each
+   * searched column and case sensitivity.
+   *
+   * The text of the file is kept in the parser strings arena and cells are
+   * views of that text. Rows can be modified only with Value() and RowAdd()
+   * that copy provided text to the arena too, so the cells never refer to
+   * the memory of the caller. Cells (and the rows copied from a parser) are
+   * valid only as long as the parser exists.
+   *
+   * Parser may also be created from a table compiled into the application.
+   * Its cells are views of the static table data and the first column is
+   * searched with the table perfect hash until rows are modified.
    */
   class CFileParserCSV : CNonCopyable {
   public:
-    using CStringArray = std::vector<std::string>; ///< @brief The array of strings.
+    using CStringArray = std::vector<boost::string_ref>; ///< @brief The array of cells.
     using CRowsList = std::deque<CStringArray>;	   ///< @brief The list of string arrays. 
 
   private:
+    using CRowsIndex = std::unordered_map<std::string, CStringArray *>;   ///< @brief Rows indexed by the value of one column.
+    using CIndexesMap = std::map<std::pair<unsigned, bool>, CRowsIndex>;  ///< @brief Rows indexes for (column, nocase) pairs.
+
     const bfs::path _filePath;                     ///< @brief Input file path.
+    CStringArena _arena;                           ///< @brief The storage of cells text.
     CRowsList _rowsList;	                       ///< @brief The list of file rows.
+    mutable std::mutex _indexesMutex;              ///< @brief Protects rows indexes of parsers shared between threads.
+    mutable CIndexesMap _indexesMap;               ///< @brief Rows indexes built on demand.
+    mutable bool _indexesVerify;                   ///< @brief Some rows might have been modified since the indexes were built.
+    CMemoryCharge _rowsMemory;                     ///< @brief Memory used by parsed rows.
+    mutable CMemoryCharge _indexesMemory;          ///< @brief Memory used by rows indexes.
+    const TCompiledCSV *_compiled = nullptr;       ///< @brief Compiled table used to search the first column (nullptr if none).
+
+    CStringArray *RowFind(const std::string &value, unsigned column, bool nocase) const;
 
   public:
     explicit CFileParserCSV(bfs::path filePath);
+    CFileParserCSV(bfs::path filePath, const TCompiledCSV &compiled);
     const bfs::path &Path() const { return _filePath; }
     const CStringArray &Row(const std::string &value, unsigned column = 0, bool nocase = false) const;
-    CStringArray &Row(const std::string &value, unsigned column = 0, bool nocase = false);
     const CRowsList &Rows() const;
-    CRowsList &Rows();
+    void RowAdd(const CStringArray &cells);
+    void Value(const CStringArray &row, unsigned column, boost::string_ref value);
     void Dump(const bfs::path &filePath = "") const;
   };
 
+
+  /**
+   * @brief Cache of CSV files parsers.
+   *
+   * condor2nav::CFileParserCSVCache keeps parsed CSV files (together with their
+   * rows indexes) between translations. A file is parsed again only when it
+   * was modified since the last parse.
+   *
+   * @note Parser returned by Parser() stays valid as long as the caller
+   *       holds it, even if the cache replaces it with a newer one.
+   */
+  class CFileParserCSVCache : CNonCopyable {
+    /**
+     * @brief Cached parser.
+     */
+    struct TEntry {
+      std::time_t writeTime;                          ///< @brief File modification time at parse time
+      std::shared_ptr<const CFileParserCSV> parser;   ///< @brief File parser
+    };
+
+    std::map<bfs::path, TEntry> _entries;             ///< @brief Cached parsers
+    std::mutex _mutex;                                ///< @brief Serializes cache access
+
+  public:
+    std::shared_ptr<const CFileParserCSV> Parser(const bfs::path &filePath);
+  };
+
 }
 
 #endif /* __FILEPARSERCSV_H__ */
@@ -26,12 +26,49 @@
  */
 
 #include "fileParserINI.h"
+#include "fingerprint.h"
 #include "istream.h"
 #include "ostream.h"
+#include "traceLog.h"
+#include "writeBehind.h"
+#include <algorithm>
 
 
 namespace {
 
+  /**
+   * @brief Dumped file state.
+   */
+  struct TDumpRecord {
+    std::uint64_t writeTime;                          ///< @brief File modification time after the dump
+    std::string hash;                                 ///< @brief Hash of the dumped content
+  };
+
+  std::mutex dumpsMutex;
+  std::map<bfs::path, TDumpRecord> dumps;
+
+
+  /**
+  * @brief Checks if the file still has the content dumped previously.
+  *
+  * @param path The path of the file to check.
+  * @param hash The hash of the content to dump.
+  *
+  * @return @p true if the same content was dumped to the file and it was not modified since then.
+  */
+  bool DumpMatches(const bfs::path &path, const std::string &hash)
+  {
+    TDumpRecord record;
+    {
+      std::lock_guard<std::mutex> lock{dumpsMutex};
+      auto it = dumps.find(path);
+      if(it == dumps.end() || it->second.hash != hash)
+        return false;
+      record = it->second;
+    }
+    return condor2nav::FileWriteTime(path) == record.writeTime;
+  }
+
   /**
   * @brief Parses the line as key=value pairs.
   *
@@ -43,17 +80,34 @@ namespace {
   *
   * @exception std Thrown when operation failed.
   */
-  std::pair<const std::string, std::string> LineParseKeyValue(const std::string &line)
+  std::pair<boost::string_ref, boost::string_ref> LineParseKeyValue(boost::string_ref line)
   {
     using namespace condor2nav;
-    auto pos = line.find_first_of("=");
-    if(pos == std::string::npos)
-      throw EOperationFailed{"ERROR: '=' sign not found in line '" + line + "'!!!"};
-
-    auto ret = std::make_pair(line.substr(0, pos), line.substr(pos + 1));
-    Trim(ret.first);
-    Trim(ret.second);
-    return ret;
+    auto pos = line.find('=');
+    if(pos == boost::string_ref::npos)
+      throw EOperationFailed{"ERROR: '=' sign not found in line '" + line.to_string() + "'!!!"};
+
+    auto key = Trim(line.substr(0, pos));
+    auto value = Trim(line.substr(pos + 1));
+    return std::make_pair(key, value);
+  }
+
+
+  /**
+  * @brief Returns the memory used by key=value pairs.
+  *
+  * @param map The pairs to check.
+  *
+  * @return The number of bytes used.
+  */
+  template<class Map>
+  std::size_t Footprint(const Map &map)
+  {
+    using namespace condor2nav;
+    auto bytes = map.capacity() * sizeof(typename Map::value_type);
+    for(const auto &v : map)
+      bytes += CMemoryAccount::Heap(v.second);
+    return bytes;
   }
 
 }
@@ -66,10 +120,12 @@ namespace {
  * @param filePath The path of the INI file to parse.
  */
 condor2nav::CFileParserINI::CFileParserINI(bfs::path filePath) :
-  _filePath{std::move(filePath)}
+  _filePath{std::move(filePath)}, _arena{TMemorySubsystem::PARSERS}, _memory{TMemorySubsystem::PARSERS}
 {
+  CTraceScope trace{"parser", "INI", _filePath};
+
   // open input INI file
-  CIStream inputStream{filePath};
+  CIStream inputStream{_filePath};
   Parse(inputStream);
 }
 
@@ -83,13 +139,41 @@ condor2nav::CFileParserINI::CFileParserINI(bfs::path filePath) :
  * @param url The path on the server to the INI file.
  */
 condor2nav::CFileParserINI::CFileParserINI(const std::string &server, const bfs::path &url) :
-  _filePath{server + url.generic_string()}
+  _filePath{server + url.generic_string()}, _arena{TMemorySubsystem::PARSERS}, _memory{TMemorySubsystem::PARSERS}
 {
   CIStream inputStream{server, url.generic_string()};
   Parse(inputStream);
 }
 
 
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CFileParserINI class constructor that copies the content
+ * of already parsed file.
+ *
+ * @param filePath The path of the INI file.
+ * @param source   The parser to copy the content from.
+ */
+condor2nav::CFileParserINI::CFileParserINI(bfs::path filePath, const CFileParserINI &source) :
+  _filePath{std::move(filePath)}, _arena{TMemorySubsystem::PARSERS}, _memory{TMemorySubsystem::PARSERS}
+{
+  _valuesMap = Copy(source._valuesMap);
+  for(const auto &ch : source._chaptersList) {
+    TChapter chapter;
+    chapter.name = _arena.Store(ch.name);
+    chapter.valuesMap = Copy(ch.valuesMap);
+    _chaptersList.emplace_back(std::move(chapter));
+  }
+  Index();
+  Account();
+  if(!source._dirty) {
+    _hash = source._hash;
+    _dirty = false;
+  }
+}
+
+
 /**
  * @brief INI file parser.
  *
@@ -100,14 +184,14 @@ condor2nav::CFileParserINI::CFileParserINI(const std::string &server, const bfs:
 void condor2nav::CFileParserINI::Parse(CIStream &inputStream)
 {
   // parse all lines
-  std::string line;
+  boost::string_ref line;
   CValuesMap *currentMap = &_valuesMap;
   while(inputStream.GetLine(line)) {
     if(line.empty())
       continue;
 
-    auto pos = line.find_first_not_of(" ");
-    if(pos == std::string::npos)
+    auto pos = line.find_first_not_of(' ');
+    if(pos == boost::string_ref::npos)
       continue;
 
     if(line[pos] == ';' || line[pos] == '#')
@@ -116,26 +200,104 @@ void condor2nav::CFileParserINI::Parse(CIStream &inputStream)
 
     if(line[pos] == '[') {
       // new chapter
-      auto pos2 = line.find_first_of("]");
-      if(pos2 == std::string::npos)
-        throw EOperationFailed{"ERROR: ']' not found in file line '" + line + "' in '" + Path().string() + "' INI !!!"};
+      auto pos2 = line.find(']');
+      if(pos2 == boost::string_ref::npos)
+        throw EOperationFailed{"ERROR: ']' not found in file line '" + line.to_string() + "' in '" + Path().string() + "' INI !!!"};
       
       TChapter chapter;
-      chapter.name = line.substr(1, pos2 - 1);
-      Trim(chapter.name);
+      chapter.name = _arena.Store(Trim(line.substr(pos + 1, pos2 - pos - 1)));
       _chaptersList.emplace_back(std::move(chapter));
       currentMap = &_chaptersList.back().valuesMap;
       continue;
     }
     
     // add new entry
-    auto ret = currentMap->insert(LineParseKeyValue(line));
-    if(!ret.second)
-       throw EOperationFailed{"ERROR: Entry '" + ret.first->first + "' provided more than once in '" + Path().string() + "' INI file!!!"};
+    const auto value = LineParseKeyValue(line);
+    currentMap->emplace_back(_arena.Store(value.first), value.second.to_string());
+  }
+
+  // sort values and build chapters index
+  Sort(_valuesMap);
+  for(auto &ch : _chaptersList)
+    Sort(ch.valuesMap);
+  Index();
+  Account();
+}
+
+
+/**
+ * @brief Copies the values.
+ *
+ * Method copies the values of other parser storing their keys in this
+ * parser arena.
+ *
+ * @param map The values to copy.
+ *
+ * @return Copied values.
+ */
+auto condor2nav::CFileParserINI::Copy(const CValuesMap &map) -> CValuesMap
+{
+  CValuesMap values;
+  values.reserve(map.size());
+  for(const auto &v : map)
+    values.emplace_back(_arena.Store(v.first), v.second);
+  return values;
+}
+
+
+/**
+ * @brief Builds chapters index.
+ *
+ * Method indexes chapters by their names.
+ */
+void condor2nav::CFileParserINI::Index()
+{
+  _chaptersIndex.clear();
+  for(auto &ch : _chaptersList) {
+    auto it = std::lower_bound(_chaptersIndex.begin(), _chaptersIndex.end(), ch.name,
+                               [](const TChapter *c, boost::string_ref name) { return c->name < name; });
+    if(it == _chaptersIndex.end() || (*it)->name != ch.name)
+      // in case of duplicated chapter names the first one is used
+      _chaptersIndex.insert(it, &ch);
   }
 }
 
 
+/**
+ * @brief Accounts parsed data.
+ *
+ * Method charges parsers subsystem with the memory used by the chapters
+ * and their values.
+ */
+void condor2nav::CFileParserINI::Account()
+{
+  auto bytes = Footprint(_valuesMap) + _chaptersIndex.capacity() * sizeof(TChapter *) +
+               _chaptersList.size() * sizeof(TChapter);
+  for(const auto &ch : _chaptersList)
+    bytes += Footprint(ch.valuesMap);
+  _memory.Set(bytes);
+}
+
+
+/**
+ * @brief Sorts the values.
+ *
+ * Method sorts the values by their keys.
+ *
+ * @param map The values to sort.
+ *
+ * @exception std Thrown when the same key was provided more than once.
+ */
+void condor2nav::CFileParserINI::Sort(CValuesMap &map) const
+{
+  auto less = [](const CValue &v1, const CValue &v2) { return v1.first < v2.first; };
+  std::stable_sort(map.begin(), map.end(), less);
+  auto it = std::adjacent_find(map.begin(), map.end(), [](const CValue &v1, const CValue &v2) { return v1.first == v2.first; });
+  if(it != map.end())
+    throw EOperationFailed{"ERROR: Entry '" + it->first.to_string() + "' provided more than once in '" + Path().string() + "' INI file!!!"};
+}
+
+
 /**
  * @brief Returns requested chapter.
  *
@@ -147,12 +309,13 @@ void condor2nav::CFileParserINI::Parse(CIStream &inputStream)
  *
  * @return Requested chapter.
  */
-auto condor2nav::CFileParserINI::Chapter(const std::string &chapter) -> TChapter &
+auto condor2nav::CFileParserINI::Chapter(boost::string_ref chapter) -> TChapter &
 {
-  for(auto &ch : _chaptersList)
-    if(ch.name == chapter)
-      return ch;
-  throw EOperationFailed{"ERROR: Chapter '" + chapter + "' not found in '" + Path().string() + "' INI file!!!"};
+  auto it = std::lower_bound(_chaptersIndex.begin(), _chaptersIndex.end(), chapter,
+                             [](const TChapter *c, boost::string_ref name) { return c->name < name; });
+  if(it == _chaptersIndex.end() || (*it)->name != chapter)
+    throw EOperationFailed{"ERROR: Chapter '" + chapter.to_string() + "' not found in '" + Path().string() + "' INI file!!!"};
+  return **it;
 }
 
 
@@ -167,7 +330,7 @@ auto condor2nav::CFileParserINI::Chapter(const std::string &chapter) -> TChapter
  *
  * @return Requested chapter.
  */
-auto condor2nav::CFileParserINI::Chapter(const std::string &chapter) const -> const TChapter &
+auto condor2nav::CFileParserINI::Chapter(boost::string_ref chapter) const -> const TChapter &
 {
   auto nonConst = const_cast<CFileParserINI *>(this);
   return nonConst->Chapter(chapter);
@@ -187,12 +350,13 @@ auto condor2nav::CFileParserINI::Chapter(const std::string &chapter) const -> co
  *
  * @return Requested value.
  */
-const std::string &condor2nav::CFileParserINI::Value(const std::string &chapter, const std::string &key) const
+const std::string &condor2nav::CFileParserINI::Value(boost::string_ref chapter, boost::string_ref key) const
 {
-  const CValuesMap &map = (chapter != "") ? Chapter(chapter).valuesMap : _valuesMap;
-  auto it = map.find(key);
-  if(it == map.end())
-    throw EOperationFailed{"ERROR: Entry '" + key + "' not found in '" + Path().string() + "' INI file!!!"};
+  const CValuesMap &map = !chapter.empty() ? Chapter(chapter).valuesMap : _valuesMap;
+  auto it = std::lower_bound(map.begin(), map.end(), key,
+                             [](const CValue &v, boost::string_ref k) { return v.first < k; });
+  if(it == map.end() || it->first != key)
+    throw EOperationFailed{"ERROR: Entry '" + key.to_string() + "' not found in '" + Path().string() + "' INI file!!!"};
   return it->second;
 }
 
@@ -206,12 +370,48 @@ const std::string &condor2nav::CFileParserINI::Value(const std::string &chapter,
  * @param key     The key name. 
  * @param value   The value to set.
  */
-void condor2nav::CFileParserINI::Value(const std::string &chapter, const std::string &key, std::string value)
+void condor2nav::CFileParserINI::Value(boost::string_ref chapter, boost::string_ref key, std::string value)
 {
-  if(key == "")
+  if(key.empty())
     throw EOperationFailed{"ERROR: Cannot set value for empty key in INI file!!!"};
-  CValuesMap &map = (chapter != "") ? Chapter(chapter).valuesMap : _valuesMap;
-  map[key] = std::move(value);
+  CValuesMap &map = !chapter.empty() ? Chapter(chapter).valuesMap : _valuesMap;
+  auto it = std::lower_bound(map.begin(), map.end(), key,
+                             [](const CValue &v, boost::string_ref k) { return v.first < k; });
+
+  // the footprint is updated with the difference only (profiles are translated with many sets in a row)
+  const auto capacity = map.capacity();
+  auto bytes = _memory.Bytes();
+  if(it == map.end() || it->first != key) {
+    it = map.emplace(it, _arena.Store(key), std::move(value));
+    bytes += (map.capacity() - capacity) * sizeof(CValue);
+  }
+  else if(it->second != value) {
+    bytes -= CMemoryAccount::Heap(it->second);
+    it->second = std::move(value);
+  }
+  else
+    return;
+  _memory.Set(bytes + CMemoryAccount::Heap(it->second));
+  _dirty = true;
+}
+
+
+/**
+ * @brief Returns the hash of the content.
+ *
+ * The hash is recalculated only if the content changed since the last call.
+ *
+ * @return The hash of all the key=value pairs.
+ */
+const std::string &condor2nav::CFileParserINI::Hash() const
+{
+  if(_dirty) {
+    CFingerprint fingerprint;
+    Fingerprint(fingerprint);
+    _hash = fingerprint.String();
+    _dirty = false;
+  }
+  return _hash;
 }
 
 
@@ -224,7 +424,53 @@ void condor2nav::CFileParserINI::Value(const std::string &chapter, const std::st
 */
 void condor2nav::CFileParserINI::Dump(const bfs::path &filePath /* = "" */) const
 {
-  COStream ostream{filePath.empty() ? Path() : filePath};
+  Dump(std::vector<bfs::path>{filePath.empty() ? Path() : filePath});
+}
+
+
+/**
+* @brief Dumps class data to many files.
+*
+* Method serializes class data once and writes it to all the provided
+* files concurrently. Files that already have that content because they
+* were dumped previously and not modified since then are not written again.
+*
+* @param pathList The list of files to create.
+*
+* @exception std Thrown when writing to any of the files failed.
+*/
+void condor2nav::CFileParserINI::Dump(std::vector<bfs::path> pathList) const
+{
+  CWriteBehind immediate{false};
+  Dump(std::move(pathList), immediate);
+}
+
+
+/**
+* @brief Dumps class data to many files with the write-behind queue.
+*
+* Method serializes class data and hands it over to the queue. Files that were
+* written with the same content are skipped as described for Dump().
+*
+* @param pathList The list of files to create.
+* @param queue    The queue executing the write.
+* @param written  The function to call after all the files were written successfully.
+*
+* @exception std Thrown when writing to any of the files failed and the queue is disabled.
+*/
+void condor2nav::CFileParserINI::Dump(std::vector<bfs::path> pathList, CWriteBehind &queue,
+                                      std::function<void()> written /* = nullptr */) const
+{
+  const auto hash = Hash();
+  pathList.erase(std::remove_if(pathList.begin(), pathList.end(), [&](const bfs::path &path) { return DumpMatches(path, hash); }),
+                 pathList.end());
+  if(pathList.empty()) {
+    if(written)
+      written();
+    return;
+  }
+
+  COStream ostream{pathList};
   // dump global scope
   for(const auto &v : _valuesMap)
     ostream << v.first << "=" << v.second << std::endl;
@@ -238,4 +484,137 @@ void condor2nav::CFileParserINI::Dump(const bfs::path &filePath /* = "" */) cons
     for(const auto &v : it->valuesMap)
       ostream << v.first << "=" << v.second << std::endl;
   }
+  ostream.Commit(queue, [pathList, hash, written]
+  {
+    for(const auto &path : pathList) {
+      const auto writeTime = FileWriteTime(path);
+      std::lock_guard<std::mutex> lock{dumpsMutex};
+      if(writeTime)
+        dumps[path] = TDumpRecord{writeTime, hash};
+      else
+        dumps.erase(path);
+    }
+    if(written)
+      written();
+  });
+}
+
+
+/**
+ * @brief Adds chapter data to the fingerprint.
+ *
+ * Method adds all key=value pairs of the chapter to the fingerprint. Missing
+ * chapter is treated as an empty one.
+ *
+ * @param fingerprint Fingerprint to update.
+ * @param chapter     The chapter name ("" means global scope).
+ */
+void condor2nav::CFileParserINI::Fingerprint(CFingerprint &fingerprint, boost::string_ref chapter) const
+{
+  fingerprint.Add(chapter);
+  const CValuesMap *values = &_valuesMap;
+  if(!chapter.empty()) {
+    auto it = std::lower_bound(_chaptersIndex.begin(), _chaptersIndex.end(), chapter,
+                               [](const TChapter *c, boost::string_ref name) { return c->name < name; });
+    if(it == _chaptersIndex.end() || (*it)->name != chapter)
+      return;
+    values = &(*it)->valuesMap;
+  }
+  for(const auto &v : *values)
+    fingerprint.Add(v.first).Add(v.second);
+}
+
+
+/**
+ * @brief Adds all the file data to the fingerprint.
+ *
+ * @param fingerprint Fingerprint to update.
+ */
+void condor2nav::CFileParserINI::Fingerprint(CFingerprint &fingerprint) const
+{
+  Fingerprint(fingerprint, "");
+  for(const auto &chapter : _chaptersList)
+    Fingerprint(fingerprint, chapter.name);
+}
+
+
+
+/**
+* @brief Returns the parser of the first existing file.
+*
+* Method checks candidate files in order and returns a copy of the parser
+* of the first one that exists. Only modification times are checked for
+* files that were already parsed or stored and did not change since then.
+*
+* @param candidates Paths of the files to check in priority order.
+*
+* @exception std Thrown when the file cannot be parsed.
+*
+* @return Parser of the first existing file or nullptr if none exists.
+*/
+std::unique_ptr<condor2nav::CFileParserINI> condor2nav::CFileParserINICache::Parser(const std::vector<bfs::path> &candidates)
+{
+  for(const auto &path : candidates) {
+    const auto writeTime = FileWriteTime(path);
+    if(!writeTime)
+      continue;
+
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      auto it = _entries.find(path);
+      if(it != _entries.end() && it->second.writeTime == writeTime)
+        return std::make_unique<CFileParserINI>(path, *it->second.parser);
+    }
+
+    // parse outside of the lock
+    auto parser = std::make_unique<const CFileParserINI>(path);
+    auto copy = std::make_unique<CFileParserINI>(path, *parser);
+    std::lock_guard<std::mutex> lock{_mutex};
+    _entries[path] = TEntry{writeTime, std::move(parser)};
+    return copy;
+  }
+  return nullptr;
+}
+
+
+/**
+* @brief Stores the content written to the files.
+*
+* Should be called after the parser content was dumped to the files so that
+* the next Parser() call for them does not need to read them.
+*
+* @param parser   The parser that was dumped.
+* @param pathList The list of files the parser was dumped to.
+*
+* @exception std Thrown when modification time cannot be obtained.
+*/
+void condor2nav::CFileParserINICache::Store(const CFileParserINI &parser, const std::vector<bfs::path> &pathList)
+{
+  for(const auto &path : pathList) {
+    const auto writeTime = FileWriteTime(path);
+    if(!writeTime)
+      continue;
+    auto copy = std::make_unique<const CFileParserINI>(path, parser);
+    std::lock_guard<std::mutex> lock{_mutex};
+    _entries[path] = TEntry{writeTime, std::move(copy)};
+  }
+}
+
+
+/**
+* @brief Returns the function storing the content that is being written.
+*
+* Should be used as the completion function of the write-behind Dump(). The
+* content of the parser is copied so the parser may be modified or destroyed
+* before the files are written.
+*
+* @param parser   The parser that is dumped.
+* @param pathList The list of files the parser is dumped to.
+*
+* @return The function calling Store() with the parser content.
+*/
+std::function<void()> condor2nav::CFileParserINICache::Storer(const CFileParserINI &parser, std::vector<bfs::path> pathList)
+{
+  std::shared_ptr<const CFileParserINI> content = std::make_shared<const CFileParserINI>(parser.Path(), parser);
+  return [this, content, pathList]{ Store(*content, pathList); };
 }
@@ -29,15 +29,25 @@
 #define __FILEPARSERINI_H__
 
 #include "nonCopyable.h"
+#include "memoryAccount.h"
+#include "stringArena.h"
 #include "tools.h"
-#include <memory>
+#include <cstdint>
 #include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
+#include <boost/utility/string_ref.hpp>
 
 namespace condor2nav {
 
   class CIStream;
+  class CFingerprint;
+  class CWriteBehind;
 
   /**
    * @brief INI type files parser.
@@ -46,34 +56,88 @@ namespace condor2nav {
    * provides key=value pairs can be processed with that class. Input file
    * may have those pairs grouped into chapters or provide one plain set
    * of pairs (set "" for chapter name in that case).
+   *
+   * Chapters are kept in the file order and indexed by name. Values are
+   * stored in flat arrays sorted by key so lookups do not need to allocate
+   * any temporary strings. Keys and chapter names are never modified so
+   * they are kept in the parser strings arena.
+   *
+   * Setting a value marks the parser dirty only if the value changed. The
+   * content hash is recalculated after a change only, so Dump() can cheaply
+   * skip the destinations it already wrote the same content to.
    */
   class CFileParserINI : CNonCopyable {
-    using CValuesMap = std::map<std::string, std::string>;	///< @brief The map of key=value pairs. 
+    using CValue = std::pair<boost::string_ref, std::string>;  ///< @brief key=value pair. 
+    using CValuesMap = std::vector<CValue>;                ///< @brief The array of key=value pairs sorted by key. 
 
     /**
      * @brief INI file chapter data.
      */
     struct TChapter {
-      std::string name;
+      boost::string_ref name;
       CValuesMap valuesMap;
     };
     using CChaptersList = std::deque<TChapter>;	      ///< @brief The list of INI file chapters.
+    using CChaptersIndex = std::vector<TChapter *>;   ///< @brief The array of INI file chapters sorted by name.
 
     const bfs::path _filePath;                        ///< @brief Input file path.
+    CStringArena _arena;                              ///< @brief The storage of keys and chapter names.
     CValuesMap _valuesMap;	                          ///< @brief The map of plain key=value pairs. 
     CChaptersList _chaptersList;                      ///< @brief The list of chapters and their data found in the file.
+    CChaptersIndex _chaptersIndex;                    ///< @brief The index of chapters found in the file.
+    CMemoryCharge _memory;                            ///< @brief Memory used by parsed data.
+    mutable std::string _hash;                        ///< @brief Hash of the content (empty if not calculated yet).
+    mutable bool _dirty = true;                       ///< @brief The content changed since the hash was calculated.
 
     void Parse(CIStream &inputStream);
-    TChapter &Chapter(const std::string &chapter);
-    const TChapter &Chapter(const std::string &chapter) const;
+    CValuesMap Copy(const CValuesMap &map);
+    void Sort(CValuesMap &map) const;
+    void Index();
+    void Account();
+    const std::string &Hash() const;
+    TChapter &Chapter(boost::string_ref chapter);
+    const TChapter &Chapter(boost::string_ref chapter) const;
 
   public:
     explicit CFileParserINI(bfs::path filePath);
     CFileParserINI(const std::string &server, const bfs::path &url);
+    CFileParserINI(bfs::path filePath, const CFileParserINI &source);
     const bfs::path &Path() const { return _filePath; }
-    const std::string &Value(const std::string &chapter, const std::string &key) const;
-    void Value(const std::string &chapter, const std::string &key, std::string value);
+    const std::string &Value(boost::string_ref chapter, boost::string_ref key) const;
+    void Value(boost::string_ref chapter, boost::string_ref key, std::string value);
     void Dump(const bfs::path &filePath = "") const;
+    void Dump(std::vector<bfs::path> pathList) const;
+    void Dump(std::vector<bfs::path> pathList, CWriteBehind &queue, std::function<void()> written = nullptr) const;
+    void Fingerprint(CFingerprint &fingerprint, boost::string_ref chapter) const;
+    void Fingerprint(CFingerprint &fingerprint) const;
+  };
+
+
+  /**
+   * @brief Cache of INI files parsers.
+   *
+   * condor2nav::CFileParserINICache keeps parsed profiles between translations.
+   * Every parser returned to the caller is a private copy of the cached one
+   * so it may be freely modified. A file is read again only when its
+   * modification time changed. Profiles written by the application are stored
+   * with Store() so they do not have to be read back in the next translation.
+   */
+  class CFileParserINICache : CNonCopyable {
+    /**
+     * @brief Cached parser.
+     */
+    struct TEntry {
+      std::uint64_t writeTime;                        ///< @brief File modification time at parse time
+      std::unique_ptr<const CFileParserINI> parser;   ///< @brief File parser
+    };
+
+    std::map<bfs::path, TEntry> _entries;             ///< @brief Cached parsers
+    std::mutex _mutex;                                ///< @brief Serializes cache access
+
+  public:
+    std::unique_ptr<CFileParserINI> Parser(const std::vector<bfs::path> &candidates);
+    void Store(const CFileParserINI &parser, const std::vector<bfs::path> &pathList);
+    std::function<void()> Storer(const CFileParserINI &parser, std::vector<bfs::path> pathList);
   };
 
 }
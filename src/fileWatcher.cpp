@@ -0,0 +1,210 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file fileWatcher.cpp
+ *
+ * @brief Implements the condor2nav::CFileWatcher class. 
+ */
+
+#include "fileWatcher.h"
+#include "traitsNoCase.h"
+#include <algorithm>
+
+
+const unsigned condor2nav::CFileWatcher::POLL_INTERVAL;
+const unsigned condor2nav::CFileWatcher::BUFFER_SIZE;
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param dirs      Directories to watch.
+ * @param extension Extension of files to report (case insensitive).
+ * @param debounce  Time in ms without writes needed to report a file.
+ *
+ * @exception std Thrown when any of the directories cannot be watched.
+ */
+condor2nav::CFileWatcher::CFileWatcher(const CPathList &dirs, std::string extension, unsigned debounce) :
+  _extension{std::move(extension)}, _debounce{debounce}
+{
+  // no reallocation may throw once a request is pending
+  _dirs.reserve(dirs.size());
+  try {
+    for(const auto &path : dirs) {
+      auto dir = std::make_unique<TDirectory>();
+      dir->path = path;
+      auto handle = CreateFile(path.string().c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+      if(handle == INVALID_HANDLE_VALUE)
+        throw EOperationFailed{"ERROR: Unable to watch directory '" + path.string() + "' (error: " + Convert(GetLastError()) + ")!!!"};
+      dir->handle.reset(handle);
+      dir->event.reset(CreateEvent(nullptr, TRUE, FALSE, nullptr));
+      if(!dir->event)
+        throw EOperationFailed{"ERROR: Unable to create event for directory '" + path.string() + "' (error: " + Convert(GetLastError()) + ")!!!"};
+      dir->buffer.resize(BUFFER_SIZE / sizeof(DWORD));
+      Request(*dir);
+      _dirs.emplace_back(std::move(dir));
+    }
+  }
+  catch(...) {
+    // destructor is not called so requests of already watched directories have to be finished here
+    Cancel();
+    throw;
+  }
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Cancels all pending notification requests.
+ */
+condor2nav::CFileWatcher::~CFileWatcher()
+{
+  Cancel();
+}
+
+
+/**
+ * @brief Cancels pending notification requests.
+ *
+ * Method waits until the system stops using every notification buffer so
+ * that directory handles and buffers may be released.
+ */
+void condor2nav::CFileWatcher::Cancel() throw()
+{
+  for(auto &dir : _dirs) {
+    if(CancelIo(dir->handle.get())) {
+      DWORD bytes;
+      GetOverlappedResult(dir->handle.get(), &dir->overlapped, &bytes, TRUE);
+    }
+  }
+}
+
+
+/**
+ * @brief Requests next change notification for a directory.
+ *
+ * @param dir Watched directory.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+void condor2nav::CFileWatcher::Request(TDirectory &dir) const
+{
+  ZeroMemory(&dir.overlapped, sizeof(dir.overlapped));
+  dir.overlapped.hEvent = dir.event.get();
+  if(!ReadDirectoryChangesW(dir.handle.get(), dir.buffer.data(), static_cast<DWORD>(dir.buffer.size() * sizeof(DWORD)), FALSE,
+                            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+                            nullptr, &dir.overlapped, nullptr))
+    throw EOperationFailed{"ERROR: Unable to watch directory '" + dir.path.string() + "' (error: " + Convert(GetLastError()) + ")!!!"};
+}
+
+
+/**
+ * @brief Processes completed change notifications of a directory.
+ *
+ * Method updates the list of pending files and requests next notification.
+ *
+ * @param dir Watched directory.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+void condor2nav::CFileWatcher::Process(TDirectory &dir)
+{
+  DWORD bytes = 0;
+  if(!GetOverlappedResult(dir.handle.get(), &dir.overlapped, &bytes, FALSE))
+    throw EOperationFailed{"ERROR: Unable to watch directory '" + dir.path.string() + "' (error: " + Convert(GetLastError()) + ")!!!"};
+
+  // no data means that the buffer overflowed and the changes were lost
+  const auto now = CClock::now();
+  auto data = reinterpret_cast<const char *>(dir.buffer.data());
+  for(DWORD offset = 0; bytes > 0;) {
+    auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(data + offset);
+    const auto path = dir.path / std::wstring{info->FileName, info->FileNameLength / sizeof(WCHAR)};
+    if(CStringNoCase{path.extension().string().c_str()} == _extension.c_str()) {
+      switch(info->Action) {
+      case FILE_ACTION_ADDED:
+      case FILE_ACTION_MODIFIED:
+      case FILE_ACTION_RENAMED_NEW_NAME:
+        _pending[path] = now;
+        break;
+      case FILE_ACTION_REMOVED:
+      case FILE_ACTION_RENAMED_OLD_NAME:
+        _pending.erase(path);
+        break;
+      }
+    }
+    if(!info->NextEntryOffset)
+      break;
+    offset += info->NextEntryOffset;
+  }
+
+  ResetEvent(dir.event.get());
+  Request(dir);
+}
+
+
+/**
+ * @brief Waits for a new or modified file.
+ *
+ * Method blocks until a file with a watched extension is created or modified
+ * in any of watched directories and is not written for the debounce period.
+ *
+ * @param cancel Token used to cancel the wait.
+ *
+ * @exception EOperationCancelled Thrown when the wait was cancelled.
+ * @exception std Thrown when operation failed to execute.
+ *
+ * @return Path of the new or modified file.
+ */
+bfs::path condor2nav::CFileWatcher::Wait(const CCancellationToken &cancel)
+{
+  std::vector<HANDLE> events;
+  for(const auto &dir : _dirs)
+    events.push_back(dir->event.get());
+
+  while(true) {
+    cancel.ThrowIfCancelled();
+
+    // report the first file that is not written any more
+    const auto now = CClock::now();
+    auto timeout = std::chrono::milliseconds{POLL_INTERVAL};
+    for(auto it = _pending.begin(); it != _pending.end(); ++it) {
+      const auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second);
+      if(idle >= _debounce) {
+        auto path = it->first;
+        _pending.erase(it);
+        if(bfs::exists(path))
+          return path;
+        timeout = std::chrono::milliseconds{0};
+        break;
+      }
+      timeout = std::min(timeout, _debounce - idle);
+    }
+
+    const auto status = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, static_cast<DWORD>(timeout.count()));
+    if(status >= WAIT_OBJECT_0 && status < WAIT_OBJECT_0 + events.size())
+      Process(*_dirs[status - WAIT_OBJECT_0]);
+    else if(status == WAIT_FAILED)
+      throw EOperationFailed{"ERROR: Unable to wait for directory changes (error: " + Convert(GetLastError()) + ")!!!"};
+  }
+}
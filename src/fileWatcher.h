@@ -0,0 +1,87 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file fileWatcher.h
+ *
+ * @brief Declares the condor2nav::CFileWatcher class. 
+ */
+
+#ifndef __FILEWATCHER_H__
+#define __FILEWATCHER_H__
+
+#include "nonCopyable.h"
+#include "tools.h"
+#include "cancellation.h"
+#include "boostfwd.h"
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Directories changes watcher.
+   *
+   * condor2nav::CFileWatcher uses directory change notifications to find files
+   * with provided extension that were created or modified in watched directories.
+   * A file is reported only after it was not written for a debounce period so
+   * files that are still being saved are not reported.
+   */
+  class CFileWatcher : CNonCopyable {
+  public:
+    using CPathList = std::vector<bfs::path>;            ///< @brief The list of paths.
+
+  private:
+    using CClock = std::chrono::steady_clock;
+    static const unsigned POLL_INTERVAL = 200;           ///< @brief Max time between cancellation checks [ms]
+    static const unsigned BUFFER_SIZE = 64 * 1024;       ///< @brief Changes notifications buffer size [bytes]
+
+    /**
+     * @brief Watched directory.
+     */
+    struct TDirectory {
+      bfs::path path;                                    ///< @brief Directory path
+      CHandleRes handle;                                 ///< @brief Directory handle
+      CHandleRes event;                                  ///< @brief Notification event
+      OVERLAPPED overlapped;                             ///< @brief Pending notification request
+      std::vector<DWORD> buffer;                         ///< @brief Notifications buffer
+    };
+
+    const std::string _extension;                        ///< @brief Extension of reported files
+    const std::chrono::milliseconds _debounce;           ///< @brief Time without writes needed to report a file
+    std::vector<std::unique_ptr<TDirectory>> _dirs;      ///< @brief Watched directories
+    std::map<bfs::path, CClock::time_point> _pending;    ///< @brief Changed files and the time of their last change
+
+    void Request(TDirectory &dir) const;
+    void Process(TDirectory &dir);
+    void Cancel() throw();
+
+  public:
+    CFileWatcher(const CPathList &dirs, std::string extension, unsigned debounce);
+    ~CFileWatcher();
+    bfs::path Wait(const CCancellationToken &cancel);
+  };
+
+}
+
+#endif /* __FILEWATCHER_H__ */
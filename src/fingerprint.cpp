@@ -0,0 +1,97 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file fingerprint.cpp
+ *
+ * @brief Implements the condor2nav::CFingerprint class. 
+ */
+
+#include "fingerprint.h"
+
+namespace {
+
+  const std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+  const std::uint64_t FNV_PRIME        = 1099511628211ULL;
+
+}
+
+
+/**
+ * @brief Class constructor.
+ */
+condor2nav::CFingerprint::CFingerprint() :
+  _hash{FNV_OFFSET_BASIS}
+{
+}
+
+
+/**
+ * @brief Adds data to the fingerprint.
+ *
+ * Data is terminated with a zero byte so that "ab"+"c" and "a"+"bc" give
+ * different fingerprints.
+ *
+ * @param data Data to add.
+ *
+ * @return Fingerprint instance.
+ */
+condor2nav::CFingerprint &condor2nav::CFingerprint::Add(boost::string_ref data)
+{
+  for(auto c : data) {
+    _hash ^= static_cast<unsigned char>(c);
+    _hash *= FNV_PRIME;
+  }
+  _hash *= FNV_PRIME;
+  return *this;
+}
+
+
+/**
+ * @brief Adds all the strings from an array to the fingerprint.
+ *
+ * @param data Data to add.
+ *
+ * @return Fingerprint instance.
+ */
+condor2nav::CFingerprint &condor2nav::CFingerprint::Add(const std::vector<boost::string_ref> &data)
+{
+  Add(std::to_string(data.size()));
+  for(const auto &str : data)
+    Add(str);
+  return *this;
+}
+
+
+/**
+ * @brief Returns the fingerprint.
+ *
+ * @return Fingerprint as a hexadecimal string.
+ */
+std::string condor2nav::CFingerprint::String() const
+{
+  static const char hex[] = "0123456789abcdef";
+  std::string str(16, '0');
+  auto hash = _hash;
+  for(auto it = str.rbegin(); it != str.rend(); ++it, hash >>= 4)
+    *it = hex[hash & 0x0F];
+  return str;
+}
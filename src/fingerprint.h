@@ -0,0 +1,57 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file fingerprint.h
+ *
+ * @brief Declares the condor2nav::CFingerprint class. 
+ */
+
+#ifndef __FINGERPRINT_H__
+#define __FINGERPRINT_H__
+
+#include <boost/utility/string_ref.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Data fingerprint.
+   *
+   * condor2nav::CFingerprint calculates a 64-bit FNV-1a hash of all the data
+   * provided with Add() calls. It is used to detect if translation inputs
+   * changed since the previous run.
+   */
+  class CFingerprint {
+    std::uint64_t _hash;                                     ///< @brief Current hash value
+
+  public:
+    CFingerprint();
+    CFingerprint &Add(boost::string_ref data);
+    CFingerprint &Add(const std::vector<boost::string_ref> &data);
+    std::string String() const;
+  };
+
+}
+
+#endif /* __FINGERPRINT_H__ */
@@ -29,7 +29,6 @@
 #include "condor2navGUI.h"
 #include "resource.h"
 #include "translator.h"
-#include "condor.h"
 #include <array>
 
 
@@ -45,6 +44,17 @@ condor2nav::gui::CCondor2NavGUI::CLogger::CLogger(TType type, HWND hDlg) :
 }
 
 
+/**
+ * @brief Class destructor.
+ *
+ * Waits for all pending traces to be posted to the logging window.
+ */
+condor2nav::gui::CCondor2NavGUI::CLogger::~CLogger()
+{
+  Flush();
+}
+
+
 /**
  * @brief Dumps the text to the logger window.
  *
@@ -62,18 +72,22 @@ void condor2nav::gui::CCondor2NavGUI::CLogger::Trace(const std::string &str) con
 /**
  * @brief Class constructor. 
  *
+ * Constructor does not block the dialog. Condor installation is looked up
+ * by the active object and FPL files are probed by the thread pool. FPL
+ * widgets show the loading state and are filled in when probes complete.
+ *
  * @param hInst The instance. 
  * @param hDlg  Handle of the dialog. 
  */
 condor2nav::gui::CCondor2NavGUI::CCondor2NavGUI(HINSTANCE hInst, HWND hDlg) :
-  _condorPath{CCondor::InstallPath()},
+  _condorPath{_condorPathSource.get_future().share()},
   _normal{CLogger::TType::LOG_NORMAL, hDlg},
   _high{CLogger::TType::LOG_HIGH, hDlg},
   _warning{CLogger::TType::WARNING, hDlg},
   _error{CLogger::TType::ERROR, hDlg},
   _hDlg{hDlg},
-  _fplDefault{hDlg, IDC_FPL_DEFAULT_RADIO},
-  _fplLastRace{hDlg, IDC_FPL_LAST_RACE_RADIO},
+  _fplDefault{hDlg, IDC_FPL_DEFAULT_RADIO, true},
+  _fplLastRace{hDlg, IDC_FPL_LAST_RACE_RADIO, true},
   _fplOther{hDlg, IDC_FPL_OTHER_RADIO},
   _fplSelect{hDlg, IDC_FPL_SELECT_BUTTON, true},
   _fplPath{hDlg, IDC_FPL_PATH_EDIT},
@@ -81,8 +95,10 @@ condor2nav::gui::CCondor2NavGUI::CCondor2NavGUI(HINSTANCE hInst, HWND hDlg) :
   _aatOn{hDlg, IDC_AAT_ON_RADIO},
   _aatTime{hDlg, IDC_AAT_TIME_COMBO, true},
   _aatMinutes{hDlg, IDC_AAT_STATIC, true},
-  _translate{hDlg, IDC_TRANSLATE_BUTTON},
-  _log{hDlg, IDC_LOG_RICHEDIT2}
+  _translate{hDlg, IDC_TRANSLATE_BUTTON, true},
+  _log{hDlg, IDC_LOG_RICHEDIT2},
+  _downloadProgress{hDlg, IDC_DOWNLOAD_PROGRESS, DOWNLOAD_PROGRESS_RANGE},
+  _downloadStatus{hDlg, IDC_DOWNLOAD_STATIC}
 {
   // Attach icon to main dialog
   SendMessage(hDlg, WM_SETICON, ICON_BIG, LPARAM(LoadIcon(hInst, MAKEINTRESOURCE(IDI_CONDOR2NAV))));
@@ -93,33 +109,49 @@ condor2nav::gui::CCondor2NavGUI::CCondor2NavGUI(HINSTANCE hInst, HWND hDlg) :
   for(unsigned i=2; i<=20; i++)
     _aatTime.Add(Convert(i * 15));
 
-  // set default task
-  auto fplPath = condor::FPLPath(ConfigParser(), TFPLType::DEFAULT, _condorPath);
-
-  try {
-    AATCheck(CCondor{_condorPath, fplPath});
-    _fplPath.String(fplPath.string());
-    _fplDefault.Select();
-  }
-  catch(const Exception &) {
-    _fplDefault.Disable();
-    _fplOther.Select();
-    _fplSelect.Enable();
-  }
+  // look for Condor installation before any translation
+  _fplPath.String("Loading...");
+  _activeObject.Send([this]{
+    try {
+      _condorPathSource.set_value(condor::InstallPath());
+    }
+    catch(const std::exception &ex) {
+      Error() << ex.what() << std::endl;
+      _condorPathSource.set_exception(std::current_exception());
+    }
+  });
 
-  // check if last result is available
-  try {
-    fplPath = condor::FPLPath(ConfigParser(), TFPLType::RESULT, _condorPath);
-  }
-  catch(const Exception &) {
-    _fplLastRace.Disable();
+  // probe FPL files in the background
+  for(const auto fplType : {TFPLType::DEFAULT, TFPLType::RESULT}) {
+    _fplThreadPool.Send([this, fplType]{
+      auto probe = std::make_unique<TFPLProbe>();
+      probe->fplType = fplType;
+      probe->startup = true;
+      probe->valid = false;
+      try {
+        probe->path = condor::FPLPath(ConfigParser(), fplType, CondorPath());
+        if(fplType == TFPLType::DEFAULT) {
+          probe->summary = condor::FPLSummary(probe->path);
+          probe->valid = true;
+        }
+      }
+      catch(const std::exception &) {
+        probe->path.clear();
+      }
+      FPLProbePost(std::move(probe));
+    });
   }
 }
 
 
 condor2nav::gui::CCondor2NavGUI::~CCondor2NavGUI()
 {
-  _abort = true;
+  _cancel.Cancel();
+  _fplProbeCancel.Cancel();
+  if(_mapsSync.valid())
+    _mapsSync.wait();
+  if(_prefetchJob.valid())
+    _prefetchJob.wait();
 }
 
 
@@ -129,37 +161,170 @@ condor2nav::gui::CCondor2NavGUI::~CCondor2NavGUI()
  * Method Checks if condor-club AAT task file is provided. It looks for certain entries
  * that are added by http://condor-club.eu server to the file.
  *
- * @param condor Condor wrapper
+ * @param summary The summary of FPL file
  */
-void condor2nav::gui::CCondor2NavGUI::AATCheck(const CCondor &condor) const
+void condor2nav::gui::CCondor2NavGUI::AATCheck(const condor::TFPLSummary &summary) const
 {
-  try {
-    const CFileParserINI &taskParser = condor.TaskParser();
-    if(taskParser.Value("Task", "AAT") == "Distance")
-      Error() << "ERROR: AAT/D tasks are not supported!!!" << std::endl;
-    else if(taskParser.Value("Task", "AAT") == "Speed") {
-      _aatOn.Click();
-      try {
-        _aatTime.String(taskParser.Value("Task", "DesignatedTime"));
+  if(summary.aat == "Distance")
+    Error() << "ERROR: AAT/D tasks are not supported!!!" << std::endl;
+  else if(summary.aat == "Speed") {
+    _aatOn.Click();
+    if(!summary.designatedTime.empty())
+      _aatTime.String(summary.designatedTime);
+    else
+      Error() << "ERROR: Corrupted condor-club task file!!!" << std::endl;
+  }
+}
+
+
+/**
+ * @brief Probes FPL file.
+ *
+ * Method finds and reads the summary of the FPL file in the background. FPL path
+ * widget and AAT settings are updated when the summary is ready. Previous probe
+ * is cancelled so that its result does not overwrite the newer one. If tasks
+ * preparation is enabled the selected task is prepared for the translation.
+ *
+ * @param fplType Type of the FPL file.
+ * @param fplPath Full pathname of the FPL file (for TFPLType::USER only).
+ */
+void condor2nav::gui::CCondor2NavGUI::FPLProbe(TFPLType fplType, bfs::path fplPath /* = bfs::path{} */)
+{
+  _fplProbeCancel.Cancel();
+  _fplProbeCancel = CCancellationSource{};
+  _fplThreadPool.Send([this, fplType, fplPath](const CCancellationToken &cancel){
+    auto probe = std::make_unique<TFPLProbe>();
+    probe->fplType = fplType;
+    probe->startup = false;
+    probe->cancel = cancel;
+    probe->path = fplPath;
+    probe->valid = false;
+    try {
+      if(fplType != TFPLType::USER) {
+        // create Condor FPL file path
+        probe->path = condor::FPLPath(ConfigParser(), fplType, CondorPath());
+        cancel.ThrowIfCancelled();
+      }
+      probe->summary = condor::FPLSummary(probe->path);
+      probe->valid = true;
+      cancel.ThrowIfCancelled();
+      MapsPriority(probe->summary.landscape);
+      const auto path = probe->path;
+      FPLProbePost(std::move(probe));
+
+      if(_prefetch) {
+        try {
+          _prefetch->Prepare(CondorPath(), path);
+        }
+        catch(const std::exception &) {
+          // errors are reported by the translation
+        }
       }
-      catch(EOperationFailed &) {
-        Error() << "ERROR: Corrupted condor-club task file!!!" << std::endl;
+    }
+    catch(const EOperationCancelled &) {
+    }
+    catch(const std::exception &ex) {
+      Error() << ex.what() << std::endl;
+      if(probe)
+        FPLProbePost(std::move(probe));
+    }
+  }, _fplProbeCancel.Token());
+}
+
+
+/**
+ * @brief Posts FPL file probe result to the dialog.
+ *
+ * Method is called from the FPL probing threads.
+ *
+ * @param probe The result of the probe.
+ */
+void condor2nav::gui::CCondor2NavGUI::FPLProbePost(std::unique_ptr<TFPLProbe> probe) const
+{
+  if(PostMessage(_hDlg, WM_FPL_PROBE, 0, reinterpret_cast<LPARAM>(probe.get())))
+    probe.release();
+}
+
+
+/**
+ * @brief Shows FPL file probe result.
+ *
+ * Startup probe of the default task sets it unless the user selected other
+ * file in the meantime. Results of outdated probes are ignored.
+ *
+ * @param probe The result of the probe.
+ */
+void condor2nav::gui::CCondor2NavGUI::FPLProbed(std::unique_ptr<const TFPLProbe> probe)
+{
+  if(probe->startup && probe->fplType == TFPLType::RESULT) {
+    // last result is available
+    if(!probe->path.empty())
+      _fplLastRace.Enable();
+    return;
+  }
+
+  if(probe->startup) {
+    _fplLoading = false;
+    if(probe->valid) {
+      _fplDefault.Enable();
+      if(!_fplOther.Selected()) {
+        MapsPriority(probe->summary.landscape);
+        _fplPath.String(probe->path.string());
+        _fplDefault.Select();
+        AATCheck(probe->summary);
       }
     }
+    else if(!_fplOther.Selected()) {
+      _fplPath.String("");
+      _fplOther.Select();
+      _fplSelect.Enable();
+    }
   }
-  catch(EOperationFailed &) {
+  else if(!probe->cancel.Cancelled()) {
+    if(probe->fplType != TFPLType::USER && !probe->path.empty())
+      _fplPath.String(probe->path.string());
+    if(probe->valid)
+      AATCheck(probe->summary);
   }
+  TranslateUpdate();
 }
 
 
 /**
  * @brief Checks if translation is valid to execute.
  *
+ * Translation is not valid until the FPL widgets are loaded.
+ *
  * @return true if it succeeds, false if it fails. 
  */
 bool condor2nav::gui::CCondor2NavGUI::TranslateValid() const
 {
-  return !_running && (!_fplOther.Selected() || _fplPath.String() != "") && (!_aatOn.Selected() || _aatTime.Selection() != "" || _aatTime.ItemSelected());
+  return !_running && !_fplLoading && (!_fplOther.Selected() || _fplPath.String() != "") && (!_aatOn.Selected() || _aatTime.Selection() != "" || _aatTime.ItemSelected());
+}
+
+
+/**
+ * @brief Enables translation button if translation is valid to execute.
+ */
+void condor2nav::gui::CCondor2NavGUI::TranslateUpdate()
+{
+  if(TranslateValid())
+    _translate.Enable();
+  else
+    _translate.Disable();
+}
+
+
+/**
+ * @brief Handles the end of the translation.
+ *
+ * Method is called by the dialog thread when the translation posted
+ * its end.
+ */
+void condor2nav::gui::CCondor2NavGUI::TranslateFinished()
+{
+  _running = false;
+  TranslateUpdate();
 }
 
 
@@ -179,11 +344,7 @@ void condor2nav::gui::CCondor2NavGUI::Command(HWND hwnd, int controlID, int comm
   case IDC_FPL_DEFAULT_RADIO:
     if(command == BN_CLICKED) {
       _fplSelect.Disable();
-
-      // create Condor FPL file path
-      const auto fplPath = condor::FPLPath(ConfigParser(), CCondor2NavGUI::TFPLType::DEFAULT, _condorPath);
-      _fplPath.String(fplPath.string());
-
+      FPLProbe(TFPLType::DEFAULT);
       fplChanged = true;
     }
     break;
@@ -191,11 +352,7 @@ void condor2nav::gui::CCondor2NavGUI::Command(HWND hwnd, int controlID, int comm
   case IDC_FPL_LAST_RACE_RADIO:
     if(command == BN_CLICKED) {
       _fplSelect.Disable();
-
-      // create Condor FPL file path
-      const auto fplPath = condor::FPLPath(ConfigParser(), CCondor2NavGUI::TFPLType::RESULT, _condorPath);
-      _fplPath.String(fplPath.string());
-
+      FPLProbe(TFPLType::RESULT);
       fplChanged = true;
     }
     break;
@@ -233,6 +390,7 @@ void condor2nav::gui::CCondor2NavGUI::Command(HWND hwnd, int controlID, int comm
       // Display the Open dialog box. 
       if(GetOpenFileName(&ofn) == TRUE) {
         _fplPath.String(ofn.lpstrFile);
+        FPLProbe(TFPLType::USER, ofn.lpstrFile);
         fplChanged = true;
       }
 
@@ -265,54 +423,63 @@ void condor2nav::gui::CCondor2NavGUI::Command(HWND hwnd, int controlID, int comm
   case IDC_TRANSLATE_BUTTON:
     if(command == BN_CLICKED) {
       _log.Clear();
-      _activeObject.Send([this]{
-        try {
-          _running = true;
-          _translate.Disable();
+      _running = true;
+      _translate.Disable();
 
-          CTranslator translator{*this, ConfigParser(), CCondor{_condorPath, _fplPath.String()},
-                                 _aatOn.Selected() ? Convert<unsigned>(_aatTime.Selection()) : 0};
+      // widgets are read here as they may be used by the dialog thread only
+      const bfs::path fplPath{_fplPath.String()};
+      const auto aatTime = _aatOn.Selected() ? _aatTime.Selection() : std::string{};
+      _activeObject.Send([this, fplPath, aatTime]{
+        try {
+          // use the task prepared in the background if available
+          auto condor = _prefetch ? _prefetch->Prepared(fplPath) : nullptr;
+          if(condor)
+            Log() << "Using task data prepared in the background" << std::endl;
+          else
+            condor = std::make_shared<const CCondor>(CondorPath(), fplPath, NaviConPool());
+
+          CTranslator translator{*this, ConfigParser(), *condor, !aatTime.empty() ? Convert<unsigned>(aatTime) : 0};
           translator.Run();
-
-          _running = false;
-          if(TranslateValid())
-            _translate.Enable();
         }
         catch(const std::exception &ex) {
           Error() << ex.what() << std::endl;
         }
+        PostMessage(_hDlg, WM_TRANSLATE_FINISHED, 0, 0);
       });
     }
     break;
   }
 
-  if(fplChanged) {
-    AATCheck(CCondor{_condorPath, _fplPath.String()});
-  }
-  if(changed || fplChanged) {
-    if(TranslateValid())
-      _translate.Enable();
-    else
-      _translate.Disable();
-  }
+  if(changed || fplChanged)
+    TranslateUpdate();
 }
 
 
-void condor2nav::gui::CCondor2NavGUI::OnStart(std::function<bool()> abort)
+void condor2nav::gui::CCondor2NavGUI::OnStart(CCancellationToken cancel)
 {
-  _activeObject.Send([this, abort]{
+  // translations are not blocked by the maps synchronization
+  _mapsSync = std::async(std::launch::async, [this, cancel]{
     try {
-      _running = true;
-      _translate.Disable();
-      this->CCondor2Nav::OnStart(std::move(abort));
-      _running = false;
-      if(TranslateValid())
-        _translate.Enable();
+      this->CCondor2Nav::OnStart(cancel);
     }
     catch(const std::exception &ex) {
       Error() << ex.what() << std::endl;
     }
   });
+
+  // the default task and the last race are likely to be translated next
+  if(CTaskPrefetch::Enabled(*this)) {
+    _prefetch = std::make_unique<CTaskPrefetch>(*this);
+    _prefetchJob = std::async(std::launch::async, [this, cancel]
+    {
+      try {
+        _prefetch->Prepare(CondorPath(), cancel);
+      }
+      catch(const std::exception &) {
+        // Condor installation errors are already reported
+      }
+    });
+  }
 }
 
 
@@ -333,4 +500,49 @@ void condor2nav::gui::CCondor2NavGUI::Log(CLogger::TType type, std::unique_ptr<c
     break;
   }
   _log.Append(*str);
+
+  if(!_logFlushScheduled) {
+    SetTimer(_hDlg, LOG_FLUSH_TIMER, LOG_FLUSH_INTERVAL, nullptr);
+    _logFlushScheduled = true;
+  }
+}
+
+
+/**
+ * @brief Renders all buffered logs.
+ *
+ * Method is called periodically by the logs rendering timer.
+ */
+void condor2nav::gui::CCondor2NavGUI::LogFlush()
+{
+  KillTimer(_hDlg, LOG_FLUSH_TIMER);
+  _logFlushScheduled = false;
+  _log.Flush();
+}
+
+
+/**
+ * @brief Posts the download status to the dialog.
+ *
+ * Method is called from the download worker threads. Status reports are
+ * already batched by the downloader so each of them is posted.
+ *
+ * @param status Overall status of the current files download.
+ */
+void condor2nav::gui::CCondor2NavGUI::DownloadStatus(const CDownloader::TStatus &status) const
+{
+  auto dup = std::make_unique<CDownloader::TStatus>(status);
+  PostMessage(_hDlg, WM_DOWNLOAD_STATUS, 0, reinterpret_cast<LPARAM>(dup.release()));
+}
+
+
+/**
+ * @brief Shows the download status.
+ *
+ * @param status Overall status of the current files download.
+ */
+void condor2nav::gui::CCondor2NavGUI::DownloadStatus(std::unique_ptr<const CDownloader::TStatus> status)
+{
+  _downloadProgress.Position(status->completion);
+  _downloadStatus.String((status->done ? "Download finished: " : "Downloading: ") + status->Summary());
 }
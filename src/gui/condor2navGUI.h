@@ -29,19 +29,27 @@
 #define __CONDOR2NAV_GUI_H__
 
 #include "condor2nav.h"
+#include "condor.h"
 #include "widgets.h"
 #include "activeObject.h"
+#include "threadPool.h"
+#include "taskPrefetch.h"
+#include <future>
 
 namespace condor2nav {
 
-  class CCondor;
-
   /**
    * @brief Condor2Nav GUI interface namespace.
    */
   namespace gui {
 
     const unsigned WM_LOG = WM_USER + 1;
+    const unsigned WM_DOWNLOAD_STATUS = WM_USER + 2;
+    const unsigned WM_FPL_PROBE = WM_USER + 3;
+    const unsigned WM_TRANSLATE_FINISHED = WM_USER + 4;
+    const unsigned DOWNLOAD_PROGRESS_RANGE = 1000; ///< @brief Full download progress bar position (per mille)
+    const UINT_PTR LOG_FLUSH_TIMER = 1;          ///< @brief Timer used to render buffered logs
+    const unsigned LOG_FLUSH_INTERVAL = 100;     ///< @brief Buffered logs rendering period [ms]
 
     /**
      * @brief Main GUI project class.
@@ -62,14 +70,34 @@ namespace condor2nav {
         void Trace(const std::string &str) const override;
       public:
         CLogger(TType type, HWND hDlg);
+        ~CLogger();
+      };
+
+      /**
+       * @brief FPL file probe result.
+       *
+       * Probes run on the thread pool and post their results to the dialog
+       * so that the widgets are updated only by the dialog thread.
+       */
+      struct TFPLProbe {
+        TFPLType fplType;                        ///< @brief Type of the probed FPL file
+        bool startup;                            ///< @brief Probe started together with the dialog
+        CCancellationToken cancel;               ///< @brief Cancelled when the probe is outdated
+        bfs::path path;                          ///< @brief Full pathname of the FPL file (empty if not found)
+        bool valid;                              ///< @brief FPL file summary was read
+        condor::TFPLSummary summary;             ///< @brief FPL file summary
       };
 
     private:
       const HWND _hDlg;	                         ///< @brief The dialog handle
-      const bfs::path _condorPath;               ///< @brief Full pathname of the Condor directory
+      std::promise<bfs::path> _condorPathSource; ///< @brief Provides the Condor directory found in the background
+      std::shared_future<bfs::path> _condorPath; ///< @brief Full pathname of the Condor directory
 
       bool _running = false;
-      bool _abort = false;
+      bool _logFlushScheduled = false;           ///< @brief Buffered logs rendering timer is active
+      bool _fplLoading = true;                   ///< @brief The startup probe of the default FPL file did not finish yet
+      CCancellationSource _cancel;               ///< @brief Cancels background operations on exit
+      CCancellationSource _fplProbeCancel;       ///< @brief Cancels outdated FPL file probes
 
       CLogger _normal;                           ///< @brief Normal logging level logger
       CLogger _high;                             ///< @brief Important logging level logger
@@ -90,27 +118,42 @@ namespace condor2nav {
       CWidgetButton _translate;                  ///< @brief The Condor2Nav start translation button
 
       CWidgetRichEdit _log;                      ///< @brief The Condor2Nav logging window
+      CWidgetProgressBar _downloadProgress;      ///< @brief The files download progress bar
+      CWidgetEdit _downloadStatus;               ///< @brief The files download status label
 
+      std::unique_ptr<CTaskPrefetch> _prefetch;  ///< @brief Tasks prepared for translation (nullptr if disabled)
       CActiveObject _activeObject;               ///< @brief Active object
-
-      void AATCheck(const CCondor &condor) const;
+      CThreadPool _fplThreadPool{2};             ///< @brief Thread pool used for FPL files probing
+      std::future<void> _mapsSync;               ///< @brief LK8000 maps synchronization running in the background
+      std::future<void> _prefetchJob;            ///< @brief Likely tasks preparation running in the background
+
+      bfs::path CondorPath() const { return _condorPath.get(); }
+      void AATCheck(const condor::TFPLSummary &summary) const;
+      void FPLProbe(TFPLType fplType, bfs::path fplPath = bfs::path{});
+      void FPLProbePost(std::unique_ptr<TFPLProbe> probe) const;
       bool TranslateValid() const;
+      void TranslateUpdate();
 
     public:
       CCondor2NavGUI(HINSTANCE hInst, HWND hDlg);
       ~CCondor2NavGUI();
 
-      void OnStart(std::function<bool()> abort) override;
+      void OnStart(CCancellationToken cancel) override;
       const CLogger &Log() const override     { return _normal; }
       const CLogger &LogHigh() const override { return _high; }
       const CLogger &Warning() const override { return _warning; }
       const CLogger &Error() const override   { return _error; }
+      void DownloadStatus(const CDownloader::TStatus &status) const override;
 
       void Command(HWND hwnd, int controlID, int command);
 
       void Log(CLogger::TType type, std::unique_ptr<const std::string> str);
+      void LogFlush();
+      void DownloadStatus(std::unique_ptr<const CDownloader::TStatus> status);
+      void FPLProbed(std::unique_ptr<const TFPLProbe> probe);
+      void TranslateFinished();
 
-      bool Abort() const { return _abort; }
+      CCancellationToken CancellationToken() const { return _cancel.Token(); }
     };
 
   } // namespace gui
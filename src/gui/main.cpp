@@ -89,7 +89,7 @@ INT_PTR CALLBACK condor2nav::gui::MainDialogProc(HWND hDlg, UINT message, WPARAM
   switch(message) {
   case WM_INITDIALOG:
     app = std::make_unique<CCondor2NavGUI>(hInst, hDlg);
-    app->OnStart([=]{ return app->Abort(); });
+    app->OnStart(app->CancellationToken());
     return TRUE;
 
   case WM_COMMAND:
@@ -115,6 +115,25 @@ INT_PTR CALLBACK condor2nav::gui::MainDialogProc(HWND hDlg, UINT message, WPARAM
     app->Log(static_cast<CCondor2NavGUI::CLogger::TType>(wParam), std::unique_ptr<const std::string>(reinterpret_cast<const std::string*>(lParam)));
     return TRUE;
 
+  case WM_DOWNLOAD_STATUS:
+    app->DownloadStatus(std::unique_ptr<const CDownloader::TStatus>(reinterpret_cast<const CDownloader::TStatus*>(lParam)));
+    return TRUE;
+
+  case WM_FPL_PROBE:
+    app->FPLProbed(std::unique_ptr<const CCondor2NavGUI::TFPLProbe>(reinterpret_cast<const CCondor2NavGUI::TFPLProbe*>(lParam)));
+    return TRUE;
+
+  case WM_TRANSLATE_FINISHED:
+    app->TranslateFinished();
+    return TRUE;
+
+  case WM_TIMER:
+    if(wParam == condor2nav::gui::LOG_FLUSH_TIMER) {
+      app->LogFlush();
+      return TRUE;
+    }
+    break;
+
   case WM_CLOSE:
     app.reset();
     DestroyWindow(hDlg);
@@ -143,8 +162,10 @@ INT_PTR CALLBACK condor2nav::gui::MainDialogProc(HWND hDlg, UINT message, WPARAM
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInst, char *cmdParam, int cmdShow)
 {
   try {
-    // init RichEdit controls
+    // init RichEdit and progress bar controls
     condor2nav::CLibraryRes _richEditLib{::LoadLibrary("RichEd20.dll")};
+    INITCOMMONCONTROLSEX commonControls{sizeof(INITCOMMONCONTROLSEX), ICC_PROGRESS_CLASS};
+    InitCommonControlsEx(&commonControls);
 
     // create MainDialog window
     HWND hDialog = CreateDialog(hInstance, MAKEINTRESOURCE(IDD_MAIN_DIALOG), nullptr, (DLGPROC)condor2nav::gui::MainDialogProc);
@@ -24,6 +24,8 @@
 #define IDC_RICHEDIT22                  1014
 #define IDC_LOG_RICHEDIT2               1014
 #define IDC_AAT_STATIC                  1015
+#define IDC_DOWNLOAD_PROGRESS           1016
+#define IDC_DOWNLOAD_STATIC             1017
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -33,7 +35,7 @@
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        131
 #define _APS_NEXT_COMMAND_VALUE         32773
-#define _APS_NEXT_CONTROL_VALUE         1016
+#define _APS_NEXT_CONTROL_VALUE         1018
 #define _APS_NEXT_SYMED_VALUE           110
 #endif
 #endif
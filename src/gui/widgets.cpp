@@ -30,6 +30,7 @@
 #include <richedit.h>
 #include <memory>
 #include <array>
+#include <algorithm>
 
 
 /**
@@ -240,13 +241,129 @@ void condor2nav::gui::CWidgetComboBox::String(const std::string &str) const
 *
 * @param hwndParent Handle of the control's parent. 
 * @param id         Windows control identifier. 
+* @param range      The position of a full progress bar. 
 * @param disabled   Specifies if a widget should be initially disabled. 
 */
-condor2nav::gui::CWidgetRichEdit::CWidgetRichEdit(HWND hwndParent, int id, bool disabled /*= false*/) :
-  CWidget{hwndParent, id, disabled},
-  _effectMask{EFFECT_NONE}, _color{TColor::AUTO}
+condor2nav::gui::CWidgetProgressBar::CWidgetProgressBar(HWND hwndParent, int id, unsigned range, bool disabled /*= false*/) :
+  CWidget{hwndParent, id, disabled}
 {
+  SendMessage(Hwnd(), PBM_SETRANGE32, 0, (LPARAM)range);
+}
 
+
+/**
+ * @brief Sets the progress bar position. 
+ *
+ * @param pos The new position. 
+ */
+void condor2nav::gui::CWidgetProgressBar::Position(unsigned pos) const
+{
+  SendMessage(Hwnd(), PBM_SETPOS, (WPARAM)pos, 0);
+}
+
+
+
+namespace {
+
+  /**
+   * @brief RTF stream being provided to a rich edit control.
+   */
+  struct TRTFStream {
+    const std::string &rtf;   ///< @brief RTF text
+    size_t pos;               ///< @brief Number of characters already provided
+  };
+
+
+  /**
+   * @brief EM_STREAMIN callback.
+   *
+   * @param cookie   RTF stream.
+   * @param buffer   Buffer to fill.
+   * @param size     Buffer size.
+   * @param [out] read Number of bytes provided.
+   *
+   * @return 0 on success.
+   */
+  DWORD CALLBACK RTFStreamIn(DWORD_PTR cookie, LPBYTE buffer, LONG size, LONG *read)
+  {
+    auto &stream = *reinterpret_cast<TRTFStream *>(cookie);
+    const auto count = std::min<size_t>(size, stream.rtf.size() - stream.pos);
+    memcpy(buffer, stream.rtf.data() + stream.pos, count);
+    stream.pos += count;
+    *read = static_cast<LONG>(count);
+    return 0;
+  }
+
+
+  /**
+   * @brief Returns RTF color table index for provided color.
+   *
+   * @param color Text color.
+   *
+   * @return Color table index.
+   */
+  unsigned RTFColorIndex(condor2nav::gui::CWidgetRichEdit::TColor color)
+  {
+    // index 0 is the auto color; the rest follows TColor order
+    return static_cast<unsigned>(color);
+  }
+
+
+  /**
+   * @brief Appends text escaped for RTF.
+   *
+   * @param text      Text to escape.
+   * @param [out] rtf RTF text.
+   */
+  void RTFEscape(const std::string &text, std::string &rtf)
+  {
+    static const char hex[] = "0123456789abcdef";
+    for(auto c : text) {
+      const auto uc = static_cast<unsigned char>(c);
+      switch(c) {
+      case '\\':
+      case '{':
+      case '}':
+        rtf += '\\';
+        rtf += c;
+        break;
+      case '\r':
+        break;
+      case '\n':
+        rtf += "\\par\n";
+        break;
+      case '\t':
+        rtf += "\\tab ";
+        break;
+      default:
+        if(uc < 0x80)
+          rtf += c;
+        else {
+          rtf += "\\'";
+          rtf += hex[uc >> 4];
+          rtf += hex[uc & 0x0F];
+        }
+      }
+    }
+  }
+
+}
+
+
+/**
+* @brief Class constructor. 
+*
+* @param hwndParent Handle of the control's parent. 
+* @param id         Windows control identifier. 
+* @param disabled   Specifies if a widget should be initially disabled. 
+* @param maxLength  Max number of characters kept in the widget. The oldest lines are removed when exceeded.
+*/
+condor2nav::gui::CWidgetRichEdit::CWidgetRichEdit(HWND hwndParent, int id, bool disabled /*= false*/, unsigned maxLength /*= DEFAULT_MAX_LENGTH*/) :
+  CWidget{hwndParent, id, disabled},
+  _maxLength{maxLength}, _effectMask{EFFECT_NONE}, _color{TColor::AUTO}
+{
+  // leave room for one flush over the limit before trimming
+  SendMessage(Hwnd(), EM_EXLIMITTEXT, 0, 2 * _maxLength);
 }
 
 
@@ -255,6 +372,7 @@ condor2nav::gui::CWidgetRichEdit::CWidgetRichEdit(HWND hwndParent, int id, bool
  */
 void condor2nav::gui::CWidgetRichEdit::Clear()
 {
+  _runs.clear();
   SendMessage(Hwnd(), WM_SETTEXT, 0, (LPARAM)"");
   Format(EFFECT_NONE, TColor::AUTO);
 }
@@ -263,47 +381,13 @@ void condor2nav::gui::CWidgetRichEdit::Clear()
 /**
  * @brief Sets text format. 
  *
+ * Format is applied to the text provided with following Append() calls.
+ *
  * @param effectMask Text effect mask. 
  * @param color      Text color. 
- *
- * @exception EOperationFailed Thrown when operation failed to execute. 
  */
 void condor2nav::gui::CWidgetRichEdit::Format(unsigned effectMask, TColor color)
 {
-  if(effectMask == _effectMask && color == _color)
-    return;
-
-  CHARFORMAT2 format;
-  ZeroMemory(&format, sizeof(format));
-  format.cbSize = sizeof(CHARFORMAT2);
-  format.dwMask = CFM_BOLD | CFM_ITALIC | CFM_COLOR;
-  
-  if(effectMask & EFFECT_BOLD)
-    format.dwEffects |= CFE_BOLD;
-  if(effectMask & EFFECT_ITALIC)
-    format.dwEffects |= CFE_ITALIC;
-  switch(color) {
-  case TColor::AUTO:
-    format.dwEffects |= CFE_AUTOCOLOR;
-    break;
-  case TColor::RED:
-    format.crTextColor = RGB(0xFF, 0, 0);
-    break;
-  case TColor::GREEN:
-    format.crTextColor = RGB(0, 0xFF, 0);
-    break;
-  case TColor::BLUE:
-    format.crTextColor = RGB(0, 0, 0xFF);
-    break;
-  case TColor::ORANGE:
-    format.crTextColor = RGB(0xFF, 0x99, 0x00);
-    break;
-  case TColor::BLACK:
-    format.crTextColor = RGB(0, 0, 0);
-    break;
-  }
-
-  SendMessage(Hwnd(), EM_SETCHARFORMAT, SCF_SELECTION, (LPARAM)&format);
   _effectMask = effectMask;
   _color = color;
 }
@@ -312,14 +396,86 @@ void condor2nav::gui::CWidgetRichEdit::Format(unsigned effectMask, TColor color)
 /**
  * @brief Appends provided text.
  *
+ * Text is buffered and rendered with the next Flush() call.
+ *
  * @param text The text to append
  */
 void condor2nav::gui::CWidgetRichEdit::Append(const std::string &text)
 {
+  if(text.empty())
+    return;
+  if(!_runs.empty() && _runs.back().effectMask == _effectMask && _runs.back().color == _color)
+    _runs.back().text += text;
+  else
+    _runs.push_back(TRun{_effectMask, _color, text});
+}
+
+
+/**
+ * @brief Removes the oldest lines if the text is longer than allowed.
+ */
+void condor2nav::gui::CWidgetRichEdit::Trim() const
+{
+  GETTEXTLENGTHEX textLength{GTL_NUMCHARS, CP_ACP};
+  const auto length = static_cast<unsigned>(SendMessage(Hwnd(), EM_GETTEXTLENGTHEX, (WPARAM)&textLength, 0));
+  if(length <= _maxLength)
+    return;
+
+  // remove whole lines up to the one containing the first character to keep
+  const auto line = SendMessage(Hwnd(), EM_EXLINEFROMCHAR, 0, length - _maxLength);
+  auto end = SendMessage(Hwnd(), EM_LINEINDEX, line + 1, 0);
+  if(end < 0)
+    end = length - _maxLength;
+  CHARRANGE cr;
+  cr.cpMin = 0;
+  cr.cpMax = static_cast<LONG>(end);
+  SendMessage(Hwnd(), EM_EXSETSEL, 0, (LPARAM)&cr);
+  SendMessage(Hwnd(), EM_REPLACESEL, 0, (LPARAM)"");
+}
+
+
+/**
+ * @brief Renders all buffered text.
+ *
+ * All the buffered text runs are inserted with one RTF stream and with
+ * the widget redraw suspended. Scrollback is trimmed afterwards.
+ */
+void condor2nav::gui::CWidgetRichEdit::Flush()
+{
+  if(_runs.empty())
+    return;
+
+  std::string rtf = "{\\rtf1\\ansi{\\colortbl;\\red255\\green0\\blue0;\\red0\\green255\\blue0;\\red0\\green0\\blue255;\\red255\\green153\\blue0;\\red0\\green0\\blue0;}\n";
+  for(auto &run : _runs) {
+    rtf += "{\\cf" + Convert(RTFColorIndex(run.color));
+    if(run.effectMask & EFFECT_BOLD)
+      rtf += "\\b";
+    if(run.effectMask & EFFECT_ITALIC)
+      rtf += "\\i";
+    rtf += ' ';
+    RTFEscape(run.text, rtf);
+    rtf += '}';
+  }
+  rtf += '}';
+  _runs.clear();
+
+  SendMessage(Hwnd(), WM_SETREDRAW, FALSE, 0);
+
   CHARRANGE cr;
   cr.cpMin = -1;
   cr.cpMax = -1;
   SendMessage(Hwnd(), EM_EXSETSEL, 0, (LPARAM)&cr);
-  SendMessage(Hwnd(), EM_REPLACESEL, 0, (LPARAM)text.c_str());
+
+  TRTFStream stream{rtf, 0};
+  EDITSTREAM editStream;
+  editStream.dwCookie = reinterpret_cast<DWORD_PTR>(&stream);
+  editStream.dwError = 0;
+  editStream.pfnCallback = RTFStreamIn;
+  SendMessage(Hwnd(), EM_STREAMIN, SF_RTF | SFF_SELECTION, (LPARAM)&editStream);
+
+  Trim();
+
+  SendMessage(Hwnd(), WM_SETREDRAW, TRUE, 0);
+  InvalidateRect(Hwnd(), nullptr, TRUE);
   SendMessage(Hwnd(), WM_VSCROLL, SB_BOTTOM, 0);
 }
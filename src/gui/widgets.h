@@ -29,6 +29,8 @@
 #define __WIDGETS_H__
 
 #include "nonCopyable.h"
+#include <string>
+#include <vector>
 
 namespace condor2nav {
 
@@ -102,6 +104,16 @@ namespace condor2nav {
     };
 
 
+    /**
+     * @brief Progress bar widget.
+     */
+    class CWidgetProgressBar : public CWidget {
+    public:
+      CWidgetProgressBar(HWND hwndParent, int id, unsigned range, bool disabled = false);
+      void Position(unsigned pos) const;
+    };
+
+
     /**
      * @brief Rich edit widget. 
      */
@@ -128,15 +140,32 @@ namespace condor2nav {
         EFFECT_ITALIC = 0x02,
       };
 
+      static const unsigned DEFAULT_MAX_LENGTH = 256 * 1024;   ///< @brief Default scrollback size [chars]
+
     private:
+      /**
+       * @brief Text run waiting to be rendered.
+       */
+      struct TRun {
+        unsigned effectMask;      ///< @brief Text effect mask
+        TColor color;             ///< @brief Text color
+        std::string text;         ///< @brief Text to render
+      };
+
+      const unsigned _maxLength;  ///< @brief Max number of characters kept in the widget
       unsigned _effectMask;	    ///< @brief Current text effect mask
       TColor _color;	        ///< @brief Current text color
+      std::vector<TRun> _runs;    ///< @brief Text runs waiting for Flush()
+
+      void Trim() const;
 
     public:
-      CWidgetRichEdit(HWND hwndParent, int id, bool disabled = false);
+      CWidgetRichEdit(HWND hwndParent, int id, bool disabled = false, unsigned maxLength = DEFAULT_MAX_LENGTH);
       void Clear();
       void Format(unsigned effectMask, TColor color);
       void Append(const std::string &text);
+      bool Pending() const { return !_runs.empty(); }
+      void Flush();
     };
 
   } // namespace gui
@@ -0,0 +1,122 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file gzipDecoder.cpp
+ *
+ * @brief Implements the condor2nav::CGzipDecoder class. 
+ */
+
+#include "gzipDecoder.h"
+#include "tools.h"
+#include <boost/iostreams/filter/gzip.hpp>
+
+
+/**
+ * @brief Decompression state.
+ */
+struct condor2nav::CGzipDecoder::TImpl {
+  /**
+   * @brief Sink providing decompressed data to the handler.
+   */
+  struct TSink {
+    using char_type = char;
+    using category = boost::iostreams::sink_tag;
+
+    TImpl *impl;
+    std::streamsize write(const char *data, std::streamsize size)
+    {
+      impl->handler(data, static_cast<std::size_t>(size));
+      *impl->size += static_cast<std::uint64_t>(size);
+      return size;
+    }
+  };
+
+  CDataHandler handler;                                  ///< @brief Decompressed data handler
+  std::uint64_t *size;                                   ///< @brief The number of decompressed bytes
+  boost::iostreams::gzip_decompressor filter;            ///< @brief gzip filter
+  TSink sink;                                            ///< @brief Decompressed data sink
+};
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param handler Function called with decompressed data.
+ */
+condor2nav::CGzipDecoder::CGzipDecoder(CDataHandler handler) :
+  _impl{std::make_unique<TImpl>()}, _size{0}
+{
+  _impl->handler = std::move(handler);
+  _impl->size = &_size;
+  _impl->sink.impl = _impl.get();
+}
+
+
+/**
+ * @brief Class destructor.
+ */
+condor2nav::CGzipDecoder::~CGzipDecoder()
+{
+}
+
+
+/**
+ * @brief Decompresses next portion of data.
+ *
+ * @param data Compressed data.
+ * @param size The size of compressed data.
+ *
+ * @exception std Thrown when data are not valid gzip data or the handler failed.
+ */
+void condor2nav::CGzipDecoder::Write(const char *data, std::size_t size)
+{
+  try {
+    while(size) {
+      const auto num = _impl->filter.write(_impl->sink, data, static_cast<std::streamsize>(size));
+      if(num <= 0)
+        throw EOperationFailed{"ERROR: Unable to decompress data!!!"};
+      data += num;
+      size -= static_cast<std::size_t>(num);
+    }
+  }
+  catch(const boost::iostreams::gzip_error &ex) {
+    throw EOperationFailed{"ERROR: Invalid compressed data (" + std::string{ex.what()} + ")!!!"};
+  }
+}
+
+
+/**
+ * @brief Finishes decompression.
+ *
+ * Method provides the rest of decompressed data to the handler.
+ *
+ * @exception std Thrown when data are not valid gzip data or the handler failed.
+ */
+void condor2nav::CGzipDecoder::Finish()
+{
+  try {
+    _impl->filter.close(_impl->sink, std::ios_base::out);
+  }
+  catch(const boost::iostreams::gzip_error &ex) {
+    throw EOperationFailed{"ERROR: Invalid compressed data (" + std::string{ex.what()} + ")!!!"};
+  }
+}
@@ -0,0 +1,71 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file gzipDecoder.h
+ *
+ * @brief Declares the condor2nav::CGzipDecoder class. 
+ */
+
+#ifndef __GZIPDECODER_H__
+#define __GZIPDECODER_H__
+
+#include "nonCopyable.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace condor2nav {
+
+  /**
+   * @brief Streaming gzip decoder.
+   *
+   * condor2nav::CGzipDecoder decompresses gzip data provided in portions
+   * of any size. Decompressed data are provided to the handler as soon as
+   * they are available so the whole file never has to be kept in memory.
+   */
+  class CGzipDecoder : CNonCopyable {
+  public:
+    /**
+     * @brief Function called with next portion of decompressed data.
+     *
+     * @param data Decompressed data.
+     * @param size The size of decompressed data.
+     */
+    using CDataHandler = std::function<void(const char *data, std::size_t size)>;
+
+  private:
+    struct TImpl;
+
+    std::unique_ptr<TImpl> _impl;                        ///< @brief Decompression state
+    std::uint64_t _size;                                 ///< @brief The number of decompressed bytes
+
+  public:
+    explicit CGzipDecoder(CDataHandler handler);
+    ~CGzipDecoder();
+    void Write(const char *data, std::size_t size);
+    void Finish();
+    std::uint64_t Size() const { return _size; }
+  };
+
+}
+
+#endif /* __GZIPDECODER_H__ */
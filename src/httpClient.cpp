@@ -0,0 +1,389 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file httpClient.cpp
+ *
+ * @brief Implements the HTTP client class (condor2nav::CHttpClient). 
+ */
+
+#include "httpClient.h"
+#include "gzipDecoder.h"
+#include "traceLog.h"
+#include "memoryAccount.h"
+#include <boost/asio/ip/tcp.hpp>
+#include "tools.h"        // has to be included after boost/asio
+#include <boost/filesystem/path.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+
+
+namespace {
+
+  std::mutex instanceMutex;      // guards the singleton creation
+
+  /**
+   * @brief Response header data needed to read the content.
+   */
+  struct THeaders {
+    bool chunked = false;                             ///< @brief Content is provided with chunked transfer encoding. 
+    bool close = false;                               ///< @brief Server closes the connection after the response. 
+    bool lengthKnown = false;                         ///< @brief Content length was provided. 
+    bool gzip = false;                                ///< @brief Content is compressed with gzip. 
+    std::uint64_t length = 0;                         ///< @brief Content length. 
+    std::uint64_t rangeStart = 0;                     ///< @brief The position of provided content range. 
+    std::uint64_t rangeTotal = 0;                     ///< @brief The size of the whole file provided with content range (0 if not known). 
+    std::string etag;                                 ///< @brief Entity tag of the content. 
+    std::string lastModified;                         ///< @brief Modification date of the content. 
+  };
+
+  std::string Lower(boost::string_ref str)
+  {
+    std::string result{str.to_string()};
+    std::transform(result.begin(), result.end(), result.begin(), [](char c){ return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return result;
+  }
+
+  bool GetLine(std::istream &stream, std::string &line)
+  {
+    if(!std::getline(stream, line))
+      return false;
+    if(!line.empty() && line.back() == '\r')
+      line.pop_back();
+    return true;
+  }
+
+}
+
+
+/**
+ * @brief Persistent server connection.
+ */
+struct condor2nav::CHttpClient::TConnection {
+  boost::asio::ip::tcp::iostream stream;             ///< @brief Connection stream.
+};
+
+
+/**
+ * @brief Returns singleton instance.
+ *
+ * Method returns singleton instance.
+ *
+ * @return Singleton instance.
+ */
+condor2nav::CHttpClient &condor2nav::CHttpClient::Instance()
+{
+  // function local statics initialization is not thread-safe in VS2013
+  std::lock_guard<std::mutex> lock{instanceMutex};
+  static CHttpClient instance;
+  return instance;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CHttpClient class constructor.
+ */
+condor2nav::CHttpClient::CHttpClient()
+{
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * condor2nav::CHttpClient class destructor.
+ */
+condor2nav::CHttpClient::~CHttpClient()
+{
+}
+
+
+/**
+ * @brief Provides a connection to the server.
+ *
+ * Method provides idle connection to the server if available or
+ * establishes a new one. Server name may be followed by ':' and the port
+ * number (default HTTP port is used otherwise).
+ *
+ * @param server Server to connect to.
+ * @param reused Set to @p true if idle connection was provided.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Connection to the server.
+ */
+auto condor2nav::CHttpClient::Acquire(const std::string &server, bool &reused) -> CConnectionPtr
+{
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto &idle = _idle[server];
+    if(!idle.empty()) {
+      auto connection = std::move(idle.back());
+      idle.pop_back();
+      reused = true;
+      return connection;
+    }
+  }
+
+  reused = false;
+  auto connection = std::make_unique<TConnection>();
+  const auto colon = server.find(':');
+  if(colon == std::string::npos)
+    connection->stream.connect(server, "http");
+  else
+    connection->stream.connect(server.substr(0, colon), server.substr(colon + 1));
+  if(!connection->stream)
+    throw EOperationFailed{"ERROR: Unable to connect to: '" + server + "', error: " + connection->stream.error().message()};
+  return connection;
+}
+
+
+/**
+ * @brief Stores a connection for reuse.
+ *
+ * @param server     Server the connection is established to.
+ * @param connection Idle connection.
+ */
+void condor2nav::CHttpClient::Release(const std::string &server, CConnectionPtr connection)
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto &idle = _idle[server];
+  if(idle.size() < MAX_IDLE_CONNECTIONS)
+    idle.emplace_back(std::move(connection));
+}
+
+
+/**
+ * @brief Returns the validator of a range request.
+ *
+ * Weak entity tags cannot be used to validate a range so the modification
+ * date is used instead.
+ *
+ * @return 'If-Range' header value or an empty string if no validator can be used.
+ */
+std::string condor2nav::CHttpClient::TValidators::Range() const
+{
+  if(!etag.empty() && etag.compare(0, 2, "W/") != 0)
+    return etag;
+  return lastModified;
+}
+
+
+/**
+ * @brief Downloads a file.
+ *
+ * Method downloads a file from the server. When @p offset is not 0 only
+ * the part of the file starting from the offset is requested. The server
+ * may ignore such request and provide the whole file. Received content
+ * is provided to the handler in portions together with their position
+ * in the file.
+ *
+ * Whole files are requested with gzip content encoding allowed. Compressed
+ * content is decompressed on the fly so the handler always gets file data.
+ *
+ * When @p validators are provided and not empty the request is conditional.
+ * For a whole file the server responds with HTTP_NOT_MODIFIED and no content
+ * if the file did not change since the validators were obtained. For a range
+ * request the validators are sent with 'If-Range' header and the server
+ * provides the whole file if it changed. Validators are updated with the ones
+ * provided with a new content before the content is read.
+ *
+ * @param server     Server to download the file from.
+ * @param url        Path of the file on the server.
+ * @param timeout    Timeout of the request in seconds.
+ * @param offset     The position of the file to download the data from.
+ * @param handler    Function called with received content.
+ * @param validators Cache validators of the file already downloaded.
+ * @param total      Set to the size of the whole file before the content is read
+ *                   (0 if not known, e.g. for compressed or chunked content).
+ *                   For HTTP_RANGE_NOT_SATISFIABLE it is the size reported by the server.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return HTTP status code (HTTP_OK, HTTP_PARTIAL_CONTENT, HTTP_NOT_MODIFIED or HTTP_RANGE_NOT_SATISFIABLE).
+ */
+unsigned condor2nav::CHttpClient::Get(const std::string &server, const bfs::path &url, unsigned timeout, std::uint64_t offset, const CDataHandler &handler,
+                                      TValidators *validators /* = nullptr */, std::uint64_t *total /* = nullptr */)
+{
+  const auto address = server + url.generic_string();
+  CTraceScope trace{"http", "Get", address};
+  for(unsigned attempt=0; ; attempt++) {
+    bool reused;
+    auto connection = Acquire(server, reused);
+    auto &http = connection->stream;
+    http.expires_from_now(boost::posix_time::seconds(timeout));
+
+    // send the request
+    http << "GET " << url.generic_string() << " HTTP/1.1\r\n";
+    http << "Host: " << server << "\r\n";
+    http << "Accept: */*\r\n";
+    if(offset) {
+      http << "Range: bytes=" << offset << "-\r\n";
+      // the range is provided only if the file did not change since its first part was downloaded
+      if(validators && !validators->Range().empty())
+        http << "If-Range: " << validators->Range() << "\r\n";
+    }
+    else {
+      // ranges of compressed content do not match file positions
+      http << "Accept-Encoding: gzip\r\n";
+      if(validators && !validators->etag.empty())
+        http << "If-None-Match: " << validators->etag << "\r\n";
+      if(validators && !validators->lastModified.empty())
+        http << "If-Modified-Since: " << validators->lastModified << "\r\n";
+    }
+    http << "Connection: keep-alive\r\n\r\n";
+    http.flush();
+
+    // check that response is OK
+    std::string httpVersion;
+    http >> httpVersion;
+    if(!http && reused && attempt == 0)
+      // idle connection was closed by the server in the meantime
+      continue;
+    unsigned status;
+    http >> status;
+    std::string statusMessage;
+    GetLine(http, statusMessage);
+    if(!http || httpVersion.substr(0, 5) != "HTTP/")
+      throw EOperationFailed{"ERROR: Invalid response from: '" + address + "'"};
+    if(status != HTTP_OK && status != HTTP_PARTIAL_CONTENT && status != HTTP_RANGE_NOT_SATISFIABLE &&
+       !(status == HTTP_NOT_MODIFIED && validators))
+      throw EOperationFailed{"ERROR: '" + address + "' returned a response with status code: " + Convert(status)};
+
+    // process the response headers, which are terminated by a blank line
+    THeaders headers;
+    headers.close = httpVersion == "HTTP/1.0";
+    std::string line;
+    while(GetLine(http, line) && !line.empty()) {
+      const auto colon = line.find(':');
+      if(colon == std::string::npos)
+        continue;
+      const auto name = Lower(Trim(boost::string_ref{line}.substr(0, colon)));
+      const auto value = Trim(boost::string_ref{line}.substr(colon + 1));
+      if(name == "content-length") {
+        headers.lengthKnown = true;
+        headers.length = std::strtoull(value.to_string().c_str(), nullptr, 10);
+      }
+      else if(name == "content-encoding")
+        headers.gzip = Lower(value) == "gzip";
+      else if(name == "transfer-encoding")
+        headers.chunked = Lower(value).find("chunked") != std::string::npos;
+      else if(name == "connection")
+        headers.close = Lower(value) == "close";
+      else if(name == "content-range" && value.starts_with("bytes ")) {
+        // 'bytes <start>-<end>/<total>' or 'bytes */<total>'
+        headers.rangeStart = std::strtoull(value.substr(6).to_string().c_str(), nullptr, 10);
+        const auto slash = value.find('/');
+        if(slash != boost::string_ref::npos)
+          headers.rangeTotal = std::strtoull(value.substr(slash + 1).to_string().c_str(), nullptr, 10);
+      }
+      else if(name == "etag")
+        headers.etag = value.to_string();
+      else if(name == "last-modified")
+        headers.lastModified = value.to_string();
+    }
+    if(!http)
+      throw EOperationFailed{"ERROR: Invalid response from: '" + address + "'"};
+    if(status == HTTP_PARTIAL_CONTENT && headers.rangeStart != offset)
+      throw EOperationFailed{"ERROR: '" + address + "' returned invalid content range!!!"};
+    if(headers.gzip && status == HTTP_PARTIAL_CONTENT)
+      throw EOperationFailed{"ERROR: '" + address + "' returned compressed content range!!!"};
+    if(validators && status != HTTP_NOT_MODIFIED && status != HTTP_RANGE_NOT_SATISFIABLE) {
+      validators->etag = headers.etag;
+      validators->lastModified = headers.lastModified;
+    }
+
+    // compressed content is decompressed as it arrives
+    std::unique_ptr<CGzipDecoder> decoder;
+    if(headers.gzip && status == HTTP_OK)
+      decoder = std::make_unique<CGzipDecoder>([&](const char *data, std::size_t size){ handler(decoder->Size(), data, size); });
+
+    // read the content
+    std::vector<char, CCountingAllocator<char, TMemorySubsystem::NETWORK>> buffer(CHUNK_SIZE);
+    auto pos = status == HTTP_PARTIAL_CONTENT ? offset : 0;
+    if(total) {
+      if(status == HTTP_RANGE_NOT_SATISFIABLE)
+        *total = headers.rangeTotal;
+      else
+        *total = !decoder && headers.lengthKnown && (status == HTTP_OK || status == HTTP_PARTIAL_CONTENT) ? pos + headers.length : 0;
+    }
+    auto read = [&](std::uint64_t size) -> bool
+    {
+      while(size) {
+        http.read(buffer.data(), static_cast<std::streamsize>(std::min<std::uint64_t>(size, buffer.size())));
+        const auto num = static_cast<std::size_t>(http.gcount());
+        if(num == 0)
+          return false;
+        if(decoder)
+          decoder->Write(buffer.data(), num);
+        else if(status != HTTP_RANGE_NOT_SATISFIABLE)
+          handler(pos, buffer.data(), num);
+        trace.Bytes(num);
+        pos += num;
+        size -= num;
+      }
+      return true;
+    };
+
+    bool complete;
+    if(status == HTTP_NOT_MODIFIED)
+      // response never has a content
+      complete = true;
+    else if(headers.chunked) {
+      complete = false;
+      while(GetLine(http, line)) {
+        const auto size = std::strtoull(line.c_str(), nullptr, 16);
+        if(size == 0) {
+          // skip trailers
+          while(GetLine(http, line) && !line.empty())
+            ;
+          complete = static_cast<bool>(http);
+          break;
+        }
+        if(!read(size) || !GetLine(http, line))
+          break;
+      }
+    }
+    else if(headers.lengthKnown)
+      complete = read(headers.length);
+    else {
+      // the content ends when the server closes the connection
+      headers.close = true;
+      read(std::numeric_limits<std::uint64_t>::max());
+      complete = http.eof() && http.error() != boost::asio::error::operation_aborted;
+    }
+
+    if(http.error() == boost::asio::error::operation_aborted)
+      throw EOperationFailed{"ERROR: Download timeout (" + Convert(timeout) + " seconds) exceeded!"};
+    if(!complete)
+      throw EOperationFailed{"ERROR: Connection to '" + address + "' closed before the whole file was received!!!"};
+    if(decoder)
+      decoder->Finish();
+
+    if(!headers.close)
+      Release(server, std::move(connection));
+    return status;
+  }
+}
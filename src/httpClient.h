@@ -0,0 +1,105 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file httpClient.h
+ *
+ * @brief Declares the HTTP client class (condor2nav::CHttpClient). 
+ */
+
+#ifndef __HTTP_CLIENT_H__
+#define __HTTP_CLIENT_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief HTTP/1.1 client
+   *
+   * condor2nav::CHttpClient class downloads files with HTTP/1.1 protocol.
+   * Connections are kept alive and reused by next requests to the same
+   * server. Partial downloads may be resumed with a byte range request.
+   * Conditional requests are supported with entity tags and modification
+   * dates. Compressed transfers (gzip content encoding) are supported.
+   *
+   * @note Singleton design pattern
+   * @note All the methods are thread-safe
+   */
+  class CHttpClient : CNonCopyable {
+  public:
+    /**
+     * @brief Function called with next portion of received content.
+     *
+     * @param pos  Position of the data in the file.
+     * @param data Received data.
+     * @param size The size of received data.
+     */
+    using CDataHandler = std::function<void(std::uint64_t pos, const char *data, std::size_t size)>;
+
+    /**
+     * @brief Cache validators of a file.
+     */
+    struct TValidators {
+      std::string etag;                                            ///< @brief 'ETag' header value
+      std::string lastModified;                                    ///< @brief 'Last-Modified' header value
+
+      std::string Range() const;
+    };
+
+    static const unsigned HTTP_OK = 200;                           ///< @brief The whole file is provided. 
+    static const unsigned HTTP_PARTIAL_CONTENT = 206;              ///< @brief Requested range of the file is provided. 
+    static const unsigned HTTP_NOT_MODIFIED = 304;                 ///< @brief The file did not change since it was validated. 
+    static const unsigned HTTP_RANGE_NOT_SATISFIABLE = 416;        ///< @brief Requested range is outside of the file. 
+
+  private:
+    struct TConnection;
+    using CConnectionPtr = std::unique_ptr<TConnection>;
+    using CConnectionsList = std::vector<CConnectionPtr>;
+
+    static const unsigned MAX_IDLE_CONNECTIONS = 8;                ///< @brief The maximum number of idle connections kept per server. 
+    static const std::size_t CHUNK_SIZE = 64 * 1024;               ///< @brief The size of data provided to a handler at once. 
+
+    std::map<std::string, CConnectionsList> _idle;                 ///< @brief Idle connections for each server. 
+    std::mutex _mutex;                                             ///< @brief Idle connections guard. 
+
+    CHttpClient();
+    CConnectionPtr Acquire(const std::string &server, bool &reused);
+    void Release(const std::string &server, CConnectionPtr connection);
+
+  public:
+    static CHttpClient &Instance();
+    ~CHttpClient();
+    unsigned Get(const std::string &server, const bfs::path &url, unsigned timeout, std::uint64_t offset, const CDataHandler &handler,
+                 TValidators *validators = nullptr, std::uint64_t *total = nullptr);
+  };
+
+}
+
+#endif /* __HTTP_CLIENT_H__ */
@@ -27,9 +27,28 @@
 
 #include "istream.h"
 #include <algorithm>
-#include <boost/asio/ip/tcp.hpp>
-#include "activeSync.h"   // has to be included after boost/asio
-#include <boost/filesystem/fstream.hpp>
+#include <iterator>
+#include "asyncIO.h"
+#include "tools.h"
+#include "traceLog.h"
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+/**
+ * @brief Local file memory mapping.
+ */
+struct condor2nav::CIStream::TMapping {
+  boost::interprocess::file_mapping file;      ///< @brief Mapped file. 
+  boost::interprocess::mapped_region region;   ///< @brief Mapped region of the file. 
+
+  explicit TMapping(const bfs::path &fileName) :
+    file{fileName.string().c_str(), boost::interprocess::read_only},
+    region{file, boost::interprocess::read_only}
+  {
+  }
+};
 
 
 /**
@@ -39,63 +58,128 @@
  *
  * @param fileName The name of the file to read.
  */
-condor2nav::CIStream::CIStream(const bfs::path &fileName)
+condor2nav::CIStream::CIStream(const bfs::path &fileName) :
+  _begin{nullptr}, _end{nullptr}, _pos{nullptr}, _text{true}, _good{true}
 {
+  CTraceScope trace{"io", "Read", fileName};
   switch(PathType(fileName)) {
   case TPathType::LOCAL:
     {
-      bfs::fstream stream{fileName, std::ios_base::in};
-      if(!stream)
+      boost::system::error_code ec;
+      auto size = bfs::file_size(fileName, ec);
+      if(ec)
         throw EOperationFailed{"ERROR: Couldn't open file '" + fileName.string() + "' for reading!!!"};
-      _buffer << stream.rdbuf();
+      if(size == 0) {
+        // empty files cannot be mapped
+        BufferAttach();
+        break;
+      }
+
+      try {
+        _mapping = std::make_unique<TMapping>(fileName);
+      }
+      catch(const boost::interprocess::interprocess_exception &ex) {
+        throw EOperationFailed{"ERROR: Couldn't open file '" + fileName.string() + "' for reading (" + ex.what() + ")!!!"};
+      }
+      _begin = static_cast<const char *>(_mapping->region.get_address());
+      _end = _begin + _mapping->region.get_size();
+      _pos = _begin;
     }
     break;
 
   case TPathType::ACTIVE_SYNC:
-    _buffer.str(CActiveSync::Instance().Read(fileName));
+    // line endings are translated while the data is read
+    CAsyncIO::Instance().Read(fileName, [this](const char *data, std::size_t size){ _buffer.append(data, size); }).get();
+    BufferAttach();
     break;
   }
+  trace.Bytes(static_cast<std::uint64_t>(_end - _begin));
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CIStream class constructor. Downloads the file from the server
+ * reusing already established connection if possible.
+ *
+ * @param server  Server to download the file from.
+ * @param url     Path of the file on the server.
+ * @param timeout Download timeout in seconds.
+ */
+condor2nav::CIStream::CIStream(const std::string &server, const bfs::path &url, unsigned timeout /* = 30 */) :
+  _begin{nullptr}, _end{nullptr}, _pos{nullptr}, _text{false}, _good{true}
+{
+  CAsyncIO::Instance().Read(server, url, timeout,
+                            [this](const char *data, std::size_t size){ _buffer.append(data, size); }).get();
+  BufferAttach();
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * condor2nav::CIStream class destructor.
+ */
+condor2nav::CIStream::~CIStream()
+{
+}
+
+
+/**
+ * @brief Sets the stream range to the internal buffer.
+ *
+ * Method sets the stream data range to the content of the internal buffer.
+ */
+void condor2nav::CIStream::BufferAttach()
+{
+  _begin = _buffer.data();
+  _end = _begin + _buffer.size();
+  _pos = _begin;
+}
+
+
+/**
+ * @brief Reads next line from the stream.
+ *
+ * Method provides the next line of the stream without copying its data. The line
+ * stays valid for the lifetime of the stream object. Line ending characters are
+ * not provided.
+ *
+ * @param line Read line.
+ *
+ * @return @p false if there are no more lines in the stream.
+ */
+bool condor2nav::CIStream::GetLine(boost::string_ref &line)
+{
+  if(_pos == _end) {
+    line.clear();
+    _good = false;
+    return false;
+  }
+
+  auto lineEnd = std::find(_pos, _end, '\n');
+  line = boost::string_ref{_pos, static_cast<size_t>(lineEnd - _pos)};
+  _pos = lineEnd == _end ? _end : lineEnd + 1;
+  if(_text && !line.empty() && line.back() == '\r')
+    line.remove_suffix(1);
+  return true;
 }
 
 
-condor2nav::CIStream::CIStream(const std::string &server, const bfs::path &url, unsigned timeout /* = 30 */)
+/**
+ * @brief Reads next line from the stream.
+ *
+ * Method copies the next line of the stream to provided string.
+ *
+ * @param line Read line.
+ *
+ * @return @p false if there are no more lines in the stream.
+ */
+bool condor2nav::CIStream::GetLine(std::string &line)
 {
-  boost::asio::ip::tcp::iostream http;
-  http.expires_from_now(boost::posix_time::seconds(timeout));
-
-  // establish a connection to the server.
-  http.connect(server, "http");
-  if(!http)
-    throw EOperationFailed{"ERROR: Unable to connect to: '" + server + url.generic_string() + "', error: " + http.error().message()};
-
-  // Send the request. We specify the "Connection: close" header so that the
-  // server will close the socket after transmitting the response. This will
-  // allow us to treat all data up until the EOF as the content.
-  http << "GET " << url.generic_string() << " HTTP/1.0\r\n";
-  http << "Host: " << server << "\r\n";
-  http << "Accept: */*\r\n";
-  http << "Connection: close\r\n\r\n";
-
-  // Check that response is OK.
-  std::string http_version;
-  http >> http_version;
-  unsigned int status_code;
-  http >> status_code;
-  std::string status_message;
-  std::getline(http, status_message);
-  if(!http || http_version.substr(0, 5) != "HTTP/")
-    throw EOperationFailed{"ERROR: Invalid response from: '" + server + url.generic_string() + "'"};
-  if(status_code != 200)
-    throw EOperationFailed{"ERROR: '" + server + url.generic_string() + "' returned a response with status code: " + Convert(status_code)};
-
-  // Process the response headers, which are terminated by a blank line.
-  std::string header;
-  while(std::getline(http, header) && header != "\r")
-    ;
-
-  // Write the remaining data to internal buffer
-  _buffer << http.rdbuf();
-
-  if(http.error() == boost::asio::error::operation_aborted)
-    throw EOperationFailed{"ERROR: Download timeout (" + Convert(timeout) + " seconds) exceeded!"};
+  boost::string_ref ref;
+  auto ret = GetLine(ref);
+  line.assign(ref.data(), ref.size());
+  return ret;
 }
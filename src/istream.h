@@ -30,7 +30,10 @@
 
 #include "nonCopyable.h"
 #include "boostfwd.h"
-#include <sstream>
+#include "memoryAccount.h"
+#include <boost/utility/string_ref.hpp>
+#include <memory>
+#include <string>
 
 namespace condor2nav {
 
@@ -38,19 +41,49 @@ namespace condor2nav {
    * @brief Input stream wrapper
    *
    * condor2nav::CIStream class is a wrapper for different stream types.
+   * Local files are memory mapped and their data is provided directly
+   * from the mapping. Data downloaded from the server or read from the
+   * ActiveSync device is stored in an internal buffer.
    */
   class CIStream : CNonCopyable {
-    std::stringstream _buffer;            ///< @brief Buffer with file data. 
+    struct TMapping;
+
+    std::unique_ptr<TMapping> _mapping;   ///< @brief Local file mapping. 
+    CCountedString<TMemorySubsystem::NETWORK> _buffer;   ///< @brief Buffer with not mapped data. 
+    const char *_begin;                   ///< @brief The beginning of the stream data. 
+    const char *_end;                     ///< @brief The end of the stream data. 
+    const char *_pos;                     ///< @brief Current read position. 
+    bool _text;                           ///< @brief Provide the data with '\r\n' line endings translated. 
+    bool _good;                           ///< @brief The state of the last read operation. 
+
+    void BufferAttach();
+
   public:
     explicit CIStream(const bfs::path &fileName);
     CIStream(const std::string &server, const bfs::path &url, unsigned timeout = 30);
-    explicit operator bool() const           { return static_cast<bool>(_buffer); }
-    std::istream &GetLine(std::string &line) { return getline(_buffer, line); }
+    ~CIStream();
+    explicit operator bool() const           { return _good; }
+    boost::string_ref Data() const           { return boost::string_ref{_begin, static_cast<std::size_t>(_end - _begin)}; }
+    bool GetLine(boost::string_ref &line);
+    bool GetLine(std::string &line);
 
     template<class Stream>
     friend Stream &operator<<(Stream &out, CIStream &in)
     {
-      out << in._buffer.rdbuf();
+      if(!in._text) {
+        out.write(in._begin, in._end - in._begin);
+        return out;
+      }
+
+      // skip '\r' in all '\r\n' sequences as text mode file stream would do
+      auto begin = in._begin;
+      for(auto it = begin; it != in._end; ++it) {
+        if(*it == '\r' && it + 1 != in._end && *(it + 1) == '\n') {
+          out.write(begin, it - begin);
+          begin = it + 1;
+        }
+      }
+      out.write(begin, in._end - begin);
       return out;
     }
   };
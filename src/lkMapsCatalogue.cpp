@@ -0,0 +1,243 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file lkMapsCatalogue.cpp
+ *
+ * @brief Implements the condor2nav::CLKMapsCatalogue class. 
+ */
+
+#include "lkMapsCatalogue.h"
+#include "fileParserINI.h"
+#include "ostream.h"
+#include "tools.h"
+#include <algorithm>
+#include <cstring>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace {
+
+  const char CATALOGUE_MAGIC[8] = "C2NCAT";         ///< @brief Catalogue file signature
+  const std::uint32_t CATALOGUE_VERSION = 1;        ///< @brief Has to be changed when TRecord changes
+
+  /**
+   * @brief Catalogue file header.
+   */
+  struct THeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t count;
+    std::uint32_t reserved;
+  };
+
+  /**
+   * @brief Copies a string to a fixed-size record field.
+   *
+   * @param dest  Record field.
+   * @param value String to copy.
+   *
+   * @exception std Thrown when the string does not fit in the field.
+   */
+  template<std::size_t N>
+  void FieldSet(char (&dest)[N], const std::string &value)
+  {
+    if(value.size() >= N)
+      throw condor2nav::EOperationFailed{"ERROR: Value '" + value + "' is too long for maps catalogue!!!"};
+    std::copy(value.begin(), value.end(), dest);
+  }
+
+  /**
+   * @brief Returns map template value or an empty string if not provided.
+   */
+  std::string OptionalValue(const condor2nav::CFileParserINI &parser, const char *key)
+  {
+    try {
+      return parser.Value("", key);
+    }
+    catch(const condor2nav::Exception &) {
+      return std::string{};
+    }
+  }
+
+  /**
+   * @brief Returns the scale of LK8000 map template.
+   *
+   * @return Map scale or 0 if unknown.
+   */
+  unsigned MapScale(const condor2nav::CFileParserINI &map)
+  {
+    //if(OptionalValue(map, "RES90") == "YES")
+    //  return 90;
+    if(OptionalValue(map, "RES250") == "YES")
+      return 250;
+    if(OptionalValue(map, "RES500") == "YES")
+      return 500;
+    if(OptionalValue(map, "RES1000") == "YES")
+      return 1000;
+    return 0;
+  }
+
+}
+
+
+/**
+ * @brief Mapped catalogue file.
+ */
+struct condor2nav::CLKMapsCatalogue::TMapping {
+  boost::interprocess::file_mapping file;      ///< @brief Mapped file. 
+  boost::interprocess::mapped_region region;   ///< @brief Mapped region of the file. 
+  explicit TMapping(const bfs::path &path) :
+    file{path.string().c_str(), boost::interprocess::read_only},
+    region{file, boost::interprocess::read_only}
+  {}
+};
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CLKMapsCatalogue class constructor. It maps the catalogue file
+ * and checks that it describes exactly the provided templates in their current
+ * versions. Missing or modified templates are parsed and the catalogue file
+ * is rewritten in such a case. Templates that cannot be parsed are skipped
+ * and reported with Errors().
+ *
+ * @param catalogPath  Catalogue file path.
+ * @param templatesDir The directory of templates files.
+ * @param names        Templates file names.
+ *
+ * @exception std Thrown when the catalogue cannot be written.
+ */
+condor2nav::CLKMapsCatalogue::CLKMapsCatalogue(const bfs::path &catalogPath, const bfs::path &templatesDir, CNamesList names) :
+  _begin{nullptr}, _end{nullptr}, _parsed{0}
+{
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+
+  // map the previous catalogue
+  const TRecord *oldBegin = nullptr;
+  const TRecord *oldEnd = nullptr;
+  try {
+    _mapping = std::make_unique<TMapping>(catalogPath);
+    const auto size = _mapping->region.get_size();
+    const auto header = static_cast<const THeader *>(_mapping->region.get_address());
+    if(size >= sizeof(THeader) &&
+       std::memcmp(header->magic, CATALOGUE_MAGIC, sizeof(CATALOGUE_MAGIC)) == 0 &&
+       header->version == CATALOGUE_VERSION && header->recordSize == sizeof(TRecord) &&
+       size == sizeof(THeader) + header->count * sizeof(TRecord)) {
+      oldBegin = reinterpret_cast<const TRecord *>(header + 1);
+      oldEnd = oldBegin + header->count;
+    }
+  }
+  catch(const std::exception &) {
+    // no catalogue yet
+  }
+
+  // merge current templates with the catalogue
+  bool modified = oldEnd - oldBegin != static_cast<std::ptrdiff_t>(names.size());
+  auto old = oldBegin;
+  std::vector<TRecord> records;
+  records.reserve(names.size());
+  for(const auto &name : names) {
+    while(old != oldEnd && name.Compare(old->file) > 0)
+      ++old;
+
+    const auto path = templatesDir / name.c_str();
+    const auto writeTime = FileWriteTime(path);
+    if(old != oldEnd && name.Compare(old->file) == 0 && old->writeTime == writeTime) {
+      records.push_back(*old);
+      continue;
+    }
+
+    modified = true;
+    try {
+      records.push_back(Parse(path, name, writeTime));
+      ++_parsed;
+    }
+    catch(const std::exception &ex) {
+      _errors.emplace_back(ex.what());
+    }
+  }
+
+  if(!modified) {
+    _begin = oldBegin;
+    _end = oldEnd;
+    return;
+  }
+
+  // store the new catalogue
+  _mapping.reset();
+  _records = std::move(records);
+  _begin = _records.data();
+  _end = _begin + _records.size();
+
+  THeader header{};
+  std::copy(std::begin(CATALOGUE_MAGIC), std::end(CATALOGUE_MAGIC), header.magic);
+  header.version = CATALOGUE_VERSION;
+  header.recordSize = sizeof(TRecord);
+  header.count = static_cast<std::uint32_t>(_records.size());
+  COStream stream{catalogPath};
+  stream.Write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if(!_records.empty())
+    stream.Write(reinterpret_cast<const char *>(_records.data()), static_cast<std::streamsize>(_records.size() * sizeof(TRecord)));
+  stream.Commit();
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * condor2nav::CLKMapsCatalogue class destructor.
+ */
+condor2nav::CLKMapsCatalogue::~CLKMapsCatalogue()
+{
+}
+
+
+/**
+ * @brief Parses one template file.
+ *
+ * @param path      Template file path.
+ * @param file      Template file name.
+ * @param writeTime Template file modification time.
+ *
+ * @exception std Thrown when the template is invalid.
+ *
+ * @return Catalogue record.
+ */
+auto condor2nav::CLKMapsCatalogue::Parse(const bfs::path &path, const CNameNoCase &file, std::uint64_t writeTime) -> TRecord
+{
+  const CFileParserINI parser{path};
+  TRecord record{};
+  FieldSet(record.file, file.str());
+  FieldSet(record.name, OptionalValue(parser, "NAME"));
+  FieldSet(record.dir, OptionalValue(parser, "DIR"));
+  FieldSet(record.mapZone, OptionalValue(parser, "MAPZONE"));
+  record.lonMin = Convert<double>(parser.Value("", "LONMIN"));
+  record.lonMax = Convert<double>(parser.Value("", "LONMAX"));
+  record.latMin = Convert<double>(parser.Value("", "LATMIN"));
+  record.latMax = Convert<double>(parser.Value("", "LATMAX"));
+  record.writeTime = writeTime;
+  record.scale = MapScale(parser);
+  return record;
+}
@@ -0,0 +1,102 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file lkMapsCatalogue.h
+ *
+ * @brief Declares the condor2nav::CLKMapsCatalogue class. 
+ */
+
+#ifndef __LKMAPSCATALOGUE_H__
+#define __LKMAPSCATALOGUE_H__
+
+#include "nonCopyable.h"
+#include "nameNoCase.h"
+#include "boostfwd.h"
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Binary catalogue of map templates.
+   *
+   * condor2nav::CLKMapsCatalogue provides the few fields of LK8000 maps templates
+   * and Condor landscapes templates that are needed for maps matching. They are
+   * stored in a binary file with fixed-size records sorted by file name that is
+   * memory mapped with one call. Only the templates that were added or modified
+   * since the catalogue was written are parsed and the catalogue is rewritten
+   * only if anything changed.
+   */
+  class CLKMapsCatalogue : CNonCopyable {
+  public:
+    using CNamesList = std::vector<CNameNoCase>;
+
+    /**
+     * @brief Catalogue record.
+     *
+     * Strings are zero terminated.
+     */
+    struct TRecord {
+      char file[64];                      ///< @brief Template file name
+      char name[64];                      ///< @brief Map name ('NAME' field)
+      char dir[32];                       ///< @brief Map directory on LK8000 server ('DIR' field)
+      char mapZone[32];                   ///< @brief Map zone on LK8000 server ('MAPZONE' field)
+      double lonMin;                      ///< @brief Minimum longitude
+      double lonMax;                      ///< @brief Maximum longitude
+      double latMin;                      ///< @brief Minimum latitude
+      double latMax;                      ///< @brief Maximum latitude
+      std::uint64_t writeTime;            ///< @brief Template file modification time
+      std::uint32_t scale;                ///< @brief Map scale (0 if unknown)
+      std::uint32_t reserved;             ///< @brief Padding
+    };
+
+    using CErrorsList = std::vector<std::string>;
+
+  private:
+    struct TMapping;
+
+    std::unique_ptr<TMapping> _mapping;   ///< @brief Mapped catalogue file
+    std::vector<TRecord> _records;        ///< @brief Records if the catalogue had to be updated
+    const TRecord *_begin;                ///< @brief The first record
+    const TRecord *_end;                  ///< @brief One past the last record
+    unsigned _parsed;                     ///< @brief The number of parsed templates
+    CErrorsList _errors;                  ///< @brief Templates that could not be parsed
+
+    static TRecord Parse(const bfs::path &path, const CNameNoCase &file, std::uint64_t writeTime);
+
+  public:
+    CLKMapsCatalogue(const bfs::path &catalogPath, const bfs::path &templatesDir, CNamesList names);
+    ~CLKMapsCatalogue();
+
+    const TRecord *begin() const { return _begin; }
+    const TRecord *end() const { return _end; }
+    std::size_t size() const { return static_cast<std::size_t>(_end - _begin); }
+    unsigned Parsed() const { return _parsed; }
+    const CErrorsList &Errors() const { return _errors; }
+  };
+
+}
+
+#endif /* __LKMAPSCATALOGUE_H__ */
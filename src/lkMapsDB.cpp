@@ -30,94 +30,278 @@
 #include "fileParserCSV.h"
 #include "translator.h"
 #include "istream.h"
+#include "ostream.h"
+#include "httpClient.h"
+#include "traceLog.h"
 #include "tools.h"
 #include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 #include <boost\filesystem\fstream.hpp>
 
 namespace condor2nav {
 
-  unsigned MapScale(const CFileParserINI &map);
+  unsigned DownloadConfig(const CFileParserINI &configParser, const std::string &key, unsigned defaultValue);
 
 }
 
-const bfs::path   condor2nav::CLKMapsDB::CONDOR_TEMPLATES_DIR            = "data/Landscapes";
-const bfs::path   condor2nav::CLKMapsDB::CONDOR2NAV_LK8000_TEMPLATES_DIR = "data/LK8000/LKMTemplates";
+namespace {
+
+  /**
+   * @brief Parses LK8000 maps templates index.
+   *
+   * @param index Index file content.
+   *
+   * @return Sorted list of templates names.
+   */
+  condor2nav::CLKMapsDB::CNamesList IndexParse(const std::string &index)
+  {
+    condor2nav::CLKMapsDB::CNamesList names;
+    std::istringstream stream{index};
+    std::string line;
+    while(std::getline(stream, line)) {
+      condor2nav::Trim(line);
+      if(!line.empty())
+        names.emplace_back(line);
+    }
+    sort(begin(names), end(names));
+    return names;
+  }
+
+  /**
+   * @brief Reads the stored copy of LK8000 maps templates index.
+   *
+   * @param path  Stored index file path.
+   * @param index Index file content.
+   *
+   * @return @p true if the whole file was read.
+   */
+  bool IndexRead(const bfs::path &path, std::string &index)
+  {
+    bfs::ifstream stream{path, std::ios_base::in | std::ios_base::binary};
+    if(!stream)
+      return false;
+    std::ostringstream content;
+    if(!(content << stream.rdbuf()) || stream.bad())
+      return false;
+    index = content.str();
+    return true;
+  }
+
+  /**
+   * @brief Grid index of LK8000 maps bounding boxes.
+   *
+   * Bounding boxes and scales of all the maps are extracted once to a packed
+   * array. Every map is registered in all the grid cells its box overlaps and
+   * each cell keeps its maps ordered by scale, so finding the best map for a
+   * landscape checks only the maps of one cell.
+   */
+  class CMapsIndex {
+  public:
+    /**
+     * @brief Map bounding box.
+     */
+    struct TBox {
+      double lonMin, lonMax, latMin, latMax;
+      unsigned scale;                                 ///< @brief Map scale (smaller is better)
+      unsigned index;                                 ///< @brief Map index in the order of registration
+    };
+
+  private:
+    static const double CELL_SIZE;                    ///< @brief Grid cell size [deg]
+
+    std::vector<TBox> _boxes;                         ///< @brief Packed maps data
+    std::unordered_map<long long, std::vector<unsigned>> _cells;   ///< @brief Indexes of _boxes overlapping each cell
+
+    static long Cell(double coord) { return static_cast<long>(std::floor(coord / CELL_SIZE)); }
+    static long long Key(long lon, long lat) { return (static_cast<long long>(lon) << 32) ^ static_cast<unsigned>(lat); }
+
+  public:
+    /**
+     * @brief Registers a map.
+     *
+     * @param box Map bounding box.
+     */
+    void Add(const TBox &box)
+    {
+      const auto pos = static_cast<unsigned>(_boxes.size());
+      _boxes.push_back(box);
+      for(auto lon = Cell(box.lonMin); lon <= Cell(box.lonMax); ++lon)
+        for(auto lat = Cell(box.latMin); lat <= Cell(box.latMax); ++lat)
+          _cells[Key(lon, lat)].push_back(pos);
+    }
+
+    /**
+     * @brief Orders maps of every cell by their scale.
+     *
+     * Has to be called after all maps are registered.
+     */
+    void Build()
+    {
+      for(auto &cell : _cells)
+        std::sort(cell.second.begin(), cell.second.end(), [this](unsigned i1, unsigned i2)
+        {
+          const auto &b1 = _boxes[i1];
+          const auto &b2 = _boxes[i2];
+          return b1.scale < b2.scale || (b1.scale == b2.scale && b1.index < b2.index);
+        });
+    }
+
+    /**
+     * @brief Finds the map with the best scale that covers the whole area.
+     *
+     * @return Map data or nullptr if no map covers the area.
+     */
+    const TBox *Best(double lonMin, double lonMax, double latMin, double latMax) const
+    {
+      // any map that contains the area contains its corner
+      const auto it = _cells.find(Key(Cell(lonMin), Cell(latMin)));
+      if(it == _cells.end())
+        return nullptr;
+      for(auto i : it->second) {
+        const auto &box = _boxes[i];
+        if(condor2nav::InsideArea(condor2nav::TLongitude{box.lonMin}, condor2nav::TLongitude{box.lonMax},
+                                  condor2nav::TLatitude{box.latMin}, condor2nav::TLatitude{box.latMax},
+                                  condor2nav::TLongitude{lonMin}, condor2nav::TLongitude{lonMax},
+                                  condor2nav::TLatitude{latMin}, condor2nav::TLatitude{latMax}))
+          return &box;
+      }
+      return nullptr;
+    }
+  };
+
+  const double CMapsIndex::CELL_SIZE = 1.0;
+
+}
+
+const bfs::path   condor2nav::CLKMapsDB::CONDOR_TEMPLATES_DIR             = "data/Landscapes";
+const bfs::path   condor2nav::CLKMapsDB::CONDOR_CATALOGUE_PATH            = "data/Landscapes.cat";
+const bfs::path   condor2nav::CLKMapsDB::CONDOR2NAV_LK8000_TEMPLATES_DIR  = "data/LK8000/LKMTemplates";
+const bfs::path   condor2nav::CLKMapsDB::CONDOR2NAV_LK8000_CATALOGUE_PATH = "data/LK8000/LKMTemplates.cat";
 const bfs::path   condor2nav::CLKMapsDB::CONDOR2NAV_LK8000_MAPS_DIR      = "data/LK8000/_Maps/condor2nav";
 const bfs::path   condor2nav::CLKMapsDB::LK8000_MAPS_URL                 = "/listing/LKMAPS";
 const std::string condor2nav::CLKMapsDB::LKM_TEMPLATES_INDEX_SERVER      = "cloud.github.com";
 const bfs::path   condor2nav::CLKMapsDB::LKM_TEMPLATES_INDEX_URL         = "/downloads/mpusz/Condor2Nav/LKMTemplates.txt";
+const bfs::path   condor2nav::CLKMapsDB::LKM_TEMPLATES_INDEX_PATH        = "data/LK8000/LKMTemplatesIndex.txt";
+const bfs::path   condor2nav::CLKMapsDB::LKM_TEMPLATES_INDEX_VALIDATORS_PATH = "data/LK8000/LKMTemplatesIndex.ini";
 
 
-unsigned condor2nav::MapScale(const CFileParserINI &map)
+unsigned condor2nav::DownloadConfig(const CFileParserINI &configParser, const std::string &key, unsigned defaultValue)
 {
-  //if(map.Value("", "RES90") == "YES")
-  //  return 90;
-  if(map.Value("", "RES250") == "YES")
-    return 250;
-  if(map.Value("", "RES500") == "YES")
-    return 500;
-  if(map.Value("", "RES1000") == "YES")
-    return 1000;
-  throw EOperationFailed{"ERROR: Unknown LK8000 map '" + map.Value("", "NAME") + "' scale!!!"};
+  try {
+    return Convert<unsigned>(configParser.Value("LK8000", key));
+  }
+  catch(const Exception &) {
+    return defaultValue;
+  }
 }
 
 
 condor2nav::CLKMapsDB::CLKMapsDB(const CCondor2Nav &app) :
-  _app{app}, _sceneriesParser{CTranslator::DATA_PATH / _app.ConfigParser().Value("Condor2Nav", "Target") / CTranslator::SCENERIES_DATA_FILE_NAME}
+  _app{app}, _sceneriesParser{CTranslator::DATA_PATH / "LK8000" / CTranslator::SCENERIES_DATA_FILE_NAME},
+  _downloader{DownloadConfig(app.ConfigParser(), "MapsDownloadConnections", 4),
+              DownloadConfig(app.ConfigParser(), "MapsDownloadRetries", 3),
+              DownloadConfig(app.ConfigParser(), "MapsDownloadRetryDelay", 1000)}
 {
   // fill the list of Condor landscapes templates
   std::for_each(bfs::directory_iterator(CONDOR_TEMPLATES_DIR), bfs::directory_iterator(),
-                [this](const bfs::path &p) { _condor.emplace_back(p.filename().string().c_str()); });
+                [this](const bfs::path &p) { _condor.emplace_back(p.filename().string()); });
   DirectoryCreate(CONDOR2NAV_LK8000_TEMPLATES_DIR);
 }
 
 
-auto condor2nav::CLKMapsDB::LKMTemplatesSync(const std::function<bool()> &abort) const -> CNamesList
+/**
+ * @brief Synchronizes LK8000 maps templates with the server.
+ *
+ * The templates index is requested conditionally. If it did not change since
+ * all the templates it lists were downloaded the stored copy is used and no
+ * local directory scan is needed unless the templates directory was modified
+ * since. The index is downloaded again if its stored copy cannot be read.
+ *
+ * @param cancel Cancellation token.
+ *
+ * @exception std Thrown when the index cannot be downloaded.
+ *
+ * @return The list of all available templates.
+ */
+auto condor2nav::CLKMapsDB::LKMTemplatesSync(const CCancellationToken &cancel) const -> CNamesList
 {
-  // fill the list of already downloaded LKMaps templates
-  CNamesList lkLocal;
-  std::for_each(bfs::directory_iterator(CONDOR2NAV_LK8000_TEMPLATES_DIR), bfs::directory_iterator(),
-                [&](const bfs::path &p) { lkLocal.emplace_back(p.filename().string().c_str()); });
-  sort(begin(lkLocal), end(lkLocal));
+  CTraceScope trace{"maps", "LKMTemplatesSync"};
 
   // get the list of all LKMaps templates on LK8000 server
   _app.Log() << "Obtaining list of LK8000 maps templates..." << std::endl;
-  CNamesList lkRemote;
+  CHttpClient::TValidators validators;
+  std::string templatesTime;
+  if(bfs::exists(LKM_TEMPLATES_INDEX_PATH) && bfs::exists(LKM_TEMPLATES_INDEX_VALIDATORS_PATH)) {
+    try {
+      const CFileParserINI parser{LKM_TEMPLATES_INDEX_VALIDATORS_PATH};
+      validators.etag = parser.Value("", "ETag");
+      validators.lastModified = parser.Value("", "LastModified");
+      templatesTime = parser.Value("", "TemplatesTime");
+    }
+    catch(const Exception &) {
+      validators = CHttpClient::TValidators{};
+    }
+  }
 
   // temporary solution - read from a fixed file
-  CIStream templates{LKM_TEMPLATES_INDEX_SERVER, LKM_TEMPLATES_INDEX_URL};
-  while(templates) {
-    std::string line;
-    templates.GetLine(line);
-    Trim(line);
-    if(!line.empty())
-      lkRemote.emplace_back(line.c_str());
+  std::string index;
+  auto get = [&]
+  {
+    index.clear();
+    return CHttpClient::Instance().Get(LKM_TEMPLATES_INDEX_SERVER, LKM_TEMPLATES_INDEX_URL, 30, 0,
+                                       [&](std::uint64_t, const char *data, std::size_t size){ index.append(data, size); },
+                                       &validators);
+  };
+  if(get() == CHttpClient::HTTP_NOT_MODIFIED) {
+    if(!IndexRead(LKM_TEMPLATES_INDEX_PATH, index)) {
+      // stored copy is not usable so the whole index is needed
+      _app.Warning() << "WARNING: Couldn't read '" << LKM_TEMPLATES_INDEX_PATH.string() << "' file!!!" << std::endl;
+      validators = CHttpClient::TValidators{};
+      get();
+    }
+    else if(templatesTime == std::to_string(FileWriteTime(CONDOR2NAV_LK8000_TEMPLATES_DIR))) {
+      _app.Log() << "No new LK8000 maps templates found" << std::endl;
+      return IndexParse(index);
+    }
   }
-  sort(begin(lkRemote), end(lkRemote));
+  auto lkRemote = IndexParse(index);
+
+  // fill the list of already downloaded LKMaps templates
+  CNamesList lkLocal;
+  std::for_each(bfs::directory_iterator(CONDOR2NAV_LK8000_TEMPLATES_DIR), bfs::directory_iterator(), [&](const bfs::path &p)
+  {
+    if(p.extension() != DOWNLOAD_TEMP_EXTENSION)
+      lkLocal.emplace_back(p.filename().string());
+  });
+  sort(begin(lkLocal), end(lkLocal));
 
   // check if there are new LK8000 templates on the LK8000 server
   CNamesList diff;
   std::set_difference(begin(lkRemote), end(lkRemote), begin(lkLocal), end(lkLocal), std::back_inserter(diff));
+  bool complete = true;
   if(diff.size()) {
     // download new templates from LK8000 server
     _app.Log() << "Downloading new LK8000 maps templates..." << std::endl;
-    CNamesList errors;
-    for(auto &name : diff) {
-      if(abort())
-        break;
-      try {
-        _app.Log() << " - " << name << std::endl;
-        Download("www.bware.it", LK8000_MAPS_URL / "TEMPLATES" / name.c_str(), CONDOR2NAV_LK8000_TEMPLATES_DIR / name.c_str());
-      }
-      catch(const EOperationFailed &ex) {
-        _app.Error() << ex.what() << std::endl;
-        errors.emplace_back(name);
+    CDownloader::CFileList files;
+    files.reserve(diff.size());
+    for(auto &name : diff)
+      files.push_back(CDownloader::TFile{"www.bware.it", LK8000_MAPS_URL / "TEMPLATES" / name.c_str(), CONDOR2NAV_LK8000_TEMPLATES_DIR / name.c_str(), 30});
+    const auto status = _downloader.Run(files, cancel,
+                                        [this](const CDownloader::TFile &file){ _app.Log() << " - " + file.path.filename().string() + "\n"; },
+                                        [this](const CDownloader::TFile &, const std::string &error){ _app.Error() << error + "\n"; },
+                                        CDownloader::CProgressHandler{}, CDownloader::CPriorityHandler{},
+                                        [this](const CDownloader::TStatus &s){ _app.DownloadStatus(s); });
+
+    // remove errored or cancelled templates if any
+    for(size_t i=0; i<diff.size(); i++) {
+      if(!status[i]) {
+        lkRemote.erase(find(begin(lkRemote), end(lkRemote), diff[i]));
+        complete = false;
       }
     }
-
-    // remove errored templates if any
-    for(auto &e : errors)
-      lkRemote.erase(find(begin(lkRemote), end(lkRemote), e));
   }
   else {
     _app.Log() << "No new LK8000 maps templates found" << std::endl;
@@ -125,18 +309,36 @@ auto condor2nav::CLKMapsDB::LKMTemplatesSync(const std::function<bool()> &abort)
 
   CNamesList result;
   set_union(begin(lkLocal), end(lkLocal), begin(lkRemote), end(lkRemote), std::back_inserter(result));
+
+  // store the index for conditional requests only if all its templates are available
+  bfs::remove(LKM_TEMPLATES_INDEX_VALIDATORS_PATH);
+  if(complete && (!validators.etag.empty() || !validators.lastModified.empty())) {
+    COStream stored{LKM_TEMPLATES_INDEX_PATH};
+    for(const auto &name : result)
+      stored << name << "\n";
+    stored.Commit();
+    COStream validatorsFile{LKM_TEMPLATES_INDEX_VALIDATORS_PATH};
+    validatorsFile << "ETag=" << validators.etag << "\n";
+    validatorsFile << "LastModified=" << validators.lastModified << "\n";
+    validatorsFile << "TemplatesTime=" << FileWriteTime(CONDOR2NAV_LK8000_TEMPLATES_DIR) << "\n";
+    validatorsFile.Commit();
+  }
   return result;
 }
 
 
-auto condor2nav::CLKMapsDB::LandscapesMatch(CNamesList allTemplates) -> CParsersMap
+auto condor2nav::CLKMapsDB::LandscapesMatch(CNamesList allTemplates) -> CMapsList
 {
+  CTraceScope trace{"maps", "LandscapesMatch"};
   _app.Log() << "Looking for new/better maps match..." << std::endl;
 
-  // fill a list of Condor sceneries data
-  CParsersMap condor;
-  for(const auto &name : _condor)
-    condor[name] = std::make_shared<CFileParserINI>(CONDOR_TEMPLATES_DIR / name.c_str());
+  // load Condor sceneries and LKMaps templates data (only new templates are parsed)
+  const CLKMapsCatalogue condor{CONDOR_CATALOGUE_PATH, CONDOR_TEMPLATES_DIR, _condor};
+  const CLKMapsCatalogue lk{CONDOR2NAV_LK8000_CATALOGUE_PATH, CONDOR2NAV_LK8000_TEMPLATES_DIR, std::move(allTemplates)};
+  for(const auto &error : condor.Errors())
+    _app.Warning() << error << std::endl;
+  for(const auto &error : lk.Errors())
+    _app.Warning() << error << std::endl;
 
   // fill the list of already downloaded LKMaps
   CNamesList lkmLocal;
@@ -145,9 +347,9 @@ auto condor2nav::CLKMapsDB::LandscapesMatch(CNamesList allTemplates) -> CParsers
     std::for_each(bfs::directory_iterator(CONDOR2NAV_LK8000_MAPS_DIR), bfs::directory_iterator(), [&](const bfs::path &p)
     {
       if(p.extension() == ".LKM")
-        lkmLocal.emplace_back(p.stem().string().c_str());
+        lkmLocal.emplace_back(p.stem().string());
       else if(p.extension() == ".DEM") {
-        CStringNoCase file{p.stem().string().c_str()};
+        const auto file = p.stem().string();
         demLocal.emplace_back(file.substr(0, file.find_last_of('_')));
       }
     });
@@ -158,48 +360,42 @@ auto condor2nav::CLKMapsDB::LandscapesMatch(CNamesList allTemplates) -> CParsers
   CNamesList lkLocal;
   set_intersection(begin(lkmLocal), end(lkmLocal), begin(demLocal), end(demLocal), back_inserter(lkLocal));
 
-  // prepare a list of all LKMaps templates data
-  CParsersMap lk;
-  for(const auto &name : allTemplates)
-    lk[name] = std::make_shared<CFileParserINI>(CONDOR2NAV_LK8000_TEMPLATES_DIR / name.c_str());
+  // index templates areas
+  CMapsIndex index;
+  for(const auto &map : lk) {
+    if(!map.scale) {
+      _app.Warning() << "ERROR: Unknown LK8000 map '" << map.name << "' scale!!!" << std::endl;
+      continue;
+    }
+    index.Add(CMapsIndex::TBox{map.lonMin, map.lonMax, map.latMin, map.latMax, map.scale, static_cast<unsigned>(&map - lk.begin())});
+  }
+  index.Build();
 
-  CParsersMap result;
+  CMapsList result;
 
   // do for all Condor maps
-  for(auto &landscape : condor) {
-    auto lonMin = Convert<double>(landscape.second->Value("", "LONMIN"));
-    auto lonMax = Convert<double>(landscape.second->Value("", "LONMAX"));
-    auto latMin = Convert<double>(landscape.second->Value("", "LATMIN"));
-    auto latMax = Convert<double>(landscape.second->Value("", "LATMAX"));
-
-    CStringNoCase landscapeName{landscape.first, 0, landscape.first.find_last_of('_')};
-    auto &landscapeData = _sceneriesParser.Row(landscapeName.c_str(), 0, true);
-    std::shared_ptr<CFileParserINI> bestMatch;
-    
-    // check for all maps
-    for(auto &map : lk) {
-      // check if there is a new LK map that covers all landscape area
-      const bool insideArea = InsideArea(
-        TLongitude{Convert<double>(map.second->Value("", "LONMIN"))}, TLongitude{Convert<double>(map.second->Value("", "LONMAX"))},
-        TLatitude{Convert<double>(map.second->Value("", "LATMIN"))}, TLatitude{Convert<double>(map.second->Value("", "LATMAX"))},
-        TLongitude{lonMin}, TLongitude{lonMax}, TLatitude{latMin}, TLatitude{latMax});
-      if(insideArea) {
-        // check if that map is better than already found
-        if(!bestMatch || MapScale(*map.second) < MapScale(*bestMatch))
-          bestMatch = map.second;
-      }
-    }
+  for(const auto &landscape : condor) {
+    const std::string file{landscape.file};
+    const CNameNoCase landscapeName{file.substr(0, file.find_last_of('_'))};
+    auto &landscapeData = _sceneriesParser.Row(landscapeName.str(), 0, true);
+
+    // find the LK map with the best scale that covers all landscape area
+    const auto box = index.Best(landscape.lonMin, landscape.lonMax, landscape.latMin, landscape.latMax);
+    if(box) {
+      const auto &bestMatch = lk.begin()[box->index];
 
-    if(bestMatch) {
       // set new map data in CSV file
-      auto &newName = bestMatch->Value("", "NAME");
-      landscapeData[CTranslator::CTarget::SCENERY_MAP_FILE] = newName + ".LKM";
-      landscapeData[CTranslator::CTarget::SCENERY_TERRAIN_FILE] = newName + "_" + Convert(MapScale(*bestMatch)) + ".DEM";
+      const std::string newName{bestMatch.name};
+      _sceneriesParser.Value(landscapeData, CTranslator::CTarget::SCENERY_MAP_FILE, newName + ".LKM");
+      _sceneriesParser.Value(landscapeData, CTranslator::CTarget::SCENERY_TERRAIN_FILE, newName + "_" + Convert(box->scale) + ".DEM");
 
-      if(none_of(begin(lkLocal), end(lkLocal), [&](CStringNoCase &m){ return m == newName.c_str(); })) {
-        _app.Log() << " - " << newName << " -> " << landscape.first << std::endl;
+      const CNameNoCase newMap{newName};
+      if(!std::binary_search(begin(lkLocal), end(lkLocal), newMap)) {
+        _app.Log() << " - " << newName << " -> " << file << std::endl;
         // store in results
-        result[newName.c_str()] = bestMatch;
+        auto &map = result[newMap];
+        map.record = bestMatch;
+        map.landscapes.push_back(landscapeName);
       }
     }
   }
@@ -214,32 +410,78 @@ auto condor2nav::CLKMapsDB::LandscapesMatch(CNamesList allTemplates) -> CParsers
 }
 
 
-void condor2nav::CLKMapsDB::LKMDownload(CParsersMap &maps, const std::function<bool()> &abort) const
+void condor2nav::CLKMapsDB::LKMDownload(const CMapsList &maps, const CCancellationToken &cancel) const
 {
+  CTraceScope trace{"maps", "LKMDownload"};
   _app.Log() << "Downloading new LK8000 maps..." << std::endl;
-  for(auto &map : maps) {
+  // the server may provide pre-compressed archives next to the map files
+  const auto archive = DownloadConfig(_app.ConfigParser(), "MapsDownloadCompressed", 0) ? ".gz" : "";
+  CDownloader::CFileList files;
+  std::map<bfs::path, const TMap *> fileMaps;
+  std::map<const TMap *, unsigned> remaining;
+  for(const auto &map : maps) {
     try {
+      const std::string name{map.second.record.name};
+      const std::string dir{map.second.record.dir};
+      const std::string mapZone{map.second.record.mapZone};
       bfs::path path = LK8000_MAPS_URL;
-      if(map.second->Value("", "DIR") == "CONDOR")
+      if(dir == "CONDOR")
         path /= "EUR/CONDOR.DIR";
+      else if(dir.empty() || mapZone.empty())
+        throw EOperationFailed{"ERROR: LK8000 map '" + name + "' template does not define DIR and MAPZONE!!!"};
       else
-        path = path / map.second->Value("", "MAPZONE") / (map.second->Value("", "DIR") + ".DIR");
-
-      auto download = [&](const std::string &name) {
-        _app.Log() << " - " << name << std::endl;
-        Download("www.bware.it", path / name, CONDOR2NAV_LK8000_MAPS_DIR / name, 180);
-      };
-
-      if(abort())
-        return;
-      download(map.second->Value("", "NAME") + ".LKM");
-
-      if(abort())
-        return;
-      download(map.second->Value("", "NAME") + "_" + Convert(MapScale(*map.second)) + ".DEM");
+        path = path / mapZone / (dir + ".DIR");
+
+      const auto lkm = name + ".LKM";
+      const auto dem = name + "_" + Convert(map.second.record.scale) + ".DEM";
+      files.push_back(CDownloader::TFile{"www.bware.it", path / (lkm + archive), CONDOR2NAV_LK8000_MAPS_DIR / lkm, 180});
+      files.push_back(CDownloader::TFile{"www.bware.it", path / (dem + archive), CONDOR2NAV_LK8000_MAPS_DIR / dem, 180});
+      fileMaps[CONDOR2NAV_LK8000_MAPS_DIR / lkm] = &map.second;
+      fileMaps[CONDOR2NAV_LK8000_MAPS_DIR / dem] = &map.second;
+      remaining[&map.second] = 2;
     }
     catch(const EOperationFailed &ex) {
       _app.Error() << ex.what() << std::endl;
     }
   }
+
+  // landscape maps are ready when both LKM and DEM files are finished
+  std::mutex remainingMutex;
+  auto finished = [&](const CDownloader::TFile &file)
+  {
+    const auto map = fileMaps.at(file.path);
+    {
+      std::lock_guard<std::mutex> lock{remainingMutex};
+      if(--remaining[map])
+        return;
+    }
+    _app.MapsDownloaded(map->landscapes);
+  };
+
+  _downloader.Run(files, cancel,
+                  [this](const CDownloader::TFile &file){ _app.Log() << " - " + file.path.filename().string() + "\n"; },
+                  [&](const CDownloader::TFile &file, const std::string &error)
+                  {
+                    _app.Error() << error + "\n";
+                    finished(file);
+                  },
+                  [&](const CDownloader::TFile &file, std::uint64_t size, std::uint64_t, unsigned rate, bool done)
+                  {
+                    // the progress of unfinished files is reported with the overall status
+                    if(!done)
+                      return;
+                    _app.Log() << "   " + file.path.filename().string() + " downloaded: " +
+                                  Convert(static_cast<unsigned>(size / 1024)) + " kB (" + Convert(rate / 1024) + " kB/s)\n";
+                    finished(file);
+                  },
+                  [&](const CDownloader::TFile &file)
+                  {
+                    // download maps of the currently selected landscape first
+                    const auto landscape = _app.MapsPriority();
+                    if(landscape.empty())
+                      return false;
+                    const auto &landscapes = fileMaps.at(file.path)->landscapes;
+                    return std::find(landscapes.begin(), landscapes.end(), CNameNoCase{landscape}) != landscapes.end();
+                  },
+                  [this](const CDownloader::TStatus &status){ _app.DownloadStatus(status); });
 }
@@ -29,8 +29,10 @@
 #define __LKMAPSDB_H__
 
 #include "nonCopyable.h"
-#include "traitsNoCase.h"
+#include "nameNoCase.h"
 #include "fileParserCSV.h"
+#include "lkMapsCatalogue.h"
+#include "downloader.h"
 #include "boostfwd.h"
 #include <vector>
 #include <map>
@@ -47,24 +49,36 @@ namespace condor2nav {
    */
   class CLKMapsDB : CNonCopyable {
   public:
-    typedef std::vector<CStringNoCase> CNamesList;
-    typedef std::map<CStringNoCase, std::shared_ptr<CFileParserINI>> CParsersMap;
+    typedef std::vector<CNameNoCase> CNamesList;
+    /**
+     * @brief New LK8000 map to download.
+     */
+    struct TMap {
+      CLKMapsCatalogue::TRecord record;   ///< @brief LK8000 map template data. 
+      CNamesList landscapes;              ///< @brief Condor landscapes using the map. 
+    };
+    typedef std::map<CNameNoCase, TMap> CMapsList;
   private:
     static const bfs::path   CONDOR_TEMPLATES_DIR;
+    static const bfs::path   CONDOR_CATALOGUE_PATH;
     static const bfs::path   CONDOR2NAV_LK8000_TEMPLATES_DIR;
+    static const bfs::path   CONDOR2NAV_LK8000_CATALOGUE_PATH;
     static const bfs::path   CONDOR2NAV_LK8000_MAPS_DIR;
     static const bfs::path   LK8000_MAPS_URL;
     static const std::string LKM_TEMPLATES_INDEX_SERVER;
     static const bfs::path   LKM_TEMPLATES_INDEX_URL;
+    static const bfs::path   LKM_TEMPLATES_INDEX_PATH;
+    static const bfs::path   LKM_TEMPLATES_INDEX_VALIDATORS_PATH;
 
     const CCondor2Nav &_app;
     CFileParserCSV _sceneriesParser;
     CNamesList _condor;
+    CDownloader _downloader;
   public:
     explicit CLKMapsDB(const CCondor2Nav &app);
-    CNamesList LKMTemplatesSync(const std::function<bool()> &abort) const;
-    CParsersMap LandscapesMatch(CNamesList allTemplates);
-    void LKMDownload(CParsersMap &maps, const std::function<bool()> &abort) const;
+    CNamesList LKMTemplatesSync(const CCancellationToken &cancel) const;
+    CMapsList LandscapesMatch(CNamesList allTemplates);
+    void LKMDownload(const CMapsList &maps, const CCancellationToken &cancel) const;
   };
 
 }
@@ -0,0 +1,140 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file lkTerrain.cpp
+ *
+ * @brief Implements the condor2nav::CLKTerrain class. 
+ */
+
+#include "lkTerrain.h"
+#include "ostream.h"
+#include <algorithm>
+#include <cmath>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+/**
+ * @brief Mapped terrain file.
+ */
+struct condor2nav::CLKTerrain::TMapping {
+  boost::interprocess::file_mapping file;      ///< @brief Mapped file. 
+  boost::interprocess::mapped_region region;   ///< @brief Mapped region of the file. 
+  explicit TMapping(const bfs::path &path) :
+    file{path.string().c_str(), boost::interprocess::read_only},
+    region{file, boost::interprocess::read_only}
+  {}
+};
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CLKTerrain class constructor. It maps the terrain file and
+ * validates its header.
+ *
+ * @param path Terrain file path.
+ *
+ * @exception std Thrown when the file cannot be mapped or is not a valid DEM file.
+ */
+condor2nav::CLKTerrain::CLKTerrain(const bfs::path &path) :
+  _header{nullptr}, _raster{nullptr}
+{
+  try {
+    _mapping = std::make_unique<TMapping>(path);
+  }
+  catch(const std::exception &) {
+    throw EOperationFailed{"ERROR: Unable to open terrain file '" + path.string() + "'!!!"};
+  }
+
+  const auto size = _mapping->region.get_size();
+  const auto data = static_cast<const char *>(_mapping->region.get_address());
+  if(size < sizeof(THeader))
+    throw EOperationFailed{"ERROR: Terrain file '" + path.string() + "' is too short!!!"};
+  _header = reinterpret_cast<const THeader *>(data);
+  if(_header->rows <= 0 || _header->columns <= 0 || _header->stepSize <= 0 ||
+     size < sizeof(THeader) + std::uint64_t(_header->rows) * _header->columns * sizeof(std::int16_t))
+    throw EOperationFailed{"ERROR: Terrain file '" + path.string() + "' is corrupted!!!"};
+  _raster = reinterpret_cast<const std::int16_t *>(data + sizeof(THeader));
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * condor2nav::CLKTerrain class destructor.
+ */
+condor2nav::CLKTerrain::~CLKTerrain()
+{
+}
+
+
+/**
+ * @brief Writes terrain clipped to the area.
+ *
+ * Method writes a new DEM file that covers only the provided area. The rows
+ * of the raster are copied directly from the mapped terrain file.
+ *
+ * @param outputPath Clipped terrain file path.
+ * @param lonMin     Western edge of the area.
+ * @param lonMax     Eastern edge of the area.
+ * @param latMin     Southern edge of the area.
+ * @param latMax     Northern edge of the area.
+ *
+ * @exception std Thrown when the area is outside of the terrain or operation failed.
+ *
+ * @return The size of the clipped terrain file.
+ */
+std::uint64_t condor2nav::CLKTerrain::Clip(const bfs::path &outputPath, TLongitude lonMin, TLongitude lonMax, TLatitude latMin, TLatitude latMax) const
+{
+  const auto &header = *_header;
+  if(lonMax.value < header.left || lonMin.value > header.right || latMax.value < header.bottom || latMin.value > header.top)
+    throw EOperationFailed{"ERROR: Task area is outside of the terrain!!!"};
+
+  // raster cells touched by the area
+  auto index = [](double value, std::int32_t count)
+  {
+    return static_cast<std::int32_t>(std::max(0.0, std::min(count - 1.0, value)));
+  };
+  const auto colMin = index(std::floor((lonMin.value - header.left) / header.stepSize), header.columns);
+  const auto colMax = index(std::ceil((lonMax.value - header.left) / header.stepSize), header.columns);
+  const auto rowMin = index(std::floor((header.top - latMax.value) / header.stepSize), header.rows);
+  const auto rowMax = index(std::ceil((header.top - latMin.value) / header.stepSize), header.rows);
+
+  // edges are moved by whole raster steps to keep the original georeferencing
+  THeader clipped{header};
+  clipped.left   = header.left + colMin * header.stepSize;
+  clipped.right  = header.right - (header.columns - 1 - colMax) * header.stepSize;
+  clipped.top    = header.top - rowMin * header.stepSize;
+  clipped.bottom = header.bottom + (header.rows - 1 - rowMax) * header.stepSize;
+  clipped.rows    = rowMax - rowMin + 1;
+  clipped.columns = colMax - colMin + 1;
+
+  COStream output{outputPath};
+  output.Write(reinterpret_cast<const char *>(&clipped), sizeof(clipped));
+  const auto rowSize = static_cast<std::streamsize>(clipped.columns * sizeof(std::int16_t));
+  for(auto row=rowMin; row<=rowMax; row++)
+    output.Write(reinterpret_cast<const char *>(_raster + std::uint64_t(row) * header.columns + colMin), rowSize);
+  output.Commit();
+
+  return sizeof(clipped) + std::uint64_t(clipped.rows) * rowSize;
+}
@@ -0,0 +1,80 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file lkTerrain.h
+ *
+ * @brief Declares the condor2nav::CLKTerrain class. 
+ */
+
+#ifndef __LKTERRAIN_H__
+#define __LKTERRAIN_H__
+
+#include "nonCopyable.h"
+#include "tools.h"
+#include "boostfwd.h"
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace condor2nav {
+
+  /**
+   * @brief LK8000 terrain file.
+   *
+   * condor2nav::CLKTerrain provides access to LK8000 DEM terrain file. The file
+   * consists of a header followed by a raster of 16-bit altitudes stored row by
+   * row from the north-west corner. The file is memory mapped so that only the
+   * rows that are needed to clip the terrain to an area are read from disk.
+   */
+  class CLKTerrain : CNonCopyable {
+  public:
+    /**
+     * @brief DEM file header.
+     */
+    struct THeader {
+      double left;                        ///< @brief Western edge longitude
+      double right;                       ///< @brief Eastern edge longitude
+      double top;                         ///< @brief Northern edge latitude
+      double bottom;                      ///< @brief Southern edge latitude
+      double stepSize;                    ///< @brief Raster step in degrees
+      std::int32_t rows;                  ///< @brief The number of raster rows
+      std::int32_t columns;               ///< @brief The number of raster columns
+    };
+
+  private:
+    struct TMapping;
+
+    std::unique_ptr<TMapping> _mapping;   ///< @brief Mapped terrain file
+    const THeader *_header;               ///< @brief Terrain file header
+    const std::int16_t *_raster;          ///< @brief Terrain altitudes
+
+  public:
+    explicit CLKTerrain(const bfs::path &path);
+    ~CLKTerrain();
+
+    const THeader &Header() const { return *_header; }
+    std::uint64_t Clip(const bfs::path &outputPath, TLongitude lonMin, TLongitude lonMax, TLatitude latMin, TLatitude latMax) const;
+  };
+
+}
+
+#endif /* __LKTERRAIN_H__ */
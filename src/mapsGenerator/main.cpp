@@ -0,0 +1,291 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file mapsGenerator/main.cpp
+ *
+ * @brief Implements LK8000 landscapes templates generator.
+ *
+ * Generator computes the bounding box of every installed Condor landscape and
+ * writes LK8000 map template used for matching LK8000 maps to landscapes.
+ * NaviCon.dll keeps the terrain of only one landscape so every landscape is
+ * processed by a separate worker process and workers are run in parallel.
+ */
+
+#include "condor.h"
+#include "fileParserINI.h"
+#include "ostream.h"
+#include "tools.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <windows.h>
+
+
+namespace {
+
+  const bfs::path OUTPUT_DIR = "data/LK8000/Landscapes";
+  const std::string WORKER_OPTION = "--worker";
+
+
+  /**
+   * @brief Prints generator usage.
+   */
+  void Usage()
+  {
+    std::cout << "Usage: condor2nav-maps [LANDSCAPE_NAME...]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Generates LK8000 templates of provided (or all installed) Condor landscapes." << std::endl;
+  }
+
+
+  /**
+   * @brief Returns the string with a coordinate rounded to 0.1 degree.
+   *
+   * @param value Coordinate to convert.
+   *
+   * @return Coordinate string.
+   */
+  std::string Coord(double value)
+  {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(1) << value;
+    return stream.str();
+  }
+
+
+  /**
+   * @brief Calculates great circle distance between two points.
+   *
+   * @return Distance in km.
+   */
+  double Distance(double lat1, double lon1, double lat2, double lon2)
+  {
+    const double dLat = condor2nav::Deg2Rad(lat2 - lat1);
+    const double dLon = condor2nav::Deg2Rad(lon2 - lon1);
+    const double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+                     std::cos(condor2nav::Deg2Rad(lat1)) * std::cos(condor2nav::Deg2Rad(lat2)) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 6371 * 2 * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+  }
+
+
+  /**
+   * @brief Returns LK8000 server map zone for a landscape.
+   *
+   * @param lonMin Western edge of the landscape.
+   * @param latMin Southern edge of the landscape.
+   *
+   * @return Map zone name.
+   */
+  const char *MapZone(double lonMin, double latMin)
+  {
+    if(lonMin < -30)
+      return latMin > 10 ? "NAM" : "SAM";
+    if(latMin < 35 && lonMin < 50)
+      return "AFR";
+    if(latMin < -10)
+      return "AUS";
+    if((latMin >= 35 && lonMin < 40) || latMin > 50)
+      return "EUR";
+    return "ASO";
+  }
+
+
+  /**
+   * @brief Generates LK8000 template of one landscape.
+   *
+   * Function is run in a worker process as NaviCon.dll supports only one
+   * landscape in a process.
+   *
+   * @param condorPath Condor installation directory.
+   * @param landscape  The name of the landscape.
+   *
+   * @exception std Thrown when operation failed.
+   */
+  void TemplateGenerate(const bfs::path &condorPath, const std::string &landscape)
+  {
+    const condor2nav::CFileParserINI landscapeParser{condorPath / "Landscapes" / landscape / (landscape + ".ini")};
+    const auto name = landscape + "_" + landscapeParser.Value("General", "Version");
+
+    // convert all landscape corners
+    const condor2nav::CCondor::CCoordConverter coordConv{condorPath, landscape};
+    const auto maxX = coordConv.MaxX();
+    const auto maxY = coordConv.MaxY();
+    const auto corners = coordConv.Positions({{0, 0}, {maxX, 0}, {0, maxY}, {maxX, maxY}});
+    double lonMin = corners.front().longitude.value, lonMax = lonMin;
+    double latMin = corners.front().latitude.value,  latMax = latMin;
+    for(const auto &pos : corners) {
+      lonMin = std::min(lonMin, pos.longitude.value);
+      lonMax = std::max(lonMax, pos.longitude.value);
+      latMin = std::min(latMin, pos.latitude.value);
+      latMax = std::max(latMax, pos.latitude.value);
+    }
+    lonMin = std::floor(lonMin * 10) / 10;
+    lonMax = std::ceil(lonMax * 10) / 10;
+    latMin = std::floor(latMin * 10) / 10;
+    latMax = std::ceil(latMax * 10) / 10;
+
+    // select terrain resolution for the landscape size
+    const auto area = Distance(latMax, lonMin, latMax, lonMax) * Distance(latMin, lonMin, latMax, lonMin);
+    const auto res = area < 270 * 270 ? 250 : area < 540 * 540 ? 500 : 1000;
+
+    condor2nav::COStream output{OUTPUT_DIR / (name + ".TXT")};
+    output << "NAME=" << name << "\n";
+    output << "DIR=CONDOR\n";
+    output << "\n";
+    output << "LONMIN=" << Coord(lonMin) << "\n";
+    output << "LONMAX=" << Coord(lonMax) << "\n";
+    output << "LATMIN=" << Coord(latMin) << "\n";
+    output << "LATMAX=" << Coord(latMax) << "\n";
+    output << "\n";
+    output << "RES1000=" << (res == 1000 ? "YES" : "NO") << "\n";
+    output << "RES500=" << (res == 500 ? "YES" : "NO") << "\n";
+    output << "RES250=" << (res == 250 ? "YES" : "NO") << "\n";
+    output << "RES90=NO\n";
+    output << "\n";
+    output << "TOPOLOGY=YES\n";
+    output << "XTOPOLOGY=YES\n";
+    output << "MAPZONE=" << MapZone(lonMin, latMin) << "\n";
+    output << "\n";
+    output << "#REM: Condor landscape: " << name << "\n";
+    output.Commit();
+  }
+
+
+  /**
+   * @brief Runs worker processes for all the landscapes.
+   *
+   * @param exePath    The path of the generator executable.
+   * @param landscapes The names of the landscapes.
+   *
+   * @return The number of failed landscapes.
+   */
+  unsigned WorkersRun(const bfs::path &exePath, const std::vector<std::string> &landscapes)
+  {
+    const auto workersNum = std::max(1u, std::min(std::thread::hardware_concurrency(), unsigned{MAXIMUM_WAIT_OBJECTS}));
+
+    struct TWorker {
+      HANDLE process;
+      std::string landscape;
+    };
+    std::vector<TWorker> workers;
+    unsigned failed = 0;
+
+    // wait for any worker to finish
+    auto wait = [&]
+    {
+      std::vector<HANDLE> handles;
+      for(const auto &w : workers)
+        handles.push_back(w.process);
+      const auto ret = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+      const auto idx = ret - WAIT_OBJECT_0;
+      if(idx >= handles.size())
+        throw condor2nav::EOperationFailed{"ERROR: Unable to wait for worker processes!!!"};
+
+      DWORD exitCode = EXIT_FAILURE;
+      GetExitCodeProcess(workers[idx].process, &exitCode);
+      CloseHandle(workers[idx].process);
+      if(exitCode == EXIT_SUCCESS)
+        std::cout << " - " << workers[idx].landscape << std::endl;
+      else {
+        std::cerr << "ERROR: Landscape '" << workers[idx].landscape << "' template not generated!!!" << std::endl;
+        failed++;
+      }
+      workers.erase(workers.begin() + idx);
+    };
+
+    for(const auto &landscape : landscapes) {
+      if(workers.size() == workersNum)
+        wait();
+
+      auto cmdLine = L"\"" + exePath.wstring() + L"\" " + std::wstring{WORKER_OPTION.begin(), WORKER_OPTION.end()} + L" \"" + bfs::path{landscape}.wstring() + L"\"";
+      STARTUPINFOW si{};
+      si.cb = sizeof(si);
+      PROCESS_INFORMATION pi{};
+      if(!CreateProcessW(nullptr, &cmdLine[0], nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi)) {
+        std::cerr << "ERROR: Unable to start worker process for landscape '" << landscape << "'!!!" << std::endl;
+        failed++;
+        continue;
+      }
+      CloseHandle(pi.hThread);
+      workers.push_back(TWorker{pi.hProcess, landscape});
+    }
+    while(!workers.empty())
+      wait();
+
+    return failed;
+  }
+
+}
+
+
+/**
+ * @brief Main entry-point for this application.
+ *
+ * @param argc Number of command-line arguments. 
+ * @param argv Array of command-line argument strings. 
+ *
+ * @return Exit-code for the process - 0 for success, else an error code. 
+ */
+int main(int argc, const char *argv[])
+{
+  try {
+    const auto condorPath = condor2nav::condor::InstallPath();
+
+    if(argc == 3 && argv[1] == WORKER_OPTION) {
+      TemplateGenerate(condorPath, argv[2]);
+      return EXIT_SUCCESS;
+    }
+
+    std::vector<std::string> landscapes;
+    for(int i=1; i<argc; i++) {
+      if(argv[i][0] == '-') {
+        Usage();
+        return EXIT_FAILURE;
+      }
+      landscapes.emplace_back(argv[i]);
+    }
+    if(landscapes.empty()) {
+      std::for_each(bfs::directory_iterator(condorPath / "Landscapes"), bfs::directory_iterator(), [&](const bfs::path &p)
+      {
+        if(is_directory(p))
+          landscapes.emplace_back(p.filename().string());
+      });
+      std::sort(landscapes.begin(), landscapes.end());
+    }
+
+    condor2nav::DirectoryCreate(OUTPUT_DIR);
+    std::cout << "Generating " << landscapes.size() << " LK8000 landscapes templates..." << std::endl;
+
+    wchar_t exePath[MAX_PATH];
+    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+    return WorkersRun(exePath, landscapes) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  catch(const std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,141 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file memoryAccount.cpp
+ *
+ * @brief Implements memory accounting classes (condor2nav::CMemoryAccount, condor2nav::CMemoryCharge). 
+ */
+
+#include "memoryAccount.h"
+#include <atomic>
+
+
+namespace {
+
+  // zero initialized before any dynamic initialization so buffers of static objects may be counted too
+  std::atomic<std::size_t> current[condor2nav::CMemoryAccount::SUBSYSTEMS_NUM];
+  std::atomic<std::size_t> peak[condor2nav::CMemoryAccount::SUBSYSTEMS_NUM];
+  std::atomic<std::size_t> totalCurrent;
+  std::atomic<std::size_t> totalPeak;
+
+  /**
+   * @brief Raises the peak value if needed.
+   *
+   * @param peakValue Peak value to update.
+   * @param value     Current value.
+   */
+  void PeakUpdate(std::atomic<std::size_t> &peakValue, std::size_t value)
+  {
+    auto prev = peakValue.load();
+    while(prev < value && !peakValue.compare_exchange_weak(prev, value))
+      ;
+  }
+
+}
+
+
+/**
+ * @brief Charges a subsystem with allocated memory.
+ *
+ * @param subsystem Subsystem to charge.
+ * @param bytes     The number of allocated bytes.
+ */
+void condor2nav::CMemoryAccount::Allocated(TMemorySubsystem subsystem, std::size_t bytes)
+{
+  const auto i = static_cast<unsigned>(subsystem);
+  PeakUpdate(peak[i], current[i] += bytes);
+  PeakUpdate(totalPeak, totalCurrent += bytes);
+}
+
+
+/**
+ * @brief Releases memory charged to a subsystem.
+ *
+ * @param subsystem Charged subsystem.
+ * @param bytes     The number of released bytes.
+ */
+void condor2nav::CMemoryAccount::Released(TMemorySubsystem subsystem, std::size_t bytes)
+{
+  current[static_cast<unsigned>(subsystem)] -= bytes;
+  totalCurrent -= bytes;
+}
+
+
+/**
+ * @brief Returns memory usage of a subsystem.
+ *
+ * @param subsystem Subsystem to check.
+ *
+ * @return Memory usage.
+ */
+auto condor2nav::CMemoryAccount::Usage(TMemorySubsystem subsystem) -> TUsage
+{
+  const auto i = static_cast<unsigned>(subsystem);
+  return TUsage{current[i].load(), peak[i].load()};
+}
+
+
+/**
+ * @brief Returns memory usage of all the subsystems.
+ *
+ * @return Memory usage.
+ */
+auto condor2nav::CMemoryAccount::Total() -> TUsage
+{
+  return TUsage{totalCurrent.load(), totalPeak.load()};
+}
+
+
+/**
+ * @brief Returns subsystem name.
+ *
+ * @param subsystem Subsystem to check.
+ *
+ * @return Subsystem name.
+ */
+const char *condor2nav::CMemoryAccount::Name(TMemorySubsystem subsystem)
+{
+  switch(subsystem) {
+  case TMemorySubsystem::PARSERS:
+    return "parsers";
+  case TMemorySubsystem::NETWORK:
+    return "network";
+  case TMemorySubsystem::OUTPUT:
+    return "output buffers";
+  }
+  return "";
+}
+
+
+/**
+ * @brief Sets the number of bytes charged.
+ *
+ * @param bytes Object footprint.
+ */
+void condor2nav::CMemoryCharge::Set(std::size_t bytes)
+{
+  if(bytes > _bytes)
+    CMemoryAccount::Allocated(_subsystem, bytes - _bytes);
+  else
+    CMemoryAccount::Released(_subsystem, _bytes - bytes);
+  _bytes = bytes;
+}
@@ -0,0 +1,149 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file memoryAccount.h
+ *
+ * @brief Declares memory accounting classes (condor2nav::CMemoryAccount, condor2nav::CCountingAllocator). 
+ */
+
+#ifndef __MEMORY_ACCOUNT_H__
+#define __MEMORY_ACCOUNT_H__
+
+#include "nonCopyable.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace condor2nav {
+
+  /**
+   * @brief Subsystems which memory usage is accounted.
+   */
+  enum class TMemorySubsystem {
+    PARSERS,              ///< @brief INI and CSV files content
+    NETWORK,              ///< @brief Data downloaded from the server or read from ActiveSync device
+    OUTPUT                ///< @brief Output files buffers
+  };
+
+  /**
+   * @brief Memory usage accounting.
+   *
+   * condor2nav::CMemoryAccount class keeps current and peak memory usage of
+   * application subsystems. Buffers are counted with condor2nav::CCountingAllocator
+   * and composite objects (i.e. parsers) charge their footprint with
+   * condor2nav::CMemoryCharge.
+   *
+   * @note All the methods are thread-safe
+   */
+  class CMemoryAccount {
+  public:
+    static const unsigned SUBSYSTEMS_NUM = 3;     ///< @brief The number of accounted subsystems
+
+    /**
+     * @brief Memory usage.
+     */
+    struct TUsage {
+      std::size_t current;                        ///< @brief Bytes used now
+      std::size_t peak;                           ///< @brief The maximum number of bytes used
+    };
+
+    static void Allocated(TMemorySubsystem subsystem, std::size_t bytes);
+    static void Released(TMemorySubsystem subsystem, std::size_t bytes);
+    static TUsage Usage(TMemorySubsystem subsystem);
+    static TUsage Total();
+    static const char *Name(TMemorySubsystem subsystem);
+
+    /**
+     * @brief Returns the size of string data allocated on the heap.
+     *
+     * @param str String to check.
+     *
+     * @return The number of bytes (0 for strings stored inside of the object).
+     */
+    static std::size_t Heap(const std::string &str) { return str.capacity() > std::string{}.capacity() ? str.capacity() + 1 : 0; }
+  };
+
+
+  /**
+   * @brief Allocator counting memory of a subsystem.
+   *
+   * @tparam T         Allocated type.
+   * @tparam Subsystem Subsystem charged with allocated memory.
+   */
+  template<class T, TMemorySubsystem Subsystem>
+  class CCountingAllocator : public std::allocator<T> {
+  public:
+    template<class U>
+    struct rebind {
+      using other = CCountingAllocator<U, Subsystem>;
+    };
+
+    CCountingAllocator() {}
+    CCountingAllocator(const CCountingAllocator &) {}
+    template<class U>
+    CCountingAllocator(const CCountingAllocator<U, Subsystem> &) {}
+
+    T *allocate(std::size_t n, const void * = nullptr)
+    {
+      auto ptr = std::allocator<T>::allocate(n);
+      CMemoryAccount::Allocated(Subsystem, n * sizeof(T));
+      return ptr;
+    }
+
+    void deallocate(T *ptr, std::size_t n)
+    {
+      std::allocator<T>::deallocate(ptr, n);
+      CMemoryAccount::Released(Subsystem, n * sizeof(T));
+    }
+  };
+
+  template<class T, class U, TMemorySubsystem Subsystem>
+  bool operator==(const CCountingAllocator<T, Subsystem> &, const CCountingAllocator<U, Subsystem> &) { return true; }
+  template<class T, class U, TMemorySubsystem Subsystem>
+  bool operator!=(const CCountingAllocator<T, Subsystem> &, const CCountingAllocator<U, Subsystem> &) { return false; }
+
+  /**
+   * @brief String which memory is charged to a subsystem.
+   */
+  template<TMemorySubsystem Subsystem>
+  using CCountedString = std::basic_string<char, std::char_traits<char>, CCountingAllocator<char, Subsystem>>;
+
+
+  /**
+   * @brief Memory charge of an object.
+   *
+   * condor2nav::CMemoryCharge class charges a subsystem with the footprint
+   * of an object for the lifetime of the charge.
+   */
+  class CMemoryCharge : CNonCopyable {
+    const TMemorySubsystem _subsystem;            ///< @brief Charged subsystem
+    std::size_t _bytes;                           ///< @brief Charged bytes
+  public:
+    explicit CMemoryCharge(TMemorySubsystem subsystem) : _subsystem{subsystem}, _bytes{0} {}
+    ~CMemoryCharge() { CMemoryAccount::Released(_subsystem, _bytes); }
+    void Set(std::size_t bytes);
+    std::size_t Bytes() const { return _bytes; }
+  };
+
+}
+
+#endif /* __MEMORY_ACCOUNT_H__ */
@@ -0,0 +1,147 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file nameNoCase.cpp
+ *
+ * @brief Implements the condor2nav::CNameNoCase class. 
+ */
+
+#include "nameNoCase.h"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace {
+
+  std::mutex poolMutex;
+
+  /**
+   * @brief Returns the upper case version of the character.
+   *
+   * Characters are folded the same way as in condor2nav::CTraitsNoCase.
+   *
+   * @param ch The character to fold.
+   *
+   * @return Folded character.
+   */
+  inline char Fold(char ch)
+  {
+    return static_cast<char>(std::toupper(ch));
+  }
+
+}
+
+
+/**
+ * @brief Returns the interned name.
+ *
+ * Method adds the name and its folded key to the pool if they were not
+ * interned before.
+ *
+ * @param name The name to intern.
+ *
+ * @return Interned name.
+ */
+auto condor2nav::CNameNoCase::Intern(boost::string_ref name) -> const TName *
+{
+  /**
+   * @brief The pool of interned names.
+   *
+   * Unordered maps nodes are never moved so pointers to them stay valid.
+   */
+  struct TPool {
+    std::unordered_map<std::string, TKey> keys;
+    std::unordered_map<std::string, TName> names;
+  };
+
+  // function local statics initialization is not thread-safe in VS2013
+  std::lock_guard<std::mutex> lock{poolMutex};
+  static TPool pool;
+
+  auto str = name.to_string();
+  auto it = pool.names.find(str);
+  if(it != pool.names.end())
+    return &it->second;
+
+  auto folded = str;
+  for(auto &ch : folded)
+    ch = Fold(ch);
+  auto &key = pool.keys[folded];
+  if(key.folded.empty() && !folded.empty()) {
+    key.hash = std::hash<std::string>{}(folded);
+    key.folded = std::move(folded);
+  }
+  auto &interned = pool.names[str];
+  interned.name = std::move(str);
+  interned.key = &key;
+  return &interned;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CNameNoCase class constructor that creates an empty name.
+ */
+condor2nav::CNameNoCase::CNameNoCase() :
+  _name{Intern("")}
+{
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CNameNoCase class constructor.
+ *
+ * @param name The name to intern.
+ */
+condor2nav::CNameNoCase::CNameNoCase(boost::string_ref name) :
+  _name{Intern(name)}
+{
+}
+
+
+/**
+ * @brief Compares the name with a string in case-insensitive manner.
+ *
+ * The order is the same as the order of the names.
+ *
+ * @param name The string to compare with.
+ *
+ * @return Negative if the name is less than @p name, 0 if they are equal, or positive if it is
+ *         greater. 
+ */
+int condor2nav::CNameNoCase::Compare(boost::string_ref name) const
+{
+  const auto &folded = Key().folded;
+  const auto size = std::min(folded.size(), name.size());
+  for(std::size_t i = 0; i < size; ++i) {
+    const auto ch1 = static_cast<unsigned char>(folded[i]);
+    const auto ch2 = static_cast<unsigned char>(Fold(name[i]));
+    if(ch1 != ch2)
+      return ch1 < ch2 ? -1 : +1;
+  }
+  return folded.size() < name.size() ? -1 : folded.size() > name.size() ? +1 : 0;
+}
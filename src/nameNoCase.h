@@ -0,0 +1,157 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file nameNoCase.h
+ *
+ * @brief Declares the condor2nav::CNameNoCase class. 
+ */
+
+#ifndef __NAMENOCASE_H__
+#define __NAMENOCASE_H__
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <boost/utility/string_ref.hpp>
+
+namespace condor2nav {
+
+  /**
+   * @brief Interned case-insensitive name.
+   *
+   * condor2nav::CNameNoCase keeps the name in a global pool together with
+   * its case-folded version and hash that are computed only once. Names that
+   * differ only in case share the same folded key so comparing them for
+   * equality compares pointers and ordering compares folded keys with memcmp.
+   * The original spelling of a name is preserved (i.e. for file names and URLs).
+   *
+   * @note Interned names are never released so the class should be used only
+   *       for the limited sets of names (i.e. landscapes and maps templates).
+   */
+  class CNameNoCase {
+  public:
+    /**
+     * @brief Case-folded key of the name.
+     */
+    struct TKey {
+      std::string folded;                 ///< @brief Upper case version of the name
+      std::size_t hash;                   ///< @brief Hash of the folded name
+    };
+
+  private:
+    /**
+     * @brief Interned name.
+     */
+    struct TName {
+      std::string name;                   ///< @brief Original spelling of the name
+      const TKey *key;                    ///< @brief Case-folded key
+    };
+
+    const TName *_name;                   ///< @brief Interned name
+
+    static const TName *Intern(boost::string_ref name);
+
+  public:
+    CNameNoCase();
+    explicit CNameNoCase(boost::string_ref name);
+
+    const std::string &str() const { return _name->name; }
+    const char *c_str() const { return _name->name.c_str(); }
+    std::size_t size() const { return _name->name.size(); }
+    bool empty() const { return _name->name.empty(); }
+    const TKey &Key() const { return *_name->key; }
+    int Compare(boost::string_ref name) const;
+  };
+
+
+  /**
+   * @brief Compares 2 names in case-insensitive manner.
+   *
+   * @param n1 The first name to compare. 
+   * @param n2 The second name to compare. 
+   *
+   * @return true if both names are the same.
+   */
+  inline bool operator==(const CNameNoCase &n1, const CNameNoCase &n2)
+  {
+    return &n1.Key() == &n2.Key();
+  }
+
+
+  /**
+   * @brief Compares 2 names in case-insensitive manner.
+   *
+   * @param n1 The first name to compare. 
+   * @param n2 The second name to compare. 
+   *
+   * @return true if names are different.
+   */
+  inline bool operator!=(const CNameNoCase &n1, const CNameNoCase &n2)
+  {
+    return !(n1 == n2);
+  }
+
+
+  /**
+   * @brief Compares 2 names in case-insensitive manner.
+   *
+   * @param n1 The first name to compare. 
+   * @param n2 The second name to compare. 
+   *
+   * @return true if name 1 is smaller than name 2.
+   */
+  inline bool operator<(const CNameNoCase &n1, const CNameNoCase &n2)
+  {
+    return n1 != n2 && n1.Key().folded < n2.Key().folded;
+  }
+
+
+  /**
+   * @brief Dumps the name to a stream. 
+   *
+   * @param os   Output stream
+   * @param name Case-insensitive name
+   *
+   * @return Output stream. 
+   */
+  inline std::ostream &operator<<(std::ostream &os, const CNameNoCase &name)
+  {
+    return os << name.str();
+  }
+
+}
+
+
+namespace std {
+
+  /**
+   * @brief Hash of case-insensitive name.
+   */
+  template<>
+  struct hash<condor2nav::CNameNoCase> {
+    std::size_t operator()(const condor2nav::CNameNoCase &name) const { return name.Key().hash; }
+  };
+
+}
+
+#endif /* __NAMENOCASE_H__ */
@@ -0,0 +1,319 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file namedPipe.cpp
+ *
+ * @brief Implements the condor2nav::CNamedPipe class. 
+ */
+
+#include "namedPipe.h"
+
+
+const unsigned condor2nav::CNamedPipe::POLL_INTERVAL;
+const unsigned condor2nav::CNamedPipe::BUFFER_SIZE;
+
+
+/**
+ * @brief Connects to a server end of the pipe.
+ *
+ * @param name    Pipe name.
+ * @param timeout Time in ms to wait for a busy server.
+ *
+ * @exception std Thrown when operation failed to execute.
+ *
+ * @return Client end of the pipe or nullptr if there is no server running.
+ */
+auto condor2nav::CNamedPipe::Connect(const std::string &name, unsigned timeout) -> std::unique_ptr<CNamedPipe>
+{
+  while(true) {
+    auto handle = CreateFile(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+    if(handle != INVALID_HANDLE_VALUE)
+      return std::unique_ptr<CNamedPipe>{new CNamedPipe{name, handle}};
+
+    // server is serving another client
+    const auto error = GetLastError();
+    if(error != ERROR_PIPE_BUSY)
+      return nullptr;
+    if(!WaitNamedPipe(name.c_str(), timeout)) {
+      if(GetLastError() == ERROR_SEM_TIMEOUT)
+        throw EOperationFailed{"ERROR: Timeout while connecting to pipe '" + name + "'!!!"};
+      return nullptr;
+    }
+  }
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Creates a client end of the pipe.
+ *
+ * @param name Pipe name.
+ * @param pipe Connected pipe handle.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+condor2nav::CNamedPipe::CNamedPipe(std::string name, HANDLE pipe) :
+  _name{std::move(name)}, _pipe{pipe}, _event{CreateEvent(nullptr, TRUE, FALSE, nullptr)}, _server{false}
+{
+  if(!_event)
+    throw EOperationFailed{"ERROR: Unable to create event for pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Creates a server end of the pipe. Only one server may exist for a pipe name.
+ *
+ * @param name Pipe name.
+ *
+ * @exception std Thrown when operation failed to execute.
+ */
+condor2nav::CNamedPipe::CNamedPipe(std::string name) :
+  _name{std::move(name)}, _server{true}
+{
+  auto handle = CreateNamedPipe(_name.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                1, BUFFER_SIZE, BUFFER_SIZE, 0, nullptr);
+  if(handle == INVALID_HANDLE_VALUE)
+    throw EOperationFailed{"ERROR: Unable to create pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+  _pipe.reset(handle);
+  _event.reset(CreateEvent(nullptr, TRUE, FALSE, nullptr));
+  if(!_event)
+    throw EOperationFailed{"ERROR: Unable to create event for pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Disconnects the client of a server end of the pipe.
+ */
+condor2nav::CNamedPipe::~CNamedPipe()
+{
+  if(_server)
+    DisconnectNamedPipe(_pipe.get());
+}
+
+
+/**
+ * @brief Waits for a client connection.
+ *
+ * @param cancel Token used to cancel the wait.
+ *
+ * @exception EOperationCancelled Thrown when the wait was cancelled.
+ * @exception std Thrown when operation failed to execute.
+ */
+void condor2nav::CNamedPipe::Accept(const CCancellationToken &cancel)
+{
+  OVERLAPPED overlapped;
+  Prepare(overlapped);
+  if(!ConnectNamedPipe(_pipe.get(), &overlapped)) {
+    switch(GetLastError()) {
+    case ERROR_PIPE_CONNECTED:
+      return;
+    case ERROR_IO_PENDING:
+      break;
+    default:
+      throw EOperationFailed{"ERROR: Unable to wait for a client of pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+    }
+  }
+
+  while(true) {
+    if(cancel.Cancelled()) {
+      DWORD bytes;
+      if(CancelIo(_pipe.get()))
+        GetOverlappedResult(_pipe.get(), &overlapped, &bytes, TRUE);
+      cancel.ThrowIfCancelled();
+    }
+    const auto status = WaitForSingleObject(_event.get(), POLL_INTERVAL);
+    if(status == WAIT_OBJECT_0) {
+      DWORD bytes;
+      if(!GetOverlappedResult(_pipe.get(), &overlapped, &bytes, FALSE))
+        throw EOperationFailed{"ERROR: Unable to wait for a client of pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+      return;
+    }
+    if(status == WAIT_FAILED)
+      throw EOperationFailed{"ERROR: Unable to wait for a client of pipe '" + _name + "' (error: " + Convert(GetLastError()) + ")!!!"};
+  }
+}
+
+
+/**
+ * @brief Disconnects current client.
+ *
+ * Method waits until the client reads all the data written to the pipe.
+ */
+void condor2nav::CNamedPipe::Disconnect()
+{
+  FlushFileBuffers(_pipe.get());
+  DisconnectNamedPipe(_pipe.get());
+  _buffer.clear();
+}
+
+
+/**
+ * @brief Prepares an overlapped structure for the next transfer.
+ *
+ * @param [out] overlapped Overlapped structure to prepare.
+ */
+void condor2nav::CNamedPipe::Prepare(OVERLAPPED &overlapped) const
+{
+  ZeroMemory(&overlapped, sizeof(overlapped));
+  overlapped.hEvent = _event.get();
+  ResetEvent(_event.get());
+}
+
+
+/**
+ * @brief Waits for a transfer to complete.
+ *
+ * Pending transfer is cancelled with CancelIo() (CancelIoEx() is not
+ * available on Windows XP) and waited for before an exception is thrown,
+ * so that the overlapped structure is not used after it is released.
+ *
+ * @param status     Status returned by the transfer request.
+ * @param overlapped Overlapped structure of the transfer.
+ * @param cancel     Token used to cancel the transfer.
+ * @param timeout    Max time to wait for the transfer [ms].
+ *
+ * @exception EOperationCancelled Thrown when the transfer was cancelled.
+ * @exception std Thrown when the transfer timed out.
+ *
+ * @return Number of bytes transferred or 0 if the other end disconnected.
+ */
+DWORD condor2nav::CNamedPipe::Complete(BOOL status, OVERLAPPED &overlapped, const CCancellationToken &cancel, unsigned timeout) const
+{
+  if(!status && GetLastError() != ERROR_IO_PENDING)
+    return 0;
+  DWORD bytes = 0;
+  for(unsigned waited = 0; ; waited += POLL_INTERVAL) {
+    const auto wait = WaitForSingleObject(_event.get(), POLL_INTERVAL);
+    if(wait == WAIT_OBJECT_0)
+      break;
+    if(wait == WAIT_FAILED || cancel.Cancelled() || (timeout != INFINITE && waited + POLL_INTERVAL >= timeout)) {
+      const auto error = wait == WAIT_FAILED ? GetLastError() : ERROR_SUCCESS;
+      if(CancelIo(_pipe.get()))
+        GetOverlappedResult(_pipe.get(), &overlapped, &bytes, TRUE);
+      cancel.ThrowIfCancelled();
+      if(error != ERROR_SUCCESS)
+        throw EOperationFailed{"ERROR: Unable to wait for transfer on pipe '" + _name + "' (error: " + Convert(error) + ")!!!"};
+      throw EOperationFailed{"ERROR: Timeout while waiting for transfer on pipe '" + _name + "'!!!"};
+    }
+  }
+  if(!GetOverlappedResult(_pipe.get(), &overlapped, &bytes, FALSE))
+    return 0;
+  return bytes;
+}
+
+
+/**
+ * @brief Reads next portion of data from the pipe to the buffer.
+ *
+ * @param cancel  Token used to cancel the read.
+ * @param timeout Max time to wait for the data [ms].
+ *
+ * @exception EOperationCancelled Thrown when the read was cancelled.
+ * @exception std Thrown when the read timed out.
+ *
+ * @return @p false if the other end disconnected.
+ */
+bool condor2nav::CNamedPipe::Fill(const CCancellationToken &cancel, unsigned timeout)
+{
+  char data[4096];
+  OVERLAPPED overlapped;
+  Prepare(overlapped);
+  const auto bytes = Complete(ReadFile(_pipe.get(), data, sizeof(data), nullptr, &overlapped), overlapped, cancel, timeout);
+  _buffer.append(data, bytes);
+  return bytes > 0;
+}
+
+
+/**
+ * @brief Reads a text line from the pipe.
+ *
+ * @param [out] line Line read without the end of line character.
+ * @param cancel     Token used to cancel the read.
+ * @param timeout    Max time to wait for every portion of the data [ms].
+ *
+ * @exception EOperationCancelled Thrown when the read was cancelled.
+ * @exception std Thrown when the read timed out.
+ *
+ * @return @p false if the other end disconnected before the end of the line.
+ */
+bool condor2nav::CNamedPipe::ReadLine(std::string &line, const CCancellationToken &cancel, unsigned timeout)
+{
+  std::string::size_type pos;
+  while((pos = _buffer.find('\n')) == std::string::npos)
+    if(!Fill(cancel, timeout))
+      return false;
+  line.assign(_buffer, 0, pos);
+  _buffer.erase(0, pos + 1);
+  return true;
+}
+
+
+/**
+ * @brief Reads a data block from the pipe.
+ *
+ * @param size       Size of the block.
+ * @param [out] data Data read.
+ * @param cancel     Token used to cancel the read.
+ * @param timeout    Max time to wait for every portion of the data [ms].
+ *
+ * @exception EOperationCancelled Thrown when the read was cancelled.
+ * @exception std Thrown when the read timed out.
+ *
+ * @return @p false if the other end disconnected before the end of the block.
+ */
+bool condor2nav::CNamedPipe::Read(std::size_t size, std::string &data, const CCancellationToken &cancel, unsigned timeout)
+{
+  while(_buffer.size() < size)
+    if(!Fill(cancel, timeout))
+      return false;
+  data.assign(_buffer, 0, size);
+  _buffer.erase(0, size);
+  return true;
+}
+
+
+/**
+ * @brief Writes data to the pipe.
+ *
+ * @param data Data to write.
+ *
+ * @return @p false if the other end disconnected.
+ */
+bool condor2nav::CNamedPipe::Write(const std::string &data)
+{
+  for(DWORD offset = 0; offset < data.size();) {
+    OVERLAPPED overlapped;
+    Prepare(overlapped);
+    const auto bytes = Complete(WriteFile(_pipe.get(), data.data() + offset, static_cast<DWORD>(data.size() - offset), nullptr, &overlapped), overlapped,
+                                CCancellationToken{}, INFINITE);
+    if(!bytes)
+      return false;
+    offset += bytes;
+  }
+  return true;
+}
@@ -0,0 +1,76 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file namedPipe.h
+ *
+ * @brief Declares the condor2nav::CNamedPipe class. 
+ */
+
+#ifndef __NAMEDPIPE_H__
+#define __NAMEDPIPE_H__
+
+#include "nonCopyable.h"
+#include "tools.h"
+#include "cancellation.h"
+#include <memory>
+#include <string>
+
+namespace condor2nav {
+
+  /**
+   * @brief Named pipe connection.
+   *
+   * condor2nav::CNamedPipe is one end of a local named pipe. Server end
+   * accepts clients one at a time. Waiting for a client may be cancelled.
+   * Both ends exchange text lines and raw data blocks. Reads may be
+   * cancelled and limited with a timeout.
+   */
+  class CNamedPipe : CNonCopyable {
+    static const unsigned POLL_INTERVAL = 200;           ///< @brief Max time between cancellation checks [ms]
+    static const unsigned BUFFER_SIZE = 64 * 1024;       ///< @brief Pipe buffers size [bytes]
+
+    const std::string _name;                             ///< @brief Pipe name
+    CHandleRes _pipe;                                    ///< @brief Pipe handle
+    CHandleRes _event;                                   ///< @brief Overlapped operations event
+    std::string _buffer;                                 ///< @brief Data read ahead of the current line
+    bool _server;                                        ///< @brief Server end of the pipe
+
+    CNamedPipe(std::string name, HANDLE pipe);
+    void Prepare(OVERLAPPED &overlapped) const;
+    DWORD Complete(BOOL status, OVERLAPPED &overlapped, const CCancellationToken &cancel, unsigned timeout) const;
+    bool Fill(const CCancellationToken &cancel, unsigned timeout);
+
+  public:
+    static std::unique_ptr<CNamedPipe> Connect(const std::string &name, unsigned timeout);
+
+    explicit CNamedPipe(std::string name);
+    ~CNamedPipe();
+    void Accept(const CCancellationToken &cancel);
+    void Disconnect();
+    bool ReadLine(std::string &line, const CCancellationToken &cancel = CCancellationToken{}, unsigned timeout = INFINITE);
+    bool Read(std::size_t size, std::string &data, const CCancellationToken &cancel = CCancellationToken{}, unsigned timeout = INFINITE);
+    bool Write(const std::string &data);
+  };
+
+}
+
+#endif /* __NAMEDPIPE_H__ */
@@ -0,0 +1,361 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file naviConPool.cpp
+ *
+ * @brief Implements the condor2nav::CNaviConPool class. 
+ */
+
+#include "naviConPool.h"
+#include "tools.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <windows.h>
+
+
+/* ******************************* N A V I C O N   W O R K E R ****************************** */
+
+namespace {
+
+  // Inheritable handles are inherited by every process started with bInheritHandles.
+  // Creation of child pipe ends and the process start are serialized so that workers
+  // started concurrently do not inherit the pipes of each other (which would prevent
+  // reads from failing when a worker dies). PROC_THREAD_ATTRIBUTE_HANDLE_LIST is not
+  // available on Windows XP.
+  std::mutex spawnMutex;
+
+}
+
+namespace condor2nav {
+
+  /**
+   * @brief NaviCon.dll worker process.
+   *
+   * condor2nav::CNaviConPool::CWorker starts the worker process for one landscape
+   * and exchanges conversion requests with it through its standard input and output.
+   */
+  class CNaviConPool::CWorker : CNonCopyable {
+    const std::string _condorPath;              ///< @brief The path to Condor directory.
+    const std::string _landscape;               ///< @brief The name of the landscape.
+    CHandleRes _process;                        ///< @brief Worker process.
+    CHandleRes _input;                          ///< @brief Write end of worker standard input.
+    CHandleRes _output;                         ///< @brief Read end of worker standard output.
+    TReady _ready;                              ///< @brief Worker ready message.
+    bool _alive;                                ///< @brief Worker process can handle requests.
+
+    void Read(void *data, size_t size);
+    void Write(const void *data, size_t size);
+
+  public:
+    std::mutex mutex;                           ///< @brief Serializes requests sent to the worker.
+
+    CWorker(const bfs::path &workerPath, const bfs::path &condorPath, const std::string &landscape);
+    ~CWorker();
+    bool Match(const bfs::path &condorPath, const std::string &landscape) const { return _alive && _landscape == landscape && _condorPath == condorPath.string(); }
+    const TReady &Ready() const { return _ready; }
+    std::vector<float> Convert(const std::vector<float> &points);
+  };
+
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CNaviConPool::CWorker class constructor that starts the worker
+ * process and waits until NaviCon.dll is initialized with the landscape terrain.
+ *
+ * @param workerPath The path of the worker executable.
+ * @param condorPath The path to Condor directory.
+ * @param landscape  The name of the landscape.
+ *
+ * @exception std Thrown when operation failed.
+ */
+condor2nav::CNaviConPool::CWorker::CWorker(const bfs::path &workerPath, const bfs::path &condorPath, const std::string &landscape) :
+  _condorPath{condorPath.string()}, _landscape{landscape}, _ready{}, _alive{false}
+{
+  auto cmdLine = L"\"" + workerPath.wstring() + L"\" \"" + condorPath.wstring() + L"\" \"" + bfs::path{landscape}.wstring() + L"\"";
+  {
+    std::lock_guard<std::mutex> lock{spawnMutex};
+
+    HANDLE inRead, inWrite, outRead, outWrite;
+    if(!::CreatePipe(&inRead, &inWrite, nullptr, 0))
+      throw EOperationFailed{"ERROR: Unable to create NaviCon worker input pipe!!!"};
+    CHandleRes childInput{inRead};
+    _input.reset(inWrite);
+    if(!::CreatePipe(&outRead, &outWrite, nullptr, 0))
+      throw EOperationFailed{"ERROR: Unable to create NaviCon worker output pipe!!!"};
+    CHandleRes childOutput{outWrite};
+    _output.reset(outRead);
+
+    // only child ends of the pipes are inherited
+    if(!::SetHandleInformation(childInput.get(), HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT) ||
+       !::SetHandleInformation(childOutput.get(), HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT))
+      throw EOperationFailed{"ERROR: Unable to prepare NaviCon worker pipes!!!"};
+
+    STARTUPINFOW si{};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = childInput.get();
+    si.hStdOutput = childOutput.get();
+    si.hStdError = ::GetStdHandle(STD_ERROR_HANDLE);
+    PROCESS_INFORMATION pi{};
+    if(!::CreateProcessW(nullptr, &cmdLine[0], nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi))
+      throw EOperationFailed{"ERROR: Unable to start NaviCon worker process for landscape '" + landscape + "'!!!"};
+    ::CloseHandle(pi.hThread);
+    _process.reset(pi.hProcess);
+
+    // child ends are closed (before other workers are started) so that reads fail when the worker exits
+  }
+
+  _alive = true;
+  Read(&_ready, sizeof(_ready));
+  if(_ready.status) {
+    _alive = false;
+    throw EOperationFailed{"ERROR: NaviCon worker failed to initialize landscape '" + landscape + "'!!!"};
+  }
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Asks the worker process to finish and terminates it if it does not respond.
+ */
+condor2nav::CNaviConPool::CWorker::~CWorker()
+{
+  if(_alive) {
+    const std::uint32_t stop = 0;
+    DWORD written;
+    ::WriteFile(_input.get(), &stop, sizeof(stop), &written, nullptr);
+  }
+  _input.reset();
+  if(_process && ::WaitForSingleObject(_process.get(), 1000) != WAIT_OBJECT_0)
+    ::TerminateProcess(_process.get(), EXIT_FAILURE);
+}
+
+
+/**
+ * @brief Reads data from the worker.
+ *
+ * @param data Output buffer.
+ * @param size The number of bytes to read.
+ *
+ * @exception std Thrown when the worker process died.
+ */
+void condor2nav::CNaviConPool::CWorker::Read(void *data, size_t size)
+{
+  auto ptr = static_cast<char *>(data);
+  while(size) {
+    DWORD read = 0;
+    if(!::ReadFile(_output.get(), ptr, static_cast<DWORD>(size), &read, nullptr) || !read) {
+      _alive = false;
+      throw EOperationFailed{"ERROR: NaviCon worker for landscape '" + _landscape + "' stopped responding!!!"};
+    }
+    ptr += read;
+    size -= read;
+  }
+}
+
+
+/**
+ * @brief Writes data to the worker.
+ *
+ * @param data Data to write.
+ * @param size The number of bytes to write.
+ *
+ * @exception std Thrown when the worker process died.
+ */
+void condor2nav::CNaviConPool::CWorker::Write(const void *data, size_t size)
+{
+  DWORD written = 0;
+  if(!::WriteFile(_input.get(), data, static_cast<DWORD>(size), &written, nullptr) || written != size) {
+    _alive = false;
+    throw EOperationFailed{"ERROR: NaviCon worker for landscape '" + _landscape + "' stopped responding!!!"};
+  }
+}
+
+
+/**
+ * @brief Converts Condor coordinates in the worker process.
+ *
+ * @note Should be called with the worker mutex locked.
+ *
+ * @param points (x, y) pairs of Condor coordinates.
+ *
+ * @exception std Thrown when the worker process died.
+ *
+ * @return (longitude, latitude) pairs.
+ */
+std::vector<float> condor2nav::CNaviConPool::CWorker::Convert(const std::vector<float> &points)
+{
+  std::vector<char> request(sizeof(std::uint32_t) + points.size() * sizeof(float));
+  const auto count = static_cast<std::uint32_t>(points.size() / 2);
+  std::memcpy(request.data(), &count, sizeof(count));
+  if(!points.empty())
+    std::memcpy(request.data() + sizeof(count), points.data(), points.size() * sizeof(float));
+  Write(request.data(), request.size());
+
+  std::vector<float> values(points.size());
+  if(!values.empty())
+    Read(values.data(), values.size() * sizeof(float));
+  return values;
+}
+
+
+
+/* ********************************* N A V I C O N   P O O L ******************************** */
+
+const bfs::path condor2nav::CNaviConPool::WORKER_FILE_NAME = "condor2nav-navicon.exe";
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param workerPath The path of the worker executable.
+ * @param size       Max number of running workers.
+ */
+condor2nav::CNaviConPool::CNaviConPool(bfs::path workerPath, unsigned size) :
+  _workerPath{std::move(workerPath)}, _size{std::max(size, 1u)}
+{
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * NOTE: Destructor definition is needed here to make sure that CWorker is defined.
+ */
+condor2nav::CNaviConPool::~CNaviConPool()
+{
+}
+
+
+/**
+ * @brief Returns the worker for the landscape.
+ *
+ * Method returns already running worker or starts a new one. The least recently
+ * used workers that are not busy are stopped when the pool is full.
+ *
+ * @param condorPath The path to Condor directory.
+ * @param landscape  The name of the landscape.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Landscape worker.
+ */
+auto condor2nav::CNaviConPool::Worker(const bfs::path &condorPath, const std::string &landscape) const -> CWorkerPtr
+{
+  auto find = [&]
+  {
+    auto it = std::find_if(_workers.begin(), _workers.end(), [&](const CWorkerPtr &w){ return w->Match(condorPath, landscape); });
+    if(it == _workers.end())
+      return CWorkerPtr{};
+    _workers.splice(_workers.begin(), _workers, it);
+    return _workers.front();
+  };
+
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(auto worker = find())
+      return worker;
+  }
+
+  // landscape initialization takes time so do not block other landscapes
+  auto worker = std::make_shared<CWorker>(_workerPath, condorPath, landscape);
+
+  // evicted workers are stopped after the pool is unlocked (stopping waits for the process)
+  std::list<CWorkerPtr> evicted;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if(auto other = find())
+      return other;
+    _workers.push_front(worker);
+    for(auto it = _workers.end(); _workers.size() > _size && it != _workers.begin();) {
+      --it;
+      if(it->use_count() == 1) {
+        auto next = std::next(it);
+        evicted.splice(evicted.end(), _workers, it);
+        it = next;
+      }
+    }
+  }
+  return worker;
+}
+
+
+/**
+ * @brief Removes the worker from the pool.
+ *
+ * @param worker The worker to remove.
+ */
+void condor2nav::CNaviConPool::Remove(const CWorkerPtr &worker) const
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  _workers.remove(worker);
+}
+
+
+/**
+ * @brief Returns landscape max coordinates.
+ *
+ * @param condorPath The path to Condor directory.
+ * @param landscape  The name of the landscape.
+ * @param maxX       Landscape max X coordinate.
+ * @param maxY       Landscape max Y coordinate.
+ *
+ * @exception std Thrown when operation failed.
+ */
+void condor2nav::CNaviConPool::Max(const bfs::path &condorPath, const std::string &landscape, float &maxX, float &maxY) const
+{
+  auto worker = Worker(condorPath, landscape);
+  maxX = worker->Ready().maxX;
+  maxY = worker->Ready().maxY;
+}
+
+
+/**
+ * @brief Converts Condor coordinates to geographic positions.
+ *
+ * Method sends all the points to the landscape worker in one request.
+ * Requests for different landscapes are handled in parallel.
+ *
+ * @param condorPath The path to Condor directory.
+ * @param landscape  The name of the landscape.
+ * @param points     (x, y) pairs of Condor coordinates.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return (longitude, latitude) pairs.
+ */
+std::vector<float> condor2nav::CNaviConPool::Convert(const bfs::path &condorPath, const std::string &landscape, const std::vector<float> &points) const
+{
+  auto worker = Worker(condorPath, landscape);
+  try {
+    std::lock_guard<std::mutex> lock{worker->mutex};
+    return worker->Convert(points);
+  }
+  catch(const Exception &) {
+    Remove(worker);
+    throw;
+  }
+}
@@ -0,0 +1,93 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file naviConPool.h
+ *
+ * @brief Declares the condor2nav::CNaviConPool class. 
+ */
+
+#ifndef __NAVICONPOOL_H__
+#define __NAVICONPOOL_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include <boost/filesystem/path.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace condor2nav {
+
+  /**
+   * @brief NaviCon.dll worker processes pool.
+   *
+   * NaviCon.dll keeps the terrain of only one landscape in its global state so
+   * one process cannot convert coordinates of different landscapes concurrently.
+   * condor2nav::CNaviConPool runs a helper process (condor2nav-navicon.exe) for
+   * every landscape in use and sends batched conversion requests to it through
+   * anonymous pipes. Workers stay warm for the next requests of their landscapes.
+   * When the pool is full the least recently used idle worker is stopped.
+   *
+   * Requests protocol (binary, little endian):
+   * - worker writes TReady when NaviCon.dll is initialized with the landscape terrain,
+   * - request: the number of points (uint32) followed by (x, y) float pairs,
+   * - response: (longitude, latitude) float pairs,
+   * - request with 0 points stops the worker.
+   */
+  class CNaviConPool : CNonCopyable {
+  public:
+    /**
+     * @brief Worker ready message.
+     */
+    struct TReady {
+      std::uint32_t status;                   ///< @brief 0 if NaviCon.dll was initialized.
+      float maxX;                             ///< @brief Landscape max X coordinate.
+      float maxY;                             ///< @brief Landscape max Y coordinate.
+    };
+
+    static const bfs::path WORKER_FILE_NAME;  ///< @brief The name of the worker executable.
+
+  private:
+    class CWorker;
+    using CWorkerPtr = std::shared_ptr<CWorker>;
+
+    const bfs::path _workerPath;              ///< @brief The path of the worker executable.
+    const unsigned _size;                     ///< @brief Max number of running workers.
+    mutable std::mutex _mutex;                ///< @brief Protects workers list.
+    mutable std::list<CWorkerPtr> _workers;   ///< @brief Running workers (the most recently used first).
+
+    CWorkerPtr Worker(const bfs::path &condorPath, const std::string &landscape) const;
+    void Remove(const CWorkerPtr &worker) const;
+
+  public:
+    CNaviConPool(bfs::path workerPath, unsigned size);
+    ~CNaviConPool();
+    void Max(const bfs::path &condorPath, const std::string &landscape, float &maxX, float &maxY) const;
+    std::vector<float> Convert(const bfs::path &condorPath, const std::string &landscape, const std::vector<float> &points) const;
+  };
+
+}
+
+#endif /* __NAVICONPOOL_H__ */
@@ -0,0 +1,131 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file naviConWorker/main.cpp
+ *
+ * @brief Implements NaviCon.dll worker process.
+ *
+ * NaviCon.dll keeps the terrain of only one landscape so the application runs
+ * one worker process for every landscape used at the same time (see
+ * condor2nav::CNaviConPool). The worker initializes NaviCon.dll with the landscape
+ * terrain and converts batches of Condor coordinates received on its standard
+ * input until a request with no points or the end of input.
+ */
+
+#include "condor.h"
+#include "naviConPool.h"
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <windows.h>
+
+namespace {
+
+  /**
+   * @brief Reads data from the standard input.
+   *
+   * @param data Output buffer.
+   * @param size The number of bytes to read.
+   *
+   * @return @p true if all the data was read.
+   */
+  bool Read(void *data, size_t size)
+  {
+    const auto input = GetStdHandle(STD_INPUT_HANDLE);
+    auto ptr = static_cast<char *>(data);
+    while(size) {
+      DWORD read = 0;
+      if(!ReadFile(input, ptr, static_cast<DWORD>(size), &read, nullptr) || !read)
+        return false;
+      ptr += read;
+      size -= read;
+    }
+    return true;
+  }
+
+
+  /**
+   * @brief Writes data to the standard output.
+   *
+   * @param data Data to write.
+   * @param size The number of bytes to write.
+   *
+   * @return @p true if all the data was written.
+   */
+  bool Write(const void *data, size_t size)
+  {
+    DWORD written = 0;
+    return WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+  }
+
+}
+
+
+/**
+ * @brief Main entry-point for this application.
+ *
+ * @param argc Number of command-line arguments. 
+ * @param argv Array of command-line argument strings. 
+ *
+ * @return Exit-code for the process - 0 for success, else an error code. 
+ */
+int main(int argc, const char *argv[])
+{
+  if(argc != 3) {
+    std::cerr << "Usage: " << condor2nav::CNaviConPool::WORKER_FILE_NAME.string() << " CONDOR_PATH LANDSCAPE" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the application keeps the conversion cache so the worker does not need one
+  std::unique_ptr<const condor2nav::CCondor::CCoordConverter> coordConv;
+  condor2nav::CNaviConPool::TReady ready{};
+  try {
+    coordConv = std::make_unique<const condor2nav::CCondor::CCoordConverter>(argv[1], argv[2], nullptr, false);
+    ready.maxX = coordConv->MaxX();
+    ready.maxY = coordConv->MaxY();
+  }
+  catch(const std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    ready.status = 1;
+  }
+  if(!Write(&ready, sizeof(ready)) || ready.status)
+    return EXIT_FAILURE;
+
+  try {
+    std::uint32_t count;
+    condor2nav::CCondor::CCoordConverter::CPointArray points;
+    while(Read(&count, sizeof(count)) && count) {
+      points.resize(count);
+      if(!Read(points.data(), points.size() * sizeof(points.front())))
+        return EXIT_FAILURE;
+      const auto values = coordConv->Values(points);
+      if(!Write(values.data(), values.size() * sizeof(values.front())))
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+  catch(const std::exception &ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
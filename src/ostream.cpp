@@ -26,9 +26,43 @@
  */
 
 #include "ostream.h"
-#include "activeSync.h"
+#include "asyncIO.h"
+#include "tools.h"
+#include "writeBehind.h"
 #include <algorithm>
-#include <boost/filesystem/fstream.hpp>
+#include <future>
+#include <boost/filesystem/path.hpp>
+
+
+/**
+ * @brief Stores one character in the buffer.
+ *
+ * @param ch Character to store.
+ *
+ * @return Stored character or EOF.
+ */
+auto condor2nav::COStream::CStringBuffer::overflow(int_type ch) -> int_type
+{
+  if(traits_type::eq_int_type(ch, traits_type::eof()))
+    return traits_type::not_eof(ch);
+  _data.push_back(traits_type::to_char_type(ch));
+  return ch;
+}
+
+
+/**
+ * @brief Stores characters in the buffer.
+ *
+ * @param buffer Characters to store.
+ * @param num    The number of characters.
+ *
+ * @return The number of stored characters.
+ */
+std::streamsize condor2nav::COStream::CStringBuffer::xsputn(const char *buffer, std::streamsize num)
+{
+  _data.append(buffer, static_cast<size_t>(num));
+  return num;
+}
 
 
 /**
@@ -39,7 +73,7 @@
  * @param fileName The name of the file to create.
  */
 condor2nav::COStream::COStream(bfs::path fileName) :
-  _pathList{{std::move(fileName)}}
+  _buffer{&_streamBuffer}, _pathList{{std::move(fileName)}}, _committed{false}
 {
 }
 
@@ -52,7 +86,7 @@ condor2nav::COStream::COStream(bfs::path fileName) :
  * @param pathList The list of files to create.
  */
 condor2nav::COStream::COStream(CPathList pathList) :
-  _pathList{std::move(pathList)}
+  _buffer{&_streamBuffer}, _pathList{std::move(pathList)}, _committed{false}
 {
 }
 
@@ -60,29 +94,108 @@ condor2nav::COStream::COStream(CPathList pathList) :
 /**
  * @brief Class destructor.
  *
- * condor2nav::COStream class destructor. Writes local buffer to
- * a file.
+ * condor2nav::COStream class destructor. Writes the data if Commit() was not called.
+ * Errors are not reported in such a case so Commit() should always be called explicitly.
  */
 condor2nav::COStream::~COStream()
 {
-  if(_buffer.str().size()) {
-    for(auto &path : _pathList) {
-      switch(PathType(path)) {
-      case TPathType::LOCAL:
-        {
-          bfs::ofstream stream{path, std::ios_base::out | std::ios_base::binary};
-          if(!stream)
-            throw EOperationFailed{"ERROR: Couldn't open file '" + path.string() + "' for writing!!!"};
-          stream << _buffer.str();
-        }
-        break;
-
-      case TPathType::ACTIVE_SYNC:
-        CActiveSync::Instance().Write(path, _buffer.str());
-        break;
-      }
+  try {
+    Commit();
+  }
+  catch(const std::exception &) {
+  }
+}
+
+
+/**
+ * @brief Writes one buffer to many destinations.
+ *
+ * Method sends the writes of the same data to all the provided paths
+ * to condor2nav::CAsyncIO so local files (including network shares) are
+ * written in parallel while ActiveSync files are written one after another
+ * on the RAPI thread. All the destinations are processed even if some
+ * of them fail.
+ *
+ * @param pathList The list of files to create.
+ * @param data     The data to write.
+ *
+ * @exception std Thrown when writing to any of the files failed. The message
+ *                contains one line for each failed destination.
+ */
+void condor2nav::COStream::FanOut(const CPathList &pathList, boost::string_ref data)
+{
+  if(pathList.empty())
+    return;
+
+  auto &io = CAsyncIO::Instance();
+  std::vector<std::future<void>> writes;
+  writes.reserve(pathList.size());
+  for(const auto &path : pathList)
+    writes.emplace_back(io.Write(path, data));
+
+  // data has to stay valid until all the writes are completed
+  std::string message;
+  for(auto &w : writes) {
+    try {
+      w.get();
+    }
+    catch(const std::exception &ex) {
+      message += (message.empty() ? "" : "\n") + std::string{ex.what()};
     }
   }
+  if(!message.empty())
+    throw EOperationFailed{message};
+}
+
+
+/**
+ * @brief Writes collected data to all files.
+ *
+ * Method writes the buffer to all the provided paths with FanOut(). Nothing is
+ * written if no data was provided.
+ *
+ * @exception std Thrown when writing to any of the files failed.
+ */
+void condor2nav::COStream::Commit()
+{
+  if(_committed)
+    return;
+  _committed = true;
+
+  const auto &data = _streamBuffer.Data();
+  if(data.empty())
+    return;
+
+  FanOut(_pathList, boost::string_ref{data.data(), data.size()});
+}
+
+
+/**
+ * @brief Hands collected data over to the write-behind queue.
+ *
+ * Method moves the buffer to the queue that writes it to all the provided
+ * paths with FanOut(). Nothing is written if no data was provided.
+ *
+ * @param queue   The queue executing the write.
+ * @param written The function to call after all the files were written successfully.
+ *
+ * @exception std Thrown when writing to any of the files failed and the queue is disabled.
+ */
+void condor2nav::COStream::Commit(CWriteBehind &queue, std::function<void()> written /* = nullptr */)
+{
+  if(_committed)
+    return;
+  _committed = true;
+
+  auto data = std::make_shared<const CStringBuffer::CData>(_streamBuffer.Release());
+  auto pathList = std::make_shared<const CPathList>(std::move(_pathList));
+  queue.Send([data, pathList, written]
+  {
+    if(!data->empty())
+      FanOut(*pathList, boost::string_ref{data->data(), data->size()});
+    if(written)
+      written();
+  });
 }
 
 
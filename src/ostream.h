@@ -30,31 +30,61 @@
 
 #include "nonCopyable.h"
 #include "boostfwd.h"
-#include <sstream>
+#include "memoryAccount.h"
+#include <boost/utility/string_ref.hpp>
+#include <functional>
+#include <ostream>
+#include <streambuf>
+#include <string>
 #include <vector>
 
 namespace condor2nav {
 
+  class CWriteBehind;
+
   /**
    * @brief Output stream wrapper
    *
    * condor2nav::COStream class is a wrapper for different stream types.
+   * All the data is collected in one contiguous buffer that is written to
+   * all the provided paths with Commit(). All the destinations are written
+   * concurrently (see FanOut()). Commit() may also hand the buffer over to
+   * a write-behind queue so the caller does not wait for the writes.
    */
   class COStream : CNonCopyable {
   public:
     using CPathList = std::vector<bfs::path>;
 
   private:
-    std::stringstream _buffer;            ///< @brief Buffer with file data. 
-    CPathList _pathList;
+    /**
+     * @brief Stream buffer storing data in a contiguous string.
+     */
+    class CStringBuffer : public std::streambuf {
+    public:
+      using CData = CCountedString<TMemorySubsystem::OUTPUT>;
+    private:
+      CData _data;                        ///< @brief Buffered data. 
+    protected:
+      int_type overflow(int_type ch) override;
+      std::streamsize xsputn(const char *buffer, std::streamsize num) override;
+    public:
+      const CData &Data() const { return _data; }
+      CData Release() { return std::move(_data); }
+    };
+
+    CStringBuffer _streamBuffer;          ///< @brief Buffer with file data. 
+    std::ostream _buffer;                 ///< @brief Formatting stream using the buffer. 
+    CPathList _pathList;                  ///< @brief The list of files to create. 
+    bool _committed;                      ///< @brief Data were already written. 
 
   public:
     explicit COStream(bfs::path fileName);
     explicit COStream(CPathList pathList);
     ~COStream();
+    static void FanOut(const CPathList &pathList, boost::string_ref data);
     COStream &Write(const char *buffer, std::streamsize num);
-
-    void Dump(const bfs::path &fileName);
+    void Commit();
+    void Commit(CWriteBehind &queue, std::function<void()> written = nullptr);
 
     /**
      * @brief Writes new data to a stream. 
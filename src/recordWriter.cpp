@@ -0,0 +1,101 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file recordWriter.cpp
+ *
+ * @brief Implements the condor2nav::CRecordWriter class. 
+ */
+
+#include "recordWriter.h"
+#include <boost/filesystem.hpp>
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CRecordWriter class constructor.
+ *
+ * @param fileName  The path of the file to create.
+ * @param separator Fields separator.
+ */
+condor2nav::CRecordWriter::CRecordWriter(bfs::path fileName, char separator /* = ',' */) :
+  _stream{std::move(fileName)}, _separator{separator}, _rows{0}
+{
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CRecordWriter class constructor.
+ *
+ * @param pathList  The list of paths of the files to create.
+ * @param separator Fields separator.
+ */
+condor2nav::CRecordWriter::CRecordWriter(COStream::CPathList pathList, char separator /* = ',' */) :
+  _stream{std::move(pathList)}, _separator{separator}, _rows{0}
+{
+}
+
+
+/**
+ * @brief Adds a free-form line. 
+ *
+ * Method adds a line that does not follow the records format
+ * (i.e. a file header or a comment).
+ *
+ * @param line Line to add.
+ *
+ * @return Writer instance.
+ */
+auto condor2nav::CRecordWriter::Line(const std::string &line) -> CRecordWriter &
+{
+  _stream << line << std::endl;
+  return *this;
+}
+
+
+/**
+ * @brief Writes all the records. 
+ *
+ * Method writes all the collected records to the output files
+ * with a single write operation per file.
+ *
+ * @exception std Thrown when operation failed.
+ */
+void condor2nav::CRecordWriter::Commit()
+{
+  _stream.Commit();
+}
+
+
+/**
+ * @brief Hands all the records over to the write-behind queue. 
+ *
+ * @param queue The queue executing the write.
+ *
+ * @exception std Thrown when operation failed and the queue is disabled.
+ */
+void condor2nav::CRecordWriter::Commit(CWriteBehind &queue)
+{
+  _stream.Commit(queue);
+}
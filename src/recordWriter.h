@@ -0,0 +1,96 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file recordWriter.h
+ *
+ * @brief Declares the condor2nav::CRecordWriter class. 
+ */
+
+#ifndef __RECORD_WRITER_H__
+#define __RECORD_WRITER_H__
+
+#include "ostream.h"
+
+namespace condor2nav {
+
+  /**
+   * @brief Batched records file writer.
+   *
+   * condor2nav::CRecordWriter class collects separated records (i.e. waypoints,
+   * airspaces, sceneries subsets) of one output file and writes all of them
+   * with a single write operation on Commit(). It should be used to create
+   * line oriented files from within the loops over input data.
+   */
+  class CRecordWriter : CNonCopyable {
+    COStream _stream;                     ///< @brief Output stream buffering all the records. 
+    char _separator;                      ///< @brief Fields separator. 
+    unsigned _rows;                       ///< @brief The number of records written. 
+
+    void Fields() {}
+
+    /**
+     * @brief Writes next fields of a record.
+     *
+     * @param field  Field to write.
+     * @param fields Remaining fields to write.
+     */
+    template<class T, class... Args>
+    void Fields(const T &field, const Args &... fields)
+    {
+      _stream << _separator << field;
+      Fields(fields...);
+    }
+
+  public:
+    explicit CRecordWriter(bfs::path fileName, char separator = ',');
+    explicit CRecordWriter(COStream::CPathList pathList, char separator = ',');
+
+    /**
+     * @brief Adds a record. 
+     *
+     * Method adds a new record composed from provided fields separated
+     * with the writer separator.
+     *
+     * @param field  The first field of a record.
+     * @param fields Remaining fields of a record.
+     *
+     * @return Writer instance.
+     */
+    template<class T, class... Args>
+    CRecordWriter &Row(const T &field, const Args &... fields)
+    {
+      _stream << field;
+      Fields(fields...);
+      _stream << std::endl;
+      ++_rows;
+      return *this;
+    }
+
+    CRecordWriter &Line(const std::string &line);
+    unsigned Rows() const { return _rows; }
+    void Commit();
+    void Commit(CWriteBehind &queue);
+  };
+
+}
+
+#endif /* __RECORD_WRITER_H__ */
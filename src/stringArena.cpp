@@ -0,0 +1,96 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file stringArena.cpp
+ *
+ * @brief Implements the condor2nav::CStringArena class. 
+ */
+
+#include "stringArena.h"
+#include <algorithm>
+#include <cstring>
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CStringArena class constructor.
+ *
+ * @param subsystem Subsystem charged with the memory of stored strings.
+ */
+condor2nav::CStringArena::CStringArena(TMemorySubsystem subsystem) :
+  _free{nullptr}, _freeSize{0}, _blockSize{BLOCK_SIZE_MIN}, _reserved{0}, _memory{subsystem}
+{
+}
+
+
+/**
+ * @brief Allocates memory for a string.
+ *
+ * Method returns free space from the last block. New blocks are growing
+ * up to the maximum size. Strings bigger than a quarter of the maximum
+ * block size get dedicated blocks so the free space of the last shared
+ * block is not wasted.
+ *
+ * @param size The number of bytes to allocate.
+ *
+ * @return Allocated memory.
+ */
+char *condor2nav::CStringArena::Allocate(std::size_t size)
+{
+  if(size > BLOCK_SIZE_MAX / 4) {
+    _blocks.emplace_back(new char[size]);
+    _reserved += size;
+    _memory.Set(_reserved);
+    return _blocks.back().get();
+  }
+
+  if(size > _freeSize) {
+    _blocks.emplace_back(new char[_blockSize]);
+    _free = _blocks.back().get();
+    _freeSize = _blockSize;
+    _reserved += _blockSize;
+    _memory.Set(_reserved);
+    _blockSize = std::min<std::size_t>(_blockSize * 2, BLOCK_SIZE_MAX);
+  }
+  char *ptr = _free;
+  _free += size;
+  _freeSize -= size;
+  return ptr;
+}
+
+
+/**
+ * @brief Stores a string.
+ *
+ * @param str The string to copy.
+ *
+ * @return The view of the copied string valid for the lifetime of the arena.
+ */
+boost::string_ref condor2nav::CStringArena::Store(boost::string_ref str)
+{
+  if(str.empty())
+    return boost::string_ref{};
+  char *ptr = Allocate(str.size());
+  std::memcpy(ptr, str.data(), str.size());
+  return boost::string_ref{ptr, str.size()};
+}
@@ -0,0 +1,69 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file stringArena.h
+ *
+ * @brief Declares the condor2nav::CStringArena class. 
+ */
+
+#ifndef __STRING_ARENA_H__
+#define __STRING_ARENA_H__
+
+#include "nonCopyable.h"
+#include "memoryAccount.h"
+#include <memory>
+#include <vector>
+#include <boost/utility/string_ref.hpp>
+
+namespace condor2nav {
+
+  /**
+   * @brief Monotonic strings storage.
+   *
+   * condor2nav::CStringArena copies strings into a few large memory blocks
+   * and returns views of stored data. Stored strings are never modified
+   * or released separately. All the blocks are freed at once when arena
+   * is destroyed.
+   */
+  class CStringArena : CNonCopyable {
+    enum : std::size_t {
+      BLOCK_SIZE_MIN = 4 * 1024,          ///< @brief The size of the first block
+      BLOCK_SIZE_MAX = 64 * 1024          ///< @brief The maximum size of a shared block
+    };
+
+    std::vector<std::unique_ptr<char[]>> _blocks;   ///< @brief Allocated memory blocks
+    char *_free;                                    ///< @brief Free space in the last shared block
+    std::size_t _freeSize;                          ///< @brief The size of free space in the last shared block
+    std::size_t _blockSize;                         ///< @brief The size of the next shared block
+    std::size_t _reserved;                          ///< @brief The size of all the blocks
+    CMemoryCharge _memory;                          ///< @brief Memory used by the blocks
+
+    char *Allocate(std::size_t size);
+
+  public:
+    explicit CStringArena(TMemorySubsystem subsystem);
+    boost::string_ref Store(boost::string_ref str);
+  };
+
+}
+
+#endif /* __STRING_ARENA_H__ */
@@ -28,7 +28,13 @@
 #include "targetLK8000.h"
 #include "imports/lk8000Types.h"
 #include "ostream.h"
+#include "lkTerrain.h"
+#include "taskCorridor.h"
+#include "recordWriter.h"
+#include "istream.h"
 #include <array>
+#include <cmath>
+#include <future>
 
 
 const bfs::path condor2nav::CTargetLK8000::AIRSPACES_SUBDIR    = "_Airspaces";
@@ -42,6 +48,37 @@ const bfs::path condor2nav::CTargetLK8000::DEFAULT_SYSTEM_PROFILE_NAME   = "DEFA
 const bfs::path condor2nav::CTargetLK8000::DEFAULT_AIRCRAFT_PROFILE_NAME = "DEFAULT_AIRCRAFT.acf";
 
 const bfs::path condor2nav::CTargetLK8000::OUTPUT_AIRCRAFT_PROFILE_NAME  = "Condor.acf";
+const bfs::path condor2nav::CTargetLK8000::TASK_TERRAIN_FILE_NAME        = "condor2navTask.DEM";
+const bfs::path condor2nav::CTargetLK8000::TASK_WAYPOINTS_FILE_NAME      = "condor2navTask.cup";
+
+
+namespace {
+
+  /**
+   * @brief Returns a field of a CUP file line.
+   *
+   * @param line  CUP file line.
+   * @param index The index of the field.
+   *
+   * @return Field text (empty if not found).
+   */
+  boost::string_ref CupField(boost::string_ref line, unsigned index)
+  {
+    bool quoted = false;
+    size_t begin = 0;
+    for(size_t i=0; i<line.size(); i++) {
+      if(line[i] == '"')
+        quoted = !quoted;
+      else if(line[i] == ',' && !quoted) {
+        if(!index--)
+          return line.substr(begin, i - begin);
+        begin = i + 1;
+      }
+    }
+    return index ? boost::string_ref{} : line.substr(begin);
+  }
+
+}
 
 
 /**
@@ -50,9 +87,10 @@ const bfs::path condor2nav::CTargetLK8000::OUTPUT_AIRCRAFT_PROFILE_NAME  = "Cond
  * condor2nav::CTargetLK8000 class constructor.
  *
  * @param translator Configuration INI file parser.
+ * @param outputPath Translation output directory.
  */
-condor2nav::CTargetLK8000::CTargetLK8000(const CTranslator &translator) :
-  CTargetXCSoarCommon{translator},
+condor2nav::CTargetLK8000::CTargetLK8000(const CTranslator &translator, bfs::path outputPath) :
+  CTargetXCSoarCommon{translator, std::move(outputPath)},
   _outputLK8000DataPath{OutputPath() / "LK8000"},
   _condor2navDataPathString{ConfigParser().Value("LK8000", "LK8000Path")}
 {
@@ -63,15 +101,15 @@ condor2nav::CTargetLK8000::CTargetLK8000(const CTranslator &translator) :
   _outputPolarsSubDir    = POLARS_SUBDIR / subDir;
   _outputWaypointsSubDir = WAYPOINTS_SUBDIR / subDir;
 
-  // create directories
-  DirectoryCreate(_outputLK8000DataPath / _outputAirspacesSubDir);
-  DirectoryCreate(_outputLK8000DataPath / _outputMapsSubDir);
-  DirectoryCreate(_outputLK8000DataPath / _outputPolarsSubDir);
-  DirectoryCreate(_outputLK8000DataPath / _outputWaypointsSubDir);
+  // declare output directories (created by the translator)
+  DirectoryAdd(_outputLK8000DataPath / _outputAirspacesSubDir);
+  DirectoryAdd(_outputLK8000DataPath / _outputMapsSubDir);
+  DirectoryAdd(_outputLK8000DataPath / _outputPolarsSubDir);
+  DirectoryAdd(_outputLK8000DataPath / _outputWaypointsSubDir);
 
   {
     const auto outputTaskDir = _outputLK8000DataPath / TASKS_SUBDIR / subDir;
-    DirectoryCreate(outputTaskDir);
+    DirectoryAdd(outputTaskDir);
     _outputTaskFilePathList.emplace_back(outputTaskDir / TASK_FILE_NAME);
   }
   if(Convert<unsigned>(ConfigParser().Value("LK8000", "DefaultTaskOverwrite"))) {
@@ -81,39 +119,30 @@ condor2nav::CTargetLK8000::CTargetLK8000(const CTranslator &translator) :
 
   {
     const auto outputConfigDir = _outputLK8000DataPath / CONFIG_SUBDIR / subDir;
-    DirectoryCreate(outputConfigDir);
+    DirectoryAdd(outputConfigDir);
     _outputSystemProfilePathList.emplace_back(outputConfigDir / OUTPUT_PROFILE_NAME);
     _outputAircraftProfilePathList.emplace_back(outputConfigDir / OUTPUT_AIRCRAFT_PROFILE_NAME);
   }
   if(Convert<unsigned>(ConfigParser().Value("LK8000", "DefaultProfilesOverwrite"))) {
     const auto outputConfigDir = _outputLK8000DataPath / CONFIG_SUBDIR;
-    DirectoryCreate(outputConfigDir);
+    DirectoryAdd(outputConfigDir);
     _outputSystemProfilePathList.emplace_back(outputConfigDir / DEFAULT_SYSTEM_PROFILE_NAME);
     _outputAircraftProfilePathList.emplace_back(outputConfigDir / DEFAULT_AIRCRAFT_PROFILE_NAME);
   }
 
-  // init profile files parsers
-  auto systemPath = _outputLK8000DataPath / CONFIG_SUBDIR / subDir / OUTPUT_PROFILE_NAME;
-  if(!FileExists(systemPath)) {
-    systemPath = _outputLK8000DataPath / CONFIG_SUBDIR / DEFAULT_SYSTEM_PROFILE_NAME;
-    if(!FileExists(systemPath)) {
-      systemPath = CTranslator::DATA_PATH / DEFAULT_SYSTEM_PROFILE_NAME;
-      if(!FileExists(systemPath))
-        throw EOperationFailed{"ERROR: Please copy '" + DEFAULT_SYSTEM_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
-    }
-  }
-  _systemParser = std::make_unique<CFileParserINI>(systemPath);
-
-  auto aircraftPath = _outputLK8000DataPath / CONFIG_SUBDIR / subDir / OUTPUT_AIRCRAFT_PROFILE_NAME;
-  if(!FileExists(aircraftPath)) {
-    aircraftPath = _outputLK8000DataPath / CONFIG_SUBDIR / DEFAULT_AIRCRAFT_PROFILE_NAME;
-    if(!FileExists(aircraftPath)) {
-      aircraftPath = CTranslator::DATA_PATH / DEFAULT_AIRCRAFT_PROFILE_NAME;
-      if(!FileExists(aircraftPath))
-        throw EOperationFailed{"ERROR: Please copy '" + DEFAULT_AIRCRAFT_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
-    }
-  }
-  _aircraftParser = std::make_unique<CFileParserINI>(aircraftPath);
+  // init profile files parsers (profiles read or written by previous translations are reused if not modified)
+  auto &cache = Translator().App().INICache();
+  _systemParser = cache.Parser({_outputLK8000DataPath / CONFIG_SUBDIR / subDir / OUTPUT_PROFILE_NAME,
+                                _outputLK8000DataPath / CONFIG_SUBDIR / DEFAULT_SYSTEM_PROFILE_NAME,
+                                CTranslator::DATA_PATH / DEFAULT_SYSTEM_PROFILE_NAME});
+  if(!_systemParser)
+    throw EOperationFailed{"ERROR: Please copy '" + DEFAULT_SYSTEM_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
+
+  _aircraftParser = cache.Parser({_outputLK8000DataPath / CONFIG_SUBDIR / subDir / OUTPUT_AIRCRAFT_PROFILE_NAME,
+                                  _outputLK8000DataPath / CONFIG_SUBDIR / DEFAULT_AIRCRAFT_PROFILE_NAME,
+                                  CTranslator::DATA_PATH / DEFAULT_AIRCRAFT_PROFILE_NAME});
+  if(!_aircraftParser)
+    throw EOperationFailed{"ERROR: Please copy '" + DEFAULT_AIRCRAFT_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
 }
 
 
@@ -124,10 +153,54 @@ condor2nav::CTargetLK8000::CTargetLK8000(const CTranslator &translator) :
  */
 condor2nav::CTargetLK8000::~CTargetLK8000()
 {
-  for(const auto &path : _outputSystemProfilePathList)
-    _systemParser->Dump(path);
-  for(const auto &path : _outputAircraftProfilePathList)
-    _aircraftParser->Dump(path);
+}
+
+
+/**
+ * @brief Adds target profiles to the fingerprint. 
+ *
+ * @param fingerprint Fingerprint to update.
+ */
+void condor2nav::CTargetLK8000::ProfilesFingerprint(CFingerprint &fingerprint) const
+{
+  _systemParser->Fingerprint(fingerprint);
+  _aircraftParser->Fingerprint(fingerprint);
+}
+
+
+/**
+ * @brief Writes target profiles. 
+ *
+ * Method writes LK8000 system and aircraft profiles modified by the translation.
+ * Both profiles are written concurrently and each of them is fanned out to all
+ * its destinations at once. With write-behind enabled they are only handed over
+ * to the translator output queue.
+ *
+ * @exception std Thrown when writing of any profile failed.
+ */
+void condor2nav::CTargetLK8000::Commit()
+{
+  auto &cache = Translator().App().INICache();
+  auto system = std::async(std::launch::async, [&]
+  {
+    _systemParser->Dump(_outputSystemProfilePathList, Translator().Output(), cache.Storer(*_systemParser, _outputSystemProfilePathList));
+  });
+
+  std::string errors;
+  try {
+    _aircraftParser->Dump(_outputAircraftProfilePathList, Translator().Output(), cache.Storer(*_aircraftParser, _outputAircraftProfilePathList));
+  }
+  catch(const std::exception &ex) {
+    errors = ex.what();
+  }
+  try {
+    system.get();
+  }
+  catch(const std::exception &ex) {
+    errors = ex.what() + (errors.empty() ? "" : "\n" + errors);
+  }
+  if(!errors.empty())
+    throw EOperationFailed{errors};
 }
 
 
@@ -137,14 +210,14 @@ condor2nav::CTargetLK8000::~CTargetLK8000()
  * Method dumps waypoints in LK8000 format.
  *
  * @param profileParser      LK8000 profile file parser.
- * @param taskParser         Condor task parser. 
+ * @param task               Condor task.
  * @param settingsTask       Task settings
  * @param taskPointArray     Task points array
  * @param startPointArray    Task start points array
  * @param waypointArray      The array of waypoints data.
  */
 void condor2nav::CTargetLK8000::TaskDump(CFileParserINI &profileParser,
-                                         const CFileParserINI &taskParser,
+                                         const CCondor::CTask &task,
                                          const xcsoar::SETTINGS_TASK &settingsTask,
                                          const xcsoar::TASK_POINT taskPointArray[],
                                          const xcsoar::START_POINT startPointArray[],
@@ -152,51 +225,45 @@ void condor2nav::CTargetLK8000::TaskDump(CFileParserINI &profileParser,
 {
   using namespace lk8000;
 
+  // LK8000 task file layout (version LK_TASK_VERSION)
+  using CTaskFileLayout = layout::TFile<
+    layout::TString<50>,
+    layout::TArray<TASK_POINT, lk8000::MAXTASKPOINTS>,
+    CSettingsTaskLayout,
+    layout::TArray<START_POINT, lk8000::MAXSTARTPOINTS>,
+    layout::TRecords<lk8000::WAYPOINT, lk8000::MAXTASKPOINTS>,
+    layout::TRecords<lk8000::WAYPOINT, lk8000::MAXSTARTPOINTS>>;
+  static_assert(CTaskFileLayout::size == 50 + (lk8000::MAXTASKPOINTS + lk8000::MAXSTARTPOINTS) * sizeof(lk8000::WAYPOINT) +
+                                         lk8000::MAXTASKPOINTS * sizeof(TASK_POINT) + lk8000::MAXSTARTPOINTS * sizeof(START_POINT) +
+                                         CSettingsTaskLayout::size, "Invalid LK8000 task file size");
+
+  std::vector<lk8000::WAYPOINT> taskWaypoints;
+  taskWaypoints.reserve(waypointArray.size());
+  for(const auto &waypoint : waypointArray) {
+    // padding bytes are written to the file too
+    lk8000::WAYPOINT wp;
+    memset(&wp, 0, sizeof(wp));
+    wp.Number    = waypoint.number;
+    wp.Latitude  = waypoint.latitude;
+    wp.Longitude = waypoint.longitude;
+    wp.Altitude  = waypoint.altitude;
+    wp.Flags     = waypoint.flags;
+    mbstowcs(wp.Name, waypoint.name.c_str(), lk8000::NAME_SIZE);
+    mbstowcs(wp.Comment, waypoint.comment.c_str(), lk8000::COMMENT_SIZE);
+    wp.InTask    = true;
+    wp.Style     = 1;
+    taskWaypoints.push_back(wp);
+  }
+
+  const std::string version{"LK" + Convert(LK_TASK_VERSION) + Convert(lk8000::MAXTASKPOINTS) + Convert(lk8000::MAXSTARTPOINTS)};
+  const auto buffer = CTaskFileLayout::Serialize(version, taskPointArray, settingsTask, startPointArray, taskWaypoints, std::vector<lk8000::WAYPOINT>{});
   COStream tskFile(_outputTaskFilePathList);
+  tskFile.Write(buffer.data(), buffer.size());
 
-  const std::string ver{"LK" + Convert(LK_TASK_VERSION) + Convert(lk8000::MAXTASKPOINTS) + Convert(lk8000::MAXSTARTPOINTS)};
-  std::array<char, 50> version{};
-  copy(begin(ver), end(ver), begin(version));
-  tskFile.Write(version.data(), version.size());
-
-  tskFile.Write(reinterpret_cast<const char *>(taskPointArray), lk8000::MAXTASKPOINTS * sizeof(taskPointArray[0]));
-
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AATEnabled), sizeof(settingsTask.AATEnabled));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AATTaskLength), sizeof(settingsTask.AATTaskLength));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.FinishRadius), sizeof(settingsTask.FinishRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.FinishType), sizeof(settingsTask.FinishType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.StartRadius), sizeof(settingsTask.StartRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.StartType), sizeof(settingsTask.StartType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.SectorType), sizeof(settingsTask.SectorType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.SectorRadius), sizeof(settingsTask.SectorRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AutoAdvance), sizeof(settingsTask.AutoAdvance));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.EnableMultipleStartPoints), sizeof(settingsTask.EnableMultipleStartPoints));
-
-  tskFile.Write(reinterpret_cast<const char *>(startPointArray), lk8000::MAXSTARTPOINTS * sizeof(startPointArray[0]));
-
-  std::array<lk8000::WAYPOINT, lk8000::MAXTASKPOINTS> taskWaypointArray;
-  std::array<lk8000::WAYPOINT, lk8000::MAXSTARTPOINTS> startWaypointArray;
-  memset(taskWaypointArray.data(), 0, taskWaypointArray.size() * sizeof(taskWaypointArray[0]));
-  memset(startWaypointArray.data(), 0, startWaypointArray.size() * sizeof(startWaypointArray[0]));
-
-  for(size_t i=0; i<waypointArray.size(); ++i) {
-    taskWaypointArray[i].Number    = waypointArray[i].number;
-    taskWaypointArray[i].Latitude  = waypointArray[i].latitude;
-    taskWaypointArray[i].Longitude = waypointArray[i].longitude;
-    taskWaypointArray[i].Altitude  = waypointArray[i].altitude;
-    taskWaypointArray[i].Flags     = waypointArray[i].flags;
-    mbstowcs(taskWaypointArray[i].Name, waypointArray[i].name.c_str(), lk8000::NAME_SIZE);
-    mbstowcs(taskWaypointArray[i].Comment, waypointArray[i].comment.c_str(), lk8000::COMMENT_SIZE);
-    taskWaypointArray[i].InTask    = true;
-    taskWaypointArray[i].Style     = 1;
-  }
-  
-  tskFile.Write(reinterpret_cast<const char *>(taskWaypointArray.data()), taskWaypointArray.size() * sizeof(taskWaypointArray[0]));
-  tskFile.Write(reinterpret_cast<const char *>(startWaypointArray.data()), startWaypointArray.size() * sizeof(startWaypointArray[0]));
-  
   profileParser.Value("", "StartMaxHeight", Convert(settingsTask.StartMaxHeight * 1000));
   profileParser.Value("", "StartMaxHeightMargin", "0");
   profileParser.Value("", "FinishMinHeight", Convert(settingsTask.FinishMinHeight * 1000));
+  tskFile.Commit(Translator().Output());
 }
 
 
@@ -222,9 +289,9 @@ void condor2nav::CTargetLK8000::Gps()
  */
 void condor2nav::CTargetLK8000::SceneryMap(const CFileParserCSV::CStringArray &sceneryData)
 {
-  _systemParser->Value("", "MapFile",     "\"" + _condor2navDataPathString + "\\" + (_outputMapsSubDir / sceneryData.at(SCENERY_MAP_FILE)).string() + "\"");
-  _systemParser->Value("", "TerrainFile", "\"" + _condor2navDataPathString + "\\" + (_outputMapsSubDir / sceneryData.at(SCENERY_TERRAIN_FILE)).string() + "\"");
-  _systemParser->Value("", "WPFile",      "\"" + _condor2navDataPathString + "\\" + (_outputWaypointsSubDir / sceneryData.at(SCENERY_WAYPOINTS_FILE)).string() + "\"");
+  _systemParser->Value("", "MapFile",     "\"" + _condor2navDataPathString + "\\" + (_outputMapsSubDir / sceneryData.at(SCENERY_MAP_FILE).to_string()).string() + "\"");
+  _systemParser->Value("", "TerrainFile", "\"" + _condor2navDataPathString + "\\" + (_outputMapsSubDir / sceneryData.at(SCENERY_TERRAIN_FILE).to_string()).string() + "\"");
+  _systemParser->Value("", "WPFile",      "\"" + _condor2navDataPathString + "\\" + (_outputWaypointsSubDir / sceneryData.at(SCENERY_WAYPOINTS_FILE).to_string()).string() + "\"");
 
   // reset landscape specific files in case they were set before profile import
   // if need user can still assign additionl data with second entries
@@ -249,17 +316,18 @@ void condor2nav::CTargetLK8000::SceneryTime()
 * Method created and sets glider polar file, handicap, safety speed, the time to empty the water
 * ballast and glider name for the logger.
 *
-* @param gliderData Information describing the glider. 
+* @param gliderData  Information describing the glider. 
+* @param gliderPolar Precomputed glider polar (nullptr if not available). 
  */
-void condor2nav::CTargetLK8000::Glider(const CFileParserCSV::CStringArray &gliderData)
+void condor2nav::CTargetLK8000::Glider(const CFileParserCSV::CStringArray &gliderData, const CFileParserCSV::CStringArray *gliderPolar)
 {
   _aircraftParser->Value("", "AircraftCategory1", "\"0\"");
   _aircraftParser->Value("", "PolarFile1", "\"" + _condor2navDataPathString + "\\" + (_outputPolarsSubDir / POLAR_FILE_NAME).string() + "\"");
-  _aircraftParser->Value("", "SafteySpeed1", Convert(static_cast<unsigned>(Convert<unsigned>(gliderData.at(GLIDER_SPEED_MAX)) * 1000.0 / 3.6 + 0.5)));
-  _aircraftParser->Value("", "Handicap1", gliderData.at(GLIDER_DAEC_INDEX));
-  const std::string &waterBallastEmptyTime = gliderData.at(GLIDER_WATER_BALLAST_EMPTY_TIME);
+  _aircraftParser->Value("", "SafteySpeed1", Convert(static_cast<unsigned>(Convert<unsigned>(gliderData.at(GLIDER_SPEED_MAX).to_string()) * 1000.0 / 3.6 + 0.5)));
+  _aircraftParser->Value("", "Handicap1", gliderData.at(GLIDER_DAEC_INDEX).to_string());
+  const auto waterBallastEmptyTime = gliderData.at(GLIDER_WATER_BALLAST_EMPTY_TIME).to_string();
   _aircraftParser->Value("", "BallastSecsToEmpty1", waterBallastEmptyTime == "0" ? "10" : waterBallastEmptyTime);
-  _aircraftParser->Value("", "AircraftType1", "\"" + gliderData.at(GLIDER_NAME) + "\"");
+  _aircraftParser->Value("", "AircraftType1", "\"" + gliderData.at(GLIDER_NAME).to_string() + "\"");
   _aircraftParser->Value("", "AircraftRego1", "\"\"");
   _aircraftParser->Value("", "CompetitionClass1", "\"" + Condor().TaskParser().Value("Plane", "Class") + "\"");
   _aircraftParser->Value("", "CompetitionID1", "\"\"");
@@ -272,11 +340,7 @@ void condor2nav::CTargetLK8000::Glider(const CFileParserCSV::CStringArray &glide
   polarFile << "*" << std::endl;
   polarFile << "* MassDryGross[kg], MaxWaterBallast[liters], Speed1[km/h], Sink1[m/s], Speed2, Sink2, Speed3, Sink3, WingArea[m2]" << std::endl;
   polarFile << "*****************************************************************************************************************" << std::endl;
-  for(size_t i=GLIDER_MASS_DRY_GROSS; i<=GLIDER_SINK_3; i++) {
-    if(i > GLIDER_MASS_DRY_GROSS)
-      polarFile << ",";
-    polarFile << gliderData.at(i);
-  }
+  PolarDump(polarFile, gliderData, gliderPolar);
   polarFile << "," << gliderData.at(GLIDER_WING_AREA) << std::endl;
 
   if(!gliderData.at(GLIDER_FLAPS).empty()) {
@@ -286,13 +350,15 @@ void condor2nav::CTargetLK8000::Glider(const CFileParserCSV::CStringArray &glide
   }
 
   const auto ballast = Convert<unsigned>(Condor().TaskParser().Value("Plane", "Water"));
-  const auto maxBallast = Convert<unsigned>(gliderData.at(GLIDER_MAX_WATER_BALLAST));
+  const auto maxBallast = Convert<unsigned>(gliderData.at(GLIDER_MAX_WATER_BALLAST).to_string());
   if(maxBallast > 0 && ballast > 0) {
     unsigned percent = ballast * 100 / maxBallast;
     // round it to 5% increment steps
     percent = static_cast<unsigned>((static_cast<float>(percent) + 2.5) / 5) * 5;
     Translator().App().Warning() << "WARNING: Cannot set initial glider ballast in " << Name() << " automatically. Please open 'Config'->'Setup Basic' and set '" << percent << "%' for the glider ballast." << std::endl;
   }
+  polarFile.Commit(Translator().Output());
+  OutputAdd(_outputLK8000DataPath / _outputPolarsSubDir / POLAR_FILE_NAME);
 }
 
 
@@ -301,17 +367,148 @@ void condor2nav::CTargetLK8000::Glider(const CFileParserCSV::CStringArray &glide
 *
 * Method sets task information.
 *
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task        Condor task.
 * @param sceneryData Information describing the scenery. 
 * @param aatTime     Minimum time for AAT task
  */
-void condor2nav::CTargetLK8000::Task(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime)
+void condor2nav::CTargetLK8000::Task(const CCondor::CTask &task, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime)
 {
   const auto wpFile = Convert<unsigned>(ConfigParser().Value("LK8000", "TaskWPFileGenerate"));
-  TaskProcess(*_systemParser, taskParser, coordConv, aatTime,
+  TaskProcess(*_systemParser, task, aatTime,
               lk8000::MAXTASKPOINTS, lk8000::MAXSTARTPOINTS,
               wpFile > 0, _outputLK8000DataPath / _outputWaypointsSubDir);
+  for(const auto &path : _outputTaskFilePathList)
+    OutputAdd(path);
+  if(wpFile > 0)
+    OutputAdd(_outputLK8000DataPath / _outputWaypointsSubDir / WP_FILE_NAME);
+
+  auto margin = [&](const char *key)
+  {
+    try {
+      return Convert<double>(ConfigParser().Value("LK8000", key));
+    }
+    catch(const Exception &) {
+      return 0.0;
+    }
+  };
+  const auto terrainMargin = margin("TerrainClipMargin");
+  const auto waypointsMargin = margin("TaskWaypointsMargin");
+  if(terrainMargin <= 0 && waypointsMargin <= 0)
+    return;
+
+  const auto positions = task.Positions();
+  if(positions.empty())
+    return;
+  if(terrainMargin > 0)
+    TerrainClip(positions, sceneryData, terrainMargin);
+  if(waypointsMargin > 0)
+    WaypointsSubset(positions, sceneryData, waypointsMargin);
+}
+
+
+/**
+* @brief Clips the terrain to the task area.
+*
+* Method writes the scenery terrain clipped to the bounding box of all task
+* waypoints extended with the margin and sets it as LK8000 terrain file.
+*
+* @param positions   Task waypoints positions.
+* @param sceneryData Information describing the scenery.
+* @param margin      The margin around the task waypoints in km.
+ */
+void condor2nav::CTargetLK8000::TerrainClip(const CCondor::CCoordConverter::CPositionArray &positions, const CFileParserCSV::CStringArray &sceneryData, double margin)
+{
+  double lonMin = positions.front().longitude.value, lonMax = lonMin;
+  double latMin = positions.front().latitude.value,  latMax = latMin;
+  for(const auto &pos : positions) {
+    lonMin = std::min(lonMin, pos.longitude.value);
+    lonMax = std::max(lonMax, pos.longitude.value);
+    latMin = std::min(latMin, pos.latitude.value);
+    latMax = std::max(latMax, pos.latitude.value);
+  }
+
+  // convert the margin to degrees
+  const double latMargin = margin / DEGREE_LENGTH;
+  const double lonMargin = latMargin / std::max(0.01, std::cos(Deg2Rad(std::max(std::abs(latMin), std::abs(latMax)))));
+
+  const auto terrainFile = sceneryData.at(SCENERY_TERRAIN_FILE).to_string();
+  const CLKTerrain terrain{CTranslator::DATA_PATH / DataDir() / _outputMapsSubDir / terrainFile};
+  const auto size = terrain.Clip(_outputLK8000DataPath / _outputMapsSubDir / TASK_TERRAIN_FILE_NAME,
+                                 TLongitude{lonMin - lonMargin}, TLongitude{lonMax + lonMargin},
+                                 TLatitude{latMin - latMargin}, TLatitude{latMax + latMargin});
+  OutputAdd(_outputLK8000DataPath / _outputMapsSubDir / TASK_TERRAIN_FILE_NAME);
+  Translator().App().Log() << "Terrain '" << terrainFile << "' clipped to the task area: " << static_cast<unsigned>(size / 1024) << " kB" << std::endl;
+
+  _systemParser->Value("", "TerrainFile", "\"" + _condor2navDataPathString + "\\" + (_outputMapsSubDir / TASK_TERRAIN_FILE_NAME).string() + "\"");
+}
+
+
+/**
+* @brief Filters CUP file waypoints with the task corridor.
+*
+* Method copies the header line and the waypoints that are inside the task
+* corridor. Other lines that are not waypoints and the related tasks section
+* are dropped.
+*
+* @param input    CUP file to filter.
+* @param corridor Task corridor.
+* @param output   Filtered CUP file.
+*
+* @return The number of waypoints in the input and in the output.
+ */
+auto condor2nav::CTargetLK8000::WaypointsFilter(CIStream &input, const CTaskCorridor &corridor, CRecordWriter &output) -> TWaypointsSubset
+{
+  TWaypointsSubset result = { 0, 0 };
+  boost::string_ref line;
+  for(bool header = true; input.GetLine(line); header = false) {
+    // tasks stored in the file are not needed
+    if(line.starts_with("-----Related Tasks-----"))
+      break;
+    TLatitude lat{0};
+    TLongitude lon{0};
+    try {
+      lat = CupLatitude(CupField(line, 3));
+      lon = CupLongitude(CupField(line, 4));
+    }
+    catch(const EOperationFailed &) {
+      // not a waypoint row
+      if(header)
+        output.Line(line.to_string());
+      continue;
+    }
+    result.total++;
+    if(corridor.Inside(lon, lat)) {
+      output.Line(line.to_string());
+      result.subset++;
+    }
+  }
+  return result;
+}
+
+
+/**
+* @brief Writes scenery waypoints from the task corridor.
+*
+* Method streams the scenery waypoints file and writes only the waypoints that
+* are within the margin from the task legs. The new file is set as LK8000
+* waypoints file.
+*
+* @param positions   Task waypoints positions.
+* @param sceneryData Information describing the scenery.
+* @param margin      The margin around the task legs in km.
+ */
+void condor2nav::CTargetLK8000::WaypointsSubset(const CCondor::CCoordConverter::CPositionArray &positions, const CFileParserCSV::CStringArray &sceneryData, double margin)
+{
+  const CTaskCorridor corridor{positions, margin};
+  const auto waypointsFile = sceneryData.at(SCENERY_WAYPOINTS_FILE).to_string();
+  CIStream input{CTranslator::DATA_PATH / DataDir() / _outputWaypointsSubDir / waypointsFile};
+  CRecordWriter output{_outputLK8000DataPath / _outputWaypointsSubDir / TASK_WAYPOINTS_FILE_NAME};
+  const auto result = WaypointsFilter(input, corridor, output);
+  output.Commit(Translator().Output());
+  OutputAdd(_outputLK8000DataPath / _outputWaypointsSubDir / TASK_WAYPOINTS_FILE_NAME);
+  Translator().App().Log() << "Waypoints '" << waypointsFile << "' reduced to the task corridor: " << result.subset << "/" << result.total << std::endl;
+
+  _systemParser->Value("", "WPFile", "\"" + _condor2navDataPathString + "\\" + (_outputWaypointsSubDir / TASK_WAYPOINTS_FILE_NAME).string() + "\"");
 }
  
 
@@ -320,12 +517,12 @@ void condor2nav::CTargetLK8000::Task(const CFileParserINI &taskParser, const CCo
 *
 * Method sets penalty zones used in the task.
 *
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task Condor task.
  */
-void condor2nav::CTargetLK8000::PenaltyZones(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv)
+void condor2nav::CTargetLK8000::PenaltyZones(const CCondor::CTask &task)
 {
-  PenaltyZonesProcess(*_systemParser, taskParser, coordConv, _condor2navDataPathString + "\\" + _outputAirspacesSubDir.string(), _outputLK8000DataPath / _outputAirspacesSubDir);
+  if(PenaltyZonesProcess(*_systemParser, task, _condor2navDataPathString + "\\" + _outputAirspacesSubDir.string(), _outputLK8000DataPath / _outputAirspacesSubDir))
+    OutputAdd(_outputLK8000DataPath / _outputAirspacesSubDir / AIRSPACES_FILE_NAME);
 }
 
 
@@ -34,6 +34,10 @@
 
 namespace condor2nav {
 
+  class CIStream;
+  class CRecordWriter;
+  class CTaskCorridor;
+
   /**
    * @brief Translator to LK8000 data format.
    *
@@ -55,6 +59,8 @@ namespace condor2nav {
 
     // outputs
     static const bfs::path OUTPUT_AIRCRAFT_PROFILE_NAME;  ///< @brief The name of LK8000 aircraft profile file to generate. 
+    static const bfs::path TASK_TERRAIN_FILE_NAME;        ///< @brief The name of LK8000 terrain file clipped to the task area. 
+    static const bfs::path TASK_WAYPOINTS_FILE_NAME;      ///< @brief The name of LK8000 waypoints file with the task corridor subset. 
 
     std::unique_ptr<CFileParserINI> _systemParser;        ///< @brief LK8000 system profile file parser. 
     std::unique_ptr<CFileParserINI> _aircraftParser;      ///< @brief LK8000 aircraft profile file parser. 
@@ -71,24 +77,39 @@ namespace condor2nav {
     COStream::CPathList _outputAircraftProfilePathList;   ///< @brief The path where output configuration paths should be located
 
     void TaskDump(CFileParserINI &profileParser,
-                  const CFileParserINI &taskParser,
+                  const CCondor::CTask &task,
                   const xcsoar::SETTINGS_TASK &settingsTask,
                   const xcsoar::TASK_POINT taskPointArray[],
                   const xcsoar::START_POINT startPointArray[],
                   const CWaypointArray &waypointArray) const override;
+    void TerrainClip(const CCondor::CCoordConverter::CPositionArray &positions, const CFileParserCSV::CStringArray &sceneryData, double margin);
+    void WaypointsSubset(const CCondor::CCoordConverter::CPositionArray &positions, const CFileParserCSV::CStringArray &sceneryData, double margin);
 
   public:
-    explicit CTargetLK8000(const CTranslator &translator);
+    /**
+     * @brief Task corridor waypoints subset statistics.
+     */
+    struct TWaypointsSubset {
+      unsigned total;                     ///< @brief The number of scenery waypoints
+      unsigned subset;                    ///< @brief The number of waypoints within the task corridor
+    };
+
+    static TWaypointsSubset WaypointsFilter(CIStream &input, const CTaskCorridor &corridor, CRecordWriter &output);
+
+    CTargetLK8000(const CTranslator &translator, bfs::path outputPath);
     virtual ~CTargetLK8000();
 
     const char *Name() const override { return "LK8000"; }
+    const char *DataDir() const override { return "LK8000"; }
     void Gps() override;
     void SceneryMap(const CFileParserCSV::CStringArray &sceneryData) override;
     void SceneryTime() override;
-    void Glider(const CFileParserCSV::CStringArray &gliderData) override;
-    void Task(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) override;
-    void PenaltyZones(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv) override;
+    void Glider(const CFileParserCSV::CStringArray &gliderData, const CFileParserCSV::CStringArray *gliderPolar) override;
+    void Task(const CCondor::CTask &task, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) override;
+    void PenaltyZones(const CCondor::CTask &task) override;
     void Weather(const CFileParserINI &taskParser) override;
+    void ProfilesFingerprint(CFingerprint &fingerprint) const override;
+    void Commit() override;
   };
 
 }
@@ -28,7 +28,6 @@
 #include "targetXCSoar.h"
 #include "imports/xcsoarTypes.h"
 #include "ostream.h"
-#include <array>
 
 
 const bfs::path condor2nav::CTargetXCSoar::XCSOAR_PROFILE_NAME = "xcsoar-registry.prf";
@@ -40,30 +39,27 @@ const bfs::path condor2nav::CTargetXCSoar::XCSOAR_PROFILE_NAME = "xcsoar-registr
  * condor2nav::CTargetXCSoar class constructor.
  *
  * @param translator Configuration INI file parser.
+ * @param outputPath Translation output directory.
  */
-condor2nav::CTargetXCSoar::CTargetXCSoar(const CTranslator &translator) :
-  CTargetXCSoarCommon{translator}, _outputXCSoarDataPath{OutputPath() / "XCSoarData"}
+condor2nav::CTargetXCSoar::CTargetXCSoar(const CTranslator &translator, bfs::path outputPath) :
+  CTargetXCSoarCommon{translator, std::move(outputPath)}, _outputXCSoarDataPath{OutputPath() / "XCSoarData"}
 {
   const bfs::path subDir{ConfigParser().Value("XCSoar", "Condor2NavDataSubDir")};
   _outputCondor2NavDataPath = _outputXCSoarDataPath / subDir;
   _condor2navDataPathString = ConfigParser().Value("XCSoar", "XCSoarDataPath") + "\\" + subDir.string();
 
-  DirectoryCreate(_outputCondor2NavDataPath);
+  DirectoryAdd(_outputCondor2NavDataPath);
 
   _outputTaskFilePathList.emplace_back(_outputCondor2NavDataPath / TASK_FILE_NAME);
   if(Convert<unsigned>(ConfigParser().Value("XCSoar", "DefaultTaskOverwrite")))
     _outputTaskFilePathList.emplace_back(_outputXCSoarDataPath / DEFAULT_TASK_FILE_NAME);
 
-  auto profilePath = _outputCondor2NavDataPath / OUTPUT_PROFILE_NAME;
-  if(!FileExists(profilePath)) {
-    profilePath = _outputXCSoarDataPath / XCSOAR_PROFILE_NAME;
-    if(!FileExists(profilePath)) {
-      profilePath = CTranslator::DATA_PATH / XCSOAR_PROFILE_NAME;
-      if(!FileExists(profilePath))
-        throw EOperationFailed{"ERROR: Please copy '" + XCSOAR_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
-    }
-  }
-  _profileParser = std::make_unique<CFileParserINI>(profilePath);
+  // profiles read or written by previous translations are reused if not modified
+  _profileParser = Translator().App().INICache().Parser({_outputCondor2NavDataPath / OUTPUT_PROFILE_NAME,
+                                                         _outputXCSoarDataPath / XCSOAR_PROFILE_NAME,
+                                                         CTranslator::DATA_PATH / XCSOAR_PROFILE_NAME});
+  if(!_profileParser)
+    throw EOperationFailed{"ERROR: Please copy '" + XCSOAR_PROFILE_NAME.string() + "' file to '" + CTranslator::DATA_PATH.string() + "' directory."};
 }
 
 
@@ -74,7 +70,29 @@ condor2nav::CTargetXCSoar::CTargetXCSoar(const CTranslator &translator) :
  */
 condor2nav::CTargetXCSoar::~CTargetXCSoar()
 {
-  _profileParser->Dump(_outputCondor2NavDataPath / OUTPUT_PROFILE_NAME);
+}
+
+
+/**
+ * @brief Adds target profiles to the fingerprint. 
+ *
+ * @param fingerprint Fingerprint to update.
+ */
+void condor2nav::CTargetXCSoar::ProfilesFingerprint(CFingerprint &fingerprint) const
+{
+  _profileParser->Fingerprint(fingerprint);
+}
+
+
+/**
+ * @brief Writes target profiles. 
+ *
+ * Method writes XCSoar profile modified by the translation.
+ */
+void condor2nav::CTargetXCSoar::Commit()
+{
+  const std::vector<bfs::path> pathList{_outputCondor2NavDataPath / OUTPUT_PROFILE_NAME};
+  _profileParser->Dump(pathList, Translator().Output(), Translator().App().INICache().Storer(*_profileParser, pathList));
 }
 
 
@@ -84,14 +102,14 @@ condor2nav::CTargetXCSoar::~CTargetXCSoar()
  * Method dumps waypoints in XCSoar format.
  *
  * @param profileParser      XCSoar profile file parser.
- * @param taskParser         Condor task parser. 
+ * @param task               Condor task.
  * @param settingsTask       Task settings
  * @param taskPointArray     Task points array
  * @param startPointArray    Task start points array
  * @param waypointArray      The array of waypoints data.
  */
 void condor2nav::CTargetXCSoar::TaskDump(CFileParserINI &profileParser,
-                                         const CFileParserINI &taskParser,
+                                         const CCondor::CTask &task,
                                          const xcsoar::SETTINGS_TASK &settingsTask,
                                          const xcsoar::TASK_POINT taskPointArray[],
                                          const xcsoar::START_POINT startPointArray[],
@@ -99,41 +117,37 @@ void condor2nav::CTargetXCSoar::TaskDump(CFileParserINI &profileParser,
 {
   using namespace xcsoar;
 
-  COStream tskFile(_outputTaskFilePathList);
-
-  tskFile.Write(reinterpret_cast<const char *>(taskPointArray), MAXTASKPOINTS * sizeof(TASK_POINT));
-
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AATEnabled), sizeof(settingsTask.AATEnabled));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AATTaskLength), sizeof(settingsTask.AATTaskLength));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.FinishRadius), sizeof(settingsTask.FinishRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.FinishType), sizeof(settingsTask.FinishType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.StartRadius), sizeof(settingsTask.StartRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.StartType), sizeof(settingsTask.StartType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.SectorType), sizeof(settingsTask.SectorType));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.SectorRadius), sizeof(settingsTask.SectorRadius));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.AutoAdvance), sizeof(settingsTask.AutoAdvance));
-  tskFile.Write(reinterpret_cast<const char *>(&settingsTask.EnableMultipleStartPoints), sizeof(settingsTask.EnableMultipleStartPoints));
-
-  tskFile.Write(reinterpret_cast<const char *>(startPointArray), MAXSTARTPOINTS * sizeof(START_POINT));
-
-  std::array<WAYPOINT, MAXTASKPOINTS> taskWaypointArray;
-  std::array<WAYPOINT, MAXSTARTPOINTS> startWaypointArray;
-  memset(taskWaypointArray.data(), 0, taskWaypointArray.size() * sizeof(taskWaypointArray[0]));
-  memset(startWaypointArray.data(), 0, startWaypointArray.size() * sizeof(startWaypointArray[0]));
-
-  for(size_t i=0; i<waypointArray.size(); i++) {
-    taskWaypointArray[i].Number    = waypointArray[i].number;
-    taskWaypointArray[i].Latitude  = waypointArray[i].latitude;
-    taskWaypointArray[i].Longitude = waypointArray[i].longitude;
-    taskWaypointArray[i].Altitude  = waypointArray[i].altitude;
-    taskWaypointArray[i].Flags     = waypointArray[i].flags;
-    mbstowcs(taskWaypointArray[i].Name, waypointArray[i].name.c_str(), NAME_SIZE);
-    mbstowcs(taskWaypointArray[i].Comment, waypointArray[i].comment.c_str(), COMMENT_SIZE);
-    taskWaypointArray[i].InTask    = true;
+  // XCSoar 5 task file layout
+  using CTaskFileLayout = layout::TFile<
+    layout::TArray<TASK_POINT, MAXTASKPOINTS>,
+    CSettingsTaskLayout,
+    layout::TArray<START_POINT, MAXSTARTPOINTS>,
+    layout::TRecords<WAYPOINT, MAXTASKPOINTS>,
+    layout::TRecords<WAYPOINT, MAXSTARTPOINTS>>;
+  static_assert(CTaskFileLayout::size == (MAXTASKPOINTS + MAXSTARTPOINTS) * sizeof(WAYPOINT) + MAXTASKPOINTS * sizeof(TASK_POINT) +
+                                         MAXSTARTPOINTS * sizeof(START_POINT) + CSettingsTaskLayout::size, "Invalid XCSoar task file size");
+
+  std::vector<WAYPOINT> taskWaypoints;
+  taskWaypoints.reserve(waypointArray.size());
+  for(const auto &waypoint : waypointArray) {
+    // padding bytes are written to the file too
+    WAYPOINT wp;
+    memset(&wp, 0, sizeof(wp));
+    wp.Number    = waypoint.number;
+    wp.Latitude  = waypoint.latitude;
+    wp.Longitude = waypoint.longitude;
+    wp.Altitude  = waypoint.altitude;
+    wp.Flags     = waypoint.flags;
+    mbstowcs(wp.Name, waypoint.name.c_str(), NAME_SIZE);
+    mbstowcs(wp.Comment, waypoint.comment.c_str(), COMMENT_SIZE);
+    wp.InTask    = true;
+    taskWaypoints.push_back(wp);
   }
-  
-  tskFile.Write(reinterpret_cast<const char *>(taskWaypointArray.data()), taskWaypointArray.size() * sizeof(taskWaypointArray[0]));
-  tskFile.Write(reinterpret_cast<const char *>(startWaypointArray.data()), startWaypointArray.size() * sizeof(startWaypointArray[0]));
+
+  const auto buffer = CTaskFileLayout::Serialize(taskPointArray, settingsTask, startPointArray, taskWaypoints, std::vector<WAYPOINT>{});
+  COStream tskFile(_outputTaskFilePathList);
+  tskFile.Write(buffer.data(), buffer.size());
+  tskFile.Commit(Translator().Output());
 }
 
 
@@ -166,9 +180,9 @@ void condor2nav::CTargetXCSoar::Gps()
  */
 void condor2nav::CTargetXCSoar::SceneryMap(const CFileParserCSV::CStringArray &sceneryData)
 {
-  _profileParser->Value("", "MapFile",     "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_MAP_FILE) + "\"");
-  _profileParser->Value("", "TerrainFile", "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_TERRAIN_FILE) + "\"");
-  _profileParser->Value("", "WPFile",      "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_WAYPOINTS_FILE) + "\"");
+  _profileParser->Value("", "MapFile",     "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_MAP_FILE).to_string() + "\"");
+  _profileParser->Value("", "TerrainFile", "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_TERRAIN_FILE).to_string() + "\"");
+  _profileParser->Value("", "WPFile",      "\"" + _condor2navDataPathString + "\\" + sceneryData.at(SCENERY_WAYPOINTS_FILE).to_string() + "\"");
 
   // reset landscape specific files in case they were set before profile import
   // if need user can still assign additionl data with second entries
@@ -193,18 +207,19 @@ void condor2nav::CTargetXCSoar::SceneryTime()
 * Method created and sets glider polar file, handicap, safety speed, the time to empty the water
 * ballast and glider name for the logger.
 *
-* @param gliderData Information describing the glider. 
+* @param gliderData  Information describing the glider. 
+* @param gliderPolar Precomputed glider polar (nullptr if not available). 
  */
-void condor2nav::CTargetXCSoar::Glider(const CFileParserCSV::CStringArray &gliderData)
+void condor2nav::CTargetXCSoar::Glider(const CFileParserCSV::CStringArray &gliderData, const CFileParserCSV::CStringArray *gliderPolar)
 {
   // set WinPilot Polar
   _profileParser->Value("", "Polar", "6");
   _profileParser->Value("", "PolarFile", "\"" + _condor2navDataPathString + "\\" + POLAR_FILE_NAME.string() + "\"");
 
-  _profileParser->Value("", "AircraftType", "\"" + gliderData.at(GLIDER_NAME) + "\"");
-  _profileParser->Value("", "SafteySpeed", Convert(KmH2MS(Convert<unsigned>(gliderData.at(GLIDER_SPEED_MAX)))));
-  _profileParser->Value("", "Handicap", gliderData.at(GLIDER_DAEC_INDEX));
-  const std::string &waterBallastEmptyTime = gliderData.at(GLIDER_WATER_BALLAST_EMPTY_TIME);
+  _profileParser->Value("", "AircraftType", "\"" + gliderData.at(GLIDER_NAME).to_string() + "\"");
+  _profileParser->Value("", "SafteySpeed", Convert(KmH2MS(Convert<unsigned>(gliderData.at(GLIDER_SPEED_MAX).to_string()))));
+  _profileParser->Value("", "Handicap", gliderData.at(GLIDER_DAEC_INDEX).to_string());
+  const auto waterBallastEmptyTime = gliderData.at(GLIDER_WATER_BALLAST_EMPTY_TIME).to_string();
   _profileParser->Value("", "BallastSecsToEmpty", waterBallastEmptyTime == "0" ? "10" : waterBallastEmptyTime);
 
   // create polar file
@@ -215,21 +230,19 @@ void condor2nav::CTargetXCSoar::Glider(const CFileParserCSV::CStringArray &glide
   polarFile << "*" << std::endl;
   polarFile << "* MassDryGross[kg], MaxWaterBallast[liters], Speed1[km/h], Sink1[m/s], Speed2, Sink2, Speed3, Sink3" << std::endl;
   polarFile << "***************************************************************************************************" << std::endl;
-  for(size_t i=GLIDER_MASS_DRY_GROSS; i<=GLIDER_SINK_3; i++) {
-    if(i > GLIDER_MASS_DRY_GROSS)
-      polarFile << ",";
-    polarFile << gliderData.at(i);
-  }
+  PolarDump(polarFile, gliderData, gliderPolar);
   polarFile << std::endl;
 
   const auto ballast = Convert<unsigned>(Condor().TaskParser().Value("Plane", "Water"));
-  const auto maxBallast = Convert<unsigned>(gliderData.at(GLIDER_MAX_WATER_BALLAST));
+  const auto maxBallast = Convert<unsigned>(gliderData.at(GLIDER_MAX_WATER_BALLAST).to_string());
   if(maxBallast > 0 && ballast > 0) {
     unsigned xcsoarPercent = ballast * 100 / maxBallast;
     // round it to 5% increment steps
     xcsoarPercent = static_cast<unsigned>((static_cast<float>(xcsoarPercent) + 2.5) / 5) * 5;
     Translator().App().Warning() << "WARNING: Cannot set initial glider ballast in " << Name() << " automatically. Please open 'Config'->'Setup Basic' and set '" << xcsoarPercent << "%' for the glider ballast." << std::endl;
   }
+  polarFile.Commit(Translator().Output());
+  OutputAdd(_outputCondor2NavDataPath / POLAR_FILE_NAME);
 }
 
 
@@ -238,17 +251,20 @@ void condor2nav::CTargetXCSoar::Glider(const CFileParserCSV::CStringArray &glide
 *
 * Method sets task information.
 *
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task        Condor task.
 * @param sceneryData Information describing the scenery. 
 * @param aatTime     Minimum time for AAT task
  */
-void condor2nav::CTargetXCSoar::Task(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime)
+void condor2nav::CTargetXCSoar::Task(const CCondor::CTask &task, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime)
 {
   const auto wpFile = Convert<unsigned>(ConfigParser().Value("XCSoar", "TaskWPFileGenerate"));
-  TaskProcess(*_profileParser, taskParser, coordConv, aatTime,
+  TaskProcess(*_profileParser, task, aatTime,
               xcsoar::MAXTASKPOINTS, xcsoar::MAXSTARTPOINTS,
               wpFile > 0, _outputCondor2NavDataPath);
+  for(const auto &path : _outputTaskFilePathList)
+    OutputAdd(path);
+  if(wpFile > 0)
+    OutputAdd(_outputCondor2NavDataPath / WP_FILE_NAME);
 }
  
 
@@ -257,12 +273,12 @@ void condor2nav::CTargetXCSoar::Task(const CFileParserINI &taskParser, const CCo
 *
 * Method sets penalty zones used in the task.
 *
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task Condor task.
  */
-void condor2nav::CTargetXCSoar::PenaltyZones(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv)
+void condor2nav::CTargetXCSoar::PenaltyZones(const CCondor::CTask &task)
 {
-  PenaltyZonesProcess(*_profileParser, taskParser, coordConv, _condor2navDataPathString, _outputCondor2NavDataPath);
+  if(PenaltyZonesProcess(*_profileParser, task, _condor2navDataPathString, _outputCondor2NavDataPath))
+    OutputAdd(_outputCondor2NavDataPath / AIRSPACES_FILE_NAME);
 }
 
 
@@ -50,7 +50,7 @@ namespace condor2nav {
     std::string _condor2navDataPathString;                ///< @brief The Condor2Nav destination data directory path (in XCSoar format) on the target device that runs XCSoar.
     
     void TaskDump(CFileParserINI &profileParser,
-                  const CFileParserINI &taskParser,
+                  const CCondor::CTask &task,
                   const xcsoar::SETTINGS_TASK &settingsTask,
                   const xcsoar::TASK_POINT taskPointArray[],
                   const xcsoar::START_POINT startPointArray[],
@@ -60,17 +60,20 @@ namespace condor2nav {
     COStream::CPathList _outputTaskFilePathList;          ///< @brief The path where output XCSoar task file should be located
 
   public:
-    explicit CTargetXCSoar(const CTranslator &translator);
+    CTargetXCSoar(const CTranslator &translator, bfs::path outputPath);
     ~CTargetXCSoar();
 
     const char *Name() const override { return "XCSoar 5"; }
+    const char *DataDir() const override { return "XCSoar"; }
     void Gps() override;
     void SceneryMap(const CFileParserCSV::CStringArray &sceneryData) override;
     void SceneryTime() override;
-    void Glider(const CFileParserCSV::CStringArray &gliderData) override;
-    void Task(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) override;
-    void PenaltyZones(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv) override;
+    void Glider(const CFileParserCSV::CStringArray &gliderData, const CFileParserCSV::CStringArray *gliderPolar) override;
+    void Task(const CCondor::CTask &task, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) override;
+    void PenaltyZones(const CCondor::CTask &task) override;
     void Weather(const CFileParserINI &taskParser) override;
+    void ProfilesFingerprint(CFingerprint &fingerprint) const override;
+    void Commit() override;
   };
 
 }
@@ -28,6 +28,7 @@
 #include "targetXCSoar6.h"
 #include "imports/xcsoarTypes.h"
 #include "ostream.h"
+#include "taskGeometry.h"
 
 
 /**
@@ -36,9 +37,10 @@
  * condor2nav::CTargetXCSoar6 class constructor.
  *
  * @param translator Configuration INI file parser.
+ * @param outputPath Translation output directory.
  */
-condor2nav::CTargetXCSoar6::CTargetXCSoar6(const CTranslator &translator) :
-  CTargetXCSoar{translator}
+condor2nav::CTargetXCSoar6::CTargetXCSoar6(const CTranslator &translator, bfs::path outputPath) :
+  CTargetXCSoar{translator, std::move(outputPath)}
 {
 }
 
@@ -49,14 +51,14 @@ condor2nav::CTargetXCSoar6::CTargetXCSoar6(const CTranslator &translator) :
  * Method dumps waypoints in XCSoar v6 format.
  * 
  * @param profileParser      XCSoar profile file parser.
- * @param taskParser         Condor task parser. 
+ * @param task               Condor task.
  * @param settingsTask       Task settings
  * @param taskPointArray     Task points array
  * @param startPointArray    Task start points array
  * @param waypointArray      The array of waypoints data.
  */
 void condor2nav::CTargetXCSoar6::TaskDump(CFileParserINI &profileParser,
-                                          const CFileParserINI &taskParser,
+                                          const CCondor::CTask &task,
                                           const xcsoar::SETTINGS_TASK &settingsTask,
                                           const xcsoar::TASK_POINT taskPointArray[],
                                           const xcsoar::START_POINT startPointArray[],
@@ -66,6 +68,10 @@ void condor2nav::CTargetXCSoar6::TaskDump(CFileParserINI &profileParser,
 
   COStream tskFile{_outputTaskFilePathList};
 
+  // skip takeoff waypoint
+  const auto positions = task.Positions();
+  const CTaskGeometry geometry{CCondor::CCoordConverter::CPositionArray(positions.begin() + 1, positions.end())};
+
   if(settingsTask.AATEnabled) {
     tskFile << "<Task type=\"AAT\" task_scored=\"1\" aat_min_time=\""
       << (settingsTask.AATTaskLength * 60) << "\""; 
@@ -97,9 +103,9 @@ void condor2nav::CTargetXCSoar6::TaskDump(CFileParserINI &profileParser,
     tskFile << "\t\t\t<Location longitude=\"" << waypointArray[i].longitude << "\" latitude=\""<< waypointArray[i].latitude << "\"/>" << std::endl;
     tskFile << "\t\t</Waypoint>" << std::endl;
 
-    const auto tpIdxStr = Convert(i + 1);
-    const auto radius = Convert<unsigned>(taskParser.Value("Task", "TPRadius" + tpIdxStr));
-    const auto angle = Convert<unsigned>(taskParser.Value("Task", "TPAngle" + tpIdxStr));
+    const auto &tp = task.Turnpoints()[i + 1];
+    const auto radius = tp.radius;
+    const auto angle = tp.angle;
     if(angle == 360)
       tskFile << "\t\t<ObservationZone type=\"Cylinder\" radius=\"" << radius <<"\"/>" << std::endl;
     else {
@@ -107,28 +113,7 @@ void condor2nav::CTargetXCSoar6::TaskDump(CFileParserINI &profileParser,
         tskFile << "\t\t<ObservationZone type=\"Line\" length=\"" << radius * 2 <<"\"/>" << std::endl;
       }
       else {			
-        unsigned angle1;
-        unsigned angle2;
-        if(i == 0)
-          angle1 = WaypointBearing(TLongitude{waypointArray[i + 1].longitude}, TLatitude{waypointArray[i + 1].latitude},
-                                   TLongitude{waypointArray[i].longitude},     TLatitude{waypointArray[i].latitude});
-        else
-          angle1 = WaypointBearing(TLongitude{waypointArray[i - 1].longitude}, TLatitude{waypointArray[i - 1].latitude},
-                                   TLongitude{waypointArray[i].longitude},     TLatitude{waypointArray[i].latitude});
-        if(i < (waypointArray.size() - 1))
-          angle2 = WaypointBearing(TLongitude{waypointArray[i + 1].longitude}, TLatitude{waypointArray[i + 1].latitude},
-                                   TLongitude{waypointArray[i].longitude},     TLatitude{waypointArray[i].latitude});
-        else
-          angle2=angle1;
-
-        unsigned halfAngle;
-        if(angle1 == angle2)
-          halfAngle = angle1;
-        else {
-          halfAngle = static_cast<unsigned>((angle1 + angle2) / 2.0);
-          if((angle1 > angle2 && angle1 - angle2 > 180) || (angle1 < angle2 && angle2 - angle1 > 180))
-            halfAngle = (halfAngle + 180) % 360;
-        }
+        const auto halfAngle = geometry.Bisector(i);
         const double astart = static_cast<unsigned>(360 + halfAngle - angle / 2.0) % 360;
         const double aend = static_cast<unsigned>(360 + halfAngle + angle / 2.0) % 360;
         tskFile << "<ObservationZone type=\"Sector\" radius=\"" << radius << "\" start_radial=\""<< astart <<"\" end_radial=\""<< aend <<"\" />\r\n";
@@ -137,4 +122,5 @@ void condor2nav::CTargetXCSoar6::TaskDump(CFileParserINI &profileParser,
     tskFile << "\t</Point>" << std::endl;
   }
   tskFile << "</Task>" << std::endl;
+  tskFile.Commit(Translator().Output());
 }
@@ -41,13 +41,13 @@ namespace condor2nav {
    */
   class CTargetXCSoar6 : public CTargetXCSoar {
     void TaskDump(CFileParserINI &profileParser,
-                  const CFileParserINI &taskParser,
+                  const CCondor::CTask &task,
                   const xcsoar::SETTINGS_TASK &settingsTask,
                   const xcsoar::TASK_POINT taskPointArray[],
                   const xcsoar::START_POINT startPointArray[],
                   const CWaypointArray &waypointArray) const override;
   public:
-    explicit CTargetXCSoar6(const CTranslator &translator);
+    CTargetXCSoar6(const CTranslator &translator, bfs::path outputPath);
     const char *Name() const override { return "XCSoar 6"; }
   };
 
@@ -30,8 +30,14 @@
 #include "imports/xcsoarTypes.h"
 #include "imports/lk8000Types.h"
 #include "ostream.h"
+#include "airspaceWriter.h"
+#include "recordWriter.h"
+#include "taskGeometry.h"
+#include <boost/filesystem.hpp>
 #include <cmath>
 #include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 
 const bfs::path condor2nav::CTargetXCSoarCommon::OUTPUT_PROFILE_NAME    = "Condor.prf";
@@ -47,52 +53,59 @@ const bfs::path condor2nav::CTargetXCSoarCommon::WP_FILE_NAME           = "Condo
  * condor2nav::CTargetXCSoarCommon class constructor.
  *
  * @param translator Configuration INI file parser.
+ * @param outputPath Translation output directory.
  */
-condor2nav::CTargetXCSoarCommon::CTargetXCSoarCommon(const CTranslator &translator) :
-  CTranslator::CTarget{translator}
+condor2nav::CTargetXCSoarCommon::CTargetXCSoarCommon(const CTranslator &translator, bfs::path outputPath) :
+  CTranslator::CTarget{translator, std::move(outputPath)}
 {
 }
 
 
 /**
- * @brief Sets time for scenery time zone. 
+ * @brief Dumps glider polar curve.
  *
- * Method sets UTC time offset for selected scenery and forces time synchronization to the GPS source.
+ * Method writes WinPilot polar curve values (without the end of line so that
+ * target specific values may follow). Polar points are copied from the glider
+ * data, so they are written at their full precision. If precomputed glider polar
+ * is available, its characteristic speeds and speed to fly tables are written as
+ * comments for the pilot reference.
  *
- * @param profileParser XCSoar profile file parser.
+ * @param polarFile   Polar file stream.
+ * @param gliderData  Information describing the glider.
+ * @param gliderPolar Precomputed glider polar (nullptr if not available).
  */
-void condor2nav::CTargetXCSoarCommon::SceneryTimeProcess(CFileParserINI &profileParser) const
+void condor2nav::CTargetXCSoarCommon::PolarDump(COStream &polarFile,
+                                                const CFileParserCSV::CStringArray &gliderData,
+                                                const CFileParserCSV::CStringArray *gliderPolar)
 {
-  profileParser.Value("", "UTCOffset", "0");
+  if(gliderPolar) {
+    const auto &polar = *gliderPolar;
+    polarFile << "* Min sink " << polar.at(POLAR_MIN_SINK) << "m/s at " << polar.at(POLAR_MIN_SINK_SPEED) << "km/h, " <<
+      "best LD " << polar.at(POLAR_BEST_LD) << " at " << polar.at(POLAR_BEST_LD_SPEED) << "km/h" << std::endl;
+    polarFile << "* Speed to fly [km/h] for MacCready 0-5m/s (0.5m/s steps):" << std::endl;
+    polarFile << "*   water ballast   0%: " << polar.at(POLAR_SPEED_TO_FLY_0) << std::endl;
+    if(Convert<unsigned>(gliderData.at(GLIDER_MAX_WATER_BALLAST).to_string()) > 0) {
+      polarFile << "*   water ballast  50%: " << polar.at(POLAR_SPEED_TO_FLY_50) << std::endl;
+      polarFile << "*   water ballast 100%: " << polar.at(POLAR_SPEED_TO_FLY_100) << std::endl;
+    }
+  }
+
+  polarFile << gliderData.at(GLIDER_MASS_DRY_GROSS) << "," << gliderData.at(GLIDER_MAX_WATER_BALLAST);
+  for(size_t i=0; i<6; i++)
+    polarFile << "," << gliderData.at(GLIDER_SPPED_1 + i);
 }
 
 
 /**
-* @brief Calculates the bearing between 2 locations.
-*
-* Method calculates the bearing between 2 locations.
-*
-* @param lon1 First point longitude.
-* @param lat1 First point latitude.
-* @param lon2 Second point longitude.
-* @param lat2 Second point latitude.
-*
-* @return The bearing between 2 locations.
+ * @brief Sets time for scenery time zone. 
+ *
+ * Method sets UTC time offset for selected scenery and forces time synchronization to the GPS source.
+ *
+ * @param profileParser XCSoar profile file parser.
  */
-unsigned condor2nav::CTargetXCSoarCommon::WaypointBearing(TLongitude lon1, TLatitude lat1, TLongitude lon2, TLatitude lat2) const
+void condor2nav::CTargetXCSoarCommon::SceneryTimeProcess(CFileParserINI &profileParser) const
 {
-  const auto longitude1 = Deg2Rad(lon1.value);
-  const auto latitude1 = Deg2Rad(lat1.value);
-  const auto longitude2 = Deg2Rad(lon2.value);
-  const auto latitude2 = Deg2Rad(lat2.value);
-  
-  const double clat1 = cos(latitude1);
-  const double clat2 = cos(latitude2);
-  const double dlon = longitude2 - longitude1;
-
-  const double y = sin(dlon) * clat2;
-  const double x = clat1 * sin(latitude2) - sin(latitude1) * clat2 * cos(dlon);
-  return (x==0 && y==0) ? 0 : (static_cast<unsigned>(360 + Rad2Deg(atan2(y, x)) + 0.5) % 360);
+  profileParser.Value("", "UTCOffset", "0");
 }
 
 
@@ -102,23 +115,22 @@ unsigned condor2nav::CTargetXCSoarCommon::WaypointBearing(TLongitude lon1, TLati
 * Method sets task information.
 *
 * @param profileParser XCSoar profile file parser.
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task          Condor task.
 * @param aatTime     Minimum time for AAT task
 * @param maxTaskPoints The number of waypoints stored in a task file.
 * @param maxStartPoints The number of alternate startpoints stored in a task file.
 * @param generateWPFile Flag specifying if WP file should be generated.
 * @param wpOutputPathPrefix XCSoar WP subdirectory prefix (in filesystem format).
  */
-void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser, const CFileParserINI &taskParser,
-                                                  const CCondor::CCoordConverter &coordConv,
+void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser, const CCondor::CTask &task,
                                                   unsigned aatTime,
                                                   unsigned maxTaskPoints, unsigned maxStartPoints,
                                                   bool generateWPFile, const bfs::path &wpOutputPathPrefix) const
 {
   using namespace xcsoar;
 
-  const auto tpNum = Convert<unsigned>(taskParser.Value("Task", "Count"));
+  const auto &turnpoints = task.Turnpoints();
+  const auto tpNum = static_cast<unsigned>(turnpoints.size());
 
   // check if enough waypoints to create a task
   if(tpNum - 1 > maxTaskPoints)
@@ -151,13 +163,20 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
   for(size_t i=0; i<maxStartPoints; i++)
     startPointArray[i].Index = -1;
 
+  const CTaskGeometry geometry{task.Positions()};
+
   bool tpsValid{true};
 
+  // all task waypoints are written at once
+  std::unique_ptr<CRecordWriter> wpFile;
+  if(generateWPFile)
+    wpFile = std::make_unique<CRecordWriter>(wpOutputPathPrefix / WP_FILE_NAME);
+
   // skip takeoff waypoint
   for(size_t i=1; i<tpNum; i++) {
     // dump WP file line
-    auto tpIdxStr = Convert(i);
-    auto tpName = taskParser.Value("Task", "TPName" + tpIdxStr);
+    const auto &tp = turnpoints[i];
+    auto tpName = tp.name;
     std::string name;
     if(i == 1)
       name = "S:" + tpName;
@@ -166,19 +185,17 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
     else
       name = Convert(i - 1) + ":" + tpName;
 
-    auto x = taskParser.Value("Task", "TPPosX" + tpIdxStr);
-    auto y = taskParser.Value("Task", "TPPosY" + tpIdxStr);
-    auto latitude = coordConv.Latitude(x, y);
-    auto longitude = coordConv.Longitude(x, y);
-    auto latitudeStr = Coord2DDMMFF(latitude);
-    auto longitudeStr = Coord2DDMMFF(longitude);
-    double minAlt = Convert<unsigned>(taskParser.Value("Task", "TPWidth" + tpIdxStr));
-    double altitude = minAlt ? minAlt : Convert<double>(taskParser.Value("Task", "TPPosZ" + tpIdxStr));
+    const auto latitude = tp.position.latitude;
+    const auto longitude = tp.position.longitude;
+    double minAlt = tp.width;
+    double altitude = minAlt ? minAlt : tp.altitude;
     
-    if(generateWPFile) {
-      COStream wpFile{wpOutputPathPrefix / WP_FILE_NAME};
-      wpFile << i << "," << latitudeStr << "," << longitudeStr << ","
-        << altitude << "M,T," << name << "," << tpName << std::endl;
+    if(wpFile) {
+      char latitudeStr[COORD_STR_MAX_LENGTH];
+      char longitudeStr[COORD_STR_MAX_LENGTH];
+      const boost::string_ref latitudeRef{latitudeStr, static_cast<std::size_t>(Coord2DDMMFF(latitude, latitudeStr) - latitudeStr)};
+      const boost::string_ref longitudeRef{longitudeStr, static_cast<std::size_t>(Coord2DDMMFF(longitude, longitudeStr) - longitudeStr)};
+      wpFile->Row(i, latitudeRef, longitudeRef, Convert(altitude) + "M", "T", name, tpName);
     }
 
     {
@@ -196,11 +213,10 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
     }
 
     // dump Task File data
-    const auto sectorTypeStr = taskParser.Value("Task", "TPSectorType" + tpIdxStr);
-    const auto sectorType = Convert<unsigned>(sectorTypeStr);
+    const auto sectorType = tp.sectorType;
     if(sectorType == condor::SECTOR_CLASSIC) {
-      const auto radius = Convert<unsigned>(taskParser.Value("Task", "TPRadius" + tpIdxStr));
-      const auto angle = Convert<unsigned>(taskParser.Value("Task", "TPAngle" + tpIdxStr));
+      const auto radius = tp.radius;
+      const auto angle = tp.angle;
 
       if(settingsTask.AATEnabled && i > 1 && i < tpNum - 1) {
         // AAT waypoints
@@ -212,26 +228,7 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
           taskPointArray[i - 1].AATType = WAYPOINT_AAT_SECTOR;
           taskPointArray[i - 1].AATSectorRadius = radius;
 
-          const auto x1 = taskParser.Value("Task", "TPPosX" + Convert(i - 1));
-          const auto y1 = taskParser.Value("Task", "TPPosY" + Convert(i - 1));
-          const auto lon1 = coordConv.Longitude(x1, y1);
-          const auto lat1 = coordConv.Latitude(x1, y1);
-          const auto angle1 = WaypointBearing(lon1, lat1, longitude, latitude);
-
-          const auto x2 = taskParser.Value("Task", "TPPosX" + Convert(i + 1));
-          const auto y2 = taskParser.Value("Task", "TPPosY" + Convert(i + 1));
-          const auto lon2 = coordConv.Longitude(x2, y2);
-          const auto lat2 = coordConv.Latitude(x2, y2);
-          const auto angle2 = WaypointBearing(lon2, lat2, longitude, latitude);
-
-          unsigned halfAngle;
-          if(angle1 == angle2)
-            halfAngle = angle1;
-          else {
-            halfAngle = static_cast<unsigned>((angle1 + angle2) / 2.0);
-            if((angle1 > angle2 && angle1 - angle2 > 180) || (angle1 < angle2 && angle2 - angle1 > 180))
-              halfAngle = (halfAngle + 180) % 360;
-          }
+          const auto halfAngle = geometry.Bisector(i);
           taskPointArray[i - 1].AATStartRadial = static_cast<unsigned>(360 + halfAngle - angle / 2.0) % 360;
           taskPointArray[i - 1].AATFinishRadial = static_cast<unsigned>(360 + halfAngle + angle / 2.0) % 360;
         }
@@ -304,11 +301,11 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
 
         if(i == 1) {
           settingsTask.StartRadius = radius;
-          settingsTask.StartMaxHeight = Convert<unsigned>(taskParser.Value("Task", "TPHeight" + tpIdxStr));
+          settingsTask.StartMaxHeight = tp.height;
         }
         else if(i == tpNum - 1) {
           settingsTask.FinishRadius = radius;
-          //        settingsTask.FinishMinHeight = Convert<unsigned>(taskParser.Value("Task", "TPWidth" + tpIdxStr));
+          //        settingsTask.FinishMinHeight = tp.width;
           // AGL only in XCSoar ;-(
           settingsTask.FinishMinHeight = 0;
         }
@@ -317,7 +314,21 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
     else if(sectorType == condor::SECTOR_WINDOW)
       Translator().App().Warning() << "WARNING: " << name << ": " << Name() << " does not support window TP type. Circle TP will be used and you are responsible for reaching it on correct height and with correct heading." << std::endl;
     else
-      Translator().App().Error() << "ERROR: Unsupported sector type '" << sectorTypeStr << "' specified for TP '" << name << "'!!!";
+      Translator().App().Error() << "ERROR: Unsupported sector type '" << sectorType << "' specified for TP '" << name << "'!!!";
+  }
+
+  if(wpFile)
+    wpFile->Commit(Translator().Output());
+
+  // report task legs (takeoff leg is not a part of the task)
+  if(geometry.Legs() > 1) {
+    std::ostringstream legs;
+    legs << std::fixed << std::setprecision(1);
+    for(size_t i=1; i<geometry.Legs(); i++)
+      legs << (i > 1 ? ", " : "") << geometry.Distance(i);
+    std::ostringstream total;
+    total << std::fixed << std::setprecision(1) << geometry.Total() - geometry.Distance(0);
+    Translator().App().Log() << "Task distance: " << total.str() << " km (legs: " << legs.str() << " km)" << std::endl;
   }
 
   if(!tpsValid)
@@ -343,7 +354,7 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
   profileParser.Value("", "FAIFinishHeight", Convert(settingsTask.FinishMinHeight));
 
   // dump Task file
-  TaskDump(profileParser, taskParser, settingsTask, taskPointArray.get(), startPointArray.get(), waypointArray);
+  TaskDump(profileParser, task, settingsTask, taskPointArray.get(), startPointArray.get(), waypointArray);
 }
 
 
@@ -353,47 +364,83 @@ void condor2nav::CTargetXCSoarCommon::TaskProcess(CFileParserINI &profileParser,
 * Method sets penalty zones used in the task.
 *
 * @param profileParser XCSoar profile file parser.
-* @param taskParser Condor task parser. 
-* @param coordConv  Condor coordinates converter.
+* @param task          Condor task.
 * @param pathPrefix Polar file subdirectory prefix (in XCSoar format).
 * @param outputPathPrefix Polar file subdirectory prefix (in filesystem format).
+*
+* @return @p true if airspaces file was written.
  */
-void condor2nav::CTargetXCSoarCommon::PenaltyZonesProcess(CFileParserINI &profileParser,
-                                                          const CFileParserINI &taskParser,
-                                                          const CCondor::CCoordConverter &coordConv,
+bool condor2nav::CTargetXCSoarCommon::PenaltyZonesProcess(CFileParserINI &profileParser,
+                                                          const CCondor::CTask &task,
                                                           const bfs::path &pathPrefix,
                                                           const bfs::path &outputPathPrefix) const
 {
-  const auto pzNum = Convert<unsigned>(taskParser.Value("Task", "PZCount"));
-  if(pzNum == 0) {
+  CAirspaceWriter airspaces;
+  airspaces.PenaltyZones(task.PenaltyZones());
+  AirspacesMerge(airspaces, task);
+
+  if(!airspaces.Airspaces()) {
     profileParser.Value("", "AirspaceFile", "\"\"");
-    return;
+    return false;
   }
 
   profileParser.Value("", "AirspaceFile", "\"" + (pathPrefix / AIRSPACES_FILE_NAME).string() + std::string("\""));
-  COStream airspacesFile{outputPathPrefix / AIRSPACES_FILE_NAME};
-
-  airspacesFile << "*******************************************************" << std::endl;
-  airspacesFile << "* Condor Task Penalty Zones generated with Condor2Nav *" << std::endl;
-  airspacesFile << "*******************************************************" << std::endl;
-  for(size_t i=0; i<pzNum; i++) {
-    const auto tpIdxStr = Convert(i);
-    airspacesFile << std::endl;
-    airspacesFile << "AC P" << std::endl;
-    airspacesFile << "AN Penalty Zone " << i + 1 << std::endl;
-    airspacesFile << "AH " << taskParser.Value("Task", "PZTop" + tpIdxStr) << "m AMSL" << std::endl;
-    const auto base = Convert<unsigned>(taskParser.Value("Task", "PZBase" + tpIdxStr));
-    if(base == 0)
-      airspacesFile << "AL 0" << std::endl;
-    else
-      airspacesFile << "AL " << base << "m AMSL" << std::endl;
-    
-    for(size_t j=0; j<4; j++) {
-      const auto tpCornerIdxStr = Convert(j);
-      const auto x = taskParser.Value("Task", "PZPos" + tpCornerIdxStr + "X" + tpIdxStr);
-      const auto y = taskParser.Value("Task", "PZPos" + tpCornerIdxStr + "Y" + tpIdxStr);
-      airspacesFile << "DP " << Coord2DDMMSS(coordConv.Latitude(x, y)) <<
-        " " << Coord2DDMMSS(coordConv.Longitude(x, y)) << std::endl;
+  airspaces.Commit(outputPathPrefix / AIRSPACES_FILE_NAME, Translator().Output());
+  return true;
+}
+
+
+/**
+* @brief Merges external airspaces into penalty zones.
+*
+* Method merges OpenAir airspace file of the task landscape found in
+* the directory set with 'AirspacesPath' option. If 'AirspacesClipMargin'
+* is greater than 0 only the airspaces close to the task area are merged.
+*
+* @param airspaces Airspace file writer.
+* @param task      Condor task.
+ */
+void condor2nav::CTargetXCSoarCommon::AirspacesMerge(CAirspaceWriter &airspaces, const CCondor::CTask &task) const
+{
+  std::string dir;
+  double margin = 0;
+  try {
+    dir = ConfigParser().Value("Condor2Nav", "AirspacesPath");
+    margin = Convert<double>(ConfigParser().Value("Condor2Nav", "AirspacesClipMargin"));
+  }
+  catch(const Exception &) {
+  }
+  if(dir.empty())
+    return;
+
+  const auto path = bfs::path{dir} / (task.Landscape() + ".txt");
+  if(!bfs::exists(path)) {
+    Translator().App().Warning() << "WARNING: Airspaces file '" << path.string() << "' not found!!!" << std::endl;
+    return;
+  }
+
+  const auto positions = task.Positions();
+  std::unique_ptr<CAirspaceWriter::TArea> area;
+  if(margin > 0 && !positions.empty()) {
+    area = std::make_unique<CAirspaceWriter::TArea>();
+    area->lonMin = area->lonMax = positions.front().longitude.value;
+    area->latMin = area->latMax = positions.front().latitude.value;
+    for(const auto &pos : positions) {
+      area->lonMin = std::min(area->lonMin, pos.longitude.value);
+      area->lonMax = std::max(area->lonMax, pos.longitude.value);
+      area->latMin = std::min(area->latMin, pos.latitude.value);
+      area->latMax = std::max(area->latMax, pos.latitude.value);
     }
+
+    // convert the margin to degrees
+    const double latMargin = margin / DEGREE_LENGTH;
+    const double lonMargin = latMargin / std::max(0.01, std::cos(Deg2Rad(std::max(std::abs(area->latMin), std::abs(area->latMax)))));
+    area->lonMin -= lonMargin;
+    area->lonMax += lonMargin;
+    area->latMin -= latMargin;
+    area->latMax += latMargin;
   }
+
+  const auto merged = airspaces.Merge(path, area.get());
+  Translator().App().Log() << "Airspaces merged from '" << path.string() << "': " << merged << std::endl;
 }
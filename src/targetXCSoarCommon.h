@@ -30,11 +30,13 @@
 
 #include "translator.h"
 #include "imports/xcsoarTypes.h"
+#include "binaryLayout.h"
 
 
 namespace condor2nav {
 
   class COStream;
+  class CAirspaceWriter;
 
   /**
    * @brief Common tools for XCSoar family translations.
@@ -59,6 +61,22 @@ namespace condor2nav {
     };
     using CWaypointArray = std::vector<TWaypoint>;
 
+    /**
+     * @brief Task settings as stored in XCSoar family task files.
+     */
+    using CSettingsTaskLayout = layout::TRecord<xcsoar::SETTINGS_TASK,
+      layout::TField<xcsoar::SETTINGS_TASK, BOOL,                        &xcsoar::SETTINGS_TASK::AATEnabled>,
+      layout::TField<xcsoar::SETTINGS_TASK, double,                      &xcsoar::SETTINGS_TASK::AATTaskLength>,
+      layout::TField<xcsoar::SETTINGS_TASK, DWORD,                       &xcsoar::SETTINGS_TASK::FinishRadius>,
+      layout::TField<xcsoar::SETTINGS_TASK, xcsoar::FinishSectorType_t,  &xcsoar::SETTINGS_TASK::FinishType>,
+      layout::TField<xcsoar::SETTINGS_TASK, DWORD,                       &xcsoar::SETTINGS_TASK::StartRadius>,
+      layout::TField<xcsoar::SETTINGS_TASK, xcsoar::StartSectorType_t,   &xcsoar::SETTINGS_TASK::StartType>,
+      layout::TField<xcsoar::SETTINGS_TASK, xcsoar::ASTSectorType_t,     &xcsoar::SETTINGS_TASK::SectorType>,
+      layout::TField<xcsoar::SETTINGS_TASK, DWORD,                       &xcsoar::SETTINGS_TASK::SectorRadius>,
+      layout::TField<xcsoar::SETTINGS_TASK, xcsoar::AutoAdvanceMode_t,   &xcsoar::SETTINGS_TASK::AutoAdvance>,
+      layout::TField<xcsoar::SETTINGS_TASK, bool,                        &xcsoar::SETTINGS_TASK::EnableMultipleStartPoints>>;
+    static_assert(CSettingsTaskLayout::size == 41, "Task settings are stored in a packed 41 bytes record");
+
     // outputs
     static const bfs::path OUTPUT_PROFILE_NAME;             ///< @brief The name of XCSoar profile file to generate. 
     static const bfs::path TASK_FILE_NAME;                  ///< @brief The name of XCSoar task file to generate. 
@@ -68,30 +86,32 @@ namespace condor2nav {
     static const bfs::path WP_FILE_NAME;                    ///< @brief The name of XCSoar WP file with task waypoints.
     static const unsigned WAYPOINT_INDEX_OFFSET = 100000;   ///< @brief A big value that should point behind all the waypoints
 
-    unsigned WaypointBearing(TLongitude lon1, TLatitude lat1, TLongitude lon2, TLatitude lat2) const;
     virtual void TaskDump(CFileParserINI &profileParser,
-                          const CFileParserINI &taskParser,
+                          const CCondor::CTask &task,
                           const xcsoar::SETTINGS_TASK &settingsTask,
                           const xcsoar::TASK_POINT taskPointArray[],
                           const xcsoar::START_POINT startPointArray[],
                           const CWaypointArray &waypointArray) const = 0;
     void SceneryTimeProcess(CFileParserINI &profileParser) const;
     void TaskProcess(CFileParserINI &profileParser,
-                     const CFileParserINI &taskParser,
-                     const CCondor::CCoordConverter &coordConv,
+                     const CCondor::CTask &task,
                      unsigned aatTime,
                      unsigned maxTaskPoints,
                      unsigned maxStartPoints,
                      bool generateWPFile,
                      const bfs::path &wpOutputPathPrefix) const;
-    void PenaltyZonesProcess(CFileParserINI &profileParser,
-                             const CFileParserINI &taskParser,
-                             const CCondor::CCoordConverter &coordConv,
+    bool PenaltyZonesProcess(CFileParserINI &profileParser,
+                             const CCondor::CTask &task,
                              const bfs::path &pathPrefix,
                              const bfs::path &outputPathPrefix) const;
+    void AirspacesMerge(CAirspaceWriter &airspaces, const CCondor::CTask &task) const;
 
   public:
-    explicit CTargetXCSoarCommon(const CTranslator &translator);
+    static void PolarDump(COStream &polarFile,
+                          const CFileParserCSV::CStringArray &gliderData,
+                          const CFileParserCSV::CStringArray *gliderPolar);
+
+    CTargetXCSoarCommon(const CTranslator &translator, bfs::path outputPath);
   };
 
 }
@@ -0,0 +1,119 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskCorridor.cpp
+ *
+ * @brief Implements the condor2nav::CTaskCorridor class. 
+ */
+
+#include "taskCorridor.h"
+#include <algorithm>
+#include <cmath>
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CTaskCorridor class constructor.
+ *
+ * @param positions Task waypoints positions.
+ * @param margin    The width of the corridor on each side of the legs [km].
+ */
+condor2nav::CTaskCorridor::CTaskCorridor(const CCondor::CCoordConverter::CPositionArray &positions, double margin) :
+  _margin{margin}, _cellSize{std::max(margin, 5.0)}, _lonScale{DEGREE_LENGTH}
+{
+  if(positions.empty())
+    return;
+
+  double latSum = 0;
+  for(const auto &pos : positions)
+    latSum += pos.latitude.value;
+  _lonScale = DEGREE_LENGTH * std::cos(Deg2Rad(latSum / positions.size()));
+
+  auto leg = [&](const CCondor::CCoordConverter::TPosition &p1, const CCondor::CCoordConverter::TPosition &p2)
+  {
+    _legs.push_back(TLeg{p1.longitude.value * _lonScale, p1.latitude.value * DEGREE_LENGTH,
+                         p2.longitude.value * _lonScale, p2.latitude.value * DEGREE_LENGTH});
+  };
+  if(positions.size() == 1)
+    leg(positions.front(), positions.front());
+  for(size_t i=1; i<positions.size(); i++)
+    leg(positions[i - 1], positions[i]);
+
+  // register legs in all the cells touched by their bounding boxes extended with the margin
+  for(unsigned i=0; i<_legs.size(); i++) {
+    const auto &leg = _legs[i];
+    const auto xMin = static_cast<std::int32_t>(std::floor((std::min(leg.x1, leg.x2) - _margin) / _cellSize));
+    const auto xMax = static_cast<std::int32_t>(std::floor((std::max(leg.x1, leg.x2) + _margin) / _cellSize));
+    const auto yMin = static_cast<std::int32_t>(std::floor((std::min(leg.y1, leg.y2) - _margin) / _cellSize));
+    const auto yMax = static_cast<std::int32_t>(std::floor((std::max(leg.y1, leg.y2) + _margin) / _cellSize));
+    for(auto x=xMin; x<=xMax; x++)
+      for(auto y=yMin; y<=yMax; y++)
+        _cells[Cell(x, y)].push_back(i);
+  }
+}
+
+
+/**
+ * @brief Returns the key of the index cell.
+ *
+ * @param x Cell column.
+ * @param y Cell row.
+ *
+ * @return Cell key.
+ */
+std::uint64_t condor2nav::CTaskCorridor::Cell(std::int32_t x, std::int32_t y) const
+{
+  return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y);
+}
+
+
+/**
+ * @brief Checks if a point is inside of the corridor.
+ *
+ * @param lon Point longitude.
+ * @param lat Point latitude.
+ *
+ * @return @p true if the point is not further than the margin from any of the task legs.
+ */
+bool condor2nav::CTaskCorridor::Inside(TLongitude lon, TLatitude lat) const
+{
+  const double x = lon.value * _lonScale;
+  const double y = lat.value * DEGREE_LENGTH;
+  const auto it = _cells.find(Cell(static_cast<std::int32_t>(std::floor(x / _cellSize)), static_cast<std::int32_t>(std::floor(y / _cellSize))));
+  if(it == _cells.end())
+    return false;
+
+  for(auto idx : it->second) {
+    // distance to the closest point of the leg
+    const auto &leg = _legs[idx];
+    const double dx = leg.x2 - leg.x1;
+    const double dy = leg.y2 - leg.y1;
+    const double len2 = dx * dx + dy * dy;
+    const double t = len2 > 0 ? std::max(0.0, std::min(1.0, ((x - leg.x1) * dx + (y - leg.y1) * dy) / len2)) : 0;
+    const double ex = leg.x1 + t * dx - x;
+    const double ey = leg.y1 + t * dy - y;
+    if(ex * ex + ey * ey <= _margin * _margin)
+      return true;
+  }
+  return false;
+}
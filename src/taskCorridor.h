@@ -0,0 +1,73 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskCorridor.h
+ *
+ * @brief Declares the condor2nav::CTaskCorridor class. 
+ */
+
+#ifndef __TASKCORRIDOR_H__
+#define __TASKCORRIDOR_H__
+
+#include "nonCopyable.h"
+#include "condor.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Task corridor.
+   *
+   * condor2nav::CTaskCorridor describes the area within a margin from the task
+   * legs. Legs are indexed with a grid of square cells so that checking a point
+   * needs to compute the distance only to the legs crossing the point's cell.
+   * Distances are calculated on a local plane projection which is accurate
+   * enough for Condor landscapes.
+   */
+  class CTaskCorridor : CNonCopyable {
+    /**
+     * @brief Task leg in km on a projection plane.
+     */
+    struct TLeg {
+      double x1, y1;
+      double x2, y2;
+    };
+    using CCells = std::unordered_map<std::uint64_t, std::vector<unsigned>>;
+
+    const double _margin;                 ///< @brief The width of the corridor on each side of the legs [km]
+    double _cellSize;                     ///< @brief The size of the index cell [km]
+    double _lonScale;                     ///< @brief Longitude degree length in the task area [km]
+    std::vector<TLeg> _legs;              ///< @brief Task legs
+    CCells _cells;                        ///< @brief Legs crossing the index cells
+
+    std::uint64_t Cell(std::int32_t x, std::int32_t y) const;
+
+  public:
+    CTaskCorridor(const CCondor::CCoordConverter::CPositionArray &positions, double margin);
+    bool Inside(TLongitude lon, TLatitude lat) const;
+  };
+
+}
+
+#endif /* __TASKCORRIDOR_H__ */
@@ -0,0 +1,151 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskGeometry.cpp
+ *
+ * @brief Implements the condor2nav::CTaskGeometry class. 
+ */
+
+#include "taskGeometry.h"
+#include <cmath>
+#include <numeric>
+
+
+const double condor2nav::CTaskGeometry::EARTH_RADIUS = 6371.0;
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CTaskGeometry class constructor. Calculates all the legs.
+ *
+ * @param positions Task waypoints positions.
+ */
+condor2nav::CTaskGeometry::CTaskGeometry(const CCondor::CCoordConverter::CPositionArray &positions) :
+  _total{0}
+{
+  const auto size = positions.size();
+  _lat.reserve(size);
+  _lon.reserve(size);
+  for(const auto &pos : positions) {
+    _lat.push_back(Deg2Rad(pos.latitude.value));
+    _lon.push_back(Deg2Rad(pos.longitude.value));
+  }
+
+  const auto legs = size ? size - 1 : 0;
+  _distance.resize(legs);
+  _bearing.resize(legs);
+  _backBearing.resize(legs);
+  const auto lat = _lat.data();
+  const auto lon = _lon.data();
+  const auto distance = _distance.data();
+  const auto bearing = _bearing.data();
+  const auto backBearing = _backBearing.data();
+  for(std::size_t i=0; i<legs; i++) {
+    const double sinLat1 = std::sin(lat[i]);
+    const double cosLat1 = std::cos(lat[i]);
+    const double sinLat2 = std::sin(lat[i + 1]);
+    const double cosLat2 = std::cos(lat[i + 1]);
+    const double dLon = lon[i + 1] - lon[i];
+    const double sinDLon = std::sin(dLon);
+    const double cosDLon = std::cos(dLon);
+
+    // haversine distance
+    const double sinHalfDLat = std::sin((lat[i + 1] - lat[i]) / 2);
+    const double sinHalfDLon = std::sin(dLon / 2);
+    const double a = sinHalfDLat * sinHalfDLat + cosLat1 * cosLat2 * sinHalfDLon * sinHalfDLon;
+    distance[i] = 2 * EARTH_RADIUS * std::atan2(std::sqrt(a), std::sqrt(1 - a));
+
+    // initial bearings from both ends of the leg
+    bearing[i] = Rad2Deg(std::atan2(sinDLon * cosLat2, cosLat1 * sinLat2 - sinLat1 * cosLat2 * cosDLon));
+    backBearing[i] = Rad2Deg(std::atan2(-sinDLon * cosLat1, cosLat2 * sinLat1 - sinLat2 * cosLat1 * cosDLon));
+  }
+  _total = std::accumulate(_distance.begin(), _distance.end(), 0.0);
+}
+
+
+/**
+ * @brief Rounds bearing to full degrees.
+ *
+ * @param bearing Bearing in range (-180, 180].
+ *
+ * @return Bearing in range [0, 360).
+ */
+unsigned condor2nav::CTaskGeometry::Round(double bearing)
+{
+  return static_cast<unsigned>(360 + bearing + 0.5) % 360;
+}
+
+
+/**
+ * @brief Returns the bearing of the leg.
+ *
+ * @param leg The index of the leg (the leg starts at the waypoint with the same index).
+ *
+ * @return The bearing from the leg beginning to its end [deg].
+ */
+unsigned condor2nav::CTaskGeometry::Bearing(std::size_t leg) const
+{
+  return _distance[leg] > 0 ? Round(_bearing[leg]) : 0;
+}
+
+
+/**
+ * @brief Returns the bearing from the leg end to its beginning.
+ *
+ * @param leg The index of the leg (the leg starts at the waypoint with the same index).
+ *
+ * @return The bearing from the leg end to its beginning [deg].
+ */
+unsigned condor2nav::CTaskGeometry::BackBearing(std::size_t leg) const
+{
+  return _distance[leg] > 0 ? Round(_backBearing[leg]) : 0;
+}
+
+
+/**
+ * @brief Returns the bisector of the waypoint sector.
+ *
+ * The sectors of the first and the last waypoint are oriented along
+ * their only leg.
+ *
+ * @param waypoint The index of the waypoint.
+ *
+ * @return The bearing halfway between the directions to the previous and to the next waypoint [deg].
+ */
+unsigned condor2nav::CTaskGeometry::Bisector(std::size_t waypoint) const
+{
+  if(waypoint == 0)
+    return BackBearing(0);
+  if(waypoint == Legs())
+    return Bearing(waypoint - 1);
+
+  // bearings from the previous and from the next waypoint
+  const auto angle1 = Bearing(waypoint - 1);
+  const auto angle2 = BackBearing(waypoint);
+  if(angle1 == angle2)
+    return angle1;
+  auto halfAngle = static_cast<unsigned>((angle1 + angle2) / 2.0);
+  if((angle1 > angle2 && angle1 - angle2 > 180) || (angle1 < angle2 && angle2 - angle1 > 180))
+    halfAngle = (halfAngle + 180) % 360;
+  return halfAngle;
+}
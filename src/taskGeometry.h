@@ -0,0 +1,71 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskGeometry.h
+ *
+ * @brief Declares the condor2nav::CTaskGeometry class. 
+ */
+
+#ifndef __TASKGEOMETRY_H__
+#define __TASKGEOMETRY_H__
+
+#include "nonCopyable.h"
+#include "condor.h"
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Task legs geometry.
+   *
+   * condor2nav::CTaskGeometry calculates great circle distances and bearings of
+   * all the legs between consecutive task waypoints. Coordinates are stored as
+   * separate columns and all the legs are calculated in one loop without
+   * branches so that the compiler may vectorize it.
+   */
+  class CTaskGeometry : CNonCopyable {
+    static const double EARTH_RADIUS;     ///< @brief Mean Earth radius [km]
+
+    using CColumn = std::vector<double>;
+    CColumn _lat;                         ///< @brief Waypoints latitudes [rad]
+    CColumn _lon;                         ///< @brief Waypoints longitudes [rad]
+    CColumn _distance;                    ///< @brief Legs distances [km]
+    CColumn _bearing;                     ///< @brief Legs bearings [deg]
+    CColumn _backBearing;                 ///< @brief Legs bearings from the leg end to its beginning [deg]
+    double _total;                        ///< @brief Sum of all legs distances [km]
+
+    static unsigned Round(double bearing);
+
+  public:
+    explicit CTaskGeometry(const CCondor::CCoordConverter::CPositionArray &positions);
+
+    std::size_t Legs() const              { return _distance.size(); }
+    double Distance(std::size_t leg) const { return _distance[leg]; }
+    double Total() const                  { return _total; }
+    unsigned Bearing(std::size_t leg) const;
+    unsigned BackBearing(std::size_t leg) const;
+    unsigned Bisector(std::size_t waypoint) const;
+  };
+
+}
+
+#endif /* __TASKGEOMETRY_H__ */
@@ -0,0 +1,133 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskPrefetch.cpp
+ *
+ * @brief Implements the condor2nav::CTaskPrefetch class. 
+ */
+
+#include "taskPrefetch.h"
+#include "condor.h"
+#include "condor2nav.h"
+#include "traceLog.h"
+#include "tools.h"
+
+
+/**
+ * @brief Checks if likely tasks should be prepared in the background.
+ *
+ * @param app Condor2Nav application.
+ *
+ * @return 'Condor2Nav/PreTranslate' setting (disabled if not provided).
+ */
+bool condor2nav::CTaskPrefetch::Enabled(const CCondor2Nav &app)
+{
+  try {
+    return app.ConfigParser().Value("Condor2Nav", "PreTranslate") == "1";
+  }
+  catch(const Exception &) {
+    return false;
+  }
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param app Condor2Nav application.
+ */
+condor2nav::CTaskPrefetch::CTaskPrefetch(const CCondor2Nav &app) :
+  _app{app}
+{
+}
+
+
+/**
+ * @brief Prepares the tasks that are likely to be translated next.
+ *
+ * Method prepares the default task and the task of the last race. Tasks
+ * that cannot be found or prepared are skipped as their errors are reported
+ * by the translation.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param cancel     Cancellation token checked between the tasks.
+ */
+void condor2nav::CTaskPrefetch::Prepare(const bfs::path &condorPath, const CCancellationToken &cancel)
+{
+  CTraceScope trace{"prefetch", "Prepare"};
+  for(auto fplType : { CCondor2Nav::TFPLType::DEFAULT, CCondor2Nav::TFPLType::RESULT }) {
+    if(cancel.Cancelled())
+      return;
+    try {
+      Prepare(condorPath, condor::FPLPath(_app.ConfigParser(), fplType, condorPath));
+    }
+    catch(const std::exception &) {
+    }
+  }
+}
+
+
+/**
+ * @brief Prepares a task.
+ *
+ * @param condorPath Full pathname of the Condor directory.
+ * @param fplPath    Full pathname of the FPL file.
+ *
+ * @exception std Thrown when the task cannot be prepared.
+ */
+void condor2nav::CTaskPrefetch::Prepare(const bfs::path &condorPath, const bfs::path &fplPath)
+{
+  const auto writeTime = FileWriteTime(fplPath);
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto it = _entries.find(fplPath);
+    if(it != _entries.end() && it->second.writeTime == writeTime)
+      return;
+  }
+
+  CTraceScope trace{"prefetch", "Task", fplPath.string()};
+  auto condor = std::make_shared<const CCondor>(condorPath, fplPath, _app.NaviConPool());
+  condor->Task().Turnpoints();
+  condor->Task().PenaltyZones();
+
+  std::lock_guard<std::mutex> lock{_mutex};
+  _entries[fplPath] = TEntry{writeTime, std::move(condor)};
+}
+
+
+/**
+ * @brief Returns prepared task.
+ *
+ * @param fplPath Full pathname of the FPL file.
+ *
+ * @return Prepared task or @p nullptr if the task was not prepared or the FPL
+ *         file was modified since then.
+ */
+auto condor2nav::CTaskPrefetch::Prepared(const bfs::path &fplPath) const -> std::shared_ptr<const CCondor>
+{
+  const auto writeTime = FileWriteTime(fplPath);
+  std::lock_guard<std::mutex> lock{_mutex};
+  auto it = _entries.find(fplPath);
+  if(it == _entries.end() || !writeTime || it->second.writeTime != writeTime)
+    return nullptr;
+  return it->second.condor;
+}
@@ -0,0 +1,80 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file taskPrefetch.h
+ *
+ * @brief Declares the condor2nav::CTaskPrefetch class. 
+ */
+
+#ifndef __TASK_PREFETCH_H__
+#define __TASK_PREFETCH_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include "cancellation.h"
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace condor2nav {
+
+  class CCondor;
+  class CCondor2Nav;
+
+  /**
+   * @brief Cache of prepared Condor tasks.
+   *
+   * condor2nav::CTaskPrefetch prepares in the background the tasks that are
+   * likely to be translated next (i.e. the default task and the last race).
+   * Preparation parses the FPL file and converts all the task coordinates,
+   * which may require NaviCon.dll initialization for a new landscape. The
+   * translation of a prepared task only runs the target stages and writes
+   * the outputs. A prepared task is used only if its FPL file was not
+   * modified after the preparation.
+   */
+  class CTaskPrefetch : CNonCopyable {
+    /**
+     * @brief Prepared task.
+     */
+    struct TEntry {
+      std::uint64_t writeTime;                    ///< @brief FPL file modification time at preparation time
+      std::shared_ptr<const CCondor> condor;      ///< @brief Prepared task
+    };
+
+    const CCondor2Nav &_app;                      ///< @brief Condor2Nav application
+    std::map<bfs::path, TEntry> _entries;         ///< @brief Prepared tasks
+    mutable std::mutex _mutex;                    ///< @brief Guards prepared tasks
+
+  public:
+    static bool Enabled(const CCondor2Nav &app);
+
+    explicit CTaskPrefetch(const CCondor2Nav &app);
+    void Prepare(const bfs::path &condorPath, const CCancellationToken &cancel);
+    void Prepare(const bfs::path &condorPath, const bfs::path &fplPath);
+    std::shared_ptr<const CCondor> Prepared(const bfs::path &fplPath) const;
+  };
+
+}
+
+#endif /* __TASK_PREFETCH_H__ */
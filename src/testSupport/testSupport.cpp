@@ -0,0 +1,194 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file testSupport/testSupport.cpp
+ *
+ * @brief Implements fixtures shared by Condor2Nav unit tests and benchmarks.
+ */
+
+#include "testSupport.h"
+#include "tools.h"
+#include <boost/filesystem/fstream.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+
+std::atomic<unsigned long long> condor2nav::test::allocations{0};
+std::atomic<unsigned long long> condor2nav::test::allocatedBytes{0};
+std::mutex condor2nav::test::CCurrentDir::_mutex;
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param name The prefix of the directory name.
+ */
+condor2nav::test::CWorkDir::CWorkDir(const std::string &name) :
+  _path{bfs::temp_directory_path() / bfs::unique_path(name + "-%%%%-%%%%-%%%%")}
+{
+  DirectoryCreate(_path);
+}
+
+
+/**
+ * @brief Class destructor.
+ */
+condor2nav::test::CWorkDir::~CWorkDir()
+{
+  boost::system::error_code error;
+  bfs::remove_all(_path, error);
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param path New current directory.
+ */
+condor2nav::test::CCurrentDir::CCurrentDir(const bfs::path &path) :
+  _lock{_mutex}, _previous{bfs::current_path()}
+{
+  bfs::current_path(path);
+}
+
+
+/**
+ * @brief Class destructor.
+ */
+condor2nav::test::CCurrentDir::~CCurrentDir()
+{
+  boost::system::error_code error;
+  bfs::current_path(_previous, error);
+}
+
+
+/**
+ * @brief Writes a file.
+ *
+ * @param path    File path.
+ * @param content File content.
+ *
+ * @return The size of the file.
+ */
+double condor2nav::test::FileWrite(const bfs::path &path, const std::string &content)
+{
+  bfs::ofstream stream{path, std::ios_base::out | std::ios_base::binary};
+  stream << content;
+  return static_cast<double>(content.size());
+}
+
+
+/**
+ * @brief Generates LK8000 or Condor map template.
+ *
+ * @param name   Map name.
+ * @param lonMin Western edge of the map.
+ * @param latMin Southern edge of the map.
+ * @param size   The size of the map [deg].
+ * @param res    Map resolution (250, 500 or 1000).
+ *
+ * @return File content.
+ */
+std::string condor2nav::test::TemplateGenerate(const std::string &name, double lonMin, double latMin, double size, unsigned res)
+{
+  std::ostringstream map;
+  map << std::fixed << std::setprecision(1);
+  map << "NAME=" << name << "\r\nDIR=TEST\r\n\r\n";
+  map << "LONMIN=" << lonMin << "\r\nLONMAX=" << lonMin + size << "\r\n";
+  map << "LATMIN=" << latMin << "\r\nLATMAX=" << latMin + size << "\r\n\r\n";
+  map << "RES1000=" << (res == 1000 ? "YES" : "NO") << "\r\n";
+  map << "RES500=" << (res == 500 ? "YES" : "NO") << "\r\n";
+  map << "RES250=" << (res == 250 ? "YES" : "NO") << "\r\n";
+  map << "RES90=NO\r\n\r\nTOPOLOGY=YES\r\nXTOPOLOGY=YES\r\nMAPZONE=EUR\r\n";
+  return map.str();
+}
+
+
+/**
+ * @brief Generates Condor landscapes and LK8000 maps templates in current directory.
+ *
+ * Application configuration file is created too.
+ *
+ * @param landscapes The number of Condor landscapes.
+ * @param templates  The number of LK8000 maps templates.
+ * @param rand       Random numbers generator.
+ *
+ * @return The names of LK8000 maps templates.
+ */
+condor2nav::CLKMapsDB::CNamesList condor2nav::test::LandscapesGenerate(unsigned landscapes, unsigned templates, std::mt19937 &rand)
+{
+  std::uniform_real_distribution<double> lon{-10, 40};
+  std::uniform_real_distribution<double> lat{35, 60};
+  std::uniform_int_distribution<unsigned> size{1, 10};
+  const unsigned res[] = {250, 500, 1000};
+  FileWrite(CTestApp::CONFIG_FILE_NAME, "[Condor2Nav]\r\n");
+  DirectoryCreate("data/Landscapes");
+  DirectoryCreate("data/LK8000/LKMTemplates");
+  std::ostringstream sceneries;
+  sceneries << "Condor Scenery,Map File,Terrain File,Waypoints File\n";
+  for(unsigned i=0; i<landscapes; i++) {
+    const auto name = "Landscape" + Convert(i);
+    FileWrite("data/Landscapes/" + name + "_1.0.TXT", TemplateGenerate(name, lon(rand), lat(rand), size(rand) / 4.0, 1000));
+    sceneries << name << ",,," << name << ".cup\n";
+  }
+  FileWrite("data/LK8000/SceneryData.csv", sceneries.str());
+  CLKMapsDB::CNamesList names;
+  for(unsigned i=0; i<templates; i++) {
+    const auto name = "MAP" + Convert(i);
+    FileWrite("data/LK8000/LKMTemplates/" + name + ".TXT", TemplateGenerate(name, lon(rand), lat(rand), size(rand), res[i % 3]));
+    names.emplace_back((name + ".TXT").c_str());
+  }
+  return names;
+}
+
+
+/**
+ * @brief Counts memory allocations.
+ */
+void *operator new(std::size_t size)
+{
+  ++condor2nav::test::allocations;
+  condor2nav::test::allocatedBytes += size;
+  if(auto ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc{};
+}
+
+
+void operator delete(void *ptr) throw()
+{
+  std::free(ptr);
+}
+
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+
+void operator delete[](void *ptr) throw()
+{
+  operator delete(ptr);
+}
@@ -0,0 +1,123 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file testSupport/testSupport.h
+ *
+ * @brief Declares fixtures shared by Condor2Nav unit tests and benchmarks.
+ *
+ * testSupport.cpp replaces global operator new and delete to count memory
+ * allocations so it has to be linked only into test executables.
+ */
+
+#ifndef __TEST_SUPPORT_H__
+#define __TEST_SUPPORT_H__
+
+#include "condor2nav.h"
+#include "lkMapsDB.h"
+#include <boost/filesystem/path.hpp>
+#include <atomic>
+#include <mutex>
+#include <random>
+
+namespace condor2nav {
+
+  namespace test {
+
+    extern std::atomic<unsigned long long> allocations;       ///< @brief The number of memory allocations so far
+    extern std::atomic<unsigned long long> allocatedBytes;    ///< @brief The number of bytes allocated so far
+
+
+    /**
+     * @brief Temporary working directory.
+     *
+     * Directory gets a unique name so tests and benchmarks run in parallel
+     * do not share their files. It is removed on destruction.
+     */
+    class CWorkDir : CNonCopyable {
+      const bfs::path _path;
+    public:
+      explicit CWorkDir(const std::string &name);
+      ~CWorkDir();
+      const bfs::path &Path() const { return _path; }
+      bfs::path operator/(const bfs::path &path) const { return _path / path; }
+    };
+
+
+    /**
+     * @brief Current directory scope.
+     *
+     * Condor2Nav classes use paths relative to the current directory which
+     * is shared by all the threads of the process. Scopes are serialized so
+     * only one test changes it at a time. Previous directory is restored on
+     * destruction.
+     */
+    class CCurrentDir : CNonCopyable {
+      static std::mutex _mutex;
+      const std::lock_guard<std::mutex> _lock;
+      const bfs::path _previous;
+    public:
+      explicit CCurrentDir(const bfs::path &path);
+      ~CCurrentDir();
+    };
+
+
+    /**
+     * @brief Application used by LK8000 maps tests and benchmarks.
+     *
+     * Application does not log anything.
+     */
+    class CTestApp : public CCondor2Nav {
+      class CLogger : public CCondor2Nav::CLogger {
+        void Trace(const std::string &) const override {}
+      public:
+        explicit CLogger(TType type) : CCondor2Nav::CLogger{type} {}
+        ~CLogger() { Flush(); }
+      };
+
+      CLogger _normal;
+      CLogger _high;
+      CLogger _warning;
+      CLogger _error;
+
+    public:
+      using CCondor2Nav::CONFIG_FILE_NAME;
+
+      CTestApp() :
+        _normal{CLogger::TType::LOG_NORMAL}, _high{CLogger::TType::LOG_HIGH},
+        _warning{CLogger::TType::WARNING}, _error{CLogger::TType::ERROR}
+      {}
+      const CLogger &Log() const override     { return _normal; }
+      const CLogger &LogHigh() const override { return _high; }
+      const CLogger &Warning() const override { return _warning; }
+      const CLogger &Error() const override   { return _error; }
+    };
+
+
+    double FileWrite(const bfs::path &path, const std::string &content);
+    std::string TemplateGenerate(const std::string &name, double lonMin, double latMin, double size, unsigned res);
+    CLKMapsDB::CNamesList LandscapesGenerate(unsigned landscapes, unsigned templates, std::mt19937 &rand);
+
+  }
+
+}
+
+#endif /* __TEST_SUPPORT_H__ */
@@ -0,0 +1,74 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file threadPool.cpp
+ *
+ * @brief Implements the thread pool class (condor2nav::CThreadPool). 
+ */
+
+#include "threadPool.h"
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CThreadPool class constructor.
+ *
+ * @param threads The number of worker threads.
+ */
+condor2nav::CThreadPool::CThreadPool(unsigned threads /* = std::thread::hardware_concurrency() */)
+{
+  if(threads == 0)
+    threads = 1;
+  _workers.reserve(threads);
+  for(unsigned i=0; i<threads; i++)
+    _workers.emplace_back([this]{ Run(); });
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * condor2nav::CThreadPool class destructor. Waits for all pending tasks.
+ */
+condor2nav::CThreadPool::~CThreadPool()
+{
+  // empty task stops one worker
+  for(size_t i=0; i<_workers.size(); i++)
+    _queue.Push(CTask{});
+  for(auto &w : _workers)
+    w.join();
+}
+
+
+/**
+ * @brief Worker thread loop.
+ */
+void condor2nav::CThreadPool::Run()
+{
+  for(;;) {
+    auto task = _queue.PopWait();
+    if(!task)
+      break;
+    task();           // exceptions are stored in the task future
+  }
+}
@@ -0,0 +1,100 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file threadPool.h
+ *
+ * @brief Declares the thread pool class (condor2nav::CThreadPool). 
+ */
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include "waitQueue.h"
+#include "cancellation.h"
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Thread pool.
+   *
+   * condor2nav::CThreadPool class runs provided tasks on a number of worker
+   * threads. The result (or the exception) of each task is provided with
+   * a future. Tasks sent together with a cancellation token are not started
+   * if the token was cancelled and may check the token cooperatively while
+   * running. All pending tasks are executed before the pool is destroyed.
+   */
+  class CThreadPool : CNonCopyable {
+    using CTask = std::function<void()>;
+
+    CWaitQueue<CTask> _queue;
+    std::vector<std::thread> _workers;
+
+    void Run();
+  public:
+    explicit CThreadPool(unsigned threads = std::thread::hardware_concurrency());
+    ~CThreadPool();
+    size_t Size() const { return _workers.size(); }
+
+    /**
+     * @brief Sends a task to the pool.
+     *
+     * @param func Task to run.
+     *
+     * @return The future result of the task.
+     */
+    template<typename F>
+    auto Send(F func) -> std::future<decltype(func())>
+    {
+      using R = decltype(func());
+      auto task = std::make_shared<std::packaged_task<R()>>(std::move(func));
+      auto future = task->get_future();
+      _queue.Push([task]{ (*task)(); });
+      return future;
+    }
+
+    /**
+     * @brief Sends a cancellable task to the pool.
+     *
+     * @param func  Task to run. The task is provided with the cancellation token.
+     * @param token Cancellation token of the task.
+     *
+     * @return The future result of the task. It provides condor2nav::EOperationCancelled
+     *         if the task was cancelled before it was started.
+     */
+    template<typename F>
+    auto Send(F func, CCancellationToken token) -> std::future<decltype(func(token))>
+    {
+      using R = decltype(func(token));
+      return Send([func, token]() mutable -> R
+      {
+        token.ThrowIfCancelled();
+        return func(token);
+      });
+    }
+  };
+
+}
+
+#endif /* __THREADPOOL_H__ */
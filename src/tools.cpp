@@ -26,13 +26,19 @@
  */
 
 #include "tools.h"
-#include "istream.h"
+#include "httpClient.h"
+#include "gzipDecoder.h"
 #include "activeSync.h"
+#include "asyncIO.h"
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <locale>
 #include <windows.h>
 
 
@@ -41,6 +47,288 @@ namespace {
 
   const double PI = 3.1415923865;
 
+
+  /**
+   * @brief Skips leading white spaces.
+   *
+   * @param str The string to check.
+   *
+   * @return Position of the first character that is not a white space.
+   */
+  const char *WhiteSpacesSkip(const std::string &str)
+  {
+    auto it = str.c_str();
+    while(*it == ' ' || *it == '\t' || *it == '\r' || *it == '\n')
+      ++it;
+    return it;
+  }
+
+
+  /**
+   * @brief Converts string to an integral value.
+   *
+   * Function parses an optional sign and decimal digits in the same manner as
+   * STL streams do (leading white spaces are skipped and conversion stops at
+   * the first non-digit character). Negative values for unsigned types wrap around.
+   *
+   * @param str The string to convert.
+   *
+   * @exception std Thrown when operation failed.
+   *
+   * @return Converted value.
+   */
+  template<class T>
+  T IntegerParse(const std::string &str)
+  {
+    using namespace condor2nav;
+    auto it = WhiteSpacesSkip(str);
+    if(*it == '\0')
+      // nothing to convert (the same as STL stream conversion)
+      return 0;
+
+    bool negative = false;
+    if(*it == '-' || *it == '+')
+      negative = *it++ == '-';
+    if(*it < '0' || *it > '9')
+      throw EOperationFailed{"Cannot convert '" + str + "' to requested type!!!"};
+
+    const std::uint64_t limit = negative && std::numeric_limits<T>::is_signed ?
+      static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + 1 :
+      static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    std::uint64_t value = 0;
+    for(; *it >= '0' && *it <= '9'; ++it) {
+      value = value * 10 + (*it - '0');
+      if(value > limit)
+        throw EOperationFailed{"Cannot convert '" + str + "' to requested type (out of range)!!!"};
+    }
+    return static_cast<T>(negative ? 0 - value : value);
+  }
+
+
+  /**
+   * @brief Converts string to a floating point value.
+   *
+   * Function parses decimal numbers with optional fraction and exponent.
+   * Values with up to 15 significant digits and small exponents are computed
+   * directly (the result is exact as both the mantissa and the power of 10 are
+   * exactly representable). Other values are converted with a classic locale
+   * STL stream.
+   *
+   * @param str The string to convert.
+   *
+   * @exception std Thrown when operation failed.
+   *
+   * @return Converted value.
+   */
+  double FloatingPointParse(const std::string &str)
+  {
+    using namespace condor2nav;
+    static const double pow10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const int pow10Max = sizeof(pow10) / sizeof(*pow10) - 1;
+
+    auto begin = WhiteSpacesSkip(str);
+    if(*begin == '\0')
+      // nothing to convert (the same as STL stream conversion)
+      return 0;
+
+    auto it = begin;
+    bool negative = false;
+    if(*it == '-' || *it == '+')
+      negative = *it++ == '-';
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool digitsFound = false;
+    for(; *it >= '0' && *it <= '9'; ++it) {
+      digitsFound = true;
+      if(mantissa || *it != '0') {
+        if(digits < 19)
+          mantissa = mantissa * 10 + (*it - '0');
+        else
+          ++exponent;
+        ++digits;
+      }
+    }
+    if(*it == '.') {
+      for(++it; *it >= '0' && *it <= '9'; ++it) {
+        digitsFound = true;
+        if(mantissa || *it != '0') {
+          if(digits < 19) {
+            mantissa = mantissa * 10 + (*it - '0');
+            --exponent;
+          }
+          ++digits;
+        }
+        else
+          --exponent;
+      }
+    }
+    if(!digitsFound)
+      throw EOperationFailed{"Cannot convert '" + str + "' to requested type!!!"};
+    if(*it == 'e' || *it == 'E') {
+      auto expIt = it + 1;
+      bool expNegative = false;
+      if(*expIt == '-' || *expIt == '+')
+        expNegative = *expIt++ == '-';
+      if(*expIt >= '0' && *expIt <= '9') {
+        int exp = 0;
+        for(; *expIt >= '0' && *expIt <= '9'; ++expIt)
+          if(exp < 10000)
+            exp = exp * 10 + (*expIt - '0');
+        exponent += expNegative ? -exp : exp;
+      }
+    }
+
+    if(digits <= 15 && exponent >= -pow10Max && exponent <= pow10Max) {
+      double value = static_cast<double>(mantissa);
+      value = exponent < 0 ? value / pow10[-exponent] : value * pow10[exponent];
+      return negative ? -value : value;
+    }
+
+    // slow path for values that cannot be computed exactly
+    std::istringstream stream{begin};
+    stream.imbue(std::locale::classic());
+    double value;
+    stream >> value;
+    if(stream.fail() && !stream.eof())
+      throw EOperationFailed{"Cannot convert '" + str + "' to requested type!!!"};
+    return value;
+  }
+
+
+  /**
+   * @brief Converts an integral value to a string.
+   *
+   * @param val The value to convert.
+   *
+   * @return The string describing provided value.
+   */
+  template<class T>
+  std::string IntegerFormat(T val)
+  {
+    char buffer[24];
+    auto end = buffer + sizeof(buffer);
+    auto it = end;
+    const bool negative = val < 0;
+    auto value = negative ? 0 - static_cast<std::uint64_t>(val) : static_cast<std::uint64_t>(val);
+    do {
+      *--it = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    while(value);
+    if(negative)
+      *--it = '-';
+    return std::string(it, end);
+  }
+
+}
+
+
+/**
+ * @brief Converts string to integer.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param str The string to convert.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Converted value.
+ */
+template<>
+int condor2nav::Convert<int>(const std::string &str)
+{
+  return IntegerParse<int>(str);
+}
+
+
+/**
+ * @brief Converts string to unsigned integer.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param str The string to convert.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Converted value.
+ */
+template<>
+unsigned condor2nav::Convert<unsigned>(const std::string &str)
+{
+  return IntegerParse<unsigned>(str);
+}
+
+
+/**
+ * @brief Converts string to float.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param str The string to convert.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Converted value.
+ */
+template<>
+float condor2nav::Convert<float>(const std::string &str)
+{
+  return static_cast<float>(FloatingPointParse(str));
+}
+
+
+/**
+ * @brief Converts string to double.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param str The string to convert.
+ *
+ * @exception std Thrown when operation failed.
+ *
+ * @return Converted value.
+ */
+template<>
+double condor2nav::Convert<double>(const std::string &str)
+{
+  return FloatingPointParse(str);
+}
+
+
+/**
+ * @brief Converts integer to a string.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param val The value to convert.
+ *
+ * @return The string describing provided value.
+ */
+template<>
+std::string condor2nav::Convert<int>(const int &val)
+{
+  return IntegerFormat(val);
+}
+
+
+/**
+ * @brief Converts unsigned integer to a string.
+ *
+ * Locale independent specialization of generic conversion that does not use STL streams.
+ *
+ * @param val The value to convert.
+ *
+ * @return The string describing provided value.
+ */
+template<>
+std::string condor2nav::Convert<unsigned>(const unsigned &val)
+{
+  return IntegerFormat(val);
 }
 
 
@@ -63,22 +351,66 @@ void condor2nav::Trim(std::string &str)
 }
 
 
+
+/**
+ * @brief Removes leading and trailing white spaces from string range.
+ *
+ * Method removes leading and trailing white spaces from given string range.
+ * No data is copied.
+ *
+ * @param str The string range to cut.
+ *
+ * @return Cut string range.
+ */
+boost::string_ref condor2nav::Trim(boost::string_ref str)
+{
+  const size_t pos1 = str.find_first_not_of(" \t\r");
+  if(pos1 == boost::string_ref::npos)
+    return boost::string_ref{};
+  const size_t pos2 = str.find_last_not_of(" \t\r");
+  return str.substr(pos1, pos2 - pos1 + 1);
+}
+
 namespace {
 
+  char *WritePadded(char *out, unsigned value, int width)
+  {
+    char digits[10];
+    int num = 0;
+    do {
+      digits[num++] = '0' + value % 10;
+      value /= 10;
+    } while(value);
+    for(; width > num; width--)
+      *out++ = '0';
+    while(num)
+      *out++ = digits[--num];
+    return out;
+  }
+
   template<typename T>
-  std::string Coord2DDMMFFImpl(T coord)
+  char *Coord2DDMMFFImpl(T coord, char *out)
   {
     double absValue = coord.value;
     if(coord.value < 0)
       absValue = -absValue;
     const unsigned deg = static_cast<unsigned>(absValue);
-    const double min = (absValue - deg) * 60;
-    std::stringstream stream;
-    stream.setf(std::ios::fixed, std::ios::floatfield);
-    stream.setf(std::ios::showpoint);
-    stream.precision(3);
-    stream << std::setfill('0') << std::setw(T::degStrLength) << deg << ":" << std::setw(6) << min << coord.Sign();
-    return stream.str();
+    // minutes are rounded to 3 decimal places (without carry to degrees)
+    const unsigned min = static_cast<unsigned>((absValue - deg) * 60000 + 0.5);
+    out = WritePadded(out, deg, T::degStrLength);
+    *out++ = ':';
+    out = WritePadded(out, min / 1000, 2);
+    *out++ = '.';
+    out = WritePadded(out, min % 1000, 3);
+    *out++ = coord.Sign();
+    return out;
+  }
+
+  template<typename T>
+  std::string Coord2DDMMFFImpl(T coord)
+  {
+    char buffer[condor2nav::COORD_STR_MAX_LENGTH];
+    return std::string(buffer, Coord2DDMMFFImpl(coord, buffer));
   }
 
 }
@@ -111,11 +443,43 @@ std::string condor2nav::Coord2DDMMFF(TLatitude coord)
   return Coord2DDMMFFImpl(coord);
 }
 
+/**
+ * @brief Writes longitude coordinate to the buffer.
+ *
+ * Method converts longitude coordinate from DD.FF to DD:MM.FF format
+ * without any stream formatting, locale or memory allocation.
+ *
+ * @param coord     The coordinate value to convert. 
+ * @param out       The buffer of at least COORD_STR_MAX_LENGTH characters. 
+ *
+ * @return The end of the written characters (no terminating zero is written).
+ */
+char *condor2nav::Coord2DDMMFF(TLongitude coord, char *out)
+{
+  return Coord2DDMMFFImpl(coord, out);
+}
+
+/**
+* @brief Writes latitude coordinate to the buffer.
+*
+* Method converts latitude coordinate from DD.FF to DD:MM.FF format
+* without any stream formatting, locale or memory allocation.
+*
+* @param coord     The coordinate value to convert.
+* @param out       The buffer of at least COORD_STR_MAX_LENGTH characters.
+*
+* @return The end of the written characters (no terminating zero is written).
+*/
+char *condor2nav::Coord2DDMMFF(TLatitude coord, char *out)
+{
+  return Coord2DDMMFFImpl(coord, out);
+}
+
 
 namespace {
 
   template<typename T>
-  std::string Coord2DDMMSSImpl(T coord)
+  char *Coord2DDMMSSImpl(T coord, char *out)
   {
     double absValue = coord.value;
     if(coord.value < 0)
@@ -123,9 +487,27 @@ namespace {
     const unsigned deg = static_cast<unsigned>(absValue);
     const unsigned min = static_cast<unsigned>((absValue - deg) * 60);
     const unsigned sec = static_cast<unsigned>(((absValue - deg) * 60 - min) * 60);
-    std::stringstream stream;
-    stream << std::setfill('0') << std::setw(T::degStrLength) << deg << ":" << std::setw(2) << min << ":" << std::setw(2) << sec << coord.Sign();
-    return stream.str();
+    out = WritePadded(out, deg, T::degStrLength);
+    *out++ = ':';
+    out = WritePadded(out, min, 2);
+    *out++ = ':';
+    out = WritePadded(out, sec, 2);
+    *out++ = coord.Sign();
+    return out;
+  }
+
+  template<typename T>
+  void Coord2DDMMSSImpl(T coord, std::string &out)
+  {
+    char buffer[condor2nav::COORD_STR_MAX_LENGTH];
+    out.append(buffer, Coord2DDMMSSImpl(coord, buffer));
+  }
+
+  template<typename T>
+  std::string Coord2DDMMSSImpl(T coord)
+  {
+    char buffer[condor2nav::COORD_STR_MAX_LENGTH];
+    return std::string(buffer, Coord2DDMMSSImpl(coord, buffer));
   }
 
 }
@@ -144,6 +526,34 @@ std::string condor2nav::Coord2DDMMSS(TLongitude coord)
   return Coord2DDMMSSImpl(coord);
 }
 
+/**
+ * @brief Appends longitude coordinate to the string.
+ *
+ * Method converts longitude coordinate from DD.FF to DD:MM::SS format
+ * without any stream formatting and appends it to the output string.
+ *
+ * @param coord     The coordinate value to convert. 
+ * @param out       The string to append the coordinate to. 
+ */
+void condor2nav::Coord2DDMMSS(TLongitude coord, std::string &out)
+{
+  Coord2DDMMSSImpl(coord, out);
+}
+
+/**
+* @brief Appends latitude coordinate to the string.
+*
+* Method converts latitude coordinate from DD.FF to DD:MM::SS format
+* without any stream formatting and appends it to the output string.
+*
+* @param coord     The coordinate value to convert.
+* @param out       The string to append the coordinate to.
+*/
+void condor2nav::Coord2DDMMSS(TLatitude coord, std::string &out)
+{
+  Coord2DDMMSSImpl(coord, out);
+}
+
 /**
 * @brief Converts latitude coordinate to string.
 *
@@ -158,6 +568,128 @@ std::string condor2nav::Coord2DDMMSS(TLatitude coord)
   return Coord2DDMMSSImpl(coord);
 }
 
+/**
+ * @brief Writes longitude coordinate to the buffer.
+ *
+ * Method converts longitude coordinate from DD.FF to DD:MM::SS format
+ * without any stream formatting, locale or memory allocation.
+ *
+ * @param coord     The coordinate value to convert. 
+ * @param out       The buffer of at least COORD_STR_MAX_LENGTH characters. 
+ *
+ * @return The end of the written characters (no terminating zero is written).
+ */
+char *condor2nav::Coord2DDMMSS(TLongitude coord, char *out)
+{
+  return Coord2DDMMSSImpl(coord, out);
+}
+
+/**
+* @brief Writes latitude coordinate to the buffer.
+*
+* Method converts latitude coordinate from DD.FF to DD:MM::SS format
+* without any stream formatting, locale or memory allocation.
+*
+* @param coord     The coordinate value to convert.
+* @param out       The buffer of at least COORD_STR_MAX_LENGTH characters.
+*
+* @return The end of the written characters (no terminating zero is written).
+*/
+char *condor2nav::Coord2DDMMSS(TLatitude coord, char *out)
+{
+  return Coord2DDMMSSImpl(coord, out);
+}
+
+
+namespace {
+
+  /**
+   * @brief Parses SeeYou .cup coordinate.
+   *
+   * @param str       The coordinate in DDMM.mmm[NS] or DDDMM.mmm[EW] format.
+   * @param degLength The number of degrees digits.
+   * @param positive  The hemisphere letter of positive values.
+   * @param negative  The hemisphere letter of negative values.
+   *
+   * @exception std Thrown when the coordinate is malformed.
+   *
+   * @return Coordinate value in degrees.
+   */
+  double CupCoordImpl(boost::string_ref str, int degLength, char positive, char negative)
+  {
+    auto error = [&]{ return condor2nav::EOperationFailed{"ERROR: Invalid .cup coordinate '" + str.to_string() + "'!!!"}; };
+    auto digit = [](char c){ return c >= '0' && c <= '9'; };
+
+    str = condor2nav::Trim(str);
+    const auto fracBegin = static_cast<std::size_t>(degLength) + 3;
+    if(str.size() < fracBegin + 1 || str[fracBegin - 1] != '.')
+      throw error();
+
+    unsigned deg = 0;
+    for(int i=0; i<degLength; i++) {
+      if(!digit(str[i]))
+        throw error();
+      deg = deg * 10 + (str[i] - '0');
+    }
+    if(!digit(str[degLength]) || !digit(str[degLength + 1]))
+      throw error();
+    const unsigned min = (str[degLength] - '0') * 10 + (str[degLength + 1] - '0');
+
+    // fraction of minutes (at most 9 digits are significant)
+    unsigned frac = 0;
+    unsigned scale = 1;
+    std::size_t i = fracBegin;
+    for(; i < str.size() && digit(str[i]); i++) {
+      if(scale < 1000000000) {
+        frac = frac * 10 + (str[i] - '0');
+        scale *= 10;
+      }
+    }
+    if(i == fracBegin || i + 1 != str.size() || (str[i] != positive && str[i] != negative) || min >= 60)
+      throw error();
+
+    const auto value = deg + (min + static_cast<double>(frac) / scale) / 60;
+    return str[i] == negative ? -value : value;
+  }
+
+}
+
+/**
+ * @brief Parses SeeYou .cup longitude.
+ *
+ * Function converts longitude from the DDDMM.mmm[EW] format used by
+ * SeeYou waypoint files (i.e. "01410.467E") without any locale or
+ * memory allocation.
+ *
+ * @param str The longitude string.
+ *
+ * @exception std Thrown when the longitude is malformed.
+ *
+ * @return Longitude.
+ */
+condor2nav::TLongitude condor2nav::CupLongitude(boost::string_ref str)
+{
+  return TLongitude{CupCoordImpl(str, TLongitude::degStrLength, 'E', 'W')};
+}
+
+/**
+ * @brief Parses SeeYou .cup latitude.
+ *
+ * Function converts latitude from the DDMM.mmm[NS] format used by
+ * SeeYou waypoint files (i.e. "5107.830N") without any locale or
+ * memory allocation.
+ *
+ * @param str The latitude string.
+ *
+ * @exception std Thrown when the latitude is malformed.
+ *
+ * @return Latitude.
+ */
+condor2nav::TLatitude condor2nav::CupLatitude(boost::string_ref str)
+{
+  return TLatitude{CupCoordImpl(str, TLatitude::degStrLength, 'N', 'S')};
+}
+
 
 /**
 * @brief Checks inner rectangle is spaced inside outer area.
@@ -230,27 +762,8 @@ double condor2nav::Rad2Deg(double angle)
  */
 void condor2nav::DirectoryCreate(const bfs::path &dirName)
 {
-  bool activeSync = false;
-  const std::string str = dirName.string();
-  if(str.size() > 2 && str[0] == '\\' && str[1] != '\\')
-    activeSync = true;
-
-  if(!dirName.empty()) {
-    if(!activeSync) {
-      bfs::create_directories(dirName);
-    }
-    else {
-      auto path = dirName;
-      std::vector<bfs::path> dirs;
-      while(path.parent_path() != "\\") {
-        dirs.emplace_back(path);
-        path = path.parent_path();
-      }
-      auto &activeSync = CActiveSync::Instance();
-      std::for_each(dirs.crbegin(), dirs.crend(),
-                    [&](const bfs::path &d){ activeSync.DirectoryCreate(d); });
-    }
-  }
+  if(!dirName.empty())
+    CAsyncIO::Instance().DirectoryCreate(dirName).get();
 }
 
 
@@ -265,24 +778,173 @@ void condor2nav::DirectoryCreate(const bfs::path &dirName)
  */
 bool condor2nav::FileExists(const bfs::path &fileName) 
 {
-  bool activeSync = false;
-  const auto str = fileName.string();
-  if(str.size() > 2 && str[0] == '\\' && str[1] != '\\')
-    activeSync = true;
+  return CAsyncIO::Instance().Exists(fileName).get();
+}
 
-  if(activeSync)
-    return CActiveSync::Instance().FileExists(fileName);
-  else
-    return bfs::exists(fileName);
+
+/** 
+ * @brief Returns file modification time
+ * 
+ * Function returns a value that changes every time the file is modified.
+ * Values for local and ActiveSync files are not comparable.
+ * 
+ * @param fileName File name to check
+ *
+ * @exception std Thrown when operation failed.
+ * 
+ * @return File modification time or 0 if the file does not exist
+ */
+std::uint64_t condor2nav::FileWriteTime(const bfs::path &fileName)
+{
+  if(PathType(fileName) == TPathType::ACTIVE_SYNC)
+    return CActiveSync::Instance().FileWriteTime(fileName);
+
+  boost::system::error_code ec;
+  const auto writeTime = bfs::last_write_time(fileName, ec);
+  if(ec)
+    return 0;
+  return static_cast<std::uint64_t>(writeTime);
 }
 
 
-void condor2nav::Download(const std::string &server, const bfs::path &url, const bfs::path &fileName, unsigned timeout /* = 30 */)
+const char condor2nav::DOWNLOAD_TEMP_EXTENSION[] = ".part";
+
+namespace {
+
+  const std::chrono::seconds DOWNLOAD_PROGRESS_INTERVAL{1};      // minimum time between download progress reports
+
+}
+
+
+/**
+ * @brief Downloads a file from the server.
+ *
+ * Function downloads a file from the server. Received data are written
+ * to a temporary file as they arrive so the memory usage does not depend
+ * on the file size and already received data are not lost on the timeout.
+ * If the temporary file already exists it is treated as a partial result
+ * of previous download and only its missing part is requested from the
+ * server. The cache validators of the partial file are stored next to it
+ * and the missing part is provided only if the file did not change on the
+ * server in the meantime. The temporary file is renamed to the final name
+ * on success.
+ * Pre-compressed file ('.gz' URL downloaded to a file with other extension)
+ * is decompressed on the fly. Such download cannot be resumed.
+ *
+ * @param server   Server to download the file from.
+ * @param url      Path of the file on the server.
+ * @param fileName Local path of the downloaded file.
+ * @param timeout  Download timeout in seconds.
+ * @param progress Function called periodically with download progress.
+ *
+ * @exception std Thrown when operation failed.
+ */
+void condor2nav::Download(const std::string &server, const bfs::path &url, const bfs::path &fileName, unsigned timeout /* = 30 */,
+                          const CDownloadProgress &progress /* = CDownloadProgress{} */)
 {
   DirectoryCreate(fileName.parent_path());
-  bfs::ofstream out{fileName, std::ios_base::out | std::ios_base::binary};
-  CIStream in{server, url.generic_string(), timeout};
-  out << in;
+
+  const auto tempName = fileName.string() + DOWNLOAD_TEMP_EXTENSION;
+  const auto validatorsName = fileName.string() + ".validators" + DOWNLOAD_TEMP_EXTENSION;
+  const bool compressed = url.extension() == ".gz" && fileName.extension() != ".gz";
+
+  // partial file is resumed only if it can be validated
+  CHttpClient::TValidators validators;
+  std::uint64_t offset = 0;
+  boost::system::error_code ec;
+  if(!compressed && bfs::exists(tempName, ec)) {
+    bfs::ifstream stream{validatorsName, std::ios_base::in | std::ios_base::binary};
+    if(std::getline(stream, validators.etag) && std::getline(stream, validators.lastModified) && !validators.Range().empty())
+      offset = bfs::file_size(tempName, ec);
+    if(ec)
+      offset = 0;
+  }
+  if(!offset)
+    validators = CHttpClient::TValidators{};
+
+  bfs::ofstream out;
+  auto open = [&](bool append)
+  {
+    if(!append) {
+      // validators of a new content are known before its first part is stored
+      bfs::remove(validatorsName, ec);
+      if(!compressed && !validators.Range().empty()) {
+        bfs::ofstream stream{validatorsName, std::ios_base::out | std::ios_base::binary};
+        stream << validators.etag << "\n" << validators.lastModified << "\n";
+      }
+    }
+    out.open(tempName, std::ios_base::out | std::ios_base::binary | (append ? std::ios_base::app : std::ios_base::trunc));
+    if(!out)
+      throw EOperationFailed{"ERROR: Couldn't open file '" + tempName + "' for writing!!!"};
+  };
+
+  // download rate is measured for this session only
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  auto report = start;
+  std::uint64_t size = offset;
+  std::uint64_t total = 0;
+  std::uint64_t received = 0;
+  auto rate = [&]
+  {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count();
+    return static_cast<unsigned>(ms ? received * 1000 / ms : received);
+  };
+
+  auto store = [&](std::uint64_t pos, const char *data, std::size_t num)
+  {
+    // server may ignore the range request and provide the whole file
+    if(!out.is_open())
+      open(pos > 0);
+    if(!out.write(data, static_cast<std::streamsize>(num)))
+      throw EOperationFailed{"ERROR: Couldn't write file '" + tempName + "'!!!"};
+    size = pos + num;
+  };
+
+  std::unique_ptr<CGzipDecoder> decoder;
+  if(compressed)
+    decoder = std::make_unique<CGzipDecoder>([&](const char *data, std::size_t num){ store(decoder->Size(), data, num); });
+
+  const auto status = CHttpClient::Instance().Get(server, url, timeout, offset, [&](std::uint64_t pos, const char *data, std::size_t num)
+  {
+    if(decoder)
+      decoder->Write(data, num);
+    else
+      store(pos, data, num);
+    received += num;
+    if(progress && clock::now() - report >= DOWNLOAD_PROGRESS_INTERVAL) {
+      report = clock::now();
+      // the size of a pre-compressed file does not match the decompressed data
+      progress(size, decoder ? 0 : total, rate(), false);
+    }
+  }, &validators, &total);
+  if(decoder)
+    decoder->Finish();
+
+  if(status == CHttpClient::HTTP_RANGE_NOT_SATISFIABLE && total != offset) {
+    // partial file does not match the file on the server
+    bfs::remove(validatorsName, ec);
+    bfs::remove(tempName, ec);
+    if(ec)
+      throw EOperationFailed{"ERROR: Couldn't remove file '" + tempName + "' (" + ec.message() + ")!!!"};
+    Download(server, url, fileName, timeout, progress);
+    return;
+  }
+
+  // the file was already complete (416) or empty data were received
+  if(!out.is_open() && status != CHttpClient::HTTP_RANGE_NOT_SATISFIABLE)
+    open(status == CHttpClient::HTTP_PARTIAL_CONTENT);
+  out.close();
+  if(out.fail())
+    throw EOperationFailed{"ERROR: Couldn't write file '" + tempName + "'!!!"};
+
+  bfs::rename(tempName, fileName, ec);
+  if(ec)
+    throw EOperationFailed{"ERROR: Couldn't rename file '" + tempName + "' to '" + fileName.string() + "' (" + ec.message() + ")!!!"};
+  bfs::remove(validatorsName, ec);
+
+  if(progress)
+    progress(size, size, rate(), true);
 }
 
 
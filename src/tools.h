@@ -32,6 +32,9 @@
 #include "boostfwd.h"
 #include <sstream>
 #include <memory>
+#include <cstdint>
+#include <functional>
+#include <boost/utility/string_ref.hpp>
 #include <Windows.h>
 
 
@@ -46,13 +49,31 @@ namespace condor2nav {
   };
   using CLibraryRes = std::unique_ptr<HMODULE, CLibraryDeleter>;
 
+  /**
+   * @brief Deleter for HANDLE
+   */
+  struct CHandleDeleter {
+    typedef HANDLE pointer;
+    void operator()(HANDLE handle) const { ::CloseHandle(handle); }
+  };
+  using CHandleRes = std::unique_ptr<HANDLE, CHandleDeleter>;
+
   // conversions
   template<class T>
   T Convert(const std::string &str);
   template<class T>
   std::string Convert(const T &val);
 
+  // fast locale independent numeric conversions
+  template<> int Convert<int>(const std::string &str);
+  template<> unsigned Convert<unsigned>(const std::string &str);
+  template<> float Convert<float>(const std::string &str);
+  template<> double Convert<double>(const std::string &str);
+  template<> std::string Convert<int>(const int &val);
+  template<> std::string Convert<unsigned>(const unsigned &val);
+
   void Trim(std::string &str);
+  boost::string_ref Trim(boost::string_ref str);
 
   struct TLongitude {
     static const int degStrLength = 3;
@@ -68,23 +89,48 @@ namespace condor2nav {
     char Sign() const { return value < 0 ? 'S' : 'N'; }
   };
 
+  const unsigned COORD_STR_MAX_LENGTH = 20;       ///< @brief The size of a buffer big enough for any formatted coordinate. 
+
   std::string Coord2DDMMFF(TLongitude coord);
   std::string Coord2DDMMFF(TLatitude coord);
+  char *Coord2DDMMFF(TLongitude coord, char *out);
+  char *Coord2DDMMFF(TLatitude coord, char *out);
   std::string Coord2DDMMSS(TLongitude coord);
   std::string Coord2DDMMSS(TLatitude coord);
+  void Coord2DDMMSS(TLongitude coord, std::string &out);
+  void Coord2DDMMSS(TLatitude coord, std::string &out);
+  char *Coord2DDMMSS(TLongitude coord, char *out);
+  char *Coord2DDMMSS(TLatitude coord, char *out);
+  TLongitude CupLongitude(boost::string_ref str);
+  TLatitude CupLatitude(boost::string_ref str);
 
   bool InsideArea(TLongitude outerLonMin, TLongitude outerLonMax, TLatitude outerLatMin, TLatitude outerLatMax,
                   TLongitude innerLonMin, TLongitude innerLonMax, TLatitude innerLatMin, TLatitude innerLatMax);
 
   int KmH2MS(int value);
 
+  const double DEGREE_LENGTH = 111.2;             ///< @brief Latitude degree length [km]
+
   double Deg2Rad(double angle);
   double Rad2Deg(double angle);
 
   // disk operations
   void DirectoryCreate(const bfs::path &dirName);
   bool FileExists(const bfs::path &fileName);
-  void Download(const std::string &server, const bfs::path &url, const bfs::path &fileName, unsigned timeout = 30);
+  std::uint64_t FileWriteTime(const bfs::path &fileName);
+
+  /**
+   * @brief Function called with download progress.
+   *
+   * @param size  The number of bytes of the file already downloaded.
+   * @param total The size of the whole file (0 if not known).
+   * @param rate Download rate in bytes per second.
+   * @param done @p true if the download finished.
+   */
+  using CDownloadProgress = std::function<void(std::uint64_t size, std::uint64_t total, unsigned rate, bool done)>;
+  extern const char DOWNLOAD_TEMP_EXTENSION[];                                    ///< @brief Extension of partially downloaded files. 
+  void Download(const std::string &server, const bfs::path &url, const bfs::path &fileName, unsigned timeout = 30,
+                const CDownloadProgress &progress = CDownloadProgress{});
 
   /*
    * @brief Stream types
@@ -0,0 +1,249 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file traceLog.cpp
+ *
+ * @brief Implements the stages timing classes (condor2nav::CTraceLog, condor2nav::CTraceScope). 
+ */
+
+#include "traceLog.h"
+#include "ostream.h"
+#include <boost/filesystem/path.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <windows.h>
+
+
+std::atomic<bool> condor2nav::CTraceLog::_enabled{false};
+
+namespace {
+
+  std::mutex instanceMutex;      // guards the singleton creation
+
+  /**
+   * @brief Writes JSON string.
+   *
+   * @param stream Output stream.
+   * @param str    String to write.
+   */
+  void JSONString(condor2nav::COStream &stream, const std::string &str)
+  {
+    stream << '"';
+    for(auto c : str) {
+      if(c == '"' || c == '\\')
+        stream << '\\' << c;
+      else if(static_cast<unsigned char>(c) < 0x20) {
+        char buffer[8];
+        std::sprintf(buffer, "\\u%04x", static_cast<unsigned>(c));
+        stream << buffer;
+      }
+      else
+        stream << c;
+    }
+    stream << '"';
+  }
+
+}
+
+
+/**
+ * @brief Returns singleton instance.
+ *
+ * Method returns singleton instance.
+ *
+ * @return Singleton instance.
+ */
+condor2nav::CTraceLog &condor2nav::CTraceLog::Instance()
+{
+  // function local statics initialization is not thread-safe in VS2013
+  std::lock_guard<std::mutex> lock{instanceMutex};
+  static CTraceLog instance;
+  return instance;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * condor2nav::CTraceLog class constructor.
+ */
+condor2nav::CTraceLog::CTraceLog() :
+  _start{CClock::now()}
+{
+}
+
+
+/**
+ * @brief Adds measured stage.
+ *
+ * @param event Stage data.
+ */
+void condor2nav::CTraceLog::Add(TEvent event)
+{
+  std::lock_guard<std::mutex> lock{_mutex};
+  _events.emplace_back(std::move(event));
+}
+
+
+/**
+ * @brief Takes the events added since the previous call.
+ *
+ * Taken events are removed from the log so that it does not grow in
+ * long running processes.
+ *
+ * @return Events added since the previous call.
+ */
+auto condor2nav::CTraceLog::Take() -> CEventList
+{
+  CEventList events;
+  std::lock_guard<std::mutex> lock{_mutex};
+  events.swap(_events);
+  return events;
+}
+
+
+/**
+ * @brief Sums up the events.
+ *
+ * Events are grouped by their category and name. Groups are provided in
+ * the order of their first event.
+ *
+ * @param events Events to sum up.
+ *
+ * @return Stages summary.
+ */
+auto condor2nav::CTraceLog::Summary(const CEventList &events) -> CSummaryList
+{
+  CSummaryList summary;
+  for(auto it = events.cbegin(); it != events.cend(); ++it) {
+    const auto name = std::string{it->category} + ": " + it->name;
+    auto s = std::find_if(summary.begin(), summary.end(), [&](const TSummary &t){ return t.name == name; });
+    if(s == summary.end()) {
+      summary.push_back(TSummary{name, 0, CClock::duration::zero(), 0});
+      s = summary.end() - 1;
+    }
+    s->count++;
+    s->duration += it->duration;
+    s->bytes += it->bytes;
+  }
+  return summary;
+}
+
+
+/**
+ * @brief Writes the events as Chrome 'trace_event' JSON file.
+ *
+ * @param events   Events to write.
+ * @param filePath The path of the file to create.
+ *
+ * @exception std Thrown when operation failed.
+ */
+void condor2nav::CTraceLog::Dump(const CEventList &events, const bfs::path &filePath) const
+{
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  COStream stream{filePath};
+  stream << "{\"traceEvents\":[";
+  for(const auto &event : events) {
+    if(&event != &events.front())
+      stream << ",";
+    stream << "\n{\"name\":";
+    JSONString(stream, event.name);
+    stream << ",\"cat\":";
+    JSONString(stream, event.category);
+    stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+           << ",\"ts\":" << duration_cast<microseconds>(event.start - _start).count()
+           << ",\"dur\":" << duration_cast<microseconds>(event.duration).count()
+           << ",\"args\":{\"bytes\":" << event.bytes;
+    if(!event.detail.empty()) {
+      stream << ",\"detail\":";
+      JSONString(stream, event.detail);
+    }
+    stream << "}}";
+  }
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  stream.Commit();
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Starts stage time measurement if tracing is enabled.
+ *
+ * @param category Stage category (has to be a string literal).
+ * @param name     Stage name (has to be a string literal).
+ */
+condor2nav::CTraceScope::CTraceScope(const char *category, const char *name) :
+  _enabled{CTraceLog::Enabled()}, _category{category}, _name{name}, _bytes{0}
+{
+  if(_enabled)
+    _start = CTraceLog::CClock::now();
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Starts stage time measurement if tracing is enabled.
+ *
+ * @param category Stage category (has to be a string literal).
+ * @param name     Stage name (has to be a string literal).
+ * @param detail   Stage details (i.e. landscape name).
+ */
+condor2nav::CTraceScope::CTraceScope(const char *category, const char *name, const std::string &detail) :
+  CTraceScope{category, name}
+{
+  if(_enabled)
+    _detail = detail;
+}
+
+
+/**
+ * @brief Class constructor.
+ *
+ * Starts stage time measurement if tracing is enabled. The path is converted
+ * to the stage details only if tracing is enabled.
+ *
+ * @param category Stage category (has to be a string literal).
+ * @param name     Stage name (has to be a string literal).
+ * @param path     Processed file path.
+ */
+condor2nav::CTraceScope::CTraceScope(const char *category, const char *name, const bfs::path &path) :
+  CTraceScope{category, name}
+{
+  if(_enabled)
+    _detail = path.string();
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Adds measured stage to the trace log.
+ */
+condor2nav::CTraceScope::~CTraceScope()
+{
+  if(_enabled)
+    CTraceLog::Instance().Add(CTraceLog::TEvent{_category, _name, std::move(_detail), _start, CTraceLog::CClock::now() - _start,
+                                                _bytes, static_cast<unsigned>(GetCurrentThreadId())});
+}
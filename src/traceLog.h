@@ -0,0 +1,130 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file traceLog.h
+ *
+ * @brief Declares the stages timing classes (condor2nav::CTraceLog, condor2nav::CTraceScope). 
+ */
+
+#ifndef __TRACE_LOG_H__
+#define __TRACE_LOG_H__
+
+#include "nonCopyable.h"
+#include "boostfwd.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace condor2nav {
+
+  /**
+   * @brief Processing stages timing log.
+   *
+   * condor2nav::CTraceLog class gathers the duration and the number of
+   * processed bytes of application stages measured with condor2nav::CTraceScope.
+   * Events may be written as Chrome 'trace_event' JSON file (to be loaded in
+   * 'chrome://tracing') and summed up per stage. Events are kept until they
+   * are taken for a report. Scopes cost only one flag check when tracing is
+   * disabled.
+   *
+   * @note Singleton design pattern
+   * @note All the methods are thread-safe
+   */
+  class CTraceLog : CNonCopyable {
+  public:
+    using CClock = std::chrono::steady_clock;
+
+    /**
+     * @brief Measured stage.
+     */
+    struct TEvent {
+      const char *category;                 ///< @brief Stage category
+      const char *name;                     ///< @brief Stage name
+      std::string detail;                   ///< @brief Stage details (i.e. file path)
+      CClock::time_point start;             ///< @brief Stage start time
+      CClock::duration duration;            ///< @brief Stage duration
+      std::uint64_t bytes;                  ///< @brief The number of processed bytes
+      unsigned thread;                      ///< @brief Thread identifier
+    };
+
+    /**
+     * @brief Summary of all the events of one stage.
+     */
+    struct TSummary {
+      std::string name;                     ///< @brief Stage category and name
+      unsigned count;                       ///< @brief The number of events
+      CClock::duration duration;            ///< @brief Total duration
+      std::uint64_t bytes;                  ///< @brief Total number of processed bytes
+    };
+    using CSummaryList = std::vector<TSummary>;
+    using CEventList = std::vector<TEvent>;
+
+  private:
+    static std::atomic<bool> _enabled;      ///< @brief Tracing is enabled
+
+    const CClock::time_point _start;        ///< @brief Application start time
+    CEventList _events;                     ///< @brief Events not reported yet
+    mutable std::mutex _mutex;              ///< @brief Events guard
+
+    CTraceLog();
+
+  public:
+    static CTraceLog &Instance();
+    static void Enable(bool enable) { _enabled = enable; }
+    static bool Enabled() { return _enabled; }
+
+    static CSummaryList Summary(const CEventList &events);
+
+    void Add(TEvent event);
+    CEventList Take();
+    void Dump(const CEventList &events, const bfs::path &filePath) const;
+  };
+
+
+  /**
+   * @brief Stage timer.
+   *
+   * condor2nav::CTraceScope class measures the time between its construction
+   * and destruction and adds it to condor2nav::CTraceLog as one event.
+   */
+  class CTraceScope : CNonCopyable {
+    const bool _enabled;                    ///< @brief Tracing was enabled when the stage started
+    const char *_category;                  ///< @brief Stage category
+    const char *_name;                      ///< @brief Stage name
+    std::string _detail;                    ///< @brief Stage details
+    CTraceLog::CClock::time_point _start;   ///< @brief Stage start time
+    std::uint64_t _bytes;                   ///< @brief The number of processed bytes
+
+  public:
+    CTraceScope(const char *category, const char *name);
+    CTraceScope(const char *category, const char *name, const std::string &detail);
+    CTraceScope(const char *category, const char *name, const bfs::path &path);
+    ~CTraceScope();
+    void Bytes(std::uint64_t bytes) { _bytes += bytes; }
+  };
+
+}
+
+#endif /* __TRACE_LOG_H__ */
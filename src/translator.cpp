@@ -31,10 +31,160 @@
 #include "targetXCSoar.h"
 #include "targetXCSoar6.h"
 #include "targetLK8000.h"
+#include "ostream.h"
+#include "activeSync.h"
+#include "asyncIO.h"
+#include "deviceSync.h"
+#include "traceLog.h"
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <map>
+#include <set>
 
 const bfs::path condor2nav::CTranslator::DATA_PATH                = "data";
 const bfs::path condor2nav::CTranslator::SCENERIES_DATA_FILE_NAME = "SceneryData.csv";
 const bfs::path condor2nav::CTranslator::GLIDERS_DATA_FILE_NAME   = "GliderData.csv";
+const bfs::path condor2nav::CTranslator::GLIDER_POLARS_FILE_NAME  = "GliderPolars.csv";
+
+namespace {
+
+  /**
+   * @brief Checks if outputs should be written in the background.
+   *
+   * @param configParser Configuration INI file parser.
+   *
+   * @return 'Condor2Nav/WriteBehind' setting (disabled if not provided).
+   */
+  bool WriteBehindEnabled(const condor2nav::CFileParserINI &configParser)
+  {
+    try {
+      return configParser.Value("Condor2Nav", "WriteBehind") == "1";
+    }
+    catch(const condor2nav::Exception &) {
+      return false;
+    }
+  }
+
+  const char FINGERPRINTS_FILE_EXTENSION[] = ".fingerprints";
+  const char FINGERPRINTS_VERSION[] = "1";           ///< @brief Has to be changed when stages start to use different inputs
+  const char FINGERPRINTS_OUTPUTS_SUFFIX[] = "Outputs";
+  const char FINGERPRINTS_OUTPUTS_SEPARATOR = '|';   ///< @brief Not allowed in Windows paths
+
+
+  /**
+   * @brief Checks if all the outputs of a translation stage exist.
+   *
+   * @param outputs Stage output files separated with FINGERPRINTS_OUTPUTS_SEPARATOR.
+   *
+   * @return @p true if all the files exist.
+   */
+  bool OutputsExist(const std::string &outputs)
+  {
+    for(std::string::size_type pos = 0; pos < outputs.size(); ) {
+      auto end = outputs.find(FINGERPRINTS_OUTPUTS_SEPARATOR, pos);
+      if(end == std::string::npos)
+        end = outputs.size();
+      if(!condor2nav::FileExists(outputs.substr(pos, end - pos)))
+        return false;
+      pos = end + 1;
+    }
+    return true;
+  }
+
+
+  std::mutex registryMutex;                                     // guards the targets registry
+  std::mutex missingPolarsMutex;                                // guards the list of missing glider polars
+  std::set<std::string> missingPolars;                          // gliders which missing polars were already logged
+  bool registryInitialized = false;                             // built-in targets were registered
+  std::vector<condor2nav::CTranslator::TTargetInfo> registry;   // registered translation targets
+
+  /**
+   * @brief Returns the targets registry.
+   *
+   * Function returns the registry of translation targets. Built-in targets
+   * are registered on the first use. The registry mutex has to be locked.
+   *
+   * @return Targets registry.
+   */
+  std::vector<condor2nav::CTranslator::TTargetInfo> &Registry()
+  {
+    using namespace condor2nav;
+    if(!registryInitialized) {
+      registryInitialized = true;
+      const CTranslator::TTargetInfo builtins[] = {
+        { "XCSoar5", CTranslator::STAGE_ALL,                                "1", &CTranslator::TargetCreate<CTargetXCSoar>  },
+        { "XCSoar6", CTranslator::STAGE_ALL,                                "1", &CTranslator::TargetCreate<CTargetXCSoar6> },
+        { "LK8000",  CTranslator::STAGE_ALL & ~CTranslator::STAGE_WEATHER,  "1", &CTranslator::TargetCreate<CTargetLK8000>  }
+      };
+      // targets registered before the first use take precedence
+      for(const auto &info : builtins)
+        if(std::none_of(registry.begin(), registry.end(), [&](const CTranslator::TTargetInfo &i){ return std::string{i.name} == info.name; }))
+          registry.push_back(info);
+    }
+    return registry;
+  }
+
+
+  /**
+   * @brief Checks if one path is an ancestor of another.
+   *
+   * @param parent The path of possible ancestor directory.
+   * @param path   The path to check.
+   *
+   * @return @p true if @p parent is an ancestor of @p path.
+   */
+  bool Ancestor(const bfs::path &parent, const bfs::path &path)
+  {
+    for(auto p = path.parent_path(); !p.empty(); p = p.parent_path()) {
+      if(p == parent)
+        return true;
+      if(p == p.parent_path())
+        break;
+    }
+    return false;
+  }
+
+
+  /**
+   * @brief Creates output directories.
+   *
+   * Function creates output directories of all the targets in one pass.
+   * Duplicated directories and the ones created anyway as parents of
+   * other directories are skipped. All the remaining directories are created
+   * concurrently through condor2nav::CAsyncIO.
+   *
+   * @param dirs The list of output directories.
+   *
+   * @exception std Thrown when creation of any of the directories failed.
+   */
+  void DirectoriesCreate(condor2nav::CTranslator::CTarget::CDirectories dirs)
+  {
+    using namespace condor2nav;
+    std::sort(dirs.begin(), dirs.end());
+    dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+
+    auto &io = CAsyncIO::Instance();
+    std::vector<std::future<void>> creates;
+    for(const auto &dir : dirs)
+      if(!dir.empty() && std::none_of(dirs.begin(), dirs.end(), [&](const bfs::path &d){ return Ancestor(dir, d); }))
+        creates.emplace_back(io.DirectoryCreate(dir));
+
+    std::string message;
+    for(auto &c : creates) {
+      try {
+        c.get();
+      }
+      catch(const std::exception &ex) {
+        message += (message.empty() ? "" : "\n") + std::string{ex.what()};
+      }
+    }
+    if(!message.empty())
+      throw EOperationFailed{message};
+  }
+
+}
 
 
 
@@ -44,15 +194,75 @@ const bfs::path condor2nav::CTranslator::GLIDERS_DATA_FILE_NAME   = "GliderData.
 /**
  * @brief Class constructor.
  *
- * condor2nav::CTranslator::CTarget class constructor.
+ * condor2nav::CTranslator::CTarget class constructor. Target output directory
+ * is added to the target output directories.
  *
  * @param translator Translator class.
+ * @param outputPath Translation output directory.
  */
-condor2nav::CTranslator::CTarget::CTarget(const CTranslator &translator) :
+condor2nav::CTranslator::CTarget::CTarget(const CTranslator &translator, bfs::path outputPath) :
   _translator{translator},
-  _outputPath{_translator._configParser.Value("Condor2Nav", "OutputPath")}
+  _outputPath{std::move(outputPath)}
+{
+  DirectoryAdd(_outputPath);
+}
+
+
+/**
+ * @brief Adds target output directory.
+ *
+ * Method declares a directory the target writes its outputs to. Targets
+ * should not create directories themselves. All the declared directories
+ * are created by the translator in one pass before the first translation
+ * stage.
+ *
+ * @param dir Output directory.
+ */
+void condor2nav::CTranslator::CTarget::DirectoryAdd(bfs::path dir)
 {
-  DirectoryCreate(_outputPath);
+  _directories.emplace_back(std::move(dir));
+}
+
+
+/**
+ * @brief Returns target output directories.
+ *
+ * @return The list of directories declared with DirectoryAdd().
+ */
+auto condor2nav::CTranslator::CTarget::Directories() const -> const CDirectories &
+{
+  return _directories;
+}
+
+
+/**
+ * @brief Adds translation stage output file.
+ *
+ * Method declares a file written by the current translation stage (other
+ * than target profiles). The stage is not skipped on the next translation
+ * if any of its outputs was removed.
+ *
+ * @param path Output file path.
+ */
+void condor2nav::CTranslator::CTarget::OutputAdd(bfs::path path)
+{
+  _outputs.emplace_back(std::move(path));
+}
+
+
+/**
+ * @brief Returns translation stage output files.
+ *
+ * Method returns the files declared with OutputAdd() since the previous
+ * call and clears the list.
+ *
+ * @return The list of translation stage output files.
+ */
+auto condor2nav::CTranslator::CTarget::OutputsTake() -> COutputs
+{
+  COutputs outputs;
+  outputs.swap(_outputs);
+  return outputs;
 }
 
 
@@ -112,11 +322,128 @@ const bfs::path &condor2nav::CTranslator::CTarget::OutputPath() const
 }
 
 
+/**
+ * @brief Returns precomputed glider polar.
+ *
+ * Gliders polars are generated from gliders data with 'polarOptimiser -g'.
+ * The polar is used only if it was generated from the current glider data.
+ *
+ * @param polarsParser Gliders polars CSV file parser.
+ * @param gliderData   Information describing the glider.
+ *
+ * @return Precomputed glider polar or nullptr if not available.
+ */
+auto condor2nav::CTranslator::CTarget::GliderPolar(const CFileParserCSV &polarsParser, const CFileParserCSV::CStringArray &gliderData) -> const CFileParserCSV::CStringArray *
+{
+  std::string source;
+  for(size_t i=GLIDER_MASS_DRY_GROSS; i<=GLIDER_SINK_3; i++)
+    source += (i > GLIDER_MASS_DRY_GROSS ? "/" : "") + gliderData.at(i).to_string();
+
+  try {
+    const auto &polar = polarsParser.Row(gliderData.at(GLIDER_NAME).to_string());
+    if(polar.size() > POLAR_SPEED_TO_FLY_100 && polar[POLAR_SOURCE] == source)
+      return &polar;
+  }
+  catch(const Exception &) {
+  }
+  return nullptr;
+}
+
+
 
 
 
 /* ********************************** T R A N S L A T O R *********************************** */
 
+/**
+ * @brief Registers translation target.
+ *
+ * Method adds the target to the registry of translation targets
+ * or replaces already registered target with the same name.
+ *
+ * @param info Target registration.
+ */
+void condor2nav::CTranslator::TargetRegister(const TTargetInfo &info)
+{
+  std::lock_guard<std::mutex> lock{registryMutex};
+  auto &targets = Registry();
+  auto it = std::find_if(targets.begin(), targets.end(), [&](const TTargetInfo &i){ return std::string{i.name} == info.name; });
+  if(it != targets.end())
+    *it = info;
+  else
+    targets.push_back(info);
+}
+
+
+/**
+ * @brief Returns translation target registration.
+ *
+ * @param name Translation target name.
+ *
+ * @exception std Thrown when unknown target name is provided.
+ *
+ * @return Target registration.
+ */
+auto condor2nav::CTranslator::TargetInfo(const std::string &name) -> TTargetInfo
+{
+  {
+    std::lock_guard<std::mutex> lock{registryMutex};
+    for(const auto &info : Registry())
+      if(name == info.name)
+        return info;
+  }
+
+  if(name.compare(0, 6, "XCSoar") == 0)
+    throw EOperationFailed{"ERROR: Unknown XCSoar version '" + name.substr(6) + "'!!!"};
+  else
+    throw EOperationFailed{"ERROR: Unknown translation target '" + name + "'!!!"};
+}
+
+
+/**
+ * @brief Returns the list of translation targets.
+ *
+ * Method returns the names of all the translation targets configured
+ * in 'Condor2Nav/Targets' list (i.e. XCSoar6, XCSoar5, LK8000). If the list
+ * is not provided a single target is configured with 'Condor2Nav/Target'
+ * and 'XCSoar/Version' values.
+ *
+ * @param configParser Configuration file parser.
+ *
+ * @exception std Thrown when no translation target is configured.
+ *
+ * @return The list of translation targets names.
+ */
+auto condor2nav::CTranslator::TargetNames(const CFileParserINI &configParser) -> CTargetNames
+{
+  std::string targets;
+  try {
+    targets = configParser.Value("Condor2Nav", "Targets");
+  }
+  catch(const Exception &) {
+  }
+
+  CTargetNames names;
+  boost::string_ref list{targets};
+  while(!list.empty()) {
+    const auto pos = list.find(',');
+    const auto name = Trim(list.substr(0, pos));
+    if(!name.empty() && std::find(names.begin(), names.end(), name) == names.end())
+      names.emplace_back(name.to_string());
+    list = pos == boost::string_ref::npos ? boost::string_ref{} : list.substr(pos + 1);
+  }
+
+  if(names.empty()) {
+    auto target = configParser.Value("Condor2Nav", "Target");
+    if(target == "XCSoar")
+      target += configParser.Value("XCSoar", "Version");
+    names.emplace_back(std::move(target));
+  }
+  return names;
+}
+
+
+
 /**
  * @brief Class constructor.
  *        
@@ -126,36 +453,126 @@ const bfs::path &condor2nav::CTranslator::CTarget::OutputPath() const
  * @param configParser Configuration file parser.
  * @param condor       The Condor wrapper.
  * @param aatTime      Minimum time for AAT task. 
+ * @param outputSubDir Optional subdirectory of all the targets output directories.
+ * @param sync         Specifies if staged outputs should be uploaded at the end of Run()
+ *                     (concurrent translations should call Sync() once after all of them).
+ */
+condor2nav::CTranslator::CTranslator(const CCondor2Nav &app, const CFileParserINI &configParser, const CCondor &condor, unsigned aatTime,
+                                     bfs::path outputSubDir /* = bfs::path{} */, bool sync /* = true */) :
+  _app{app}, _configParser{configParser}, _condor{condor}, _aatTime{aatTime}, _outputSubDir{std::move(outputSubDir)},
+  _output{WriteBehindEnabled(configParser)}, _sync{sync}
+{
+}
+
+
+/**
+ * @brief Returns translation target output directory.
+ *
+ * Target output directory is set with 'Condor2Nav/OutputPath<name>' value
+ * or 'Condor2Nav/OutputPath' if the first one is not provided.
+ *
+ * @param configParser Configuration INI file parser.
+ * @param name         Translation target name.
+ *
+ * @exception std Thrown when output directory is not configured.
+ *
+ * @return Translation target output directory.
  */
-condor2nav::CTranslator::CTranslator(const CCondor2Nav &app, const CFileParserINI &configParser, const CCondor &condor, unsigned aatTime) :
-  _app{app}, _configParser{configParser}, _condor{condor}, _aatTime{aatTime}
+bfs::path condor2nav::CTranslator::OutputPath(const CFileParserINI &configParser, const std::string &name)
 {
+  try {
+    return configParser.Value("Condor2Nav", "OutputPath" + name);
+  }
+  catch(const Exception &) {
+    return configParser.Value("Condor2Nav", "OutputPath");
+  }
+}
+
+
+/**
+ * @brief Returns local staging directory for translation outputs.
+ *
+ * When 'Condor2Nav/StagingPath' is provided outputs for ActiveSync
+ * directories are written to a local staging tree first and are uploaded
+ * to the device with one synchronization pass.
+ *
+ * @param configParser Configuration INI file parser.
+ * @param outputPath   Translation target output directory.
+ *
+ * @return Local staging directory or empty path if staging is not used.
+ */
+bfs::path condor2nav::CTranslator::StagingPath(const CFileParserINI &configParser, const bfs::path &outputPath)
+{
+  if(PathType(outputPath) != TPathType::ACTIVE_SYNC)
+    return bfs::path{};
+
+  std::string stagingPath;
+  try {
+    stagingPath = configParser.Value("Condor2Nav", "StagingPath");
+  }
+  catch(const Exception &) {
+  }
+  if(stagingPath.empty())
+    return bfs::path{};
+  return bfs::path{stagingPath} / outputPath.relative_path();
 }
 
 
 /**
  * @brief Creates Condor data translator target. 
  *
- * Method creates Condor data translator target.
+ * Method creates Condor data translator target. Target output directory
+ * is set with 'Condor2Nav/OutputPath<name>' value or 'Condor2Nav/OutputPath'
+ * if the first one is not provided (extended with the translator output
+ * subdirectory). ActiveSync outputs are redirected to the staging directory
+ * if one is configured.
+ *
+ * @param name Translation target name. 
+ * @param info Translation target registration.
  *
  * @return Condor data translator target.
  */
-auto condor2nav::CTranslator::Target() const -> std::unique_ptr<CTarget>
+auto condor2nav::CTranslator::Target(const std::string &name, const TTargetInfo &info) const -> std::unique_ptr<CTarget>
+{
+  auto outputPath = OutputPath(_configParser, name);
+  if(!_outputSubDir.empty())
+    outputPath /= _outputSubDir;
+  auto stagingPath = StagingPath(_configParser, outputPath);
+  if(!stagingPath.empty())
+    outputPath = std::move(stagingPath);
+
+  return info.factory(*this, std::move(outputPath));
+}
+
+
+/**
+ * @brief Uploads staged translation outputs to the device.
+ *
+ * Method synchronizes the staging directory of every configured target
+ * with its ActiveSync output directory. Only the files that differ from
+ * the ones recorded in the device manifest are uploaded so the same
+ * translation can be cheaply pushed to many devices one after another.
+ *
+ * @param app          Condor2Nav application.
+ * @param configParser Configuration INI file parser.
+ *
+ * @exception std Thrown when synchronization failed.
+ */
+void condor2nav::CTranslator::Sync(const CCondor2Nav &app, const CFileParserINI &configParser)
 {
-  const auto &target = _configParser.Value("Condor2Nav", "Target");
-  if(target == "XCSoar") {
-    const auto &version = _configParser.Value("XCSoar", "Version");
-    if(version == "5")
-      return std::make_unique<CTargetXCSoar>(*this);
-    else if(version == "6")
-      return std::make_unique<CTargetXCSoar6>(*this);
-    else
-      throw EOperationFailed{"ERROR: Unknown XCSoar version '" + version + "'!!!"};
+  // device might have been changed since the previous synchronization
+  CActiveSync::CacheClear();
+
+  for(const auto &name : TargetNames(configParser)) {
+    const auto outputPath = OutputPath(configParser, name);
+    const auto stagingPath = StagingPath(configParser, outputPath);
+    if(stagingPath.empty())
+      continue;
+
+    app.Log() << "Synchronizing '" << outputPath.string() << "' with staged outputs..." << std::endl;
+    const auto status = CDeviceSync{stagingPath, outputPath}.Run();
+    app.Log() << name << ": " << status.uploaded << " of " << status.files << " files uploaded (" << status.bytes << " bytes)" << std::endl;
   }
-  else if(target == "LK8000")
-    return std::make_unique<CTargetLK8000>(*this);
-  else
-    throw EOperationFailed{"ERROR: Unknown translation target '" + target + "'!!!"};
 }
 
 
@@ -164,60 +581,353 @@ auto condor2nav::CTranslator::Target() const -> std::unique_ptr<CTarget>
  *
  * Method is responsible for Condor data translation. Several
  * translate actions are configured through configuration INI file.
+ * Condor task data are parsed once and shared by all the configured
+ * targets. When more than one target is configured all of them run
+ * their translation stages concurrently on separate threads.
+ *
+ * Inputs of every stage are fingerprinted and stored next to the target
+ * outputs. When 'Condor2Nav/SkipUnchanged' is enabled stages with unchanged
+ * inputs are skipped as long as target profiles were not modified since
+ * they were written and the files the stages wrote still exist.
+ *
+ * When 'Condor2Nav/StagingPath' is set ActiveSync outputs are written
+ * locally and only changed files are uploaded to the device at the end
+ * (unless the translator was created without sync).
+ *
+ * When 'Condor2Nav/Trace' is enabled every stage is measured and reported
+ * at the end of translation.
+ *
+ * @exception std Thrown when translation of any target failed.
  */
 void condor2nav::CTranslator::Run()
 {
+  const CCondor2Nav::CTraceSession traceSession{_app};
   _app.LogHigh() << "Translation START" << std::endl;
 
-  // create translation target
-  auto target = Target();
-  
+  // device files might have been changed since the previous translation
+  CActiveSync::CacheClear();
+
+  // create translation targets
+  CTargetsList targets;
+  std::vector<TTargetInfo> infos;
+  for(const auto &name : TargetNames(_configParser)) {
+    const auto info = TargetInfo(name);
+    auto target = Target(name, info);
+    for(const auto &t : targets)
+      if(t->DataDir() == std::string{target->DataDir()} && t->OutputPath() == target->OutputPath())
+        throw EOperationFailed{"ERROR: Translation targets '" + std::string{t->Name()} + "' and '" + target->Name() + "' use the same output directory '" + target->OutputPath().string() + "'!!!"};
+    targets.emplace_back(std::move(target));
+    infos.push_back(info);
+  }
+
+  // output directories of all the targets are created at once
   {
-    const CFileParserCSV sceneriesParser{DATA_PATH / _configParser.Value("Condor2Nav", "Target") / SCENERIES_DATA_FILE_NAME};
-    const auto &sceneryData = sceneriesParser.Row(_condor.TaskParser().Value("Task", "Landscape"), 0, true);
+    CTraceScope trace{"translation", "Directories create"};
+    CTarget::CDirectories dirs;
+    for(const auto &target : targets)
+      dirs.insert(dirs.end(), target->Directories().begin(), target->Directories().end());
+    DirectoriesCreate(std::move(dirs));
+  }
 
-    // set Condor GPS data
-    if(_configParser.Value("Condor2Nav", "SetGPS") == "1") {
-      _app.Log() << "Setting Condor GPS data..." << std::endl;
-      target->Gps();
+  const auto setGps          = _configParser.Value("Condor2Nav", "SetGPS") == "1";
+  const auto setSceneryMap   = _configParser.Value("Condor2Nav", "SetSceneryMap") == "1";
+  const auto setSceneryTime  = _configParser.Value("Condor2Nav", "SetSceneryTime") == "1";
+  const auto setTask         = _configParser.Value("Condor2Nav", "SetTask") == "1";
+  const auto setGlider       = _configParser.Value("Condor2Nav", "SetGlider") == "1";
+  const auto setPenaltyZones = _configParser.Value("Condor2Nav", "SetPenaltyZones") == "1";
+  const auto setWeather      = _configParser.Value("Condor2Nav", "SetWeather") == "1";
+  bool skipUnchanged = true;
+  try {
+    skipUnchanged = _configParser.Value("Condor2Nav", "SkipUnchanged") == "1";
+  }
+  catch(const Exception &) {
+  }
+  const auto &taskParser = _condor.TaskParser();
+
+  // maps synchronization running in the background updates sceneries data
+  _app.MapsWait(taskParser.Value("Task", "Landscape"));
+
+  // all the lookups are done here so that targets only read the shared data
+  // CSV databases are cached by the application between translations
+  // parsers are held until the end of the translation because concurrent
+  // translations may replace them in the cache when the files change
+  std::vector<std::shared_ptr<const CFileParserCSV>> csvParsers;
+  auto csvParser = [&](const bfs::path &path) -> const CFileParserCSV &
+  {
+    csvParsers.emplace_back(_app.CSVCache().Parser(path));
+    return *csvParsers.back();
+  };
+
+  std::vector<const CFileParserCSV::CStringArray *> sceneriesData;
+  for(const auto &target : targets) {
+    const auto &parser = csvParser(DATA_PATH / target->DataDir() / SCENERIES_DATA_FILE_NAME);
+    sceneriesData.push_back(&parser.Row(taskParser.Value("Task", "Landscape"), 0, true));
+  }
+
+  const CFileParserCSV::CStringArray *gliderData = nullptr;
+  const CFileParserCSV::CStringArray *gliderPolar = nullptr;
+  if(setGlider) {
+    gliderData = &csvParser(DATA_PATH / GLIDERS_DATA_FILE_NAME).Row(taskParser.Value("Plane", "Name"));
+    try {
+      gliderPolar = CTarget::GliderPolar(csvParser(DATA_PATH / GLIDER_POLARS_FILE_NAME), *gliderData);
+    }
+    catch(const Exception &) {
+      // polars are generated only for the gliders distributed with condor2nav
     }
 
-    // translate scenery data
-    if(_configParser.Value("Condor2Nav", "SetSceneryMap") == "1") {
-      _app.Log() << "Setting scenery map data..." << std::endl;
-      target->SceneryMap(sceneryData);
+    // missing polar is logged only by the first translation of the glider
+    bool missingLog = false;
+    if(!gliderPolar) {
+      std::lock_guard<std::mutex> lock{missingPolarsMutex};
+      missingLog = missingPolars.insert(taskParser.Value("Plane", "Name")).second;
+    }
+    if(missingLog)
+      _app.Log() << "Glider '" << taskParser.Value("Plane", "Name") << "' polar not found in '" << GLIDER_POLARS_FILE_NAME.string() << "' (run 'polarOptimiser -g' to regenerate it)" << std::endl;
+  }
+
+  // task turnpoints and penalty zones are parsed once, on the first use by any target
+  const CCondor::CTask *task = nullptr;
+  if(setTask || setPenaltyZones) {
+    CTraceScope trace{"translation", "Task parse"};
+    task = &_condor.Task();
+  }
+
+  std::mutex fingerprintsMutex;
+  std::vector<std::pair<bfs::path, std::string>> fingerprintsFiles;
+  CFingerprint configFingerprint;
+  configFingerprint.Add(FINGERPRINTS_VERSION);
+  _configParser.Fingerprint(configFingerprint, "Condor2Nav");
+
+  auto translate = [&](CTarget &target, const TTargetInfo &info, const CFileParserCSV::CStringArray &sceneryData)
+  {
+    const auto prefix = targets.size() > 1 ? std::string{target.Name()} + ": " : std::string{};
+
+    // stages not supported by the target are skipped
+    const auto gps          = setGps          && (info.stages & STAGE_GPS) != 0;
+    const auto sceneryMap   = setSceneryMap   && (info.stages & STAGE_SCENERY_MAP) != 0;
+    const auto sceneryTime  = setSceneryTime  && (info.stages & STAGE_SCENERY_TIME) != 0;
+    const auto taskSet      = setTask         && (info.stages & STAGE_TASK) != 0;
+    const auto glider       = setGlider       && (info.stages & STAGE_GLIDER) != 0;
+    const auto penaltyZones = setPenaltyZones && (info.stages & STAGE_PENALTY_ZONES) != 0;
+    const auto weather      = setWeather      && (info.stages & STAGE_WEATHER) != 0;
+
+    // fingerprint the inputs of all the stages
+    auto targetFingerprint = configFingerprint;
+    targetFingerprint.Add(info.formatVersion);
+    _configParser.Fingerprint(targetFingerprint, target.DataDir());
+    std::map<std::string, std::string> fingerprints;
+    fingerprints["Gps"]          = CFingerprint{targetFingerprint}.String();
+    fingerprints["SceneryMap"]   = CFingerprint{targetFingerprint}.Add(sceneryData).String();
+    fingerprints["SceneryTime"]  = CFingerprint{targetFingerprint}.String();
+    {
+      CFingerprint fingerprint{targetFingerprint};
+      fingerprint.Add(sceneryData).Add(Convert(_aatTime));
+      taskParser.Fingerprint(fingerprint, "Task");
+      fingerprints["Task"] = fingerprint.String();
+    }
+    if(gliderData) {
+      CFingerprint fingerprint{targetFingerprint};
+      fingerprint.Add(*gliderData);
+      if(gliderPolar)
+        fingerprint.Add(*gliderPolar);
+      taskParser.Fingerprint(fingerprint, "Plane");
+      fingerprints["Glider"] = fingerprint.String();
+    }
+    {
+      CFingerprint fingerprint{targetFingerprint};
+      taskParser.Fingerprint(fingerprint, "Task");
+
+      // external airspaces merged into the penalty zones file
+      std::string airspacesDir;
+      try {
+        airspacesDir = _configParser.Value("Condor2Nav", "AirspacesPath");
+      }
+      catch(const Exception &) {
+      }
+      if(!airspacesDir.empty()) {
+        const auto airspacesPath = bfs::path{airspacesDir} / (taskParser.Value("Task", "Landscape") + ".txt");
+        boost::system::error_code ec;
+        const auto size = bfs::file_size(airspacesPath, ec);
+        fingerprint.Add(ec ? std::string{"-"} : std::to_string(size) + " " + std::to_string(FileWriteTime(airspacesPath)));
+      }
+      fingerprints["PenaltyZones"] = fingerprint.String();
+    }
+    {
+      CFingerprint fingerprint{targetFingerprint};
+      taskParser.Fingerprint(fingerprint, "Weather");
+      fingerprints["Weather"] = fingerprint.String();
     }
 
-    if(_configParser.Value("Condor2Nav", "SetSceneryTime") == "1") {
-      _app.Log() << "Setting scenery time..." << std::endl;
-      target->SceneryTime();
+    // previous fingerprints are valid only if profiles were not changed since they were written
+    const auto fingerprintsPath = target.OutputPath() / (std::string{"condor2nav"} + target.Name() + FINGERPRINTS_FILE_EXTENSION);
+    std::unique_ptr<const CFileParserINI> previous;
+    if(skipUnchanged) {
+      try {
+        previous = std::make_unique<const CFileParserINI>(fingerprintsPath);
+        CFingerprint profiles;
+        target.ProfilesFingerprint(profiles);
+        if(previous->Value("", "Profiles") != profiles.String())
+          previous.reset();
+      }
+      catch(const Exception &) {
+        previous.reset();
+      }
     }
-  
+
+    // stages are skipped only if the outputs they wrote previously still exist
+    bool modified = false;
+    std::string skipped;
+    std::map<std::string, std::string> outputs;
+    auto stage = [&](const char *name, const char *info, const std::function<void()> &func)
+    {
+      const auto outputsKey = name + std::string{FINGERPRINTS_OUTPUTS_SUFFIX};
+      if(previous) {
+        try {
+          if(previous->Value("", name) == fingerprints[name]) {
+            const auto &previousOutputs = previous->Value("", outputsKey);
+            if(OutputsExist(previousOutputs)) {
+              outputs[outputsKey] = previousOutputs;
+              skipped += (skipped.empty() ? "" : ", ") + std::string{name};
+              return;
+            }
+          }
+        }
+        catch(const Exception &) {
+        }
+      }
+      _app.Log() << prefix + info + "\n";
+      CTraceScope trace{"stage", name, std::string{target.Name()}};
+      func();
+      std::string stageOutputs;
+      for(const auto &path : target.OutputsTake())
+        stageOutputs += (stageOutputs.empty() ? "" : std::string(1, FINGERPRINTS_OUTPUTS_SEPARATOR)) + path.string();
+      outputs[outputsKey] = std::move(stageOutputs);
+      modified = true;
+    };
+
+    // set Condor GPS data
+    if(gps)
+      stage("Gps", "Setting Condor GPS data...", [&]{ target.Gps(); });
+
+    // translate scenery data
+    if(sceneryMap)
+      stage("SceneryMap", "Setting scenery map data...", [&]{ target.SceneryMap(sceneryData); });
+
+    if(sceneryTime)
+      stage("SceneryTime", "Setting scenery time...", [&]{ target.SceneryTime(); });
+
     // translate task
-    if(_configParser.Value("Condor2Nav", "SetTask") == "1") {
-      _app.Log() << "Setting task data..." << std::endl;
-      target->Task(_condor.TaskParser(), _condor.CoordConverter(), sceneryData, _aatTime);
+    if(taskSet)
+      stage("Task", "Setting task data...", [&]{ target.Task(*task, sceneryData, _aatTime); });
+
+    // translate glider data
+    if(glider)
+      stage("Glider", "Setting glider data...", [&]{ target.Glider(*gliderData, gliderPolar); });
+
+    // translate penalty zones
+    if(penaltyZones)
+      stage("PenaltyZones", "Setting penalty zones...", [&]{ target.PenaltyZones(*task); });
+
+    // translate weather
+    if(weather)
+      stage("Weather", "Setting weather data...", [&]{ target.Weather(taskParser); });
+
+    if(!skipped.empty())
+      _app.Log() << prefix + "Skipping unchanged: " + skipped + "\n";
+    if(!modified && previous)
+      return;
+
+    // write target profiles
+    {
+      CTraceScope trace{"stage", "Commit", std::string{target.Name()}};
+      target.Commit();
+    }
+
+    // fingerprints of the inputs used to create the outputs are stored after all the outputs are written
+    CFingerprint profiles;
+    target.ProfilesFingerprint(profiles);
+    std::string content = "Profiles=" + profiles.String() + "\n";
+    auto store = [&](bool enabled, const char *name)
+    {
+      if(enabled) {
+        const auto outputsKey = name + std::string{FINGERPRINTS_OUTPUTS_SUFFIX};
+        content += name + ("=" + fingerprints[name]) + "\n";
+        content += outputsKey + "=" + outputs[outputsKey] + "\n";
+      }
+    };
+    store(gps, "Gps");
+    store(sceneryMap, "SceneryMap");
+    store(sceneryTime, "SceneryTime");
+    store(taskSet, "Task");
+    store(glider, "Glider");
+    store(penaltyZones, "PenaltyZones");
+    store(weather, "Weather");
+    std::lock_guard<std::mutex> lock{fingerprintsMutex};
+    fingerprintsFiles.emplace_back(fingerprintsPath, std::move(content));
+  };
+
+  std::exception_ptr failure;
+  try {
+    if(targets.size() == 1) {
+      translate(*targets.front(), infos.front(), *sceneriesData.front());
+    }
+    else {
+      std::vector<std::future<void>> futures;
+      futures.reserve(targets.size());
+      for(size_t i=0; i<targets.size(); i++)
+        futures.emplace_back(std::async(std::launch::async, translate, std::ref(*targets[i]), std::cref(infos[i]), std::cref(*sceneriesData[i])));
+
+      // wait for all the targets and report all failures at once
+      std::string errors;
+      for(size_t i=0; i<futures.size(); i++) {
+        try {
+          futures[i].get();
+        }
+        catch(const std::exception &ex) {
+          if(!errors.empty())
+            errors += "\n";
+          errors += std::string{targets[i]->Name()} + ": " + ex.what();
+        }
+      }
+      if(!errors.empty())
+        throw EOperationFailed{errors};
     }
   }
-  
-  // translate glider data
-  if(_configParser.Value("Condor2Nav", "SetGlider") == "1") {
-    _app.Log() << "Setting glider data..." << std::endl;
-    const CFileParserCSV glidersParser{DATA_PATH / GLIDERS_DATA_FILE_NAME};
-    target->Glider(glidersParser.Row(_condor.TaskParser().Value("Plane", "Name")));
+  catch(...) {
+    failure = std::current_exception();
   }
 
-  // translate penalty zones
-  if(_configParser.Value("Condor2Nav", "SetPenaltyZones") == "1") {
-    _app.Log() << "Setting penalty zones..." << std::endl;
-    target->PenaltyZones(_condor.TaskParser(), _condor.CoordConverter());
+  // wait for the outputs written in the background (also when the translation failed)
+  {
+    CTraceScope trace{"translation", "Output wait"};
+    try {
+      _output.Wait();
+    }
+    catch(const std::exception &ex) {
+      if(!failure)
+        throw;
+      try {
+        std::rethrow_exception(failure);
+      }
+      catch(const std::exception &translation) {
+        throw EOperationFailed{std::string{translation.what()} + "\n" + ex.what()};
+      }
+    }
+  }
+  if(failure)
+    std::rethrow_exception(failure);
+  for(const auto &file : fingerprintsFiles) {
+    COStream fingerprintsFile{file.first};
+    fingerprintsFile << file.second;
+    fingerprintsFile.Commit();
   }
 
-  // translate weather
-  if(_configParser.Value("Condor2Nav", "SetWeather") == "1") {
-    _app.Log() << "Setting weather data..." << std::endl;
-    target->Weather(_condor.TaskParser());
+  // upload staged outputs
+  if(_sync) {
+    CTraceScope trace{"translation", "Sync"};
+    Sync(_app, _configParser);
   }
 
   _app.LogHigh() << "Translation FINISH" << std::endl;
+  _app.MemoryReport("Translation");
 }
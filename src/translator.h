@@ -30,6 +30,8 @@
 
 #include "condor.h"
 #include "fileParserCSV.h"
+#include "fingerprint.h"
+#include "writeBehind.h"
 
 
 namespace condor2nav {
@@ -44,14 +46,35 @@ namespace condor2nav {
    */
   class CTranslator : CNonCopyable {
   public:
+    /**
+     * @brief Translation stages.
+     */
+    enum TStage {
+      STAGE_GPS           = 1 << 0,
+      STAGE_SCENERY_MAP   = 1 << 1,
+      STAGE_SCENERY_TIME  = 1 << 2,
+      STAGE_TASK          = 1 << 3,
+      STAGE_GLIDER        = 1 << 4,
+      STAGE_PENALTY_ZONES = 1 << 5,
+      STAGE_WEATHER       = 1 << 6,
+      STAGE_ALL           = (1 << 7) - 1
+    };
+
     /**
      * @brief Translation targets hierarchy base class.
      *
      * condor2nav::CTranslator::CTarget is a base abstract class for all translation targets.
      */
     class CTarget : CNonCopyable {
+    public:
+      using CDirectories = std::vector<bfs::path>;
+      using COutputs = std::vector<bfs::path>;
+
+    private:
       const CTranslator &_translator;     ///< @brief Translator class
       const bfs::path _outputPath;        ///< @brief Translation output directory
+      CDirectories _directories;          ///< @brief Output directories used by the target
+      COutputs _outputs;                  ///< @brief Files written by the current translation stage
 
     public:
       /**
@@ -85,15 +108,43 @@ namespace condor2nav {
         GLIDER_FLAPS
       };
 
+      /**
+       * @brief Gliders polars CSV file column names (file generated with 'polarOptimiser -g').
+       */
+      enum TGliderPolarsColumns {
+        POLAR_NAME,
+        POLAR_SOURCE,
+        POLAR_SPEED_1,
+        POLAR_SINK_1,
+        POLAR_SPEED_2,
+        POLAR_SINK_2,
+        POLAR_SPEED_3,
+        POLAR_SINK_3,
+        POLAR_MIN_SINK_SPEED,
+        POLAR_MIN_SINK,
+        POLAR_BEST_LD_SPEED,
+        POLAR_BEST_LD,
+        POLAR_SPEED_TO_FLY_0,
+        POLAR_SPEED_TO_FLY_50,
+        POLAR_SPEED_TO_FLY_100
+      };
+
       const CTranslator &Translator() const;
       const CFileParserINI &ConfigParser() const;
       const CCondor &Condor() const;
-      const bfs::path &OutputPath() const;
+      void DirectoryAdd(bfs::path dir);
+      void OutputAdd(bfs::path path);
 
     public:
-      explicit CTarget(const CTranslator &translator);
+      static const CFileParserCSV::CStringArray *GliderPolar(const CFileParserCSV &polarsParser, const CFileParserCSV::CStringArray &gliderData);
+
+      CTarget(const CTranslator &translator, bfs::path outputPath);
       virtual ~CTarget() {}
 
+      const bfs::path &OutputPath() const;
+      const CDirectories &Directories() const;
+      COutputs OutputsTake();
+
       /**
        * @brief Returns target name.
        *
@@ -101,6 +152,14 @@ namespace condor2nav {
        */
       virtual const char *Name() const = 0;
 
+      /**
+       * @brief Returns target data subdirectory.
+       *
+       * Method returns the name of application data subdirectory
+       * with target specific files (i.e. sceneries data).
+       */
+      virtual const char *DataDir() const = 0;
+
       /**
        * @brief Sets Condor GPS data.
        *
@@ -129,32 +188,30 @@ namespace condor2nav {
        *
        * Method sets all the data related to the glider.
        *
-       * @param gliderData Information describing the glider. 
+       * @param gliderData  Information describing the glider. 
+       * @param gliderPolar Precomputed glider polar (nullptr if not available). 
        */
-      virtual void Glider(const CFileParserCSV::CStringArray &gliderData) = 0;
+      virtual void Glider(const CFileParserCSV::CStringArray &gliderData, const CFileParserCSV::CStringArray *gliderPolar) = 0;
 
       /**
        * @brief Sets task information. 
        *
        * Method sets task information.
        *
-       * @param taskParser  Condor task parser. 
-       * @param coordConv   Condor coordinates converter.
+       * @param task        Condor task.
        * @param sceneryData Information describing the scenery.
        * @param aatTime     Minimum time for AAT task
        */
-      virtual void Task(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv,
-                        const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) = 0;
+      virtual void Task(const CCondor::CTask &task, const CFileParserCSV::CStringArray &sceneryData, unsigned aatTime) = 0;
 
       /**
        * @brief Sets task penalty zones. 
        *
        * Method sets penalty zones used in the task.
        *
-       * @param taskParser Condor task parser. 
-       * @param coordConv  Condor coordinates converter.
+       * @param task Condor task.
        */
-      virtual void PenaltyZones(const CFileParserINI &taskParser, const CCondor::CCoordConverter &coordConv) = 0;
+      virtual void PenaltyZones(const CCondor::CTask &task) = 0;
 
       /**
        * @brief Sets weather data. 
@@ -164,25 +221,97 @@ namespace condor2nav {
        * @param taskParser Condor task parser. 
        */
       virtual void Weather(const CFileParserINI &taskParser) = 0;
+
+      /**
+       * @brief Adds target profiles to the fingerprint. 
+       *
+       * Method adds the current content of all the profiles modified by the
+       * translation to the fingerprint.
+       *
+       * @param fingerprint Fingerprint to update.
+       */
+      virtual void ProfilesFingerprint(CFingerprint &fingerprint) const = 0;
+
+      /**
+       * @brief Writes target profiles. 
+       *
+       * Method writes all the profiles modified by the translation.
+       * It is called after all the other translation stages.
+       *
+       * @exception std Thrown when writing of any of the files failed.
+       */
+      virtual void Commit() = 0;
     };
 
+    using CTargetNames = std::vector<std::string>;
+
+    /**
+     * @brief Translation target factory.
+     *
+     * @param translator Translator class.
+     * @param outputPath Translation output directory.
+     *
+     * @return Translation target.
+     */
+    using CTargetFactory = std::unique_ptr<CTarget>(*)(const CTranslator &translator, bfs::path outputPath);
+
+    /**
+     * @brief Translation target registration.
+     */
+    struct TTargetInfo {
+      const char *name;                   ///< @brief Target name used in the configuration (i.e. 'XCSoar6')
+      unsigned stages;                    ///< @brief Translation stages supported by the target (TStage flags)
+      const char *formatVersion;          ///< @brief Has to be changed when the target output formats change
+      CTargetFactory factory;             ///< @brief Creates the target
+    };
+
+    /**
+     * @brief Creates the translation target of a specific type.
+     *
+     * @param translator Translator class.
+     * @param outputPath Translation output directory.
+     *
+     * @return Translation target.
+     */
+    template<class T>
+    static std::unique_ptr<CTarget> TargetCreate(const CTranslator &translator, bfs::path outputPath)
+    {
+      return std::make_unique<T>(translator, std::move(outputPath));
+    }
+
   private:
+    using CTargetsList = std::vector<std::unique_ptr<CTarget>>;
+
     const CCondor2Nav &_app;
     const CFileParserINI &_configParser;                  ///< @brief Configuration INI file parser.
     const CCondor &_condor;                               ///< @brief Condor data.
     const unsigned _aatTime;                              ///< @brief Minimum time for AAT task
+    const bfs::path _outputSubDir;                        ///< @brief Subdirectory of the targets output directories (for batch translations)
+    mutable CWriteBehind _output;                         ///< @brief Write-behind queue of the translation outputs
+    const bool _sync;                                     ///< @brief Upload staged outputs at the end of the translation
 
-    std::unique_ptr<CTarget> Target() const;
+    static bfs::path StagingPath(const CFileParserINI &configParser, const bfs::path &outputPath);
+
+    std::unique_ptr<CTarget> Target(const std::string &name, const TTargetInfo &info) const;
 
   public:
     // inputs
     static const bfs::path DATA_PATH;                     ///< @brief Application data directory path. 
     static const bfs::path SCENERIES_DATA_FILE_NAME;      ///< @brief Sceneries data CSV file name. 
     static const bfs::path GLIDERS_DATA_FILE_NAME;        ///< @brief Gliders data CSV file name.
+    static const bfs::path GLIDER_POLARS_FILE_NAME;       ///< @brief Precomputed gliders polars CSV file name.
+
+    static void TargetRegister(const TTargetInfo &info);
+    static TTargetInfo TargetInfo(const std::string &name);
+    static CTargetNames TargetNames(const CFileParserINI &configParser);
+    static bfs::path OutputPath(const CFileParserINI &configParser, const std::string &name);
+    static void Sync(const CCondor2Nav &app, const CFileParserINI &configParser);
 
-    CTranslator(const CCondor2Nav &app, const CFileParserINI &configParser, const CCondor &condor, unsigned aatTime);
+    CTranslator(const CCondor2Nav &app, const CFileParserINI &configParser, const CCondor &condor, unsigned aatTime,
+                bfs::path outputSubDir = bfs::path{}, bool sync = true);
     void Run();
     const CCondor2Nav &App() const { return _app; }
+    CWriteBehind &Output() const { return _output; }
   };
 
 }
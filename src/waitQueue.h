@@ -32,6 +32,8 @@
 #include <queue>
 #include <thread>
 #include <condition_variable>
+#include <atomic>
+#include <memory>
 
 namespace condor2nav {
 
@@ -44,14 +46,12 @@ namespace condor2nav {
     CWaitQueue() {}
     void Push(T msg)
     {
-      bool wasEmpty;
       {
         std::lock_guard<std::mutex> lock{_mutex};
-        wasEmpty = _queue.empty();
         _queue.push(std::move(msg));
       }
-      if(wasEmpty)
-        _newItemReady.notify_one();
+      // always notify as there may be more consumers waiting
+      _newItemReady.notify_one();
     }
     T PopWait()
     {
@@ -61,6 +61,165 @@ namespace condor2nav {
       _queue.pop();
       return msg;
     }
+
+    /**
+     * @brief Takes all the queued items at once.
+     *
+     * Method waits for at least one item and takes all the items
+     * queued so far with one lock.
+     *
+     * @return Queued items in the order of pushing.
+     */
+    std::queue<T> PopAllWait()
+    {
+      std::queue<T> msgs;
+      std::unique_lock<std::mutex> lock{_mutex};
+      _newItemReady.wait(lock, [&]{ return _queue.size(); });
+      std::swap(msgs, _queue);
+      return msgs;
+    }
+  };
+
+
+  /**
+   * @brief Thread safe waiting queue with limited capacity.
+   *
+   * Producers are blocked when the queue is full until the consumer
+   * takes some items (back-pressure).
+   */
+  template<typename T>
+  class CBoundedWaitQueue : CNonCopyable {
+    std::queue<T> _queue;
+    const size_t _capacity;
+    std::condition_variable _newItemReady;
+    std::condition_variable _spaceReady;
+    std::mutex _mutex;
+  public:
+    explicit CBoundedWaitQueue(size_t capacity) : _capacity{capacity ? capacity : 1} {}
+    void Push(T msg)
+    {
+      {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _spaceReady.wait(lock, [&]{ return _queue.size() < _capacity; });
+        _queue.push(std::move(msg));
+      }
+      _newItemReady.notify_one();
+    }
+    bool TryPush(T msg)
+    {
+      {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if(_queue.size() >= _capacity)
+          return false;
+        _queue.push(std::move(msg));
+      }
+      _newItemReady.notify_one();
+      return true;
+    }
+    T PopWait()
+    {
+      T msg;
+      {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _newItemReady.wait(lock, [&]{ return _queue.size(); });
+        msg = std::move(_queue.front());
+        _queue.pop();
+      }
+      _spaceReady.notify_one();
+      return msg;
+    }
+    std::queue<T> PopAllWait()
+    {
+      std::queue<T> msgs;
+      {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _newItemReady.wait(lock, [&]{ return _queue.size(); });
+        std::swap(msgs, _queue);
+      }
+      _spaceReady.notify_all();
+      return msgs;
+    }
+  };
+
+
+  /**
+   * @brief Lock-free multiple producers single consumer ring buffer.
+   *
+   * Items are stored in a fixed size ring of cells with sequence numbers
+   * so producers only compete on one atomic index and never lock.
+   * Push fails when the ring is full. There is no waiting support so
+   * the consumer should poll it (i.e. together with other work).
+   *
+   * @note Capacity is rounded up to the power of 2.
+   */
+  template<typename T>
+  class CMPSCRingQueue : CNonCopyable {
+    struct TCell {
+      std::atomic<size_t> sequence;
+      T data;
+    };
+    enum { CACHE_LINE_SIZE = 64 };
+
+    const size_t _mask;
+    std::unique_ptr<TCell[]> _cells;
+    char _pad0[CACHE_LINE_SIZE];
+    std::atomic<size_t> _enqueuePos;
+    char _pad1[CACHE_LINE_SIZE];
+    size_t _dequeuePos;
+
+    static size_t RoundUp(size_t capacity)
+    {
+      size_t size = 2;
+      while(size < capacity)
+        size <<= 1;
+      return size;
+    }
+
+  public:
+    explicit CMPSCRingQueue(size_t capacity) :
+      _mask{RoundUp(capacity) - 1}, _cells{new TCell[_mask + 1]}, _dequeuePos{0}
+    {
+      for(size_t i=0; i<=_mask; i++)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+      _enqueuePos.store(0, std::memory_order_relaxed);
+    }
+    size_t Capacity() const { return _mask + 1; }
+    bool TryPush(const T &msg)
+    {
+      T copy(msg);
+      return TryPush(std::move(copy));
+    }
+    bool TryPush(T &&msg)
+    {
+      // msg is moved only if it was pushed successfully
+      auto pos = _enqueuePos.load(std::memory_order_relaxed);
+      for(;;) {
+        auto &cell = _cells[pos & _mask];
+        const auto seq = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if(diff == 0) {
+          if(_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            cell.data = std::move(msg);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;  // full
+        else
+          pos = _enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    bool TryPop(T &msg)
+    {
+      auto &cell = _cells[_dequeuePos & _mask];
+      if(cell.sequence.load(std::memory_order_acquire) != _dequeuePos + 1)
+        return false;    // empty
+      msg = std::move(cell.data);
+      cell.sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+      ++_dequeuePos;
+      return true;
+    }
   };
 
 }
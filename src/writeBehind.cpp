@@ -0,0 +1,106 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file writeBehind.cpp
+ *
+ * @brief Implements the condor2nav::CWriteBehind class. 
+ */
+
+#include "writeBehind.h"
+#include "activeObject.h"
+#include "tools.h"
+#include <future>
+
+
+/**
+ * @brief Class constructor.
+ *
+ * @param enabled @p true to execute the writes in the background.
+ */
+condor2nav::CWriteBehind::CWriteBehind(bool enabled) :
+  _executor{enabled ? std::make_unique<CActiveObject>() : nullptr}
+{
+}
+
+
+/**
+ * @brief Class destructor.
+ *
+ * Waits for all pending writes. Their errors are not reported so Wait()
+ * should always be called explicitly.
+ */
+condor2nav::CWriteBehind::~CWriteBehind()
+{
+  _executor.reset();
+}
+
+
+/**
+ * @brief Queues the write.
+ *
+ * @param write The function writing the data.
+ *
+ * @exception std Thrown when the write failed and the queue is disabled.
+ */
+void condor2nav::CWriteBehind::Send(CWrite write)
+{
+  if(!_executor) {
+    write();
+    return;
+  }
+
+  _executor->Send([this, write]
+  {
+    try {
+      write();
+    }
+    catch(const std::exception &ex) {
+      std::lock_guard<std::mutex> lock{_mutex};
+      _errors += (_errors.empty() ? "" : "\n") + std::string{ex.what()};
+    }
+  });
+}
+
+
+/**
+ * @brief Waits for all writes sent so far.
+ *
+ * @exception std Thrown when any of the writes failed. The message contains
+ *                the errors of all the failed writes.
+ */
+void condor2nav::CWriteBehind::Wait()
+{
+  if(_executor) {
+    std::promise<void> done;
+    auto barrier = done.get_future();
+    _executor->Send([&]{ done.set_value(); });
+    barrier.wait();
+  }
+
+  std::string errors;
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    errors.swap(_errors);
+  }
+  if(!errors.empty())
+    throw EOperationFailed{errors};
+}
@@ -0,0 +1,68 @@
+//
+// This file is part of Condor2Nav file formats translator.
+//
+// Copyright (C) 2009-2012 Mateusz Pusz
+//
+// Condor2Nav is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Condor2Nav is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Condor2Nav. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file writeBehind.h
+ *
+ * @brief Declares the condor2nav::CWriteBehind class. 
+ */
+
+#ifndef __WRITEBEHIND_H__
+#define __WRITEBEHIND_H__
+
+#include "nonCopyable.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace condor2nav {
+
+  class CActiveObject;
+
+  /**
+   * @brief Write-behind output queue.
+   *
+   * condor2nav::CWriteBehind executes output writes on a background I/O thread
+   * so that the next translation stage does not wait for slow disk or device
+   * writes of the previous one. Writes are executed in the order they were
+   * sent. Errors are collected and reported all at once by Wait(). Disabled
+   * queue executes writes immediately in the calling thread.
+   */
+  class CWriteBehind : CNonCopyable {
+  public:
+    using CWrite = std::function<void()>;
+
+  private:
+    std::mutex _mutex;                                   ///< @brief Serializes errors access
+    std::string _errors;                                 ///< @brief Errors of the executed writes
+    std::unique_ptr<CActiveObject> _executor;            ///< @brief Background I/O thread (nullptr if disabled)
+
+  public:
+    explicit CWriteBehind(bool enabled);
+    ~CWriteBehind();
+    void Send(CWrite write);
+    void Wait();
+  };
+
+}
+
+#endif /* __WRITEBEHIND_H__ */
@@ -26,12 +26,14 @@
 **/
 
 #include "application.h"
+#include "polarFit.h"
 #include "tools.h"
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <cmath>
+#include <limits>
 #include <set>
 
 
@@ -39,10 +41,16 @@
  * @brief Class constructor
  *
  * polarOptimiser::CApplication class constructor responsible for polar curve creation.
+ * If more than 3 polar curve points are provided, the polar curve equation is fitted
+ * to all of them with least-squares method. The exhaustive search for the best 3 of
+ * provided points may be used instead for validation.
  *
  * @param fileName WinPilot polar file
+ * @param bruteForce Use exhaustive searches instead of closed-form solutions
+ * @param relativeWeights Fit relative instead of absolute sink errors
  */
-polarOptimiser::CApplication::CApplication(const std::string &fileName)
+polarOptimiser::CApplication::CApplication(const std::string &fileName, bool bruteForce /* = false */, bool relativeWeights /* = false */):
+  _bruteForce(bruteForce)
 {
   // get polar curve data
   CDataArray data;
@@ -57,35 +65,8 @@ polarOptimiser::CApplication::CApplication(const std::string &fileName)
 
   double speed[3];
   double sink[3];
-  unsigned idx0 = 2, idx1 = 4, idx2 = 6;
+  const unsigned idx0 = 2, idx1 = 4, idx2 = 6;
   double bestError = 0xFFFF;
-  if(data.size() > 8) {
-    // look for the best 3 polar curve points
-    for(unsigned i=2; i<data.size(); i+=2) {
-      speed[0] = data.at(i);
-      sink[0] = data.at(i + 1);
-      for(unsigned j=i + 2; j<data.size(); j+=2) {
-        speed[1] = data.at(j);
-        sink[1] = data.at(j + 1);
-        for(unsigned k=j + 2; k<data.size(); k+=2) {
-          speed[2] = data.at(k);
-          sink[2] = data.at(k + 1);
-
-          _polar = std::auto_ptr<CPolarXCSoar>(new CPolarXCSoar(speed, sink));
-          double error = 0;
-          for(unsigned l=0; l<(data.size() - 2) / 2; l++)
-            error += abs(_polar->Sink(data.at(l * 2 + 2), data.at(0), 0) - data.at(l * 2 + 3));
-          if(error < bestError) {
-            bestError = error;
-            idx0 = i;
-            idx1 = j;
-            idx2 = k;
-          }
-        }
-      }
-    }
-  }
-
   // assign 3 polar curve points
   speed[0] = data[idx0];
   sink[0] = data[idx0 + 1];
@@ -93,6 +74,41 @@ polarOptimiser::CApplication::CApplication(const std::string &fileName)
   sink[1] = data[idx1 + 1];
   speed[2] = data[idx2];
   sink[2] = data[idx2 + 1];
+
+  if(data.size() > 8) {
+    CDataArray speeds, sinks;
+    for(unsigned i=2; i<data.size(); i+=2) {
+      speeds.push_back(data[i]);
+      sinks.push_back(data[i + 1]);
+    }
+    CPolarFit fit(speeds, sinks);
+
+    if(_bruteForce) {
+      // look for the best 3 polar curve points
+      CPolarFit::TResult result = fit.Best();
+      bestError = result.error;
+      for(unsigned i=0; i<3; i++) {
+        speed[i] = speeds[result.idx[i]];
+        sink[i] = sinks[result.idx[i]];
+      }
+    }
+    else {
+      // fit the curve to all points and describe it with the lowest, middle and highest speed
+      CDataArray weights;
+      if(relativeWeights)
+        for(unsigned i=0; i<sinks.size(); i++)
+          weights.push_back(1 / (sinks[i] * sinks[i]));
+      double polar[3];
+      fit.LeastSquares(weights, polar);
+      bestError = fit.Error(polar, std::numeric_limits<double>::max());
+      const unsigned idx[3] = { 0, static_cast<unsigned>(speeds.size() / 2), static_cast<unsigned>(speeds.size() - 1) };
+      for(unsigned i=0; i<3; i++) {
+        double v = speeds[idx[i]] / 3.6;
+        speed[i] = speeds[idx[i]];
+        sink[i] = polar[0] * v * v + polar[1] * v + polar[2];
+      }
+    }
+  }
   _polar = std::auto_ptr<CPolarXCSoar>(new CPolarXCSoar(speed, sink));
 
   if(data.size() > 8) {
@@ -284,10 +300,42 @@ void polarOptimiser::CApplication::Sink() const
 }
 
 
+/**
+ * @brief Scans glider masses for the best MassDryGross value
+ *
+ * Method checks masses in 1 kg steps until the gross sink error for full water
+ * ballast speed polar starts to grow. It is used for validation of the analytic
+ * solution.
+ *
+ * @param speedFull Full water ballast polar curve speeds
+ * @param sinkFull Full water ballast polar curve sinks
+ *
+ * @return The best MassDryGross.
+ */
+double polarOptimiser::CApplication::BestWeightScan(const double (&speedFull)[3], const double (&sinkFull)[3]) const
+{
+  unsigned weight;
+  double error = 0xFFFF;
+  for(weight=10; weight<500; weight++) {
+    double errorLast = error;
+    error = 0;
+    for(unsigned i=0; i<3; i++)
+      error += abs(_polar->Sink(speedFull[i], weight, _waterBallastLitersMax) - sinkFull[i]);
+    if(error > errorLast) {
+      weight--;
+      break;
+    }
+  }
+  return weight;
+}
+
+
 /**
  * @brief Calculates the best MassDryGross value based on MAX Water Ballast speed polar
  *
  * Method calculates the best MassDryGross value based on MAX Water Ballast speed polar.
+ * The mass is resolved analytically from polar curve equations coefficients unless
+ * exhaustive searches were requested.
  *
  * @return The best MAssDryGross.
  */
@@ -306,21 +354,23 @@ double polarOptimiser::CApplication::BestWeightCalculateUsingWaterBallast() cons
     std::cin >> sinkFull[i];
   }
 
-  unsigned weight;
-  double error = 0xFFFF;
-  for(weight=10; weight<500; weight++) {
-    double errorLast = error;
-    error = 0;
-    for(unsigned i=0; i<3; i++)
-      error += abs(_polar->Sink(speedFull[i], weight, _waterBallastLitersMax) - sinkFull[i]);
-    if(error > errorLast) {
-      error = errorLast;
-      weight--;
-      break;
-    }
-  }
+  double weight;
+  double polar[3], polarFull[3];
+  double speed[3] = { _polar->Speed(0), _polar->Speed(1), _polar->Speed(2) };
+  double sink[3] = { _polar->Sink(speed[0]), _polar->Sink(speed[1]), _polar->Sink(speed[2]) };
+  CPolarXCSoar::Coefficients(speed, sink, polar);
+  CPolarXCSoar::Coefficients(speedFull, sinkFull, polarFull);
+  if(_bruteForce || !CPolarFit::BestMass(polar, polarFull, _waterBallastLitersMax, weight))
+    weight = BestWeightScan(speedFull, sinkFull);
+
+  double error = 0;
+  for(unsigned i=0; i<3; i++)
+    error += abs(_polar->Sink(speedFull[i], weight, _waterBallastLitersMax) - sinkFull[i]);
+
   std::cout << std::endl;
-  std::cout << "The best weight [kg]: " << weight << std::endl;
+  std::cout << "The best weight [kg]: " << std::fixed << std::setprecision(1) << weight << std::endl;
+  std::cout.unsetf(std::ios_base::fixed);
+  std::cout.precision(6);
   std::cout << "Gross sink error: " << error << "m/s" << std::endl;
   std::cout << std::endl;
 
@@ -48,6 +48,7 @@ namespace polarOptimiser {
     double _massDryGross;                 /**< @brief Glider + pilot weight with empty water tanks. */
     unsigned _waterBallastLitersMax;      /**< @brief Maximum volume of water ballast in liters. */
     std::auto_ptr<CPolar> _polar;         /**< @brief Glider polar equation implementation */
+    bool _bruteForce;                     /**< @brief Use exhaustive searches instead of closed-form solutions */
 
     void PolarHeader(bool sinkError = false) const;
     void PolarLine(double speed, double weight, double ballast, bool sinkError = false, double expSink = 0) const;
@@ -57,11 +58,12 @@ namespace polarOptimiser {
 
     void SpeedPolar() const;
     void Sink() const;
+    double BestWeightScan(const double (&speedFull)[3], const double (&sinkFull)[3]) const;
     double BestWeightCalculateUsingWaterBallast() const;
     void WinPilotDump() const;
 
   public:
-    CApplication(const std::string &fileName);
+    CApplication(const std::string &fileName, bool bruteForce = false, bool relativeWeights = false);
     void Run();
   };
 
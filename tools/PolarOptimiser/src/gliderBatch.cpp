@@ -0,0 +1,219 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file gliderBatch.cpp
+ *
+ * @brief Gliders database batch processing class definition.
+**/
+
+#include "gliderBatch.h"
+#include "polarFit.h"
+#include "parallel.h"
+#include "tools.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+
+/**
+ * @brief Class constructor
+ *
+ * polarOptimiser::CGliderBatch class constructor that reads all the gliders
+ * from Condor2Nav gliders data CSV file.
+ *
+ * @param fileName Gliders data CSV file
+ */
+polarOptimiser::CGliderBatch::CGliderBatch(const std::string &fileName)
+{
+  std::ifstream inputStream(fileName.c_str());
+  if(!inputStream)
+    throw std::runtime_error("ERROR: Couldn't open gliders data file '" + fileName + "' for reading!!!");
+
+  std::string line;
+  getline(inputStream, line);   // skip columns names
+  while(getline(inputStream, line)) {
+    if(!line.empty() && line[line.size() - 1] == '\r')
+      line.erase(line.size() - 1);
+    if(line.empty())
+      continue;
+    TGlider glider;
+    glider.row = Split(line);
+    _gliders.push_back(glider);
+  }
+}
+
+
+/**
+ * @brief Splits CSV line to values
+ *
+ * @param line CSV line
+ *
+ * @return Line values (quotes are removed).
+ */
+polarOptimiser::CGliderBatch::CStringArray polarOptimiser::CGliderBatch::Split(const std::string &line)
+{
+  CStringArray values;
+  std::string value;
+  bool quoted = false;
+  for(unsigned i=0; i<line.size(); i++) {
+    char c = line[i];
+    if(c == '"')
+      quoted = !quoted;
+    else if(c == ',' && !quoted) {
+      values.push_back(value);
+      value.clear();
+    }
+    else
+      value += c;
+  }
+  values.push_back(value);
+  return values;
+}
+
+
+/**
+ * @brief Processes one glider
+ *
+ * Method fits polar curve equation to the glider points and calculates its
+ * characteristic speeds. XCSoar scales equation coefficients for water ballast
+ * by r = sqrt((mass + ballast) / mass) (a / r, b, c * r) so all the speeds are
+ * resolved analytically:
+ * - minimum sink speed: V = -b / (2 * a),
+ * - speed to fly for MacCready m: V = sqrt((c - m) / a) (m = 0 gives best LD).
+ *
+ * @param row Gliders data row
+ *
+ * @exception std Thrown when glider data are invalid.
+ *
+ * @return Gliders polars row.
+ */
+std::string polarOptimiser::CGliderBatch::Process(const CStringArray &row)
+{
+  if(row.size() <= GLIDER_SINK_3)
+    throw std::runtime_error("ERROR: Not enough gliders data!!!");
+
+  const double mass = Convert<double>(row[GLIDER_MASS_DRY_GROSS]);
+  const double ballastMax = Convert<double>(row[GLIDER_MAX_WATER_BALLAST]);
+  std::vector<double> speeds, sinks;
+  for(unsigned i=GLIDER_SPEED_1; i<=GLIDER_SINK_3; i+=2) {
+    speeds.push_back(Convert<double>(row[i]));
+    sinks.push_back(Convert<double>(row[i + 1]));
+  }
+
+  double polar[3];
+  CPolarFit(speeds, sinks).LeastSquares(std::vector<double>(), polar);
+  if(!(polar[0] < 0) || mass <= 0)
+    throw std::runtime_error("ERROR: Polar curve points do not describe a glider polar!!!");
+
+  std::ostringstream stream;
+  stream << row[GLIDER_NAME] << ",";
+  for(unsigned i=GLIDER_MASS_DRY_GROSS; i<=GLIDER_SINK_3; i++)
+    stream << (i > GLIDER_MASS_DRY_GROSS ? "/" : "") << row[i];
+
+  // fitted polar points
+  stream << std::fixed;
+  for(unsigned i=0; i<speeds.size(); i++) {
+    double v = speeds[i] / 3.6;
+    stream << "," << std::setprecision(0) << speeds[i] << "," << std::setprecision(3) << polar[0] * v * v + polar[1] * v + polar[2];
+  }
+
+  // minimum sink and best LD without water ballast
+  double vMinSink = -polar[1] / (2 * polar[0]);
+  double vBestLD = std::sqrt(polar[2] / polar[0]);
+  double sinkMin = polar[0] * vMinSink * vMinSink + polar[1] * vMinSink + polar[2];
+  double sinkBestLD = polar[0] * vBestLD * vBestLD + polar[1] * vBestLD + polar[2];
+  stream << "," << std::setprecision(0) << vMinSink * 3.6 << "," << std::setprecision(3) << sinkMin;
+  stream << "," << std::setprecision(0) << vBestLD * 3.6 << "," << std::setprecision(1) << vBestLD / -sinkBestLD;
+
+  // speed to fly tables
+  stream << std::setprecision(0);
+  for(unsigned level=0; level<BALLAST_LEVELS; level++) {
+    double ballast = ballastMax * level / (BALLAST_LEVELS - 1);
+    double r = std::sqrt((mass + ballast) / mass);
+    double a = polar[0] / r;
+    double c = polar[2] * r;
+    stream << ",";
+    for(unsigned i=0; i<MC_STEPS; i++) {
+      double mc = i * 0.5;
+      stream << (i ? "/" : "") << std::sqrt((c - mc) / a) * 3.6;
+    }
+  }
+  return stream.str();
+}
+
+
+/**
+ * @brief Worker thread processing function
+ *
+ * @param context Batch to process
+ * @param thread Index of the thread running the job
+ * @param threads The number of threads running the job
+ */
+void polarOptimiser::CGliderBatch::ProcessJob(void *context, unsigned thread, unsigned threads)
+{
+  std::vector<TGlider> &gliders = *static_cast<std::vector<TGlider> *>(context);
+  for(unsigned i=thread; i<gliders.size(); i+=threads) {
+    try {
+      gliders[i].output = Process(gliders[i].row);
+    }
+    catch(const std::exception &ex) {
+      gliders[i].error = ex.what();
+    }
+  }
+}
+
+
+/**
+ * @brief Processes all the gliders
+ *
+ * Method processes gliders on all CPU cores and writes results in the
+ * order of the gliders data file.
+ *
+ * @param fileName Gliders polars CSV file
+ *
+ * @return The number of gliders that could not be processed.
+ */
+unsigned polarOptimiser::CGliderBatch::Run(const std::string &fileName)
+{
+  ParallelRun(ProcessJob, &_gliders, ProcessorsNumber());
+
+  std::ofstream outputStream(fileName.c_str());
+  if(!outputStream)
+    throw std::runtime_error("ERROR: Couldn't open gliders polars file '" + fileName + "' for writing!!!");
+
+  outputStream << "CondorName,Source,Speed1[km/h],Sink1[m/s],Speed2,Sink2,Speed3,Sink3,MinSinkSpeed[km/h],MinSink[m/s],BestLDSpeed[km/h],BestLD,"
+                  "SpeedToFly0[km/h],SpeedToFly50[km/h],SpeedToFly100[km/h]" << std::endl;
+  unsigned failed = 0;
+  for(unsigned i=0; i<_gliders.size(); i++) {
+    if(_gliders[i].error.empty())
+      outputStream << _gliders[i].output << std::endl;
+    else {
+      std::cerr << _gliders[i].row[GLIDER_NAME] << ": " << _gliders[i].error << std::endl;
+      failed++;
+    }
+  }
+  std::cout << "Processed " << _gliders.size() - failed << " of " << _gliders.size() << " gliders" << std::endl;
+  return failed;
+}
@@ -0,0 +1,90 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file gliderBatch.h
+ *
+ * @brief Gliders database batch processing class declaration.
+**/
+
+#ifndef __GLIDERBATCH_H__
+#define __GLIDERBATCH_H__
+
+#include <string>
+#include <vector>
+
+namespace polarOptimiser {
+
+  /**
+   * @brief Gliders database batch processing
+   *
+   * polarOptimiser::CGliderBatch processes all the gliders from Condor2Nav
+   * 'GliderData.csv' file without any user interaction. For every glider it
+   * fits XCSoar polar curve equation to provided points and precomputes
+   * minimum sink, best LD and MacCready speed to fly tables for empty, half
+   * and full water ballast. Results are stored in 'GliderPolars.csv' file
+   * read by Condor2Nav when glider data are set.
+   */
+  class CGliderBatch {
+    typedef std::vector<std::string> CStringArray;
+
+    /**
+     * @brief Gliders data CSV file column names
+     */
+    enum TGlidersDataColumns {
+      GLIDER_NAME,
+      GLIDER_SPEED_MAX,
+      GLIDER_DAEC_INDEX,
+      GLIDER_WATER_BALLAST_EMPTY_TIME,
+      GLIDER_WING_AREA,
+      GLIDER_MASS_DRY_GROSS,
+      GLIDER_MAX_WATER_BALLAST,
+      GLIDER_SPEED_1,
+      GLIDER_SINK_1,
+      GLIDER_SPEED_2,
+      GLIDER_SINK_2,
+      GLIDER_SPEED_3,
+      GLIDER_SINK_3
+    };
+
+    struct TGlider {
+      CStringArray row;                   /**< @brief Gliders data row */
+      std::string output;                 /**< @brief Gliders polars row */
+      std::string error;                  /**< @brief Processing error */
+    };
+
+    static const unsigned BALLAST_LEVELS = 3; /**< @brief The number of water ballast levels (0%, 50%, 100%) */
+    static const unsigned MC_STEPS = 11;      /**< @brief The number of MacCready values in tables (0-5 m/s) */
+
+    std::vector<TGlider> _gliders;        /**< @brief Processed gliders */
+
+    static CStringArray Split(const std::string &line);
+    static std::string Process(const CStringArray &row);
+    static void ProcessJob(void *context, unsigned thread, unsigned threads);
+
+  public:
+    explicit CGliderBatch(const std::string &fileName);
+    unsigned Run(const std::string &fileName);
+  };
+
+} // namespace polarOptimiser
+
+#endif // __GLIDERBATCH_H__
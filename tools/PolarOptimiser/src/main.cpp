@@ -26,6 +26,7 @@
 **/
 
 #include "application.h"
+#include "gliderBatch.h"
 #include <iostream>
 #include <string>
 
@@ -43,10 +44,16 @@ void Usage()
   std::cout << "and you are welcome to redistribute it under GNU GPL conditions." << std::endl;
   std::cout << std::endl;
   std::cout << "Usage:" << std::endl;
-  std::cout << "  polarOptimier.exe [-h|<WINPILOT_POLAR_FILE>]" << std::endl;
+  std::cout << "  polarOptimier.exe [-h|[-b] [-r] <WINPILOT_POLAR_FILE>|-g <GLIDER_DATA_CSV> <GLIDER_POLARS_CSV>]" << std::endl;
   std::cout << std::endl;
   std::cout << "  -h                    - that help message" << std::endl;
+  std::cout << "  -b                    - use exhaustive searches of the best polar points and mass" << std::endl;
+  std::cout << "                          instead of least-squares fit and analytic solutions" << std::endl;
+  std::cout << "  -r                    - fit relative instead of absolute sink errors" << std::endl;
   std::cout << "  <WINPILOT_POLAR_FILE> - glider polar file in WinPilot like format" << std::endl;
+  std::cout << "  -g                    - non-interactive processing of all gliders from Condor2Nav" << std::endl;
+  std::cout << "                          <GLIDER_DATA_CSV> file (i.e. 'data\\GliderData.csv')" << std::endl;
+  std::cout << "                          to <GLIDER_POLARS_CSV> file (i.e. 'data\\GliderPolars.csv')" << std::endl;
 }
 
 
@@ -66,7 +73,37 @@ int main(int argc, const char *argv[])
       return EXIT_SUCCESS;
     }
 
-    polarOptimiser::CApplication app(argv[1]);
+    if(std::string(argv[1]) == "-g") {
+      if(argc != 4) {
+        Usage();
+        return EXIT_FAILURE;
+      }
+      polarOptimiser::CGliderBatch batch(argv[2]);
+      return batch.Run(argv[3]) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    bool bruteForce = false;
+    bool relativeWeights = false;
+    int i = 1;
+    for(; i<argc - 1; i++) {
+      std::string option(argv[i]);
+      if(option == "-b")
+        bruteForce = true;
+      else if(option == "-r")
+        relativeWeights = true;
+      else {
+        Usage();
+        return EXIT_FAILURE;
+      }
+    }
+
+    // options have to be followed by the polar file
+    if(argv[i][0] == '-') {
+      Usage();
+      return EXIT_FAILURE;
+    }
+
+    polarOptimiser::CApplication app(argv[i], bruteForce, relativeWeights);
     app.Run();
     return EXIT_SUCCESS;
   }
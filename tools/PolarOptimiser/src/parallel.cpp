@@ -0,0 +1,111 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file parallel.cpp
+ *
+ * @brief Parallel jobs execution definition.
+**/
+
+#include "parallel.h"
+#include <vector>
+#include <windows.h>
+
+namespace {
+
+  /**
+   * @brief Job run by a worker thread
+   */
+  struct TThreadJob {
+    polarOptimiser::FParallelJob job;     /**< @brief Job function */
+    void *context;                        /**< @brief Job context data */
+    unsigned thread;                      /**< @brief Thread index */
+    unsigned threads;                     /**< @brief The number of threads */
+  };
+
+
+  /**
+   * @brief Worker thread function
+   *
+   * @param data Job to run
+   *
+   * @return Thread exit code.
+   */
+  DWORD WINAPI ThreadRun(LPVOID data)
+  {
+    TThreadJob &job = *static_cast<TThreadJob *>(data);
+    job.job(job.context, job.thread, job.threads);
+    return 0;
+  }
+
+}
+
+
+/**
+ * @brief Returns the number of CPU cores
+ *
+ * @return The number of CPU cores.
+ */
+unsigned polarOptimiser::ProcessorsNumber()
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+}
+
+
+/**
+ * @brief Runs a job on many threads
+ *
+ * Function runs the job on provided number of threads (the calling thread is
+ * one of them) and returns when all of them finished. If a thread cannot be
+ * created, its part of the job is run by the calling thread.
+ *
+ * @param job Job function
+ * @param context Job context data
+ * @param threads The number of threads to use
+ */
+void polarOptimiser::ParallelRun(FParallelJob job, void *context, unsigned threads)
+{
+  if(threads < 1)
+    threads = 1;
+
+  std::vector<TThreadJob> jobs(threads);
+  std::vector<HANDLE> handles;
+  for(unsigned t=0; t<threads; t++) {
+    jobs[t].job = job;
+    jobs[t].context = context;
+    jobs[t].thread = t;
+    jobs[t].threads = threads;
+    if(t == 0)
+      continue;
+    HANDLE handle = CreateThread(0, 0, ThreadRun, &jobs[t], 0, 0);
+    if(handle)
+      handles.push_back(handle);
+    else
+      ThreadRun(&jobs[t]);
+  }
+  ThreadRun(&jobs[0]);
+  for(unsigned t=0; t<handles.size(); t++) {
+    WaitForSingleObject(handles[t], INFINITE);
+    CloseHandle(handles[t]);
+  }
+}
@@ -0,0 +1,47 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file parallel.h
+ *
+ * @brief Parallel jobs execution declaration.
+**/
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+namespace polarOptimiser {
+
+  /**
+   * @brief Parallel job function
+   *
+   * @param context Job context data
+   * @param thread Index of the thread running the job
+   * @param threads The number of threads running the job
+   */
+  typedef void (*FParallelJob)(void *context, unsigned thread, unsigned threads);
+
+  unsigned ProcessorsNumber();
+  void ParallelRun(FParallelJob job, void *context, unsigned threads);
+
+} // namespace polarOptimiser
+
+#endif // __PARALLEL_H__
@@ -0,0 +1,289 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file polarFit.cpp
+ *
+ * @brief Polar curve points fitting class definition.
+**/
+
+#include "polarFit.h"
+#include "polarXCSoar.h"
+#include "parallel.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+
+/**
+ * @brief Search job shared by worker threads
+ */
+struct polarOptimiser::CPolarFit::TJob {
+  const CPolarFit *fit;                 /**< @brief Searched polar */
+  std::vector<TResult> results;         /**< @brief Results of all threads */
+};
+
+
+/**
+ * @brief Class constructor
+ *
+ * polarOptimiser::CPolarFit class constructor.
+ *
+ * @param speed Measured speeds [km/h]
+ * @param sink Measured sinks [m/s]
+ */
+polarOptimiser::CPolarFit::CPolarFit(const std::vector<double> &speed, const std::vector<double> &sink) :
+  _speedKmh(speed), _sink(sink)
+{
+  if(speed.size() != sink.size() || speed.size() < 3)
+    throw std::runtime_error("ERROR: At least 3 polar curve points needed!!!");
+
+  _speed.reserve(speed.size());
+  _speed2.reserve(speed.size());
+  for(unsigned i=0; i<speed.size(); i++) {
+    double v = speed[i] / 3.6;
+    _speed.push_back(v);
+    _speed2.push_back(v * v);
+  }
+}
+
+
+/**
+ * @brief Calculates gross sink error of polar curve equation
+ *
+ * Method sums sink errors of the equation for all measured points. Summation
+ * is stopped when the error exceeds the best one found so far.
+ *
+ * @param polar Polar curve equation coefficients (see CPolarXCSoar::Coefficients())
+ * @param bestError The best error found so far
+ *
+ * @return Gross sink error (not smaller than @p bestError if summation was stopped)
+ */
+double polarOptimiser::CPolarFit::Error(const double (&polar)[3], double bestError) const
+{
+  const unsigned size = static_cast<unsigned>(_sink.size());
+  const __m128d a = _mm_set1_pd(polar[0]);
+  const __m128d b = _mm_set1_pd(polar[1]);
+  const __m128d c = _mm_set1_pd(polar[2]);
+  const __m128d signMask = _mm_set1_pd(-0.0);
+
+  __m128d sum = _mm_setzero_pd();
+  double error = 0;
+  unsigned l = 0;
+  while(l + 2 <= size) {
+    const unsigned blockEnd = (size - l >= PRUNE_BLOCK) ? l + PRUNE_BLOCK : size - (size - l) % 2;
+    for(; l<blockEnd; l+=2) {
+      __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(&_speed2[l])), _mm_mul_pd(b, _mm_loadu_pd(&_speed[l]))), c);
+      sum = _mm_add_pd(sum, _mm_andnot_pd(signMask, _mm_sub_pd(w, _mm_loadu_pd(&_sink[l]))));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, sum);
+    error = lanes[0] + lanes[1];
+    if(error >= bestError)
+      return error;
+  }
+  for(; l<size; l++) {
+    double diff = polar[0] * _speed2[l] + polar[1] * _speed[l] + polar[2] - _sink[l];
+    error += diff < 0 ? -diff : diff;
+  }
+  return error;
+}
+
+
+/**
+ * @brief Searches part of the combinations space
+ *
+ * Method checks all the triples which first point index is @p first,
+ * @p first + @p step, @p first + 2 * @p step, ....
+ *
+ * @param first The first point checked as the first one of a triple
+ * @param step The distance between first points checked
+ *
+ * @return The best triple found (the first one in case of equal errors).
+ */
+polarOptimiser::CPolarFit::TResult polarOptimiser::CPolarFit::Search(unsigned first, unsigned step) const
+{
+  const unsigned size = static_cast<unsigned>(_sink.size());
+  TResult result = { { 0, 1, 2 }, 0xFFFF };
+
+  double speed[3];
+  double sink[3];
+  double polar[3];
+  for(unsigned i=first; i<size; i+=step) {
+    speed[0] = _speedKmh[i];
+    sink[0] = _sink[i];
+    for(unsigned j=i + 1; j<size; j++) {
+      speed[1] = _speedKmh[j];
+      sink[1] = _sink[j];
+      for(unsigned k=j + 1; k<size; k++) {
+        speed[2] = _speedKmh[k];
+        sink[2] = _sink[k];
+
+        CPolarXCSoar::Coefficients(speed, sink, polar);
+        double error = Error(polar, result.error);
+        if(error < result.error) {
+          result.error = error;
+          result.idx[0] = i;
+          result.idx[1] = j;
+          result.idx[2] = k;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+
+/**
+ * @brief Worker thread search function
+ *
+ * @param context Search job
+ * @param thread Index of the thread running the job
+ * @param threads The number of threads running the job
+ */
+void polarOptimiser::CPolarFit::SearchJob(void *context, unsigned thread, unsigned threads)
+{
+  TJob &job = *static_cast<TJob *>(context);
+  job.results[thread] = job.fit->Search(thread, threads);
+}
+
+
+/**
+ * @brief Finds the best 3 polar curve points
+ *
+ * Method checks all triples of measured points with one job per CPU core.
+ * Equal errors are resolved the same way as in the sequential search so
+ * the result does not depend on the number of threads.
+ *
+ * @return The best 3 points and their gross sink error.
+ */
+polarOptimiser::CPolarFit::TResult polarOptimiser::CPolarFit::Best() const
+{
+  unsigned threads = ProcessorsNumber();
+  const unsigned firstMax = static_cast<unsigned>(_sink.size()) - 2;
+  if(threads > firstMax)
+    threads = firstMax;
+
+  TJob job;
+  job.fit = this;
+  job.results.resize(threads);
+  ParallelRun(SearchJob, &job, threads);
+
+  TResult best = job.results[0];
+  for(unsigned t=1; t<threads; t++) {
+    const TResult &result = job.results[t];
+    if(result.error < best.error || (result.error == best.error && result.idx[0] < best.idx[0]))
+      best = result;
+  }
+  return best;
+}
+
+
+/**
+ * @brief Fits polar curve equation to all measured points
+ *
+ * Method calculates weighted least-squares solution of XCSoar polar curve
+ * equation (w = a*V*V + b*V + c) for all measured points. The normal equations
+ * are solved directly so the result is exact and does not need any search.
+ *
+ * @param weights Weights of the measured points (empty for equal weights)
+ * @param polar Calculated a, b and c coefficients (see CPolarXCSoar::Coefficients())
+ *
+ * @exception std Thrown when the points do not define a quadratic curve.
+ */
+void polarOptimiser::CPolarFit::LeastSquares(const std::vector<double> &weights, double (&polar)[3]) const
+{
+  if(!weights.empty() && weights.size() != _sink.size())
+    throw std::runtime_error("ERROR: Invalid number of polar curve points weights!!!");
+
+  // sums of weighted speed powers and sink times speed powers
+  double s[5] = { 0 };
+  double t[3] = { 0 };
+  for(unsigned l=0; l<_sink.size(); l++) {
+    double w = weights.empty() ? 1 : weights[l];
+    double p = w;
+    for(unsigned k=0; k<5; k++) {
+      if(k < 3)
+        t[k] += p * _sink[l];
+      s[k] += p;
+      p *= _speed[l];
+    }
+  }
+
+  // normal equations for (a, b, c)
+  double m[3][4] = {
+    { s[4], s[3], s[2], t[2] },
+    { s[3], s[2], s[1], t[1] },
+    { s[2], s[1], s[0], t[0] }
+  };
+
+  // Gaussian elimination with partial pivoting
+  for(unsigned col=0; col<3; col++) {
+    unsigned pivot = col;
+    for(unsigned row=col + 1; row<3; row++)
+      if(std::fabs(m[row][col]) > std::fabs(m[pivot][col]))
+        pivot = row;
+    if(m[pivot][col] == 0.0)
+      throw std::runtime_error("ERROR: Polar curve points do not define a quadratic curve!!!");
+    if(pivot != col)
+      for(unsigned k=0; k<4; k++)
+        std::swap(m[col][k], m[pivot][k]);
+    for(unsigned row=col + 1; row<3; row++) {
+      double f = m[row][col] / m[col][col];
+      for(unsigned k=col; k<4; k++)
+        m[row][k] -= f * m[col][k];
+    }
+  }
+  for(int row=2; row>=0; row--) {
+    double value = m[row][3];
+    for(unsigned k=row + 1; k<3; k++)
+      value -= m[row][k] * polar[k];
+    polar[row] = value / m[row][row];
+  }
+}
+
+
+/**
+ * @brief Calculates the best glider mass for full water ballast polar
+ *
+ * XCSoar scales polar curve equation with water ballast by r = sqrt((mass + ballast) / mass)
+ * (a / r, b, c * r). Method finds the factor that matches full water ballast equation
+ * best (the geometric mean of factors fitting a and c coefficients) and resolves
+ * the mass from it.
+ *
+ * @param polar Equation coefficients without water ballast
+ * @param polarFull Equation coefficients with full water ballast
+ * @param ballastLitres Maximum water ballast
+ * @param mass Calculated glider + pilot mass
+ *
+ * @return @p true if the mass was found.
+ */
+bool polarOptimiser::CPolarFit::BestMass(const double (&polar)[3], const double (&polarFull)[3], double ballastLitres, double &mass)
+{
+  double ratio = (polar[0] * polarFull[2]) / (polarFull[0] * polar[2]);
+  if(!(ratio > 1) || ballastLitres <= 0)
+    return false;
+
+  // r = sqrt(ratio) so (mass + ballast) / mass = ratio
+  mass = ballastLitres / (ratio - 1);
+  return true;
+}
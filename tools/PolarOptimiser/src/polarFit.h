@@ -0,0 +1,82 @@
+//
+// This file is part of PolarOptimiser gliders polar files optimisation helper.
+//
+// Copyright (C) 2009 Mateusz Pusz
+//
+// PolarOptimiser is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// PolarOptimiser is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PolarOptimiser. If not, see <http://www.gnu.org/licenses/>.
+//
+// Visit the project webpage (http://sf.net/projects/condor2nav) for more info.
+//
+
+/**
+ * @file polarFit.h
+ *
+ * @brief Polar curve points fitting class declaration.
+**/
+
+#ifndef __POLARFIT_H__
+#define __POLARFIT_H__
+
+#include <vector>
+
+namespace polarOptimiser {
+
+  /**
+   * @brief The best 3 polar curve points search
+   *
+   * polarOptimiser::CPolarFit looks for the 3 measured polar curve points
+   * that define XCSoar polar curve equation with the smallest gross sink
+   * error for all measured points. Candidate triples are scored directly
+   * with the equation coefficients over speed and sink arrays (SSE2), the
+   * combinations space is split between all CPU cores and the error of a
+   * candidate is not summed any more once it exceeds the best one found.
+   *
+   * The exhaustive search is kept for validation of the closed-form
+   * solutions: a weighted least-squares fit of the polar curve equation
+   * and the analytic best glider mass for a full water ballast polar.
+   */
+  class CPolarFit {
+  public:
+    /**
+     * @brief Search result
+     */
+    struct TResult {
+      unsigned idx[3];                    /**< @brief Indexes of the best 3 points */
+      double error;                       /**< @brief Gross sink error [m/s] */
+    };
+
+  private:
+    struct TJob;
+
+    static const unsigned PRUNE_BLOCK = 8;/**< @brief The number of points summed between error checks */
+
+    std::vector<double> _speedKmh;        /**< @brief Measured speeds [km/h] */
+    std::vector<double> _speed;           /**< @brief Measured speeds [m/s] */
+    std::vector<double> _speed2;          /**< @brief Squares of measured speeds */
+    std::vector<double> _sink;            /**< @brief Measured sinks [m/s] */
+
+    static void SearchJob(void *context, unsigned thread, unsigned threads);
+    TResult Search(unsigned first, unsigned step) const;
+
+  public:
+    CPolarFit(const std::vector<double> &speed, const std::vector<double> &sink);
+    double Error(const double (&polar)[3], double bestError) const;
+    TResult Best() const;
+    void LeastSquares(const std::vector<double> &weights, double (&polar)[3]) const;
+    static bool BestMass(const double (&polar)[3], const double (&polarFull)[3], double ballastLitres, double &mass);
+  };
+
+} // namespace polarOptimiser
+
+#endif // __POLARFIT_H__
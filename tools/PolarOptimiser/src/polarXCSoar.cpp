@@ -58,7 +58,24 @@ polarOptimiser::CPolarXCSoar::CPolarXCSoar(const double (&speed)[3], const doubl
 {
   for(unsigned i=0; i<3; i++)
     _speed[i] = speed[i];
+  Coefficients(speed, sink, _polar);
+}
+
 
+/**
+ * @brief Calculates XCSoar polar curve equation coefficients
+ *
+ * Method calculates coefficients of the quadratic equation (w = a*V*V + b*V + c,
+ * with V in m/s) passing through provided 3 polar curve points. For the glider
+ * mass the points were measured with and no water ballast Sink() returns exactly
+ * that equation value.
+ *
+ * @param speed An array of speed polar curve values.
+ * @param sink An array of sink polar curve values.
+ * @param polar Calculated a, b and c coefficients.
+ */
+void polarOptimiser::CPolarXCSoar::Coefficients(const double (&speed)[3], const double (&sink)[3], double (&polar)[3])
+{
   // XCSoar specific calculations
   double d;
   double v1, v2, v3;
@@ -73,17 +90,17 @@ polarOptimiser::CPolarXCSoar::CPolarXCSoar(const double (&speed)[3], const doubl
 
   d = v1*v1*(v2-v3)+v2*v2*(v3-v1)+v3*v3*(v1-v2);
   if(d == 0.0)
-    _polar[0] = 0;
+    polar[0] = 0;
   else
-    _polar[0] = ((v2-v3)*(w1-w3)+(v3-v1)*(w2-w3))/d;
+    polar[0] = ((v2-v3)*(w1-w3)+(v3-v1)*(w2-w3))/d;
 
   d = v2-v3;
   if(d == 0.0)
-    _polar[1] = 0;
+    polar[1] = 0;
   else
-    _polar[1] = (w2-w3-_polar[0]*(v2*v2-v3*v3))/d;
+    polar[1] = (w2-w3-polar[0]*(v2*v2-v3*v3))/d;
 
-  _polar[2] = (double)(w3-_polar[0]*v3*v3-_polar[1]*v3);
+  polar[2] = (double)(w3-polar[0]*v3*v3-polar[1]*v3);
 }
 
 
@@ -44,6 +44,7 @@ namespace polarOptimiser {
     double SinkRate(double a, double b, double c, double MC, double HW, double V) const;
   public:
     CPolarXCSoar(const double (&speed)[3], const double (&sink)[3]);
+    static void Coefficients(const double (&speed)[3], const double (&sink)[3], double (&polar)[3]);
     virtual double Speed(unsigned idx) const;
     virtual double Sink(double speed, double weight, double ballastLitres) const;
   };